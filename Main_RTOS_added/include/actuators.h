@@ -2,30 +2,43 @@
 #define ACTUATORS_H
 
 #include <Arduino.h>
-#include <ESP32Servo.h>
 #include "config.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 
 // External variables
-extern Servo myServo;
-extern int degree;
 extern unsigned long lastTime;
 extern bool AC;
 
+// Wake reasons for TaskActuators (bitmask, task notification value)
+enum ActuatorEventBits : uint32_t {
+  ACT_EVT_NONE       = 0,
+  ACT_EVT_SAMPLE     = (1u << 0),  // Sensor sample with new climate or someone at the door
+  ACT_EVT_HAZARD     = (1u << 1),  // Fire/motion event posted on eventQueue
+  ACT_EVT_SERVO_DUE  = (1u << 2),  // Servo close deadline reached (wait timeout)
+  ACT_EVT_AC         = (1u << 3),  // AC switched from Blynk
+  ACT_EVT_FAN_DUE    = (1u << 4),  // Fan loop step due while regulating (wait timeout)
+  ACT_EVT_FIRE_RESET = (1u << 5),  // Latched fire relay reset from Blynk
+  ACT_EVT_ALL        = 0x3F
+};
+
 // Actuator initialization
 void initActuators();
 
-// Fan control functions
+// Event-driven wakeups: TaskActuators attaches itself, producers notify it
+// (any task, not ISRs). Notifications before the attach are dropped; the
+// task starts with a pass over every input anyway.
+void attachActuatorTask();
+void notifyActuators(uint32_t bits);
+uint32_t waitActuatorEvents();     // Blocks until notified or the next servo/fan deadline
+uint32_t getActuatorWakeCount();
+
+// Fan control (one fan_control loop step)
 void controlFan(int temperature, int humidity);
-void turnOnFan();
-void turnOffFan();
 
-// Servo control functions
-void initServo();
-void moveServo();
-void setServoPosition(int position);
+// Servo control (goals for servo_motion)
+void moveServo(int distanceCm);   // Opens at the door, closes SERVO_DELAY after the last sighting
 
 // Relay control functions
 void activateRelay();
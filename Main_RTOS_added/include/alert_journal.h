@@ -0,0 +1,63 @@
+#ifndef ALERT_JOURNAL_H
+#define ALERT_JOURNAL_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 🗒️ Alert journal
+// Every alert transition, kept across reboots in the "alerts" flash
+// partition (partitions_trace.csv) as an append-only log of 16-byte records:
+//   append   records go to a RAM ring first; TaskSystemMonitor writes them
+//            out ALERT_JOURNAL_BATCH at a time (one flash page), or once the
+//            oldest has waited ALERT_JOURNAL_FLUSH_MS
+//   wear     record n lives in slot n of the partition, modulo its size, so
+//            the log walks round every sector in turn; a sector is erased
+//            when the log enters it, dropping its oldest 256 records
+//   index    the first record of every sector (sequence and time) is kept
+//            in RAM: a time window costs a binary search over the sectors
+//            and a read of the records it returns
+//   boot     one read per sector rebuilds the index, a binary search in the
+//            newest sector finds the append point
+// The newest ALERT_JOURNAL_RECENT records are also kept in RAM, so the OLED
+// and "last N" queries for a few records never touch the flash.
+// Times are journal seconds: uptime plus the time of the last record before
+// this boot, so they only increase, but do not count time spent powered off.
+// Without the partition the journal keeps only the RAM ring.
+
+enum AlertType : uint8_t {
+  ALERT_FIRE = 1,            // detail: temperature °C
+  ALERT_FIRE_CLEAR,
+  ALERT_THIEF,               // detail: intrusion score
+  ALERT_THIEF_CLEAR,
+  ALERT_RELAY_RESET,         // Latched fire relay released (VPIN_FIRE_RESET)
+  ALERT_TYPES
+};
+
+struct AlertRecord {
+  uint32_t seq;              // Log position; 0xFFFFFFFF in an erased slot
+  uint32_t timeS;            // Journal seconds
+  uint16_t boot;             // Newest record's boot + 1 at each boot
+  uint8_t type;              // AlertType
+  uint8_t check;             // Catches records torn by a reset mid-write
+  int16_t detail;
+  uint16_t reserved;
+};
+
+bool initAlertJournal();     // Setup; false without the partition (RAM only)
+uint32_t alertJournalNowS(); // Journal seconds now
+uint16_t alertJournalBoot();
+void alertJournalAdd(AlertType type, int16_t detail);   // Any task, never blocks
+const char* alertTypeName(uint8_t type);
+
+// Queries fill out[] and return the count
+size_t alertJournalLast(size_t n, AlertRecord* out);    // Newest first
+size_t alertJournalRange(uint32_t fromS, uint32_t toS, AlertRecord* out, size_t max);  // [from, to), oldest first
+
+void serviceAlertJournal();  // TaskSystemMonitor: batched flash writes and the export
+void printAlertJournalStats();   // One Serial line, with the task statistics report
+
+// Export: "#A:" lines of the last N records (0 = everything) over Serial
+void alertJournalRequestExport(uint32_t records);
+bool alertJournalExportPending();
+
+#endif // ALERT_JOURNAL_H
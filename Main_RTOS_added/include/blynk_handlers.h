@@ -25,5 +25,7 @@ bool isBlynkConnected();
 
 // Data sending functions
 void sendSensorDataToBlynk(int temperature, int humidity, bool flame, bool motion);
+void sendTaskStatsToBlynk();  // One-line task statistics summary on VPIN_TASK_STATS
+void sendRollupToBlynk();     // Last hour/day/week aggregates on VPIN_ROLLUP_SUMMARY
 
 #endif // BLYNK_HANDLERS_H
\ No newline at end of file
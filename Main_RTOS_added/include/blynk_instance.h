@@ -5,7 +5,11 @@
 #define NO_GLOBAL_INSTANCES
 #define NO_GLOBAL_BLYNK
 
+#ifdef SIM_NATIVE
+#include <BlynkSimpleSim.h>     // Host build: same classes over a loopback socket
+#else
 #include <BlynkSimpleEsp32.h>
+#endif
 
 // Declare the global Blynk object as extern
 extern WiFiClient _blynkWifiClient;
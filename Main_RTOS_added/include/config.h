@@ -9,18 +9,26 @@
 // WiFi Configuration - Replace with your network credentials
 #define WIFI_SSID "YOUR_WIFI_SSID"
 #define WIFI_PASSWORD "YOUR_WIFI_PASSWORD"
-#define WIFI_TIMEOUT 10000  // WiFi connection timeout in milliseconds
+#define WIFI_TIMEOUT 10000  // Per-attempt WiFi connection timeout in milliseconds
+#define WIFI_BACKOFF_MIN_MS 1000    // First retry window after a failed attempt
+#define WIFI_BACKOFF_MAX_MS 60000   // Backoff window cap
+#define WIFI_FAST_RECONNECT 1       // Reuse cached BSSID/channel/DHCP lease from NVS
+#define WIFI_LEASE_DEFAULT_S 3600   // Lease length assumed when the DHCP client can't report it
+#define WIFI_LEASE_VERIFY_MS 15000  // A reused lease must reach Blynk within this, else DHCP
 
 // Pin Definitions
 #define DHTPIN 40           // DHT sensor pin
 #define FAN_PIN 12          // Fan control pin
 #define FLAME_SENSOR_PIN 4  // Flame sensor pin
+#define FLAME_ANALOG_PIN 6  // Flame sensor analog output (ADC1, FLAME_FLICKER)
 #define BUZZER_PIN 17       // Buzzer pin
 #define RELAY_PIN 1         // Relay pin
 #define PIR_PIN 5           // PIR motion sensor pin
 #define SERVO_PIN 7         // Servo motor pin
 #define TRIG_PIN 42         // Ultrasonic sensor trigger pin
 #define ECHO_PIN 41         // Ultrasonic sensor echo pin
+#define BACK_TRIG_PIN 15    // Back door ultrasonic trigger (ULTRA_BACK_DOOR)
+#define BACK_ECHO_PIN 16    // Back door ultrasonic echo (ULTRA_BACK_DOOR)
 // new
 #define LED_STRIP 20
 #define LOUD_BUZZER 19
@@ -35,6 +43,8 @@
 #define OLED_SDA_PIN 8     // SDA pin for OLED (ESP32)
 #define OLED_SCL_PIN 9     // SCL pin for OLED (ESP32)
 #define OLED_ADDRESS 0x3C   // I2C address for OLED
+#define TREND_COLUMN_S 60   // Trend page: seconds per graph column (a multiple of the 60 s rollup minute)
+#define TREND_SCALE_STEP 5  // Trend page: axis limits snap to multiples of this (°C and %)
 
 // Button Definitions
 #define BUTTON_NEXT 47
@@ -50,15 +60,203 @@
 #define TEMP_THRESHOLD 23   // Temperature threshold in Celsius
 #define HUMIDITY_THRESHOLD 60  // Humidity threshold in percentage
 
+// LEDC channels and timers
+// The S3 has 8 channels on 4 timers; channels 2t and 2t+1 share timer t
+// (arduino-esp32 2.x), and ledcSetup()/ledcWriteTone() on a channel reprogram
+// its whole timer. Each user gets a timer of its own:
+//   timer 0  servo (ESP32PWM, 50 Hz) - allocateTimer() keeps it off the others
+//   timer 1  free (channels 2, 3)
+//   timer 2  fan, channel 4 (25 kHz); channel 5 must stay unused
+//   timer 3  buzzer, channel 7 (retuned for every tone); channel 6 must stay unused
+#define SERVO_LEDC_TIMER 0
+#define FAN_LEDC_CHANNEL 4
+#define BUZZER_LEDC_CHANNEL 7
+#if (FAN_LEDC_CHANNEL / 2) % 4 == (BUZZER_LEDC_CHANNEL / 2) % 4 || (FAN_LEDC_CHANNEL / 2) % 4 == SERVO_LEDC_TIMER
+#error "FAN_LEDC_CHANNEL shares an LEDC timer with the buzzer or the servo"
+#endif
+
+// Fan Control (PI loop with on/off hysteresis on LEDC PWM, see fan_control.h)
+#define FAN_PWM_FREQ_HZ 25000        // Above hearing, 4-wire fan PWM standard
+#define FAN_PWM_BITS 8
+#define FAN_TEMP_SETPOINT_C TEMP_THRESHOLD
+#define FAN_HUMIDITY_SETPOINT_PCT HUMIDITY_THRESHOLD
+#define FAN_HUMIDITY_PCT_PER_C 5     // Humidity error worth 1 C of temperature error
+#define FAN_KP 150                   // Duty permille per C of error
+#define FAN_KI 5                     // Duty permille per C per second of error
+#define FAN_MIN_DUTY 300             // Permille; less stalls the fan, so it stays off
+#define FAN_MAX_DUTY 1000            // Permille; also the AC override duty
+#define FAN_HYSTERESIS 100           // A running fan stops below FAN_MIN_DUTY minus this
+#define FAN_CONTROL_PERIOD_MS 1000   // Loop step while regulating (idle loop sleeps)
+
+// Sensor Polling
+#define SENSOR_POLL_INTERVAL_MS 250  // TaskSensorPoll sample period
+
+// Sensor Debounce (consecutive TaskSensorPoll samples to change state)
+#define FIRE_DEBOUNCE_SAMPLES 3
+#define PIR_DEBOUNCE_SAMPLES 2
+
+// Flame Flicker Detection (flame module AO via continuous ADC, see flame_flicker.h)
+#ifndef FLAME_FLICKER
+#define FLAME_FLICKER 0              // 1 = fire also needs the 1-15 Hz flicker of a real flame
+#endif
+#define FLAME_ADC_SAMPLE_HZ 1000     // DMA conversion rate (S3 minimum is 611 Hz)
+#define FLAME_ADC_DECIMATE 4         // Conversions averaged per analysis sample (250 Hz)
+#define FLAME_ADC_FRAME_CONV 64      // Conversions per DMA frame
+#define FLAME_FFT_SIZE 256           // Analysis window, ~1 s (power of two)
+#define FLAME_FFT_HOP 128            // New samples between windows
+#define FLAME_FLICKER_LO_HZ 1
+#define FLAME_FLICKER_HI_HZ 15
+#define FLAME_MIN_AC_COUNTS 20       // Signal RMS below this is a steady source: confidence 0
+#define FLAME_FLICKER_CONFIDENCE 50  // % of AC energy in the flicker band that counts as fire
+#define FLAME_DSP_BUDGET_US 2000     // CPU budget per analysis window (core 0)
+
+// Fire Fast Path (flame pin interrupt drives the relay directly, see fire_fastpath.h)
+#ifndef FIRE_FAST_PATH
+#if FLAME_FLICKER
+#define FIRE_FAST_PATH 0             // The comparator alone also trips on sunlight
+#else
+#define FIRE_FAST_PATH 1
+#endif
+#endif
+#define FIRE_FAST_GLITCH_US 5000     // Flame input must stay active this long to trip the relay
+#define FIRE_CLEAR_FOLLOW 0          // Relay drops with the debounced fire clear
+#define FIRE_CLEAR_LATCH 1           // Relay stays on after the clear until reset on VPIN_FIRE_RESET
+#ifndef FIRE_CLEAR_MODE
+#define FIRE_CLEAR_MODE FIRE_CLEAR_FOLLOW
+#endif
+
+// PIR Edge Capture (interrupt timestamps, esp_timer debounce, see pir_capture.h)
+#ifndef PIR_EDGE_CAPTURE
+#define PIR_EDGE_CAPTURE 1           // 0 = poll with PIR_DEBOUNCE_SAMPLES in TaskSensorPoll
+#endif
+#define PIR_SETTLE_MS 50             // PIR level must hold this long after its last edge
+#define PIR_RING_EDGES 64            // ISR timestamp ring (power of two)
+
+// Intrusion Fusion (PIR + ultrasonic movement + door, see intrusion_fusion.h)
+#define INTRUSION_WINDOW_MS 3000     // Sliding evidence window, one slot per sensor sample
+#define INTRUSION_MOVE_CM 8          // Echo distance change between samples that counts as movement
+#define INTRUSION_W_PIR 50           // Source weights, sum 100; MOVE + DOOR stay below ALARM_ON
+#define INTRUSION_W_MOVE 35          // so no alert is raised without the PIR
+#define INTRUSION_W_DOOR 15
+#define INTRUSION_PIR_SLOTS 1        // Slots in the window for a source's full weight
+#define INTRUSION_MOVE_SLOTS 2
+#define INTRUSION_DOOR_SLOTS 1
+#define INTRUSION_ALARM_ON 70        // Score that raises the thief alert
+#define INTRUSION_ALARM_OFF 30       // Score that clears it again
+
+// Sensor Trace Recorder (raw TaskSensorPoll samples, replayed by tools/sensor_trace)
+#define TRACE_SINK_NONE 0
+#define TRACE_SINK_FLASH 1    // "trace" data partition (partitions_trace.csv)
+#define TRACE_SINK_SERIAL 2   // "#T:" hex lines interleaved with the Serial log
+#ifndef SENSOR_TRACE_SINK
+#define SENSOR_TRACE_SINK TRACE_SINK_NONE
+#endif
+
+// Sensor History (compressed time series in PSRAM, see history_store.h)
+#define HISTORY_INTERVAL_MS 1000     // One point per second from TaskSensorPoll
+#define HISTORY_BLOCK_BYTES 256      // Encoded block, 24-byte header included
+#define HISTORY_BLOCKS 2048          // Ring of blocks (power of two): 512 KB of PSRAM
+#define HISTORY_DISTANCE_DEADBAND_CM 2   // Smaller distance changes are stored as unchanged
+#define HISTORY_EXPORT_LINES 32      // "#H:" lines written per TaskSystemMonitor pass
+
+// Sensor History Rollups (segment-tree buckets, see history_rollup.h)
+#define ROLLUP_MINUTE_BUCKETS 1440   // One day of minutes
+#define ROLLUP_HOUR_BUCKETS 720      // 30 days of hours
+#define ROLLUP_DAY_BUCKETS 732       // Two years of days (271 KB of PSRAM in all)
+#define ROLLUP_BLYNK_MS 60000        // Summary line interval on VPIN_ROLLUP_SUMMARY
+
+// Alert Journal (flash event log in the "alerts" partition, see alert_journal.h)
+#define ALERT_JOURNAL_BATCH 16       // Records per flash write (one 256-byte page)
+#define ALERT_JOURNAL_FLUSH_MS 5000  // Longest an alert waits in RAM for the rest of its batch
+#define ALERT_JOURNAL_RECENT 32      // Newest records also kept in RAM (OLED, last-N queries)
+#define ALERT_JOURNAL_EXPORT_LINES 32   // "#A:" records written per TaskSystemMonitor pass
+
 // Ultrasonic Sensor Configuration
 #define DISTANCE_THRESHOLD 12  // Distance threshold in cm for servo activation
 #define SERVO_DELAY 3000      // Servo return delay in milliseconds
+#define DISTANCE_NONE 999      // getDistance() with nothing in range
+
+// Ultrasonic Distance Filter (median + alpha-beta tracker, see distance_filter.h)
+#define DIST_MEDIAN_N 3              // Median window (odd, <= 7); each extra pair adds a ping of lag
+#define DIST_FAR_MM 0xFFFF           // Median value of a missing echo
+#define DIST_ALPHA_Q8 128            // Tracker gains / 256: 0.5 and 0.17 (critically damped)
+#define DIST_BETA_Q8 43
+#define DIST_SNAP_MM 300             // Median jump that restarts the track instead of being tracked
+#define DIST_MAX_COAST 4             // Pings without a target bridged by prediction
+
+// Ultrasonic Array (echo interrupts, interleaved triggering, see ultrasonic_array.h)
+#ifndef ULTRASONIC_ARRAY
+#define ULTRASONIC_ARRAY 1           // 0 = one blocking pulseIn ping per TaskSensorPoll sample
+#endif
+#ifndef ULTRA_BACK_DOOR
+#define ULTRA_BACK_DOOR 0            // 1 = second HC-SR04 on BACK_TRIG_PIN / BACK_ECHO_PIN
+#endif
+#define ULTRA_MAX_RANGE_CM 400       // Listen window per ping (23.5 ms of echo)
+#define ULTRA_GUARD_US 2000          // Quiet time after a slot's last echo before the next slot fires
+#define ULTRA_CYCLE_MS 60            // Minimum trigger-to-trigger time of one sensor (HC-SR04 datasheet)
+// X(id, name, trig pin, echo pin, group). Sensors of one group hear each
+// other's bursts and take turns; different groups fire in the same slot.
+#if ULTRA_BACK_DOOR
+#define ULTRA_BACK_SENSOR(X) X(ULTRA_BACK, "back", BACK_TRIG_PIN, BACK_ECHO_PIN, 1)
+#else
+#define ULTRA_BACK_SENSOR(X)
+#endif
+#define ULTRASONIC_SENSORS(X) \
+  X(ULTRA_DOOR, "door", TRIG_PIN, ECHO_PIN, 0) \
+  ULTRA_BACK_SENSOR(X)
+
+// Door Servo Motion (trapezoidal profiles stepped by an esp_timer, see servo_motion.h)
+#define SERVO_PWM_FREQ_HZ 50       // Standard hobby servo frame
+#define SERVO_PWM_BITS 16          // LEDC duty resolution (0.3 us per step at 50 Hz)
+#define SERVO_MIN_US 500           // Pulse width at 0 degrees
+#define SERVO_MAX_US 2500          // Pulse width at 180 degrees
+#define SERVO_CLOSED_DEG 0
+#define SERVO_OPEN_DEG 180
+#define SERVO_STEP_MS 20           // Profile step, one PWM frame
+#define SERVO_MAX_SPEED_DPS 240    // Cruise speed (deg/s)
+#define SERVO_ACCEL_DPS2 720       // Acceleration and braking (deg/s^2)
 
 // Timing Configuration
-#define SERIAL_BAUD_RATE 9600  // Serial communication baud rate
+#define SERIAL_BAUD_RATE 921600  // Serial rate (nominal when Serial is USB-CDC)
 #define STARTUP_DISPLAY_DELAY 400  // Startup message display delay
 #define MODE_DISPLAY_DELAY 1000    // Mode status display delay
 
+// Deferred Logging (runtime messages go through a ring drained by TaskLogDrain)
+#define LOG_FORMAT_TEXT 0      // Drain task formats the records itself
+#define LOG_FORMAT_BINARY 1    // Framed binary records, decode with tools/log_decode
+#ifndef DEFERRED_LOG_FORMAT
+#define DEFERRED_LOG_FORMAT LOG_FORMAT_BINARY
+#endif
+#define LOG_RING_SLOTS 256         // Records buffered between drains (power of two)
+#define LOG_DRAIN_INTERVAL_MS 20   // TaskLogDrain wakeup period
+
+// RTOS Timeline Trace (PSRAM flight recorder, convert dumps with tools/rtos_trace)
+#ifndef RTOS_TRACE_ENABLED
+#define RTOS_TRACE_ENABLED 1
+#endif
+#define RTOS_TRACE_RING_EVENTS 65536   // 16-byte events, 1 MB of PSRAM (power of two)
+#define RTOS_TRACE_MAX_OBJECTS 48      // Named tasks, queues and mutexes
+#define RTOS_TRACE_EVENTS_PER_LINE 8   // Events per "#R:" dump line
+#define RTOS_TRACE_DUMP_LINES 32       // Dump lines written per TaskSystemMonitor pass
+
+// Memory Placement (see mem_placement.h for the classes)
+#define MEM_PLACEMENT_MAX_ENTRIES 32   // Buffers listed in the boot report
+#define MEM_BULK_FALLBACK_MAX 8192     // Largest MEM_BULK block allowed in internal RAM without PSRAM
+
+// RTOS Resources (task stacks, TCBs, queues and mutexes from the table in main.cpp)
+#ifndef RTOS_STATIC_ALLOCATION
+#define RTOS_STATIC_ALLOCATION 1   // 1 = ...Static APIs on .bss storage, 0 = heap
+#endif
+
+// Periodic Tasks (periods and deadlines are in the RTOS_TASKS table in main.cpp)
+#define PERIODIC_SHED_CYCLES 4       // Jobs without optional work after a deadline overrun
+
+// Runtime Task Statistics (CPU share, idle per core, loop jitter, stack headroom)
+#define TASK_STATS_MAX_TASKS 8       // Fixed table, one slot per registered task
+#define TASK_STATS_WINDOW_MS 1000    // CPU and period averaging window
+#define TASK_STATS_REPORT_MS 60000   // Serial table interval (TaskSystemMonitor)
+#define TASK_STATS_BLYNK_MS 10000    // Summary line interval on VPIN_TASK_STATS
+
 // Blynk Virtual Pins
 #define VPIN_TEMPERATURE V0
 #define VPIN_HUMIDITY V1
@@ -66,5 +264,11 @@
 #define VPIN_FLAME V4
 #define VPIN_DAY_NIGHT V5
 #define VPIN_AC_CONTROL V6
+#define VPIN_TRACE_DUMP V7   // Write 1 to dump the RTOS trace over Serial
+#define VPIN_TASK_STATS V8   // Task statistics summary (string)
+#define VPIN_FIRE_RESET V9   // Write 1 to release a latched fire relay (FIRE_CLEAR_LATCH)
+#define VPIN_HISTORY_EXPORT V10   // Write N to export the last N minutes of history over Serial (0 = all)
+#define VPIN_ROLLUP_SUMMARY V11   // Last hour, day and week min/avg/max and hazard counts (string)
+#define VPIN_ALERT_EXPORT V12     // Write N to export the last N journal alerts over Serial (0 = all)
 
 #endif // CONFIG_H
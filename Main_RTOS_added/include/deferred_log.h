@@ -0,0 +1,77 @@
+#ifndef DEFERRED_LOG_H
+#define DEFERRED_LOG_H
+
+#include <Arduino.h>
+#include <string.h>
+#include <type_traits>
+#include "config.h"
+#include "log_catalog.h"
+
+// 🪵 Deferred logging
+// logEvent() copies an id, a µs timestamp and up to LOG_MAX_ARGS numeric
+// arguments into a lock-free ring and returns; it never formats, allocates
+// or touches the UART, so it is safe in any task (and ISRs). TaskLogDrain
+// empties the ring onto Serial as framed binary records or formatted text
+// (DEFERRED_LOG_FORMAT). A full ring drops records and reports the count.
+//
+// Wire frame (binary format), text printed by other code passes through:
+//   0x1E  COBS( u16 id, u32 timestamp us, u8 core<<7 | argc,
+//               zigzag varint args..., u8 checksum )  0x00
+
+#define LOG_MAX_ARGS      4
+#define LOG_FRAME_START   0x1E
+#define LOG_FRAME_END     0x00
+#define LOG_MAX_FRAME     (2 + 4 + 1 + 5 * LOG_MAX_ARGS + 1)   // Before COBS
+
+typedef struct {
+  uint16_t id;
+  uint8_t core;
+  uint8_t argc;
+  uint32_t tsUs;
+  int32_t args[LOG_MAX_ARGS];
+} LogRecord;
+
+// Setup (call once, right after Serial is up); TaskLogDrain does the output
+bool initDeferredLog();
+
+// Producer side (any task or ISR, lock-free, never blocks)
+bool logRecord(LogId id, uint8_t argc, const int32_t* args);
+
+static inline int32_t logArg(float v) {
+  int32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  return bits;
+}
+
+static inline int32_t logArg(double v) {
+  return logArg((float)v);
+}
+
+template <typename T>
+static inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, int32_t>::type
+logArg(T v) {
+  return (int32_t)v;
+}
+
+template <typename... Args>
+static inline bool logEvent(LogId id, Args... args) {
+  static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+  int32_t packed[] = { 0, logArg(args)... };
+  return logRecord(id, (uint8_t)sizeof...(Args), packed + 1);
+}
+
+// Statistics
+uint32_t getLogDroppedCount();
+uint32_t getLogWrittenBytes();    // Bytes TaskLogDrain has written to Serial
+
+// Shared with the host decoder
+const char* getLogFormat(uint16_t id);
+uint32_t getLogCatalogHash();     // FNV-1a over all formats, sent in LOG_BOOT
+size_t formatLogRecord(const LogRecord* rec, char* out, size_t outSize);
+size_t encodeLogFrame(const LogRecord* rec, uint8_t* out);   // out >= LOG_MAX_FRAME + 4
+bool decodeLogFrame(const uint8_t* cobs, size_t len, LogRecord* rec);   // Between 0x1E and 0x00
+
+// RTOS task entrypoint
+void TaskLogDrain(void* pvParameters);
+
+#endif // DEFERRED_LOG_H
@@ -0,0 +1,43 @@
+#ifndef DISTANCE_FILTER_H
+#define DISTANCE_FILTER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 📏 Ultrasonic distance filter
+// Per sensor, per ping: the echo width goes to millimetres (Q16 multiply, no
+// float) and into a median-of-DIST_MEDIAN_N window. A missing echo enters the
+// window as "nothing in range", so one spurious echo or one lost echo never
+// gets past the median. The median feeds a fixed-point alpha-beta tracker
+// (position Q16 mm, velocity Q16 mm/ms). When the median loses the target the
+// tracker coasts on its velocity for up to DIST_MAX_COAST pings before the
+// estimate turns invalid; a median jump beyond DIST_SNAP_MM restarts the track
+// there instead of sliding towards it. No allocation, no division on the
+// common path except one by the sample interval.
+
+struct DistanceEstimate {
+  int16_t distanceCm;        // DISTANCE_NONE while !valid
+  int16_t velocityCmS;       // Negative = approaching, positive = leaving
+  bool valid;                // Target tracked (measured or coasting)
+};
+
+struct DistanceFilter {
+  uint16_t window[DIST_MEDIAN_N];   // Last pings in mm, DIST_FAR_MM = no echo
+  uint8_t head;
+  uint8_t misses;            // Consecutive pings without a target
+  bool tracking;
+  int32_t posQ16;            // mm << 16
+  int32_t velQ16;            // (mm/ms) << 16
+  uint32_t lastMs;
+  uint32_t pings;            // Statistics since the last reset
+  uint32_t dropouts;         // Pings without an echo
+  uint32_t spikes;           // Echoes the median overruled
+  uint32_t coasted;          // Pings bridged by prediction
+  uint32_t snaps;            // Tracks (re)started
+};
+
+void distanceFilterReset(DistanceFilter* f);
+DistanceEstimate distanceFilterUpdate(DistanceFilter* f, uint16_t echoUs, uint32_t tsMs);
+int echoToCm(uint16_t echoUs);   // Unfiltered conversion, DISTANCE_NONE for no echo
+
+#endif // DISTANCE_FILTER_H
@@ -0,0 +1,37 @@
+#ifndef FAN_CONTROL_H
+#define FAN_CONTROL_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 🌀 Fan control
+// Fixed-point PI loop on the larger of the temperature error and the
+// humidity error (scaled by FAN_HUMIDITY_PCT_PER_C), in milli-degrees. The
+// output is a PWM duty in permille on FAN_LEDC_CHANNEL:
+//   - below FAN_MIN_DUTY the fan stays off; once running it keeps
+//     FAN_MIN_DUTY until the demand drops FAN_HYSTERESIS below it
+//   - the integral is clamped to [0, FAN_MAX_DUTY] and does not grow while
+//     the output is saturated (anti-windup)
+//   - forceMax (AC switched on) runs at FAN_MAX_DUTY and freezes the loop
+// Duty is written only when the LEDC value changes. Time is passed in, so
+// tools/fan_model can run the same code against a thermal model.
+
+struct FanControlState {
+  uint16_t dutyPermille;      // Applied duty, 0 = off
+  int32_t errorMdeg;          // Last error, milli-degrees C
+  int32_t integralPermille;   // Integral term
+  bool forced;                // AC override active
+  uint32_t writes;            // LEDC duty writes since boot
+};
+
+bool initFanControl();        // Attaches FAN_PIN to its LEDC channel, fan off
+
+// New temperature/humidity sample or a due step; returns the duty (permille)
+uint16_t updateFanControl(int temperatureC, int humidityPct, bool forceMax, uint32_t nowMs);
+
+// Time until the loop needs a step without a new sample, UINT32_MAX at rest
+uint32_t fanControlDueInMs(uint32_t nowMs);
+
+void getFanControlState(FanControlState* out);
+
+#endif // FAN_CONTROL_H
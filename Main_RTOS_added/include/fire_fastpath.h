@@ -0,0 +1,31 @@
+#ifndef FIRE_FASTPATH_H
+#define FIRE_FASTPATH_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 🔥 Fire fast path (FIRE_FAST_PATH)
+// A GPIO interrupt on FLAME_SENSOR_PIN starts a one-shot esp_timer of
+// FIRE_FAST_GLITCH_US at the flame edge. If the input is still active when it
+// expires, the timer callback energizes the relay itself and raises the fire
+// alert (EVENT_FIRE_DETECTED + ACT_EVT_HAZARD); TaskActuators then only does
+// display, audio and telemetry. Pulses that end inside the window are counted
+// as glitches. The TaskSensorPoll debouncer still runs: it raises the alert if
+// the fast path missed it and always owns the clear, which re-arms the fast
+// path (FIRE_CLEAR_MODE decides whether the relay drops with it).
+
+struct FireFastPathStats {
+  uint32_t trips;            // Relay energized by the fast path
+  uint32_t glitches;         // Flame pulses shorter than FIRE_FAST_GLITCH_US
+  uint32_t lastLatencyUs;    // Flame edge to relay on, last trip
+  uint32_t minLatencyUs;
+  uint32_t maxLatencyUs;
+  uint32_t avgLatencyUs;
+};
+
+bool initFireFastPath();      // After initSensors/initActuators and the event queue; false when disabled
+void rearmFireFastPath();     // Debounced clear handled: the next flame edge trips again
+void getFireFastPathStats(FireFastPathStats* out);
+void printFireFastPathStats();   // One Serial line, with the task statistics report
+
+#endif // FIRE_FASTPATH_H
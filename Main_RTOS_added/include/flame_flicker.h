@@ -0,0 +1,37 @@
+#ifndef FLAME_FLICKER_H
+#define FLAME_FLICKER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 🕯️ Flame flicker detection (FLAME_FLICKER)
+// The flame module's analog output on FLAME_ANALOG_PIN is sampled by the
+// continuous ADC driver (DMA) at FLAME_ADC_SAMPLE_HZ and averaged down by
+// FLAME_ADC_DECIMATE. Every FLAME_FFT_HOP samples TaskFlameFlicker takes the
+// last FLAME_FFT_SIZE of them, removes the mean, applies a Hann window and
+// runs an ESP-DSP radix-2 FFT. The confidence is the share of the signal's
+// slope energy in the FLAME_FLICKER_LO_HZ..FLAME_FLICKER_HI_HZ flicker band
+// (0-100), or 0 when the signal is too steady to be a flame (sunlight, lamps,
+// IR sources).
+// readLiveSensors() then only reports a flame when the digital output is
+// active and the confidence reaches FLAME_FLICKER_CONFIDENCE.
+
+struct FlameFlickerStats {
+  uint32_t windows;          // Spectra computed
+  uint32_t adcOverruns;      // DMA frames lost because the task fell behind
+  uint32_t overBudget;       // Windows that took longer than FLAME_DSP_BUDGET_US
+  uint32_t lastUs;           // CPU time of one window (mean, window, FFT, band sums)
+  uint32_t avgUs;
+  uint32_t maxUs;
+  uint16_t rmsCounts;        // AC amplitude of the last window
+  uint16_t peakCentiHz;      // Strongest bin inside the flicker band
+  uint8_t confidence;        // Last published confidence, %
+};
+
+bool initFlameFlicker();      // Before the tasks start; false when disabled or the ADC/FFT setup failed
+void TaskFlameFlicker(void* pvParameters);
+uint8_t getFlameConfidence(); // 0-100, 0 until the first window
+void getFlameFlickerStats(FlameFlickerStats* out);
+void printFlameFlickerStats();   // One Serial line, with the task statistics report
+
+#endif // FLAME_FLICKER_H
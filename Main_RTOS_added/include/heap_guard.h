@@ -0,0 +1,40 @@
+#ifndef HEAP_GUARD_H
+#define HEAP_GUARD_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// 🧱 Heap guard
+// The steady state is meant to run without touching the heap: RTOS objects
+// are static (RTOS_STATIC_ALLOCATION), display text is formatted into stack
+// buffers. The guard checks that claim. With HEAP_GUARD_WRAP the linker routes
+// malloc/calloc/realloc (and with them new and String) through counting
+// wrappers:
+//
+//   build_flags = -DHEAP_GUARD_WRAP -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc
+//
+// armHeapGuard() at the end of setup() starts the count; every allocation
+// after that is counted, split by internal RAM and PSRAM, and the last one
+// is kept with its task and caller address (for addr2line). Without the wrap
+// only the free/minimum-free internal heap is tracked.
+
+struct HeapGuardStats {
+  bool counting;             // Built with HEAP_GUARD_WRAP
+  bool armed;                // Boot complete, counting
+  uint32_t allocs;           // Allocations since arming
+  uint32_t internalAllocs;   // ... of which in internal RAM
+  uint32_t bytes;            // Bytes requested since arming
+  uint32_t lastSize;
+  uintptr_t lastCaller;      // Return address of the last malloc/calloc/realloc call
+  TaskHandle_t lastTask;     // nullptr = before the scheduler or from an ISR
+  uint32_t freeInternal;     // Internal heap now
+  uint32_t minFreeInternal;  // Internal heap low-water mark since boot
+};
+
+void armHeapGuard();                    // End of setup()
+void getHeapGuardStats(HeapGuardStats* out);
+bool checkHeapGuard();                  // TaskSystemMonitor: reports new allocations, true if any
+
+#endif // HEAP_GUARD_H
@@ -0,0 +1,47 @@
+#ifndef HISTORY_ROLLUP_H
+#define HISTORY_ROLLUP_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 📊 Sensor history rollups
+// Per-minute, per-hour and per-day buckets of temperature and humidity
+// (min, max, sum, samples) and hazard counts, fed with every history point
+// by TaskSensorPoll. Each level is a ring of ROLLUP_*_BUCKETS buckets laid
+// out as the leaves of a segment tree (memPlace MEM_BULK), so:
+//   append   O(log n): the sample is merged into its three leaves and their
+//            ancestors; a new bucket clears its slot and rebuilds the path
+//   query    O(log n): a range is split into whole days, whole hours at its
+//            edges and whole minutes at theirs, one tree range per piece
+// Minutes are the finest resolution: a range edge inside a minute counts the
+// whole minute. An edge older than the finer ring is answered by the
+// enclosing coarser bucket.
+// Times are seconds of uptime (esp_timer), which do not wrap like millis()
+// and so can span the day ring.
+
+struct RollupAgg {
+  int64_t tempSum;           // °C x samples
+  int64_t humSum;            // % x samples
+  uint32_t samples;          // Points merged (seconds at 1 Hz)
+  int16_t tempMin, tempMax;
+  int16_t humMin, humMax;
+  uint32_t motionEvents;     // Rising edges of the HIST_HAZ_* bits
+  uint32_t intrusionAlarms;
+  uint32_t fireEvents;
+  uint32_t doorOpenings;
+};
+
+bool initHistoryRollup();    // Setup; false without room (rollups stay off)
+uint32_t rollupNowSec();     // Uptime in seconds, the time base of the calls below
+void rollupAdd(uint32_t sec, int16_t tempC, int16_t humPct, uint8_t hazards);  // TaskSensorPoll only
+void rollupQuery(uint32_t fromSec, uint32_t toSec, RollupAgg* out);   // [from, to)
+void rollupLast(uint32_t seconds, RollupAgg* out);   // Ending after the newest point
+
+// Averages in tenths; 0 while the aggregate is empty
+int32_t rollupTempAvg10(const RollupAgg* agg);
+int32_t rollupHumAvg10(const RollupAgg* agg);
+
+size_t formatRollupSummary(char* out, size_t size);   // Last hour, day and week on one line
+void printRollupStats();     // One Serial line, with the task statistics report
+
+#endif // HISTORY_ROLLUP_H
@@ -0,0 +1,71 @@
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 🗄️ Sensor history store
+// Compressed time series of every sensor channel in a PSRAM ring of
+// HISTORY_BLOCK_BYTES blocks (memPlace MEM_BULK). TaskSensorPoll appends one
+// point per HISTORY_INTERVAL_MS. Each block starts from a raw point in its
+// header; every later point is bit-packed against the previous one:
+//   repeat      1 bit when the interval and all values are unchanged
+//   timestamp   delta-of-delta, 1 bit for a steady interval, 9-36 bits else
+//   numeric     zig-zag delta of temperature, humidity and distance:
+//               1 bit unchanged, 6 bits within -8..7, 11 bits within
+//               -128..127, 19 bits raw
+//   hazards     XOR with the previous bits, 1 bit unchanged
+// Distance moves below HISTORY_DISTANCE_DEADBAND_CM are not stored. A quiet
+// shop costs about 1 bit per point, so a week at 1 Hz fits in a fraction of
+// the ring. A full ring overwrites its oldest block.
+// Appends are O(1). A range scan binary-searches the block headers and
+// decodes only the blocks that overlap the range. Readers copy one block
+// at a time under a short lock, so the writer never waits for them.
+// Timestamps are millis(); scans order them by age, so a range must lie
+// within the last 49 days (the ring holds about 26 days of a quiet shop).
+
+enum HistoryChannel : uint8_t {
+  HIST_TEMPERATURE = 0,      // °C
+  HIST_HUMIDITY,             // %
+  HIST_DISTANCE,             // cm, DISTANCE_NONE with nothing in range
+  HIST_HAZARDS,              // HIST_HAZ_* bits seen during the interval
+  HIST_CHANNELS
+};
+
+#define HIST_HAZ_FIRE      0x01   // Debounced fire
+#define HIST_HAZ_MOTION    0x02   // PIR output
+#define HIST_HAZ_INTRUSION 0x04   // Fused thief alert
+#define HIST_HAZ_DOOR      0x08   // Door servo open
+#define HIST_HAZ_BITS      4
+
+struct HistoryPoint {
+  uint32_t tsMs;
+  int16_t value[HIST_CHANNELS];
+};
+
+// Called for each point of a scan, oldest first; return false to stop
+typedef bool (*HistoryVisitor)(const HistoryPoint* point, void* ctx);
+
+struct HistoryStats {
+  uint32_t points;           // Appended since boot
+  uint32_t storedPoints;     // Still in the ring
+  uint32_t blocksUsed;       // Blocks holding points (open one included)
+  uint32_t bytesUsed;
+  uint32_t oldestMs;
+  uint32_t newestMs;
+  uint16_t centiBitsPerPoint;   // Encoded size of the stored points, 1/100 bit
+};
+
+bool initHistoryStore();      // Setup; false without PSRAM (the store stays off)
+void historyAppend(const HistoryPoint* point);   // TaskSensorPoll only
+uint32_t historyScan(uint32_t fromMs, uint32_t toMs, HistoryVisitor visit, void* ctx);  // Points visited
+bool historyNewest(HistoryPoint* out);           // Last point; false while empty
+void getHistoryStats(HistoryStats* out);
+void printHistoryStats();     // One Serial line, with the task statistics report
+
+// Export: "#H:" lines of the last minutes (0 = everything) over Serial
+void historyRequestExport(uint32_t minutes);
+bool historyExportPending();
+void serviceHistoryExport();  // TaskSystemMonitor; HISTORY_EXPORT_LINES per call
+
+#endif // HISTORY_STORE_H
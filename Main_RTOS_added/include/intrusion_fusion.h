@@ -0,0 +1,38 @@
+#ifndef INTRUSION_FUSION_H
+#define INTRUSION_FUSION_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 🕵️ Intrusion fusion
+// Combines three timestamped streams into one intrusion score (0-100):
+//   PIR   debounced level, pushed on every change (postMotionChange)
+//   MOVE  echo distance changed by INTRUSION_MOVE_CM since the last sample
+//   DOOR  door servo away from SERVO_CLOSED_DEG
+// Each TaskSensorPoll sample adds one slot to a sliding window of
+// INTRUSION_WINDOW_MS and drops the oldest, keeping per-source counts, so an
+// update is O(1). A source scores its INTRUSION_W_* weight once it has
+// INTRUSION_*_SLOTS slots in the window (proportionally before). The thief
+// alert (EVENT_MOTION_DETECTED, thief mode only) is raised when the score
+// reaches INTRUSION_ALARM_ON and cleared when it falls to INTRUSION_ALARM_OFF.
+// The score is also evaluated on the PIR edge itself, so when the ultrasonic
+// already saw movement the alert goes out with the PIR event.
+
+struct IntrusionStats {
+  uint32_t alarms;           // Alerts raised (thief mode)
+  uint32_t vetoed;           // PIR episodes that ended without enough corroboration
+  uint32_t lastLatencyMs;    // PIR rise to alert, last alert raised on the crossing (not a mode switch)
+  uint32_t maxLatencyMs;
+  uint8_t score;             // Current score
+  uint8_t peakScore;         // Highest score of the current or last PIR episode
+};
+
+void updateIntrusionPir(bool motion, uint32_t tsMs);   // Debounced PIR change (any task, not ISRs)
+void updateIntrusionSample(int distanceCm, bool doorIsOpen, uint32_t tsMs);  // One sensor sample
+uint8_t getIntrusionScore();
+bool isIntrusionAlarm();
+void resetIntrusionFusion();   // Empty window, alert off (trace replay sessions)
+void getIntrusionStats(IntrusionStats* out);
+void printIntrusionStats();    // One Serial line, with the task statistics report
+
+#endif // INTRUSION_FUSION_H
@@ -0,0 +1,65 @@
+#ifndef LOG_CATALOG_H
+#define LOG_CATALOG_H
+
+#include <stdint.h>
+
+// 🪵 Deferred log message catalog
+// X(id, format). Only the id and the numeric arguments go over the wire; the
+// host decoder (tools/log_decode) is built from this same list.
+// Supported conversions: %d %i %u %x %X %c %f %g %e with flags/width/precision,
+// each taking one 32-bit argument. Append new entries at the end - ids are
+// positional, and a reorder needs a matching decoder build.
+
+#define LOG_CATALOG(X) \
+  X(LOG_BOOT,                  "🪵 Log: deferred records, catalog %08x") \
+  X(LOG_DROPPED,               "⚠️ Log: %u records dropped (ring full)") \
+  X(LOG_DISTANCE,              "📏 Distance: %d cm (%d cm/s)") \
+  X(LOG_FIRE_ALERT_ON,         "[CORE 1] FIRE ALERT ACTIVATED - Display locked, audio queued") \
+  X(LOG_FIRE_ALERT_OFF,        "[CORE 1] FIRE ALERT CLEARED - Display returned to normal") \
+  X(LOG_MOTION_ALERT_ON,       "[CORE 1] MOTION ALERT ACTIVATED - Display locked, audio queued") \
+  X(LOG_MOTION_ALERT_OFF,      "[CORE 1] MOTION ALERT CLEARED - Display returned to normal") \
+  X(LOG_PLAY_STARTUP,          "[CORE 0] Playing startup tone") \
+  X(LOG_PLAY_MODE_SWITCH,      "[CORE 0] Playing mode switch tone") \
+  X(LOG_PLAY_FIRE,             "[CORE 0] Playing fire alert tone") \
+  X(LOG_PLAY_MOTION,           "[CORE 0] Playing motion alert tone") \
+  X(LOG_HEAP,                  "[CORE 0] Free heap: %u bytes, Min free: %u bytes") \
+  X(LOG_MOTION_NIGHT,          "🚨 Motion detected at NIGHT - Thief alert triggered") \
+  X(LOG_MOTION_DAY,            "👥 Motion detected during DAY - No thief alert (normal operation)") \
+  X(LOG_MOTION_CLEARED,        "✅ Motion cleared") \
+  X(LOG_AUDIO_STARTUP_BEGIN,   "Playing startup tone...") \
+  X(LOG_AUDIO_NOTE,            "Playing note %d Hz") \
+  X(LOG_AUDIO_STARTUP_DONE,    "Startup tone complete") \
+  X(LOG_AUDIO_ALERT_BEGIN,     "Playing alert tone...") \
+  X(LOG_AUDIO_ALERT_CYCLE,     "Alert tone cycle %d: %d Hz") \
+  X(LOG_AUDIO_ALERT_DONE,      "Alert tone complete") \
+  X(LOG_LCD_FIRE,              "LCD: Fire alert displayed") \
+  X(LOG_LCD_THIEF,             "LCD: Thief alert displayed") \
+  X(LOG_OLED_FIRE,             "OLED: Fire alert displayed - page cycling paused") \
+  X(LOG_OLED_SAFE,             "OLED: Safe status - resuming normal operation and page cycling") \
+  X(LOG_OLED_THIEF,            "OLED: Thief alert displayed - page cycling paused") \
+  X(LOG_OLED_MOTION_CLEARED,   "OLED: Motion cleared - resuming normal operation and page cycling") \
+  X(LOG_WIFI_FAST_CONNECT,     "🔄 WiFi: fast connect (ch %d)") \
+  X(LOG_WIFI_SCAN_CONNECT,     "🔄 WiFi: full scan connect") \
+  X(LOG_WIFI_FAIL_TIMEOUT,     "⚠️ WiFi: attempt failed (timeout), retry in %u ms") \
+  X(LOG_WIFI_FAIL_DISCONNECT,  "⚠️ WiFi: attempt failed (disconnected), retry in %u ms") \
+  X(LOG_WIFI_CONNECTED_FAST,   "✅ WiFi connected in %u ms (fast)") \
+  X(LOG_WIFI_CONNECTED_SCAN,   "✅ WiFi connected in %u ms (scan)") \
+  X(LOG_WIFI_IP,               "🌐 IP address: %u.%u.%u.%u") \
+  X(LOG_WIFI_LOST,             "⚠️ WiFi lost (reason %d) - reconnecting") \
+  X(LOG_FIRE_FAST_TRIP,        "🔥 Fire fast path: relay on %u us after the flame edge") \
+  X(LOG_FIRE_RELAY_LATCHED,    "🔥 Fire cleared - relay latched until reset") \
+  X(LOG_FIRE_RELAY_RESET,      "🔥 Fire relay reset") \
+  X(LOG_PIR_PULSE,             "🚶 PIR pulse: %u ms high") \
+  X(LOG_FLAME_DSP_OVER_BUDGET, "⚠️ Flame flicker: window took %u us (budget %u us)") \
+  X(LOG_INTRUSION_VETOED,      "🕵️ PIR motion without corroboration - no thief alert (peak score %u)") \
+  X(LOG_WIFI_LEASE_STALE,      "⚠️ WiFi: no cloud %u ms after reusing the cached lease - dropping it, back to DHCP") \
+  X(LOG_WIFI_LEASE_DHCP,       "🔄 WiFi: cloud reached on the reused lease - back to DHCP (%u s before T1)")
+
+#define LOG_CATALOG_ENUM(id, fmt) id,
+enum LogId : uint16_t {
+  LOG_CATALOG(LOG_CATALOG_ENUM)
+  LOG_ID_COUNT
+};
+#undef LOG_CATALOG_ENUM
+
+#endif // LOG_CATALOG_H
@@ -0,0 +1,35 @@
+#ifndef MEM_PLACEMENT_H
+#define MEM_PLACEMENT_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 📐 Memory placement policy
+// Every sizeable buffer is declared against a memory class, either allocated
+// here at boot (memPlace) or, for static arrays, recorded and checked
+// (MEM_DECLARE). printMemPlacement() reports where everything went.
+//
+//   MEM_HOT   internal RAM - touched every loop, from ISRs or tick hooks, or
+//             while the flash cache is off (flash write sources, stacks)
+//   MEM_DMA   internal, DMA-capable - buffers a peripheral reads or writes
+//   MEM_BULK  PSRAM - large and cold (histories, recorders); blocks up to
+//             MEM_BULK_FALLBACK_MAX fall back to internal RAM without PSRAM
+//
+// memPlace() is for setup() only: after boot the heap guard expects no
+// allocations at all.
+
+enum MemClass : uint8_t {
+  MEM_HOT = 0,
+  MEM_DMA,
+  MEM_BULK,
+  MEM_CLASS_COUNT
+};
+
+void* memPlace(const char* name, size_t size, MemClass cls);   // nullptr if the class has no room
+void memDeclare(const char* name, const void* ptr, size_t size, MemClass cls);
+#define MEM_DECLARE(name, array, cls) memDeclare((name), (array), sizeof(array), (cls))
+
+bool memIsInternal(const void* ptr);
+void printMemPlacement();   // Boot report, one line per buffer
+
+#endif // MEM_PLACEMENT_H
@@ -0,0 +1,31 @@
+#ifndef NET_EVENTS_H
+#define NET_EVENTS_H
+
+#include "config.h"
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Wake reasons for TaskWiFiBlynk (bitmask)
+enum NetEventBits : uint32_t {
+  NET_EVT_NONE      = 0,
+  NET_EVT_SOCKET    = (1u << 0),  // Blynk socket has bytes to read
+  NET_EVT_TELEMETRY = (1u << 1),  // Sensor task has something urgent to publish
+  NET_EVT_WIFI      = (1u << 2),  // WiFi driver event (connect, disconnect, got IP)
+  NET_EVT_TIMEOUT   = (1u << 3)   // Heartbeat / reconnect / send deadline reached
+};
+
+// Setup (call once before TaskWiFiBlynk starts)
+bool initNetEvents();
+
+// Wake the network task (safe to call from any task, not from ISRs)
+void notifyNetTask(uint32_t bits);
+
+// Block until the socket is readable, someone calls notifyNetTask()
+// or timeoutMs expires. sockFd < 0 means "no socket to watch".
+uint32_t waitNetEvents(int sockFd, uint32_t timeoutMs);
+
+// Wakeup statistics for diagnostics
+uint32_t getNetWakeCount();
+
+#endif // NET_EVENTS_H
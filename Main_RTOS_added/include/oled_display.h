@@ -17,15 +17,28 @@ extern bool isDay;
 extern bool AC;
 
 // OLED Display object
-extern SH1106Wire display;
+// drawText()/drawTextf() render from a char buffer; the library's
+// drawString(String) copies every string to the heap before drawing it
+#define OLED_TEXT_MAX 48   // Longest formatted line (bytes, UTF-8)
+
+class OledCanvas : public SH1106Wire {
+public:
+  using SH1106Wire::SH1106Wire;
+  bool placeBuffers();   // Frame buffer(s) from the placement layer - call before init()
+  uint16_t drawText(int16_t x, int16_t y, const char* text);   // One line, no heap
+  uint16_t drawTextf(int16_t x, int16_t y, const char* format, ...) __attribute__((format(printf, 4, 5)));
+};
+
+extern OledCanvas display;
 
 // Page types for OLED navigation
 enum PageType {
   PAGE_STATUS = 0,
   PAGE_SENSORS = 1,
-  PAGE_SYSTEM = 2,
-  PAGE_ALERTS = 3,
-  PAGE_SETTINGS = 4
+  PAGE_TREND = 2,
+  PAGE_SYSTEM = 3,
+  PAGE_ALERTS = 4,
+  PAGE_SETTINGS = 5
 };
 
 // Menu state
@@ -75,6 +88,7 @@ void executeSetting();
 // Individual page functions
 void showStatusPage();
 void showSensorPage();
+void showTrendPage();     // oled_trend.cpp
 void showSystemPage();
 void showAlertsPage();
 void showSettingsPage();
@@ -0,0 +1,25 @@
+#ifndef OLED_TREND_H
+#define OLED_TREND_H
+
+#include "config.h"
+
+// 📈 OLED trend page
+// Temperature and humidity sparklines over the last TREND_WIDTH columns of
+// TREND_COLUMN_S seconds each, one min-max bar per column from the history
+// rollups (history_rollup.h). The plot is kept in its own canvas in frame
+// buffer layout, so a frame only copies it in:
+//   new column   the canvas shifts left by one and only that column is drawn
+//   same column  the newest column is redrawn when its bucket changed
+//   axis change  everything is redrawn (limits snap to TREND_SCALE_STEP)
+// The library's double buffer flushes one bounding box around the changed
+// bytes: a plot-sized box per column (full frame on an axis change, the
+// labels move too) and a single column in between. The t/h header is held
+// back on those passes and goes out on its own, two pages by its width.
+
+#define TREND_X 24                     // Plot left edge, axis labels to its left
+#define TREND_WIDTH (128 - TREND_X)    // Columns on screen
+
+void initOLEDTrend();        // initOLEDDisplay(); records the canvas placement
+// showTrendPage() is with the other page functions in oled_display.h
+
+#endif // OLED_TREND_H
@@ -0,0 +1,45 @@
+#ifndef PERIODIC_TASK_H
+#define PERIODIC_TASK_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// ⏱️ Periodic tasks
+// Each task in the RTOS_TASKS table (main.cpp) gets its PeriodicTask as
+// pvParameters. Releases sit on an absolute grid (vTaskDelayUntil), so the
+// work done in a loop no longer stretches the period:
+//
+//   PeriodicTask* schedule = (PeriodicTask*)pvParameters;
+//   periodicStart(schedule);
+//   for (;;) {
+//     ...required work...
+//     if (periodicOptional(schedule)) { ...logging, animations... }
+//     periodicWait(schedule);
+//   }
+//
+// A job that ends after its deadline counts as an overrun and sheds the
+// optional work of the next PERIODIC_SHED_CYCLES jobs. A job that runs past
+// whole periods skips those releases instead of bursting to catch up.
+// periodMs 0 marks an event-driven task: the entry only carries its name in
+// the statistics.
+
+struct PeriodicTask {
+  uint16_t periodMs;
+  uint16_t deadlineMs;        // After the release; <= periodMs
+  TickType_t lastWake;        // Current release
+  uint32_t releases;
+  uint32_t overruns;          // Jobs finished after their deadline
+  uint32_t skipped;           // Releases dropped after long overruns
+  uint16_t worstResponseMs;   // Release to end of job
+  uint8_t shedCycles;         // Optional work is skipped while > 0
+};
+
+#define PERIODIC_TASK(periodMs, deadlineMs) { (periodMs), (deadlineMs), 0, 0, 0, 0, 0, 0 }
+
+void periodicStart(PeriodicTask* schedule);          // First release = now
+void periodicWait(PeriodicTask* schedule);           // End of job: deadline check, sleep to next release
+bool periodicOptional(const PeriodicTask* schedule); // False while shedding after an overrun
+
+#endif // PERIODIC_TASK_H
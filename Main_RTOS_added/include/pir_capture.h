@@ -0,0 +1,37 @@
+#ifndef PIR_CAPTURE_H
+#define PIR_CAPTURE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 🚶 PIR edge capture (PIR_EDGE_CAPTURE)
+// A CHANGE interrupt on PIR_PIN pushes every edge (µs timestamp + level) into
+// a lock-free ring and restarts a one-shot esp_timer of PIR_SETTLE_MS. When
+// the pin has been quiet that long the timer callback drains the ring, and if
+// the level differs from the debounced one it posts the motion event
+// (postMotionChange) stamped with the first edge of the change, then wakes
+// TaskActuators. Excursions that return within the window are glitches.
+// Replaces the polled readMotion() in TaskSensorPoll.
+
+struct PirCaptureStats {
+  uint32_t edges;            // Edges captured by the ISR
+  uint32_t overflows;        // Edges dropped on a full ring
+  uint32_t changes;          // Debounced level changes posted
+  uint32_t glitches;         // Excursions shorter than PIR_SETTLE_MS
+  uint32_t pulses;           // Completed high pulses (any width)
+  uint32_t lastPulseMs;
+  uint32_t minPulseMs;
+  uint32_t maxPulseMs;
+  uint32_t avgPulseMs;
+  uint32_t lastLatencyUs;    // First edge of a change to the posted event
+  uint32_t maxLatencyUs;
+  uint32_t avgLatencyUs;
+};
+
+bool initPirCapture();        // After initSensors, the event queue and initActuators; false when disabled
+bool isPirCaptureActive();
+bool getPirLevel();           // Debounced PIR output
+void getPirCaptureStats(PirCaptureStats* out);
+void printPirCaptureStats();  // One Serial line, with the task statistics report
+
+#endif // PIR_CAPTURE_H
@@ -0,0 +1,55 @@
+#ifndef RTOS_TRACE_H
+#define RTOS_TRACE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "system.h"
+#include "rtos_trace_hooks.h"
+
+// 🔬 RTOS timeline trace
+// Flight recorder of 16-byte events (rtos_trace_hooks.h) in a PSRAM ring:
+// recording is one atomic increment plus a few stores, timestamps are the
+// CPU cycle counter. A dump request freezes the ring and TaskSystemMonitor
+// writes it as "#R:" text lines; tools/rtos_trace turns a capture into
+// Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Event sources:
+//   task switches   kernel hooks when FreeRTOS is built with them, else the
+//                   tick hook samples the running task of each core (1 ms)
+//   queues/mutexes  kernel hooks (and the native build's FreeRTOS shim)
+//   I2C             i2cBusTake()/i2cBusGive(), with the wait for the bus
+//   ISRs            RTOS_TRACE_ISR(gpio) at the top of the handler (flame,
+//                   PIR and echo edges), one instant on the ISR row per edge
+
+// Setup (after PSRAM is up); RTOS_TRACE_ENABLED 0 leaves the recorder off
+bool initRtosTrace();
+// Name a task/queue/mutex in the dump: rtosTraceObject(handle, RTOS_OBJ_*, "name")
+
+// Record from application code (any task or ISR)
+void rtosTraceEvent(uint8_t type, const void* obj, uint16_t aux);
+#define RTOS_TRACE_ISR(id) rtosTraceRecord(RTOS_EV_ISR, nullptr, nullptr, (uint16_t)(id))
+
+// Dump: freeze on request, then emit a few lines per call
+void rtosTraceRequestDump();
+bool rtosTraceDumpPending();
+void serviceRtosTraceDump();     // TaskSystemMonitor; resumes recording when done
+
+uint32_t getRtosTraceEventCount();   // Events recorded since boot
+
+// 🚌 I2C bus transactions: i2cMutex holds, traced with the time spent waiting
+static inline bool i2cBusTake(TickType_t ticksToWait) {
+  rtosTraceEvent(RTOS_EV_I2C_WAIT, i2cMutex, 0);
+  if (xSemaphoreTake(i2cMutex, ticksToWait) != pdTRUE) {
+    rtosTraceEvent(RTOS_EV_I2C_TIMEOUT, i2cMutex, 0);
+    return false;
+  }
+  rtosTraceEvent(RTOS_EV_I2C_BEGIN, i2cMutex, 0);
+  return true;
+}
+
+static inline void i2cBusGive() {
+  rtosTraceEvent(RTOS_EV_I2C_END, i2cMutex, 0);
+  xSemaphoreGive(i2cMutex);
+}
+
+#endif // RTOS_TRACE_H
@@ -0,0 +1,102 @@
+#ifndef RTOS_TRACE_HOOKS_H
+#define RTOS_TRACE_HOOKS_H
+
+// 🔬 RTOS trace: event format and FreeRTOS kernel hooks
+// Plain C so it can be force-included into the kernel sources. The firmware
+// side is rtos_trace.h, the host converter is tools/rtos_trace.
+
+#include <stdint.h>
+
+// Event types
+#define RTOS_EV_SYNC              0   // obj = micros() at this cycle count (timeline anchor)
+#define RTOS_EV_TASK_IN           1   // obj = task now running on this core; aux 1 = tick sample
+#define RTOS_EV_TASK_OUT          2   // obj = task that blocked (native build only)
+#define RTOS_EV_QUEUE_SEND        3   // obj = queue or semaphore (give)
+#define RTOS_EV_QUEUE_SEND_FAIL   4
+#define RTOS_EV_QUEUE_RECV        5   // obj = queue or semaphore (take)
+#define RTOS_EV_QUEUE_RECV_FAIL   6
+#define RTOS_EV_QUEUE_PEEK        7
+#define RTOS_EV_QUEUE_BLOCK_SEND  8   // Task is about to wait for space
+#define RTOS_EV_QUEUE_BLOCK_RECV  9   // Task is about to wait for an item / the mutex
+#define RTOS_EV_I2C_WAIT          10  // obj = bus mutex; task asks for the I2C bus
+#define RTOS_EV_I2C_BEGIN         11  // Bus acquired, transaction starts
+#define RTOS_EV_I2C_END           12
+#define RTOS_EV_I2C_TIMEOUT       13  // Gave up waiting for the bus
+#define RTOS_EV_ISR               14  // aux = source id (GPIO number for pin interrupts)
+
+// Object kinds in the name table
+#define RTOS_OBJ_TASK             0
+#define RTOS_OBJ_QUEUE            1
+#define RTOS_OBJ_MUTEX            2
+#define RTOS_OBJ_SEMAPHORE        3
+
+// Sources of RTOS_EV_TASK_IN (dump header)
+#define RTOS_SRC_TICK             0   // Running task sampled by the tick hook
+#define RTOS_SRC_KERNEL           1   // Kernel compiled with the hooks below
+#define RTOS_SRC_SIM              2   // Native build: threads, switch in/out around waits
+
+#define RTOS_TRACE_VERSION        1
+#define RTOS_TRACE_DUMP_PREFIX    "#R:"
+
+// One event, 16 bytes. Handles are stored as their low 32 bits.
+typedef struct {
+  uint32_t cycles;   // CPU cycle counter of the recording core
+  uint8_t type;      // RTOS_EV_*
+  uint8_t core;
+  uint16_t aux;
+  uint32_t obj;
+  uint32_t task;     // Task running when the event was recorded, 0 in ISRs
+} RtosTraceEvent;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void rtosTraceRecord(uint8_t type, const void* obj, const void* task, uint16_t aux);
+void rtosTraceObject(const void* obj, uint8_t kind, const char* name);
+
+#ifdef __cplusplus
+}
+#endif
+
+// 🪝 Kernel trace macros
+// Only take effect when FreeRTOS itself is compiled with this header, which
+// the stock Arduino core (prebuilt kernel) is not. In an ESP-IDF 4.4 component
+// build, add to the project CMakeLists.txt before project():
+//   idf_build_set_property(COMPILE_OPTIONS "-DRTOS_TRACE_KERNEL_HOOKS;-include;${CMAKE_SOURCE_DIR}/include/rtos_trace_hooks.h" APPEND)
+// Without it, rtos_trace.cpp samples the running task from the tick hook.
+#ifdef RTOS_TRACE_KERNEL_HOOKS
+
+// tasks.c: pxCurrentTCB is the per-core array of IDF 4.4's SMP kernel
+#define traceTASK_CREATE(pxNewTCB) \
+  rtosTraceObject((pxNewTCB), RTOS_OBJ_TASK, (pxNewTCB)->pcTaskName)
+#define traceTASK_SWITCHED_IN() \
+  rtosTraceRecord(RTOS_EV_TASK_IN, pxCurrentTCB[xPortGetCoreID()], pxCurrentTCB[xPortGetCoreID()], 0)
+
+// queue.c (semaphores and mutexes are queues)
+#define traceQUEUE_CREATE(pxNewQueue) \
+  rtosTraceObject((pxNewQueue), (pxNewQueue)->ucQueueType == queueQUEUE_TYPE_BASE ? RTOS_OBJ_QUEUE : RTOS_OBJ_SEMAPHORE, 0)
+#define traceCREATE_MUTEX(pxNewQueue) \
+  rtosTraceObject((pxNewQueue), RTOS_OBJ_MUTEX, 0)
+#define traceQUEUE_SEND(pxQueue) \
+  rtosTraceRecord(RTOS_EV_QUEUE_SEND, (pxQueue), xTaskGetCurrentTaskHandle(), 0)
+#define traceQUEUE_SEND_FAILED(pxQueue) \
+  rtosTraceRecord(RTOS_EV_QUEUE_SEND_FAIL, (pxQueue), xTaskGetCurrentTaskHandle(), 0)
+#define traceQUEUE_RECEIVE(pxQueue) \
+  rtosTraceRecord(RTOS_EV_QUEUE_RECV, (pxQueue), xTaskGetCurrentTaskHandle(), 0)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue) \
+  rtosTraceRecord(RTOS_EV_QUEUE_RECV_FAIL, (pxQueue), xTaskGetCurrentTaskHandle(), 0)
+#define traceQUEUE_PEEK(pxQueue) \
+  rtosTraceRecord(RTOS_EV_QUEUE_PEEK, (pxQueue), xTaskGetCurrentTaskHandle(), 0)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue) \
+  rtosTraceRecord(RTOS_EV_QUEUE_BLOCK_SEND, (pxQueue), xTaskGetCurrentTaskHandle(), 0)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) \
+  rtosTraceRecord(RTOS_EV_QUEUE_BLOCK_RECV, (pxQueue), xTaskGetCurrentTaskHandle(), 0)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue) \
+  rtosTraceRecord(RTOS_EV_QUEUE_SEND, (pxQueue), 0, 0)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue) \
+  rtosTraceRecord(RTOS_EV_QUEUE_RECV, (pxQueue), 0, 0)
+
+#endif // RTOS_TRACE_KERNEL_HOOKS
+
+#endif // RTOS_TRACE_HOOKS_H
@@ -0,0 +1,78 @@
+#ifndef SENSOR_TRACE_H
+#define SENSOR_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "sensors.h"
+
+// 📼 Sensor trace format (little endian)
+//
+// A trace is a byte stream of records. Records never straddle a
+// TRACE_PAGE_SIZE page, so every page starts on a record boundary.
+//
+//   0xxxxxxx  sample   flags, dt (i8 offset from the sample period, or
+//                      u16 ms with TRACE_F_WIDE_DT),
+//                      [i8 temperature, u8 humidity], [u16 echo us]
+//   0x80      session  'S' 'G' 'T' u8 version, u16 sample period ms, u32 start ms
+//   0x81      time     u32 absolute ms; the next sample's dt counts from it
+//   0xFE      pad      fills the rest of a page
+//   0xFF      end      erased flash
+//
+// Samples only carry climate and echo fields when they changed, so a steady
+// 250 ms stream costs 2 bytes per sample.
+
+#define TRACE_VERSION        1
+#define TRACE_PAGE_SIZE      256   // Flash program page; flush unit of both sinks
+#define TRACE_MAX_RECORD     12    // Time record + widest sample
+
+#define TRACE_F_FLAME        0x01
+#define TRACE_F_PIR          0x02
+#define TRACE_F_CLIMATE      0x04
+#define TRACE_F_ECHO         0x08
+#define TRACE_F_WIDE_DT      0x10
+
+#define TRACE_REC_SESSION    0x80
+#define TRACE_REC_TIME       0x81
+#define TRACE_REC_PAD        0xFE
+#define TRACE_REC_END        0xFF
+
+#define TRACE_SERIAL_PREFIX  "#T:"
+#define TRACE_SERIAL_LINE_BYTES 48   // Record bytes per "#T:" line (~6 s of samples)
+
+// Recorder (TaskSensorPoll only)
+bool initSensorTrace();                         // Opens SENSOR_TRACE_SINK, starts a session
+void recordSensorSample(const SensorSample* s); // No-op unless a sink is open
+
+// Encoder state, shared by the recorder and host tools that write traces
+typedef struct {
+  uint32_t lastTsMs;
+  int lastTemperatureC;
+  int lastHumidityPct;
+  uint16_t lastEchoUs;
+} TraceEncoder;
+
+size_t traceEncodeSession(TraceEncoder* enc, uint32_t startMs, uint8_t* out);
+size_t traceEncodeSample(TraceEncoder* enc, const SensorSample* s, uint8_t* out);
+
+// Decoder for flash dumps and decoded serial lines
+enum TraceRecordKind {
+  TRACE_KIND_SAMPLE = 0,
+  TRACE_KIND_SESSION,
+  TRACE_KIND_END,
+  TRACE_KIND_ERROR
+};
+
+typedef struct {
+  const uint8_t* data;
+  size_t len;
+  size_t pos;
+  uint32_t tsMs;
+  SensorSample last;
+  uint16_t samplePeriodMs;   // From the latest session header
+} TraceReader;
+
+void traceReaderInit(TraceReader* r, const uint8_t* data, size_t len);
+TraceRecordKind traceReaderNext(TraceReader* r, SensorSample* out);
+
+#endif // SENSOR_TRACE_H
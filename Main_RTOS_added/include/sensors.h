@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <DHT.h>
 #include "config.h"
+#include "distance_filter.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
@@ -13,32 +14,51 @@ typedef struct {
   int temperatureC;
   int humidityPct;
   bool flame;
-  int distanceCm;
+  int distanceCm;         // Filtered, DISTANCE_NONE with nothing in range
+  int velocityCmS;        // Filtered, negative = approaching
   bool pirMotion;
   uint32_t tsMs;
 } SensorData;
 
+// Raw readings of one TaskSensorPoll cycle, before any debouncing
+typedef struct {
+  uint32_t tsMs;
+  bool flame;            // Flame sensor output active (pin low)
+  bool pirMotion;        // PIR output high
+  uint16_t echoUs;       // Ultrasonic echo width, 0 = no echo
+  int temperatureC;
+  int humidityPct;
+} SensorSample;
+
+// Fills one raw sample: live pins by default, a recorded trace on replay
+typedef void (*SensorSource)(SensorSample* out);
+
 // Externs from main.cpp
 extern DHT dht;
 extern int t;
 extern int h;
 extern long duration;
 
-extern volatile bool pirFlag; // set from ISR
-
 void initSensors();
+void setSensorSource(SensorSource source);   // nullptr restores the live pins
+void setDebounceSamples(int fireSamples, int pirSamples);
+void sampleSensors();                        // Takes the raw sample the calls below work on
+const SensorSample* getLastSample();
 void readTemperatureHumidity();
 int getTemperature();
 int getHumidity();
-void readFlameSensor();
+bool readFlameSensor();      // Debounced fire state, posts fire events
+bool raiseFireAlert(uint32_t tsMs);   // Posts EVENT_FIRE_DETECTED unless already raised; true if posted
+bool isFireAlertRaised();             // Raised and not yet cleared by the debouncer
 bool isFlameDetected();
-void readMotion();
+void readMotion();           // Polled PIR debounce (pir_capture replaces it on the target)
+void postMotionChange(bool motion, uint32_t tsMs);   // Debounced PIR change -> intrusion fusion
 bool isMotionDetected();
 void triggerUltrasonicSensor();
-int getDistance();
+int getDistance();           // Filtered estimate (cm), DISTANCE_NONE with nothing in range
+const DistanceEstimate* getDistanceEstimate();   // Distance, velocity and validity of the last sample
 
 // RTOS tasks
 void TaskSensorPoll(void* pvParameters);
-void IRAM_ATTR PIR_ISR();
 
 #endif // SENSORS_H
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef SERVO_MOTION_H
+#define SERVO_MOTION_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 🚪 Door servo motion controller
+// Callers only set a goal; an esp_timer callback steps a trapezoidal profile
+// (SERVO_ACCEL_DPS2 up to SERVO_MAX_SPEED_DPS, braking into the goal) every
+// SERVO_STEP_MS and writes the LEDC duty through ESP32PWM. A new goal takes
+// over mid-motion: a closing door that has to reopen brakes and reverses
+// without a jump. The timer only runs while the servo is moving.
+
+enum ServoGoal : uint8_t {
+  SERVO_GOAL_CLOSE = 0,   // Move to SERVO_CLOSED_DEG
+  SERVO_GOAL_OPEN,        // Move to SERVO_OPEN_DEG
+  SERVO_GOAL_HOLD         // Brake and stay wherever the door stops
+};
+
+bool initServoMotion();              // Attaches SERVO_PIN and parks the door closed
+void setServoGoal(ServoGoal goal);   // Any task; cheap when the goal is unchanged
+ServoGoal getServoGoal();
+bool isServoMoving();
+int getServoAngle();                 // Current profile position (degrees)
+
+#endif // SERVO_MOTION_H
@@ -22,6 +22,7 @@ extern QueueHandle_t eventQueue;        // queue of Event
 extern QueueHandle_t audioQueue;        // queue of AudioEvent (Core 1 -> Core 0)
 extern SemaphoreHandle_t i2cMutex;      // shared I2C bus protection
 extern SemaphoreHandle_t dataMutex;     // protects shared sensor state
+extern SemaphoreHandle_t historyMutex;  // one history scan at a time (history_store)
 
 // Event types for inter-task notifications
 enum EventType {
@@ -50,17 +51,43 @@ struct AudioEvent {
   uint32_t timestamp;
 };
 
+// WiFi connection manager states
+enum WiFiConnState {
+  WIFI_STATE_IDLE = 0,     // initWiFi() not called yet
+  WIFI_STATE_CONNECTING,   // Attempt in flight, waiting for GOT_IP or timeout
+  WIFI_STATE_CONNECTED,
+  WIFI_STATE_BACKOFF,      // Waiting for the next attempt
+  WIFI_STATE_DISABLED      // No credentials configured
+};
+
+// Time-to-connect statistics
+struct WiFiStats {
+  uint32_t attempts;
+  uint32_t connects;
+  uint32_t failures;
+  uint32_t disconnects;
+  uint32_t lastConnectMs;
+  uint32_t minConnectMs;
+  uint32_t maxConnectMs;
+  uint32_t totalConnectMs;
+  bool lastWasFast;        // Last connect used cached BSSID/channel
+};
+
 // System initialization
 void initSystem();
 
 // WiFi functions
-bool initWiFi();
+bool initWiFi();                // Non-blocking: starts the connection state machine
 bool isWiFiConnected();
 void printWiFiStatus();
-void handleWiFiReconnection();  // Background WiFi reconnection
+void handleWiFiReconnection();  // Connection state machine tick (never blocks)
+void checkWiFiLease(bool cloudConnected, bool idle);  // While connected: moves a reused lease back to DHCP (drops it if the cloud is unreachable)
 void setWiFiReconnectionEnabled(bool enabled);  // Enable/disable background reconnection
 void triggerWiFiReconnection();  // Manually trigger WiFi reconnection
-String getWiFiStatus();         // Get WiFi status for OLED display
+unsigned long getWiFiReconnectDelay();  // ms until the state machine needs a tick
+WiFiConnState getWiFiState();
+const WiFiStats& getWiFiStats();
+void getWiFiStatus(char* out, size_t size);   // WiFi status line for the OLED display
 
 // Serial communication
 void initSerial();
@@ -74,7 +101,6 @@ void TaskWiFiBlynk(void* pvParameters);
 
 // WiFi reconnection variables
 extern unsigned long lastWiFiReconnectAttempt;
-extern const unsigned long wifiReconnectInterval;
 extern bool wifiReconnecting;
 extern bool wifiReconnectionEnabled;
 
@@ -0,0 +1,56 @@
+#ifndef TASK_STATS_H
+#define TASK_STATS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "periodic_task.h"
+
+// 📊 Runtime task statistics
+// Fixed table of up to TASK_STATS_MAX_TASKS tasks, no heap. CPU share and
+// per-core idle time come from the FreeRTOS tick hook, which counts the
+// running task of each core every tick. Loop periods come from
+// taskStatsLoop() at the top of each task's loop, deadline overruns from the
+// task's PeriodicTask, stack headroom from the high-water mark.
+// updateTaskStats() closes a window every TASK_STATS_WINDOW_MS; readers always
+// get the last closed window.
+
+#define TASK_STATS_NAME_LEN 12
+
+struct TaskStatsEntry {
+  char name[TASK_STATS_NAME_LEN];
+  int8_t core;             // Pinned core, -1 = either
+  uint16_t periodMs;       // Intended loop period, 0 = event driven
+  uint16_t cpuPermille;    // Share of one core over the last window
+  uint16_t loops;          // Loop iterations in the last window
+  uint16_t avgPeriodMs;    // Actual loop period over the last window
+  uint16_t maxPeriodMs;
+  uint16_t worstLateMs;    // Largest overrun of periodMs since boot
+  uint16_t deadlineMs;
+  uint32_t overruns;       // Jobs past their deadline since boot
+  uint32_t skipped;        // Releases dropped since boot
+  uint32_t stackFreeMin;   // Least free stack since boot (bytes)
+};
+
+struct TaskStatsSnapshot {
+  uint8_t count;
+  uint16_t idlePermille[2];   // Per core
+  uint32_t windowMs;
+  TaskStatsEntry tasks[TASK_STATS_MAX_TASKS];
+};
+
+// Setup and registration (after the tasks are created)
+bool initTaskStats();
+bool registerTaskStats(TaskHandle_t task, const PeriodicTask* schedule);
+
+// Called by the measured tasks / TaskSystemMonitor
+void taskStatsLoop();       // Top of every loop iteration of a registered task
+void updateTaskStats();     // Closes the window when TASK_STATS_WINDOW_MS has passed
+
+// Readers
+void getTaskStats(TaskStatsSnapshot* out);
+size_t formatTaskStatsSummary(char* out, size_t size);   // One line, for Blynk
+void printTaskStats();      // Table on Serial
+
+#endif // TASK_STATS_H
@@ -0,0 +1,47 @@
+#ifndef ULTRASONIC_ARRAY_H
+#define ULTRASONIC_ARRAY_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "distance_filter.h"
+
+// 📡 Ultrasonic array (ULTRASONIC_ARRAY)
+// Drives the HC-SR04s of the ULTRASONIC_SENSORS table without blocking. A
+// one-shot esp_timer runs the schedule in slots: each slot triggers at most
+// one sensor per cross-talk group (round robin inside a group, all groups
+// together) and a CHANGE interrupt on every echo pin timestamps the pulse.
+// The slot ends ULTRA_GUARD_US after the last echo of the slot falls, or
+// after the ULTRA_MAX_RANGE_CM listen window when one never comes, so a near
+// target costs a few ms instead of the 30 ms pulseIn timeout. A sensor rests
+// ULTRA_CYCLE_MS between its own triggers and is skipped while its module
+// still holds the echo line high after a lost echo. Echo edges on a sensor
+// that was not triggered are counted as cross-talk and ignored.
+// Every ping goes through the sensor's own DistanceFilter; the estimates and
+// the last raw echo widths are published per sensor.
+
+#define ULTRA_ENUM_ROW(id, name, trig, echo, group) id,
+enum UltrasonicId : uint8_t {
+  ULTRASONIC_SENSORS(ULTRA_ENUM_ROW)
+  ULTRA_SENSOR_COUNT
+};
+
+struct UltrasonicStats {
+  uint32_t pings;            // Triggers fired
+  uint32_t echoes;           // Echo pulses measured inside the listen window
+  uint32_t timeouts;         // Pings without an echo in the window
+  uint32_t crossTalk;        // Echo edges while the sensor was not listening
+  uint32_t busySkips;        // Turns skipped because the echo line was still high
+  uint16_t lastEchoUs;       // 0 = no echo
+  uint16_t pingHz;           // Average trigger rate since init
+  DistanceEstimate estimate;
+};
+
+bool initUltrasonicArray();   // After initSensors; false when disabled
+bool isUltrasonicArrayActive();
+uint16_t getUltrasonicEcho(uint8_t id);                  // Last raw echo width (µs), 0 = none
+DistanceEstimate getUltrasonicEstimate(uint8_t id);      // Filtered stream of one sensor
+const char* getUltrasonicName(uint8_t id);
+void getUltrasonicStats(uint8_t id, UltrasonicStats* out);
+void printUltrasonicStats();  // One Serial line per sensor, with the task statistics report
+
+#endif // ULTRASONIC_ARRAY_H
@@ -512,4 +512,52 @@ BLYNK_WRITE(31);
 }
 #endif
 
+#ifdef BLYNK_USE_DENSE_HANDLERS
+
+/*
+ * Dense handler table (opt-in)
+ *
+ * Instead of the 128-entry read/write vectors in BlynkHandlers.cpp,
+ * the application lists only the virtual pins it actually uses:
+ *
+ *   BLYNK_DENSE_HANDLERS(
+ *       BLYNK_DENSE_PIN(V0),
+ *       BLYNK_DENSE_PIN(V3)
+ *   );
+ *
+ * Entries must be sorted by pin, this is checked at compile time.
+ * Pins that are not listed fall through to the Default handlers.
+ * The library has to be built with BLYNK_USE_DENSE_HANDLERS too,
+ * so define it in the build flags rather than in a sketch.
+ */
+
+struct BlynkDenseHandler
+{
+    uint8_t            pin;
+    WidgetReadHandler  read;
+    WidgetWriteHandler write;
+};
+
+extern const BlynkDenseHandler BlynkDenseHandlers[];
+extern const uint8_t           BlynkDenseHandlersCount;
+
+constexpr bool BlynkDenseIsSorted(const BlynkDenseHandler* table, size_t count)
+{
+    return (count < 2) ? true :
+           (table[0].pin < table[1].pin) && BlynkDenseIsSorted(table + 1, count - 1);
+}
+
+#define BLYNK_DENSE_PIN_2(pin) \
+    { pin, BlynkWidgetRead ## pin, BlynkWidgetWrite ## pin }
+
+#define BLYNK_DENSE_PIN(pin)   BLYNK_DENSE_PIN_2(pin)
+
+#define BLYNK_DENSE_HANDLERS(...) \
+    constexpr BlynkDenseHandler BlynkDenseHandlers[] = { __VA_ARGS__ }; \
+    const uint8_t BlynkDenseHandlersCount = BLYNK_COUNT_OF(BlynkDenseHandlers); \
+    static_assert(BlynkDenseIsSorted(BlynkDenseHandlers, BLYNK_COUNT_OF(BlynkDenseHandlers)), \
+                  "BLYNK_DENSE_HANDLERS: pins must be unique and sorted")
+
+#endif
+
 #endif
@@ -67,6 +67,13 @@ public:
 
     bool run(bool avail = false);
 
+    /**
+     * Milliseconds until run() has time-based work to do
+     * (ping, heartbeat/login timeout or a reconnect attempt).
+     * Lets an event-driven caller sleep instead of polling run().
+     */
+    millis_time_t timeToNextEvent();
+
     // TODO: Fixme
     void startSession() {
         conn.connect();
@@ -234,6 +241,34 @@ bool BlynkProtocol<Transp>::run(bool avail)
     return true;
 }
 
+template <class Transp>
+millis_time_t BlynkProtocol<Transp>::timeToNextEvent()
+{
+    const millis_time_t t = BlynkMillis();
+
+    struct Left {
+        static millis_time_t of(millis_time_t elapsed, millis_time_t period) {
+            return (elapsed >= period) ? 0 : (period - elapsed);
+        }
+    };
+
+    if (state == CONNECTED) {
+        const millis_time_t idle = BlynkMax(t - lastActivityIn, t - lastActivityOut);
+        const millis_time_t ping = BlynkMax(Left::of(idle, 1000UL * BLYNK_HEARTBEAT + 1),
+                                            Left::of(t - lastHeartbeat, BLYNK_TIMEOUT_MS + 1));
+        const millis_time_t dead = Left::of(t - lastActivityIn,
+                                            1000UL * BLYNK_HEARTBEAT + BLYNK_TIMEOUT_MS*3 + 1);
+        return BlynkMin(ping, dead);
+    } else if (state == CONNECTING) {
+#ifdef BLYNK_USE_DIRECT_CONNECT
+        return 0;
+#else
+        return Left::of(t - lastLogin, conn.connected() ? (BLYNK_TIMEOUT_MS + 1) : 5001UL);
+#endif
+    }
+    return 1000UL * BLYNK_HEARTBEAT;
+}
+
 template <class Transp>
 BLYNK_FORCE_INLINE
 bool BlynkProtocol<Transp>::processInput(void)
@@ -309,6 +309,8 @@ BLYNK_ON_WRITE_IMPL(31);
   BLYNK_ON_WRITE_IMPL(127);
 #endif
 
+#ifndef BLYNK_USE_DENSE_HANDLERS
+
 static const WidgetReadHandler BlynkReadHandlerVector[] BLYNK_PROGMEM = {
     BlynkWidgetRead0,   BlynkWidgetRead1,   BlynkWidgetRead2,   BlynkWidgetRead3,
     BlynkWidgetRead4,   BlynkWidgetRead5,   BlynkWidgetRead6,   BlynkWidgetRead7,
@@ -404,3 +406,41 @@ WidgetWriteHandler GetWriteHandler(uint8_t pin)
     return BlynkWriteHandlerVector[pin];
 #endif
 }
+
+#else /* BLYNK_USE_DENSE_HANDLERS */
+
+// Tables are provided by the application via BLYNK_DENSE_HANDLERS()
+// and hold only the pins it uses, sorted by pin number,
+// so a lookup is a binary search.
+
+static const BlynkDenseHandler* BlynkFindDenseHandler(uint8_t pin)
+{
+    uint8_t lo = 0;
+    uint8_t hi = BlynkDenseHandlersCount;
+    while (lo < hi) {
+        const uint8_t mid = (lo + hi) / 2;
+        const uint8_t p = BlynkDenseHandlers[mid].pin;
+        if (p == pin) {
+            return &BlynkDenseHandlers[mid];
+        } else if (p < pin) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+WidgetReadHandler GetReadHandler(uint8_t pin)
+{
+    const BlynkDenseHandler* h = BlynkFindDenseHandler(pin);
+    return h ? h->read : NULL;
+}
+
+WidgetWriteHandler GetWriteHandler(uint8_t pin)
+{
+    const BlynkDenseHandler* h = BlynkFindDenseHandler(pin);
+    return h ? h->write : NULL;
+}
+
+#endif /* BLYNK_USE_DENSE_HANDLERS */
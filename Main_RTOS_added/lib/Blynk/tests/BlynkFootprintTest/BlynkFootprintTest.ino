@@ -75,6 +75,15 @@ BLYNK_READ(V4)
 
 #endif /* ENABLE_HANDLERS */
 
+// Build with -DBLYNK_USE_DENSE_HANDLERS (the library needs it too)
+// to compare against the 128-entry handler vectors
+#ifdef BLYNK_USE_DENSE_HANDLERS
+BLYNK_DENSE_HANDLERS(
+  BLYNK_DENSE_PIN(V3),
+  BLYNK_DENSE_PIN(V4)
+);
+#endif
+
 void loop()
 {
   bool hasIncomingData = (test > 0);
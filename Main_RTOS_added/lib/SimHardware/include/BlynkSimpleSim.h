@@ -0,0 +1,54 @@
+#ifndef BlynkSimpleSim_h
+#define BlynkSimpleSim_h
+
+// 🧪 Host build counterpart of BlynkSimpleEsp32.h: same class names, the
+// transport is a WiFiClient whose socket goes to the loopback Blynk server.
+
+#define BLYNK_SEND_ATOMIC
+
+#include <arpa/inet.h>
+
+#include <BlynkApiArduino.h>
+#include <Blynk/BlynkProtocol.h>
+#include <Adapters/BlynkArduinoClient.h>
+#include <WiFi.h>
+
+typedef BlynkArduinoClientGen<WiFiClient> BlynkEsp32Client;
+
+class BlynkWifi
+    : public BlynkProtocol<BlynkEsp32Client>
+{
+    typedef BlynkProtocol<BlynkEsp32Client> Base;
+public:
+    BlynkWifi(BlynkEsp32Client& transp)
+        : Base(transp)
+    {}
+
+    void config(const char* auth,
+                const char* domain = BLYNK_DEFAULT_DOMAIN,
+                uint16_t    port   = BLYNK_DEFAULT_PORT)
+    {
+        Base::begin(auth);
+        this->conn.begin(domain, port);
+    }
+
+    void config(const char* auth,
+                IPAddress   ip,
+                uint16_t    port = BLYNK_DEFAULT_PORT)
+    {
+        Base::begin(auth);
+        this->conn.begin(ip, port);
+    }
+};
+
+#if !defined(NO_GLOBAL_INSTANCES) && !defined(NO_GLOBAL_BLYNK)
+  static WiFiClient _blynkWifiClient;
+  static BlynkEsp32Client _blynkTransport(_blynkWifiClient);
+  BlynkWifi Blynk(_blynkTransport);
+#else
+  extern BlynkWifi Blynk;
+#endif
+
+#include <BlynkWidgets.h>
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef SIM_CLIENT_H
+#define SIM_CLIENT_H
+
+// 🧪 Host build: Arduino Client interface
+
+#include "Print.h"
+#include "IPAddress.h"
+
+class Client : public Print {
+public:
+    virtual int connect(IPAddress ip, uint16_t port) = 0;
+    virtual int connect(const char* host, uint16_t port) = 0;
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int read(uint8_t* buf, size_t size) = 0;
+    virtual void flush() {}
+    virtual void stop() = 0;
+    virtual uint8_t connected() = 0;
+    virtual operator bool() { return connected(); }
+    using Print::write;
+};
+
+#endif // SIM_CLIENT_H
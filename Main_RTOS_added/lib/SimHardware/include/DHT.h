@@ -0,0 +1,23 @@
+#ifndef SIM_DHT_H
+#define SIM_DHT_H
+
+// 🧪 Host build: DHT11/DHT22 driven by the simulated climate (simSetClimate)
+
+#include <stdint.h>
+
+#define DHT11 11
+#define DHT22 22
+
+class DHT {
+public:
+    DHT(uint8_t pin, uint8_t type, uint8_t count = 6) : pin(pin), type(type) { (void)count; }
+    void begin(uint8_t usec = 55) { (void)usec; }
+    float readTemperature(bool fahrenheit = false, bool force = false);
+    float readHumidity(bool force = false);
+
+private:
+    uint8_t pin;
+    uint8_t type;
+};
+
+#endif // SIM_DHT_H
@@ -0,0 +1,42 @@
+#ifndef SIM_ESP32SERVO_H
+#define SIM_ESP32SERVO_H
+
+// 🧪 Host build: hobby servo; commanded angle is reported as SIM_OUT_SERVO.
+// ESP32PWM on SERVO_PIN is reported the same way, from its pulse width.
+
+#include <stdint.h>
+
+class ESP32PWM {
+public:
+    ESP32PWM() : pin(-1), freq(0), resolutionBits(10), duty(0) {}
+    void attachPin(uint8_t pin, double freq, uint8_t resolutionBits = 10);
+    void detachPin(int pin) { (void)pin; this->pin = -1; }
+    bool attached() const { return pin >= 0; }
+    void write(uint32_t duty);
+    uint32_t read() const { return duty; }
+    int getPin() const { return pin; }
+    static void allocateTimer(int timerNumber);    // Timer attachPin() sets up (default 0)
+
+private:
+    int pin;
+    double freq;
+    uint8_t resolutionBits;
+    uint32_t duty;
+};
+
+class Servo {
+public:
+    Servo() : pin(-1), angle(0) {}
+    int attach(int pin, int minUs = 500, int maxUs = 2500);
+    void detach() { pin = -1; }
+    bool attached() const { return pin >= 0; }
+    void write(int value);
+    void writeMicroseconds(int us);
+    int read() const { return angle; }
+
+private:
+    int pin;
+    int angle;
+};
+
+#endif // SIM_ESP32SERVO_H
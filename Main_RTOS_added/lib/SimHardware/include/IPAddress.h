@@ -0,0 +1,35 @@
+#ifndef SIM_IPADDRESS_H
+#define SIM_IPADDRESS_H
+
+// 🧪 Host build: Arduino IPAddress (IPv4, network byte order like the ESP32 core)
+
+#include <stdint.h>
+#include <netinet/in.h>
+#include "Print.h"
+
+class IPAddress : public Printable {
+public:
+    IPAddress() : addr(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : addr((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    IPAddress(uint32_t raw) : addr(raw) {}
+
+    operator uint32_t() const { return addr; }
+    uint8_t operator[](int i) const { return (uint8_t)(addr >> (8 * i)); }
+    bool operator==(const IPAddress& rhs) const { return addr == rhs.addr; }
+
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+        return String(buf);
+    }
+    size_t printTo(Print& p) const override { return p.print(toString()); }
+
+private:
+    uint32_t addr;
+};
+
+#undef INADDR_NONE
+#define INADDR_NONE IPAddress(0u)
+
+#endif // SIM_IPADDRESS_H
@@ -0,0 +1,35 @@
+#ifndef SIM_LIQUIDCRYSTAL_I2C_H
+#define SIM_LIQUIDCRYSTAL_I2C_H
+
+// 🧪 Host build: HD44780 behind a PCF8574 expander. Keeps the character
+// buffer and charges the I2C time every write costs on the real bus.
+
+#include <stdint.h>
+#include "Print.h"
+
+class LiquidCrystal_I2C : public Print {
+public:
+    LiquidCrystal_I2C(uint8_t addr, uint8_t cols, uint8_t rows);
+    void init();
+    void begin() { init(); }
+    void clear();
+    void home() { setCursor(0, 0); }
+    void setCursor(uint8_t col, uint8_t row);
+    void backlight() {}
+    void noBacklight() {}
+    void createChar(uint8_t location, uint8_t charmap[]);
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    // Simulation access: current text of one row (NUL terminated)
+    const char* rowText(uint8_t row) const;
+
+private:
+    uint8_t cols;
+    uint8_t rows;
+    uint8_t col;
+    uint8_t row;
+    char text[4][41];
+};
+
+#endif // SIM_LIQUIDCRYSTAL_I2C_H
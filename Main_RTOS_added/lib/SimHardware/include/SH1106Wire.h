@@ -0,0 +1,119 @@
+#ifndef SIM_SH1106WIRE_H
+#define SIM_SH1106WIRE_H
+
+// 🧪 Host build: 128x64 SH1106 over I2C. Pixels go to a real 1 bpp page
+// buffer; text is kept as a list of strings (no glyph rendering) so a frame
+// can be dumped as readable lines. display() charges the I2C transfer time
+// of what the library would send: with its default double buffer, only the
+// bounding box of the pixels and text items that changed since last frame.
+
+#include <stdint.h>
+#include "WString.h"
+
+enum OLEDDISPLAY_COLOR {
+    BLACK = 0,
+    WHITE = 1,
+    INVERSE = 2
+};
+
+enum OLEDDISPLAY_TEXT_ALIGNMENT {
+    TEXT_ALIGN_LEFT = 0,
+    TEXT_ALIGN_RIGHT = 1,
+    TEXT_ALIGN_CENTER = 2,
+    TEXT_ALIGN_CENTER_BOTH = 3
+};
+
+enum OLEDDISPLAY_GEOMETRY {
+    GEOMETRY_128_64 = 0
+};
+
+// Font headers only: {width, height, first char, char count}
+extern const uint8_t ArialMT_Plain_10[];
+extern const uint8_t ArialMT_Plain_16[];
+extern const uint8_t ArialMT_Plain_24[];
+
+#define SIM_OLED_WIDTH      128
+#define SIM_OLED_HEIGHT     64
+#define SIM_OLED_MAX_TEXT   16
+
+// As in the library: double buffering unless built to save memory
+#ifndef OLEDDISPLAY_REDUCE_MEMORY
+#define OLEDDISPLAY_DOUBLE_BUFFER
+#endif
+
+class SH1106Wire {
+public:
+    SH1106Wire(uint8_t address, int sda = -1, int scl = -1,
+               OLEDDISPLAY_GEOMETRY geometry = GEOMETRY_128_64, int bus = 0, uint32_t frequency = 700000);
+
+    bool init();
+    void display();
+    void clear();
+    void flipScreenVertically() {}
+    void mirrorScreen() {}
+    void invertDisplay();
+    void normalDisplay();
+    void displayOn() {}
+    void displayOff() {}
+    void setContrast(uint8_t contrast) { (void)contrast; }
+
+    void setColor(OLEDDISPLAY_COLOR color) { this->color = color; }
+    OLEDDISPLAY_COLOR getColor() const { return color; }
+    void setPixel(int16_t x, int16_t y);
+    void clearPixel(int16_t x, int16_t y);
+    bool getPixel(int16_t x, int16_t y) const;
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+    void drawHorizontalLine(int16_t x, int16_t y, int16_t length);
+    void drawVerticalLine(int16_t x, int16_t y, int16_t length);
+    void drawRect(int16_t x, int16_t y, int16_t width, int16_t height);
+    void fillRect(int16_t x, int16_t y, int16_t width, int16_t height);
+    void drawCircle(int16_t x, int16_t y, int16_t radius);
+    void fillCircle(int16_t x, int16_t y, int16_t radius);
+    void drawXbm(int16_t x, int16_t y, int16_t width, int16_t height, const uint8_t* xbm);
+
+    void setFont(const uint8_t* font) { this->font = font; }
+    void setTextAlignment(OLEDDISPLAY_TEXT_ALIGNMENT align) { this->align = align; }
+    void drawString(int16_t x, int16_t y, const String& text);
+    uint16_t getStringWidth(const String& text) const;
+    uint16_t getStringWidth(const char* text, uint16_t length, bool utf8 = false) const;
+
+    uint16_t width() const { return SIM_OLED_WIDTH; }
+    uint16_t height() const { return SIM_OLED_HEIGHT; }
+
+    // Simulation access
+    uint8_t* buffer = nullptr;   // As in the library: init() allocates it unless set before
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    uint8_t* buffer_back = nullptr;   // Last frame sent
+#endif
+    uint8_t textCount() const { return shownTextCount; }
+    const char* textAt(uint8_t i, int16_t* x, int16_t* y) const;
+
+protected:
+    // Same hook as the real library: one line of text, already measured
+    uint16_t drawStringInternal(int16_t x, int16_t y, const char* text, uint16_t length,
+                                uint16_t width, bool utf8);
+
+private:
+    struct TextItem {
+        int16_t x;
+        int16_t y;
+        uint16_t width;
+        uint8_t height;
+        char text[32];
+    };
+
+    static bool sameText(const TextItem& a, const TextItem& b);
+
+    uint8_t address;
+    uint32_t frequency;
+    OLEDDISPLAY_COLOR color;
+    OLEDDISPLAY_TEXT_ALIGNMENT align;
+    const uint8_t* font;
+    bool inverted;
+    TextItem text[SIM_OLED_MAX_TEXT];  // Drawn since clear()
+    uint8_t textItems;
+    TextItem shown[SIM_OLED_MAX_TEXT]; // Text of the last display() frame
+    uint8_t shownTextCount;
+};
+
+#endif // SIM_SH1106WIRE_H
@@ -0,0 +1,75 @@
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+// 🧪 Host build: Arduino String on top of std::string (subset used by the firmware)
+
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+
+class String {
+public:
+    String() {}
+    String(const char* s) : str(s ? s : "") {}
+    String(const std::string& s) : str(s) {}
+    String(char c) : str(1, c) {}
+    String(int v, unsigned char base = 10) { fromLong(v, base); }
+    String(unsigned int v, unsigned char base = 10) { fromULong(v, base); }
+    String(long v, unsigned char base = 10) { fromLong(v, base); }
+    String(unsigned long v, unsigned char base = 10) { fromULong(v, base); }
+    String(float v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+    String(double v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+
+    const char* c_str() const { return str.c_str(); }
+    unsigned int length() const { return (unsigned int)str.size(); }
+    char charAt(unsigned int i) const { return i < str.size() ? str[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+
+    String substring(unsigned int from) const { return substring(from, length()); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) { unsigned int t = from; from = to; to = t; }
+        if (from >= str.size()) return String();
+        return String(str.substr(from, to - from));
+    }
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t pos = str.find(c, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    int indexOf(const String& s, unsigned int from = 0) const {
+        size_t pos = str.find(s.str, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    long toInt() const { return atol(str.c_str()); }
+    float toFloat() const { return (float)atof(str.c_str()); }
+
+    String& operator+=(const String& rhs) { str += rhs.str; return *this; }
+    String& operator+=(const char* rhs) { str += rhs; return *this; }
+    String& operator+=(char rhs) { str += rhs; return *this; }
+    bool operator==(const String& rhs) const { return str == rhs.str; }
+    bool operator==(const char* rhs) const { return str == rhs; }
+    bool operator!=(const String& rhs) const { return str != rhs.str; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.str + b.str); }
+    friend String operator+(const String& a, const char* b) { return String(a.str + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b.str); }
+
+private:
+    void fromLong(long v, unsigned char base) {
+        if (base == 10) { char buf[24]; snprintf(buf, sizeof(buf), "%ld", v); str = buf; }
+        else fromULong((unsigned long)v, base);
+    }
+    void fromULong(unsigned long v, unsigned char base) {
+        char buf[72];
+        char* p = buf + sizeof(buf) - 1;
+        *p = 0;
+        do { unsigned d = v % base; *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10); v /= base; } while (v);
+        str = p;
+    }
+    void fromDouble(double v, unsigned char decimals) {
+        char buf[48]; snprintf(buf, sizeof(buf), "%.*f", decimals, v); str = buf;
+    }
+
+    std::string str;
+};
+
+#endif // SIM_WSTRING_H
@@ -0,0 +1,92 @@
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+// 🧪 Host build: WiFi station + TCP client backed by the simulated access point
+// in sim_net.cpp. Connections from WiFiClient are redirected to the loopback
+// Blynk server configured with simSetBlynkServer().
+
+#include "Arduino.h"
+#include "Client.h"
+#include "IPAddress.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1
+} wifi_mode_t;
+
+typedef enum {
+    ARDUINO_EVENT_WIFI_STA_CONNECTED = 4,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED = 5,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP = 7,
+    ARDUINO_EVENT_WIFI_STA_LOST_IP = 8
+} arduino_event_id_t;
+
+typedef arduino_event_id_t WiFiEvent_t;
+
+typedef struct {
+    struct {
+        uint8_t reason;
+    } wifi_sta_disconnected;
+} WiFiEventInfo_t;
+
+typedef void (*WiFiEventFuncCb)(WiFiEvent_t event, WiFiEventInfo_t info);
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t m);
+    void persistent(bool enabled) { (void)enabled; }
+    bool setAutoReconnect(bool enabled) { (void)enabled; return true; }
+    int onEvent(WiFiEventFuncCb cb);
+
+    wl_status_t begin(const char* ssid, const char* pass = nullptr,
+                      int32_t channel = 0, const uint8_t* bssid = nullptr, bool connect = true);
+    bool config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1 = INADDR_NONE);
+    bool disconnect(bool wifiOff = false);
+    wl_status_t status();
+
+    String SSID();
+    uint8_t* BSSID();
+    int32_t channel();
+    int8_t RSSI();
+    IPAddress localIP();
+    IPAddress gatewayIP();
+    IPAddress subnetMask();
+    IPAddress dnsIP(uint8_t index = 0);
+};
+extern WiFiClass WiFi;
+
+class WiFiClient : public Client {
+public:
+    WiFiClient() : sock(-1), timeoutMs(1000) {}
+    ~WiFiClient() { stop(); }
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    size_t readBytes(char* buf, size_t length);
+    void stop() override;
+    uint8_t connected() override;
+    void setTimeout(unsigned long ms) { timeoutMs = ms; }
+    int setNoDelay(bool nodelay);
+    int fd() const { return sock; }
+    using Print::write;
+
+private:
+    int sock;
+    unsigned long timeoutMs;
+};
+
+#endif // SIM_WIFI_H
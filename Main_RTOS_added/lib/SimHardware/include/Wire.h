@@ -0,0 +1,25 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+// 🧪 Host build: I2C bus. Devices are simulated at the driver level
+// (LiquidCrystal_I2C, SH1106Wire); this only tracks the configured clock.
+
+#include <stdint.h>
+
+class TwoWire {
+public:
+    TwoWire() : clockHz(100000) {}
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+        (void)sda; (void)scl;
+        if (frequency) clockHz = frequency;
+        return true;
+    }
+    void setClock(uint32_t frequency) { clockHz = frequency; }
+    uint32_t getClock() const { return clockHz; }
+
+private:
+    uint32_t clockHz;
+};
+extern TwoWire Wire;
+
+#endif // SIM_WIRE_H
@@ -0,0 +1,25 @@
+#ifndef SIM_ESP_DSP_H
+#define SIM_ESP_DSP_H
+
+// 🧪 Host build: the ESP-DSP kernels the firmware uses, as plain C reference
+// versions (the target links the ESP32-S3 assembly ones under the same names).
+// Results match the library's: dsps_fft2r_fc32() leaves the spectrum in
+// bit-reversed order for dsps_bit_rev_fc32().
+
+#include "esp_system.h"
+
+#define CONFIG_DSP_MAX_FFT_SIZE 4096
+
+esp_err_t dsps_fft2r_init_fc32(float* fft_table_buff, int table_size);
+void dsps_fft2r_deinit_fc32(void);
+esp_err_t dsps_fft2r_fc32(float* data, int N);        // In place, interleaved re/im
+esp_err_t dsps_bit_rev_fc32(float* data, int N);
+
+void dsps_wind_hann_f32(float* window, int len);
+
+esp_err_t dsps_mul_f32(const float* input1, const float* input2, float* output, int len,
+                       int step1, int step2, int step_out);
+esp_err_t dsps_addc_f32(const float* input, float* output, int len, float C, int step_in, int step_out);
+esp_err_t dsps_dotprod_f32(const float* src1, const float* src2, float* dest, int len);
+
+#endif // SIM_ESP_DSP_H
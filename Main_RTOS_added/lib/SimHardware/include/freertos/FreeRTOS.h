@@ -0,0 +1,59 @@
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+// 🧪 Host build: the FreeRTOS API subset used by the firmware, implemented on
+// pthreads in sim_rtos.cpp. Every task is a thread; priorities and core
+// affinity are recorded for reports but scheduling is left to the host OS.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;
+
+#define pdFALSE             0
+#define pdTRUE              1
+#define pdFAIL              pdFALSE
+#define pdPASS              pdTRUE
+#define errQUEUE_EMPTY      0
+#define errQUEUE_FULL       0
+
+#define configTICK_RATE_HZ      1000
+#define configMAX_PRIORITIES    25
+#define portTICK_PERIOD_MS      (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFFu)
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define tskNO_AFFINITY          0x7FFFFFFF
+#define configSUPPORT_STATIC_ALLOCATION 1
+
+// Caller-provided storage for the ...Static APIs. The host keeps its own
+// control blocks, so these only need to exist with a plausible size.
+typedef struct { uint8_t opaque[352]; } StaticTask_t;
+typedef struct { uint8_t opaque[84]; } StaticQueue_t;
+typedef StaticQueue_t StaticSemaphore_t;
+
+// Spinlocks become recursive host mutexes
+typedef struct {
+    pthread_mutex_t mutex;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP }
+
+void vPortEnterCritical(portMUX_TYPE* mux);
+void vPortExitCritical(portMUX_TYPE* mux);
+
+#define portENTER_CRITICAL(mux)      vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)       vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux)  vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)   vPortExitCritical(mux)
+#define taskENTER_CRITICAL(mux)      vPortEnterCritical(mux)
+#define taskEXIT_CRITICAL(mux)       vPortExitCritical(mux)
+#define portYIELD_FROM_ISR(...)      do { } while (0)
+
+BaseType_t xPortGetCoreID(void);
+BaseType_t xPortInIsrContext(void);
+
+#endif // SIM_FREERTOS_H
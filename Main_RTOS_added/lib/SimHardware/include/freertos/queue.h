@@ -0,0 +1,35 @@
+#ifndef SIM_FREERTOS_QUEUE_H
+#define SIM_FREERTOS_QUEUE_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct SimQueue* QueueHandle_t;
+
+#define queueSEND_TO_BACK   0
+#define queueSEND_TO_FRONT  1
+#define queueOVERWRITE      2
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize,
+                                 uint8_t* storage, StaticQueue_t* queueBuffer);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueReset(QueueHandle_t queue);
+
+BaseType_t xQueueGenericSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait, BaseType_t position);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait);
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t ticksToWait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+
+#define xQueueSend(q, item, wait)          xQueueGenericSend((q), (item), (wait), queueSEND_TO_BACK)
+#define xQueueSendToBack(q, item, wait)    xQueueGenericSend((q), (item), (wait), queueSEND_TO_BACK)
+#define xQueueSendToFront(q, item, wait)   xQueueGenericSend((q), (item), (wait), queueSEND_TO_FRONT)
+#define xQueueOverwrite(q, item)           xQueueGenericSend((q), (item), 0, queueOVERWRITE)
+
+// ISR variants never block and never need a context switch on the host
+#define xQueueSendFromISR(q, item, woken)       xQueueGenericSend((q), (item), 0, queueSEND_TO_BACK)
+#define xQueueSendToBackFromISR(q, item, woken) xQueueGenericSend((q), (item), 0, queueSEND_TO_BACK)
+#define xQueueOverwriteFromISR(q, item, woken)  xQueueGenericSend((q), (item), 0, queueOVERWRITE)
+#define xQueueReceiveFromISR(q, item, woken)    xQueueReceive((q), (item), 0)
+
+#endif // SIM_FREERTOS_QUEUE_H
@@ -0,0 +1,22 @@
+#ifndef SIM_FREERTOS_SEMPHR_H
+#define SIM_FREERTOS_SEMPHR_H
+
+#include "freertos/queue.h"
+
+// As in FreeRTOS, semaphores are queues of zero-sized items
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount);
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* mutexBuffer);
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* semaphoreBuffer);
+
+#define xSemaphoreTake(sem, wait)          xQueueReceive((sem), NULL, (wait))
+#define xSemaphoreGive(sem)                xQueueGenericSend((sem), NULL, 0, queueSEND_TO_BACK)
+#define xSemaphoreGiveFromISR(sem, woken)  xQueueGenericSend((sem), NULL, 0, queueSEND_TO_BACK)
+#define xSemaphoreTakeFromISR(sem, woken)  xQueueReceive((sem), NULL, 0)
+#define uxSemaphoreGetCount(sem)           uxQueueMessagesWaiting(sem)
+#define vSemaphoreDelete(sem)              vQueueDelete(sem)
+
+#endif // SIM_FREERTOS_SEMPHR_H
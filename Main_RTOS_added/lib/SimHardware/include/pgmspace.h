@@ -0,0 +1,18 @@
+#ifndef SIM_PGMSPACE_H
+#define SIM_PGMSPACE_H
+
+// 🧪 Host build: flash and RAM share one address space
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(addr)  (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#endif // SIM_PGMSPACE_H
@@ -0,0 +1,90 @@
+#ifndef SIM_HW_H
+#define SIM_HW_H
+
+// 🧪 Simulated Smart Shop Guard board
+// Scenario code drives the sensor inputs, observes the actuator outputs and
+// reads bus accounting. Pin numbers come from the project's config.h.
+
+#include <stdint.h>
+
+// ⏱️ Simulation clock (µs since start); millis(), micros() and ticks derive from it
+uint64_t simMicros();
+
+// 🌡️ Inputs (what the firmware sees through digitalRead, pulseIn and DHT)
+void simSetFlame(bool present);                   // FLAME_SENSOR_PIN, active low
+void simSetIrSource(bool present);                // Steady IR (sunlight, heater): trips FLAME_SENSOR_PIN, doesn't flicker
+uint16_t simFlameAnalog(uint64_t tUs);            // Flame module AO in 12-bit counts at time tUs
+void simSetMotion(bool present);                  // PIR_PIN
+void simSetDistanceCm(float cm);                  // First ULTRASONIC_SENSORS entry (ECHO_PIN); < 0 = no echo
+void simSetSonarDistanceCm(int index, float cm);  // Target of one ULTRASONIC_SENSORS entry, echoed after each trigger
+void simSetEchoFaults(int pct);                   // pct % of pings lose the echo, pct % get a stray 3-22 cm one
+void simSetClimate(float tempC, float humidityPct);
+void simSetButton(uint8_t pin, bool pressed);     // Buttons are INPUT_PULLUP, active low
+void simSetPinLevel(uint8_t pin, int level);      // Raw input; runs attachInterrupt() handlers
+void simSetIsrContext(bool active);               // Marks the calling thread as an ISR
+uint64_t simTaskCpuTimeUs(void* task);            // Host CPU time of a task's thread (TaskHandle_t)
+
+// ⚡ Outputs
+enum SimOutput {
+    SIM_OUT_RELAY = 0,
+    SIM_OUT_FAN,
+    SIM_OUT_SERVO,    // Commanded angle in degrees
+    SIM_OUT_BUZZER,   // Tone frequency in Hz, 0 = silent
+    SIM_OUT_COUNT
+};
+
+typedef void (*SimOutputHook)(SimOutput output, int value, uint64_t tUs);
+
+int simGetOutput(SimOutput output);
+const char* simOutputName(SimOutput output);
+void simSetOutputHook(SimOutputHook hook);        // Called on every output transition
+void simReportOutput(SimOutput output, int value);
+
+// 🌐 Network
+void simSetWiFiAvailable(bool available);         // Access point in range or not
+void simSetWiFiConnectDelay(uint32_t fastMs, uint32_t fullScanMs);
+void simSetDhcpAddress(uint8_t host);             // DHCP server reassigns: next lease is 192.168.4.<host>
+void simSetBlynkServer(const char* host, uint16_t port);  // Loopback target of every WiFiClient
+
+// 🚌 Bus and peripheral accounting
+struct SimBusStats {
+    uint64_t i2cBusyUs;     // Wire time charged by LCD and OLED writes
+    uint32_t oledFrames;
+    uint64_t oledBytes;     // Sent by display(): changed boxes only
+    uint32_t lcdBytes;
+    uint64_t serialBytes;
+    uint32_t serialBaud;
+    uint32_t dhtReads;
+    uint32_t echoPulses;
+};
+
+void simGetBusStats(SimBusStats* out);
+void simI2CTransfer(uint32_t bytes, uint32_t clockHz);   // Blocks for the wire time
+void simCountLcdBytes(uint32_t bytes);
+void simCountOledFrame();
+void simCountOledBytes(uint32_t bytes);
+void simCountDhtRead();
+void simSetSerialEcho(bool enabled);              // Copy firmware Serial output to stdout
+
+// 🔬 Kernel trace points: fired where FreeRTOS would run its trace macros.
+// A task "switches out" before it blocks and back in when the wait returns.
+enum SimRtosEvent {
+    SIM_RTOS_TASK_CREATE = 0,   // name = task name
+    SIM_RTOS_QUEUE_CREATE,
+    SIM_RTOS_MUTEX_CREATE,
+    SIM_RTOS_SEMAPHORE_CREATE,
+    SIM_RTOS_TASK_IN,
+    SIM_RTOS_TASK_OUT,
+    SIM_RTOS_QUEUE_SEND,
+    SIM_RTOS_QUEUE_SEND_FAILED,
+    SIM_RTOS_QUEUE_RECEIVE,
+    SIM_RTOS_QUEUE_RECEIVE_FAILED,
+    SIM_RTOS_QUEUE_PEEK,
+    SIM_RTOS_BLOCKING_ON_SEND,
+    SIM_RTOS_BLOCKING_ON_RECEIVE
+};
+
+typedef void (*SimRtosTraceHook)(SimRtosEvent event, void* object, const char* name);
+void simSetRtosTraceHook(SimRtosTraceHook hook);  // Also reports the tasks created so far
+
+#endif // SIM_HW_H
@@ -0,0 +1,501 @@
+#include <Arduino.h>
+#include "sim_hw.h"
+#include "config.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unistd.h>
+
+// 🧪 Simulated ESP32-S3 core: clock, GPIO, LEDC, Serial and the sensor models
+// that sit behind them (flame, PIR, HC-SR04 echo).
+
+#define SIM_ECHO_LEAD_US    450    // HC-SR04 trigger fall to echo rise (burst)
+#define SIM_ECHO_LOST_US    38000  // Echo line held high by the module when nothing answers
+
+#define SIM_GPIO_COUNT      64
+#define SIM_LEDC_CHANNELS   8      // S3: channels 2t and 2t+1 share timer t
+#define SIM_LEDC_TIMERS     4
+#define SIM_HEAP_SIZE       (320 * 1024)   // Internal heap reported by ESP.getFreeHeap()
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+// 📌 GPIO state
+static std::mutex gpioMutex;
+static int pinLevel[SIM_GPIO_COUNT];
+static uint8_t pinModes[SIM_GPIO_COUNT];
+static void (*pinIsr[SIM_GPIO_COUNT])(void);
+static void (*pinIsrArg[SIM_GPIO_COUNT])(void*);
+static void* pinIsrArgValue[SIM_GPIO_COUNT];
+static int pinIsrMode[SIM_GPIO_COUNT];
+static int ledcPin[SIM_LEDC_CHANNELS];
+static int ledcTimerChannel[SIM_LEDC_TIMERS];      // Channel that last set the timer up
+static uint32_t ledcTimerFreq[SIM_LEDC_TIMERS];
+static uint64_t ledcClashReported;                  // Bit per channel pair already reported
+
+// 🌡️ Sensor models
+struct SimSonar {
+    uint8_t trigPin;
+    uint8_t echoPin;
+};
+#define SIM_SONAR_ROW(id, name, trig, echo, group) { trig, echo },
+static const SimSonar sonars[] = { ULTRASONIC_SENSORS(SIM_SONAR_ROW) };
+#define SIM_SONARS ((int)(sizeof(sonars) / sizeof(sonars[0])))
+static std::atomic<float> sonarCm[SIM_SONARS];
+static std::atomic<int> echoFaultPct(0);
+static std::atomic<bool> flamePresent(false);
+static std::atomic<bool> irPresent(false);
+
+// ⚡ Outputs
+static std::mutex outputMutex;
+static int outputValue[SIM_OUT_COUNT];
+static SimOutputHook outputHook = nullptr;
+static const char* const outputNames[SIM_OUT_COUNT] = { "relay", "fan", "servo", "buzzer" };
+
+// 🚌 Accounting
+static std::atomic<uint64_t> i2cBusyUs(0);
+static std::atomic<uint32_t> oledFrames(0);
+static std::atomic<uint64_t> oledBytes(0);
+static std::atomic<uint32_t> lcdBytes(0);
+static std::atomic<uint64_t> serialBytes(0);
+static std::atomic<uint32_t> serialBaud(0);
+static std::atomic<uint32_t> dhtReads(0);
+static std::atomic<uint32_t> echoPulses(0);
+static std::atomic<bool> serialEcho(true);
+static std::mutex serialMutex;
+
+// Idle input levels of the board (pull-ups on the flame module and buttons)
+static bool initBoard() {
+    for (int i = 0; i < SIM_GPIO_COUNT; i++) {
+        pinLevel[i] = LOW;
+    }
+    for (int i = 0; i < SIM_LEDC_CHANNELS; i++) {
+        ledcPin[i] = -1;
+    }
+    for (int i = 0; i < SIM_LEDC_TIMERS; i++) {
+        ledcTimerChannel[i] = -1;
+    }
+    pinLevel[FLAME_SENSOR_PIN] = HIGH;
+    pinLevel[BUTTON_NEXT] = HIGH;
+    pinLevel[BUTTON_PREV] = HIGH;
+    for (int i = 0; i < SIM_SONARS; i++) {
+        sonarCm[i] = 100.0f;
+    }
+    return true;
+}
+static const bool boardReady = initBoard();
+
+// ⏱️ Timing
+uint64_t simMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long millis() {
+    return (unsigned long)(simMicros() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)simMicros();
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    // Busy-wait like the ROM routine: short delays must not yield
+    uint64_t until = simMicros() + us;
+    while (simMicros() < until) {
+    }
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+// 📌 GPIO
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= SIM_GPIO_COUNT) return;
+    std::lock_guard<std::mutex> lock(gpioMutex);
+    pinModes[pin] = mode;
+}
+
+static void sonarTriggered(int index);
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= SIM_GPIO_COUNT) return;
+    int previous;
+    {
+        std::lock_guard<std::mutex> lock(gpioMutex);
+        previous = pinLevel[pin];
+        pinLevel[pin] = val ? HIGH : LOW;
+    }
+    if (previous == HIGH && !val) {
+        for (int i = 0; i < SIM_SONARS; i++) {
+            if (sonars[i].trigPin == pin) sonarTriggered(i);
+        }
+    }
+    if (pin == RELAY_PIN) {
+        simReportOutput(SIM_OUT_RELAY, val ? 1 : 0);
+    } else if (pin == FAN_PIN) {
+        simReportOutput(SIM_OUT_FAN, val ? 1 : 0);
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    if (pin >= SIM_GPIO_COUNT) return LOW;
+    std::lock_guard<std::mutex> lock(gpioMutex);
+    return pinLevel[pin];
+}
+
+uint16_t analogRead(uint8_t pin) {
+    return digitalRead(pin) ? 4095 : 0;
+}
+
+void analogWrite(uint8_t pin, int value) {
+    digitalWrite(pin, value > 0 ? HIGH : LOW);
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+    if (pin >= SIM_GPIO_COUNT) return;
+    std::lock_guard<std::mutex> lock(gpioMutex);
+    pinIsr[pin] = isr;
+    pinIsrArg[pin] = nullptr;
+    pinIsrMode[pin] = mode;
+}
+
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) {
+    if (pin >= SIM_GPIO_COUNT) return;
+    std::lock_guard<std::mutex> lock(gpioMutex);
+    pinIsr[pin] = nullptr;
+    pinIsrArg[pin] = isr;
+    pinIsrArgValue[pin] = arg;
+    pinIsrMode[pin] = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin >= SIM_GPIO_COUNT) return;
+    std::lock_guard<std::mutex> lock(gpioMutex);
+    pinIsr[pin] = nullptr;
+    pinIsrArg[pin] = nullptr;
+}
+
+void simSetPinLevel(uint8_t pin, int level) {
+    if (pin >= SIM_GPIO_COUNT) return;
+    void (*isr)(void) = nullptr;
+    void (*isrArg)(void*) = nullptr;
+    void* arg = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(gpioMutex);
+        int previous = pinLevel[pin];
+        pinLevel[pin] = level ? HIGH : LOW;
+        if ((pinIsr[pin] || pinIsrArg[pin]) && previous != pinLevel[pin]) {
+            int mode = pinIsrMode[pin];
+            bool rising = pinLevel[pin] == HIGH;
+            if (mode == CHANGE || (mode == RISING && rising) || (mode == FALLING && !rising)) {
+                isr = pinIsr[pin];
+                isrArg = pinIsrArg[pin];
+                arg = pinIsrArgValue[pin];
+            }
+        }
+    }
+    if (isr || isrArg) {
+        simSetIsrContext(true);
+        if (isr) {
+            isr();
+        } else {
+            isrArg(arg);
+        }
+        simSetIsrContext(false);
+    }
+}
+
+// 📏 HC-SR04: the echo pulse is as wide as the round trip of the modelled distance.
+// With echo faults, that share of pings each loses its echo (soft or angled
+// target) or returns a stray short one (cross-talk, ringing)
+static unsigned long sonarEchoUs(int index) {
+    echoPulses++;
+    float cm = sonarCm[index].load();
+    int faultPct = echoFaultPct.load();
+    if (faultPct > 0) {
+        static std::mutex rngMutex;
+        static std::mt19937 rng(11);
+        std::lock_guard<std::mutex> lock(rngMutex);
+        int roll = (int)(rng() % 100);
+        if (roll < faultPct) {
+            cm = -1;                                  // Lost echo
+        } else if (roll < 2 * faultPct) {
+            cm = 3.0f + (float)(rng() % 20);          // Stray echo, 3-22 cm
+        }
+    }
+    return cm < 0 ? 0 : (unsigned long)(cm / 0.017f);
+}
+
+// Triggered module: echo line high after the burst, low after the round
+// trip (or the module's own timeout), driven from a helper thread so the
+// echo pin interrupts see real edges while the firmware goes on
+static void sonarTriggered(int index) {
+    unsigned long widthUs = sonarEchoUs(index);
+    if (widthUs == 0 || widthUs > SIM_ECHO_LOST_US) widthUs = SIM_ECHO_LOST_US;
+    uint8_t echoPin = sonars[index].echoPin;
+    std::thread([echoPin, widthUs]() {
+        usleep(SIM_ECHO_LEAD_US);
+        simSetPinLevel(echoPin, HIGH);
+        usleep((useconds_t)widthUs);
+        simSetPinLevel(echoPin, LOW);
+    }).detach();
+}
+
+unsigned long pulseIn(uint8_t pin, uint8_t state, unsigned long timeoutUs) {
+    (void)state;
+    if (pin != ECHO_PIN) {
+        delayMicroseconds(timeoutUs);
+        return 0;
+    }
+    unsigned long widthUs = sonarEchoUs(0);
+    if (widthUs == 0 || widthUs > timeoutUs) {
+        usleep(timeoutUs);
+        return 0;
+    }
+    usleep(widthUs);
+    return widthUs;
+}
+
+// 🔥 Flame module: the comparator output (DO) trips on any strong IR, the
+// analog output (AO) shows what it is. A flame flickers at a few Hz, a lamp
+// or sunlight through a window is steady; both sit on mains light ripple and
+// ADC noise.
+static void updateFlameOutput() {
+    simSetPinLevel(FLAME_SENSOR_PIN, (flamePresent || irPresent) ? LOW : HIGH);
+}
+
+void simSetFlame(bool present) {
+    flamePresent = present;
+    updateFlameOutput();
+}
+
+void simSetIrSource(bool present) {
+    irPresent = present;
+    updateFlameOutput();
+}
+
+uint16_t simFlameAnalog(uint64_t tUs) {
+    static std::mt19937 rng(7);
+    static std::normal_distribution<float> noise(0.0f, 8.0f);
+    const float twoPi = 6.2831853f;
+    float t = tUs / 1e6f;
+    float counts = 150.0f + 20.0f * sinf(twoPi * 100.0f * t) + noise(rng);
+    if (irPresent) {
+        counts += 2200.0f;
+    }
+    if (flamePresent) {
+        counts += 1800.0f + 300.0f * sinf(twoPi * 3.1f * t) + 250.0f * sinf(twoPi * 7.3f * t + 1.0f) +
+                  150.0f * sinf(twoPi * 11.7f * t + 2.0f);
+    }
+    return (uint16_t)constrain(counts, 0.0f, 4095.0f);
+}
+
+void simSetMotion(bool present) {
+    simSetPinLevel(PIR_PIN, present ? HIGH : LOW);
+}
+
+void simSetDistanceCm(float cm) {
+    simSetSonarDistanceCm(0, cm);
+}
+
+void simSetSonarDistanceCm(int index, float cm) {
+    if (index >= 0 && index < SIM_SONARS) sonarCm[index].store(cm);
+}
+
+void simSetEchoFaults(int pct) {
+    echoFaultPct.store(constrain(pct, 0, 50));
+}
+
+void simSetButton(uint8_t pin, bool pressed) {
+    simSetPinLevel(pin, pressed ? LOW : HIGH);
+}
+
+// 🎵 LEDC
+// Timers are shared like on the chip: setting a channel up retunes its
+// partner too, which is reported once per channel pair
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolutionBits) {
+    (void)resolutionBits;
+    if (channel >= SIM_LEDC_CHANNELS) return 0;
+    int timer = (channel / 2) % SIM_LEDC_TIMERS;
+    int other = ledcTimerChannel[timer];
+    if (other >= 0 && other != channel && ledcTimerFreq[timer] != freq &&
+        !(ledcClashReported & (1ull << (channel * SIM_LEDC_CHANNELS + other)))) {
+        ledcClashReported |= 1ull << (channel * SIM_LEDC_CHANNELS + other);
+        printf("⚠️ sim: LEDC channel %d retunes timer %d to %u Hz under channel %d (%u Hz)\n",
+               channel, timer, (unsigned)freq, other, (unsigned)ledcTimerFreq[timer]);
+        fflush(stdout);
+    }
+    ledcTimerChannel[timer] = channel;
+    ledcTimerFreq[timer] = freq;
+    return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    if (channel < SIM_LEDC_CHANNELS) ledcPin[channel] = pin;
+}
+
+void ledcDetachPin(uint8_t pin) {
+    for (int i = 0; i < SIM_LEDC_CHANNELS; i++) {
+        if (ledcPin[i] == pin) ledcPin[i] = -1;
+    }
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel < SIM_LEDC_CHANNELS && ledcPin[channel] == FAN_PIN) {
+        simReportOutput(SIM_OUT_FAN, duty > 0 ? 1 : 0);
+    }
+}
+
+uint32_t ledcWriteTone(uint8_t channel, uint32_t freq) {
+    if (freq > 0) ledcSetup(channel, freq, 10);  // As arduino-esp32 2.x does
+    if (channel < SIM_LEDC_CHANNELS && ledcPin[channel] == BUZZER_PIN) {
+        simReportOutput(SIM_OUT_BUZZER, (int)freq);
+    }
+    return freq;
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+    (void)duration;
+    if (pin == BUZZER_PIN) simReportOutput(SIM_OUT_BUZZER, (int)frequency);
+}
+
+void noTone(uint8_t pin) {
+    if (pin == BUZZER_PIN) simReportOutput(SIM_OUT_BUZZER, 0);
+}
+
+// 🎲 Misc
+static std::mutex randomMutex;
+static std::mt19937 randomEngine(12345);
+
+uint32_t esp_random(void) {
+    std::lock_guard<std::mutex> lock(randomMutex);
+    return (uint32_t)randomEngine();
+}
+
+void esp_restart(void) {
+    fflush(stdout);
+    _exit(1);
+}
+
+esp_reset_reason_t esp_reset_reason(void) {
+    return ESP_RST_POWERON;
+}
+
+long random(long maxValue) {
+    return maxValue > 0 ? (long)(esp_random() % (uint32_t)maxValue) : 0;
+}
+
+long random(long minValue, long maxValue) {
+    return maxValue > minValue ? minValue + random(maxValue - minValue) : minValue;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+uint32_t EspClass::getFreeHeap() { return SIM_HEAP_SIZE; }
+uint32_t EspClass::getMinFreeHeap() { return SIM_HEAP_SIZE; }
+uint32_t EspClass::getHeapSize() { return SIM_HEAP_SIZE; }
+uint32_t EspClass::getFreePsram() { return 8u * 1024 * 1024; }
+uint32_t EspClass::getPsramSize() { return 8u * 1024 * 1024; }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(simMicros() * 240); }
+void EspClass::restart() { esp_restart(); }
+
+bool psramFound() { return true; }
+void* ps_malloc(size_t size) { return malloc(size); }
+
+// 📡 Serial
+void HardwareSerial::begin(unsigned long baud) {
+    serialBaud = (uint32_t)baud;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    serialBytes += size;
+    if (serialEcho) {
+        std::lock_guard<std::mutex> lock(serialMutex);
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+void simSetSerialEcho(bool enabled) {
+    serialEcho = enabled;
+}
+
+// ⚡ Outputs
+int simGetOutput(SimOutput output) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    return outputValue[output];
+}
+
+const char* simOutputName(SimOutput output) {
+    return output < SIM_OUT_COUNT ? outputNames[output] : "?";
+}
+
+void simSetOutputHook(SimOutputHook hook) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    outputHook = hook;
+}
+
+void simReportOutput(SimOutput output, int value) {
+    SimOutputHook hook;
+    {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        if (outputValue[output] == value) return;
+        outputValue[output] = value;
+        hook = outputHook;
+    }
+    if (hook) {
+        hook(output, value, simMicros());
+    }
+}
+
+// 🚌 Accounting
+void simI2CTransfer(uint32_t bytes, uint32_t clockHz) {
+    // 9 clocks per byte (8 data + ACK), plus start/address overhead per transfer
+    uint64_t us = ((uint64_t)(bytes + 2) * 9 * 1000000) / (clockHz ? clockHz : 100000);
+    i2cBusyUs += us;
+    usleep((useconds_t)us);
+}
+
+void simCountLcdBytes(uint32_t bytes) {
+    lcdBytes += bytes;
+}
+
+void simCountOledFrame() {
+    oledFrames++;
+}
+
+void simCountOledBytes(uint32_t bytes) {
+    oledBytes += bytes;
+}
+
+void simCountDhtRead() {
+    dhtReads++;
+}
+
+void simGetBusStats(SimBusStats* out) {
+    out->i2cBusyUs = i2cBusyUs;
+    out->oledFrames = oledFrames;
+    out->oledBytes = oledBytes;
+    out->lcdBytes = lcdBytes;
+    out->serialBytes = serialBytes;
+    out->serialBaud = serialBaud;
+    out->dhtReads = dhtReads;
+    out->echoPulses = echoPulses;
+}
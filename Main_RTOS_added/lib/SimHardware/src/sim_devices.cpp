@@ -0,0 +1,462 @@
+#include <Arduino.h>
+#include <DHT.h>
+#include <ESP32Servo.h>
+#include <LiquidCrystal_I2C.h>
+#include <SH1106Wire.h>
+#include <Wire.h>
+#include "sim_hw.h"
+#include "config.h"
+#include "driver/adc.h"
+
+#include <atomic>
+#include <mutex>
+#include <unistd.h>
+
+// 🧪 Simulated peripherals with the timing their real drivers impose
+
+#define SIM_DHT_MIN_INTERVAL_MS  2000    // DHT library caches readings this long
+#define SIM_DHT_READ_US          25000   // 18 ms start pulse + 40 bit frame
+#define SIM_LCD_I2C_HZ           100000
+#define SIM_LCD_BYTES_PER_CHAR   12      // 2 nibbles x 3 expander writes x (addr + data)
+
+TwoWire Wire;
+
+// Font headers only (width, height, first char, char count)
+const uint8_t ArialMT_Plain_10[] = { 0x0A, 0x0D, 0x20, 0xE0 };
+const uint8_t ArialMT_Plain_16[] = { 0x10, 0x13, 0x20, 0xE0 };
+const uint8_t ArialMT_Plain_24[] = { 0x18, 0x1C, 0x20, 0xE0 };
+
+// 🌡️ DHT11
+static std::atomic<float> climateTempC(22.0f);
+static std::atomic<float> climateHumidity(45.0f);
+static std::atomic<unsigned long> lastDhtRead(0);
+static std::atomic<bool> dhtEverRead(false);
+
+void simSetClimate(float tempC, float humidityPct) {
+    climateTempC = tempC;
+    climateHumidity = humidityPct;
+}
+
+static void dhtSample(bool force) {
+    unsigned long now = millis();
+    if (!force && dhtEverRead && now - lastDhtRead < SIM_DHT_MIN_INTERVAL_MS) {
+        return;  // Served from the library cache
+    }
+    usleep(SIM_DHT_READ_US);
+    lastDhtRead = millis();
+    dhtEverRead = true;
+    simCountDhtRead();
+}
+
+float DHT::readTemperature(bool fahrenheit, bool force) {
+    dhtSample(force);
+    float c = climateTempC;
+    return fahrenheit ? c * 1.8f + 32.0f : c;
+}
+
+float DHT::readHumidity(bool force) {
+    dhtSample(force);
+    return climateHumidity;
+}
+
+// 🚪 Servo
+int Servo::attach(int pin, int minUs, int maxUs) {
+    (void)minUs; (void)maxUs;
+    this->pin = pin;
+    return 1;
+}
+
+void Servo::write(int value) {
+    if (value < 0) value = 0;
+    if (value > 180) value = 180;
+    angle = value;
+    simReportOutput(SIM_OUT_SERVO, angle);
+}
+
+void Servo::writeMicroseconds(int us) {
+    write((us - 500) * 180 / 2000);
+}
+
+// One ESP32PWM user on the board: it takes the first channel of its timer
+static int pwmTimer = 0;
+
+void ESP32PWM::allocateTimer(int timerNumber) {
+    if (timerNumber >= 0 && timerNumber < 4) pwmTimer = timerNumber;
+}
+
+void ESP32PWM::attachPin(uint8_t pin, double freq, uint8_t resolutionBits) {
+    ledcSetup(pwmTimer * 2, (uint32_t)freq, resolutionBits);
+    this->pin = pin;
+    this->freq = freq;
+    this->resolutionBits = resolutionBits;
+}
+
+// Pulse width back to degrees with the same 500-2500 µs span as Servo::writeMicroseconds()
+void ESP32PWM::write(uint32_t duty) {
+    this->duty = duty;
+    if (pin != SERVO_PIN || freq <= 0) return;
+    double us = duty * (1e6 / freq) / (double)(1u << resolutionBits);
+    int angle = (int)((us - 500.0) * 180.0 / 2000.0 + 0.5);
+    if (angle < 0) angle = 0;
+    if (angle > 180) angle = 180;
+    simReportOutput(SIM_OUT_SERVO, angle);
+}
+
+// 📈 Continuous ADC (DMA)
+// One ADC1 pattern; the flame module AO is the only analog model, other pins
+// read 0. S3 ADC1 channel n is GPIO n + 1.
+static std::mutex adcMutex;
+static adc_digi_init_config_t adcInit = {};
+static adc_digi_pattern_config_t adcPattern = {};
+static uint32_t adcSampleHz = 0;
+static bool adcRunning = false;
+static uint64_t adcNextUs = 0;         // Time of the next conversion to hand out
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* init_config) {
+    if (!init_config || init_config->conv_num_each_intr % SOC_ADC_DIGI_DATA_BYTES_PER_CONV) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(adcMutex);
+    adcInit = *init_config;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_controller_configure(const adc_digi_configure_t* config) {
+    if (!config || config->pattern_num != 1 || !config->adc_pattern ||
+        config->sample_freq_hz < SOC_ADC_SAMPLE_FREQ_THRES_LOW ||
+        config->sample_freq_hz > SOC_ADC_SAMPLE_FREQ_THRES_HIGH) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::lock_guard<std::mutex> lock(adcMutex);
+    adcPattern = config->adc_pattern[0];
+    adcSampleHz = config->sample_freq_hz;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_start(void) {
+    std::lock_guard<std::mutex> lock(adcMutex);
+    if (!adcSampleHz || !adcInit.conv_num_each_intr) return ESP_ERR_INVALID_STATE;
+    adcRunning = true;
+    adcNextUs = simMicros();
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_stop(void) {
+    std::lock_guard<std::mutex> lock(adcMutex);
+    adcRunning = false;
+    return ESP_OK;
+}
+
+esp_err_t adc_digi_deinitialize(void) {
+    return adc_digi_stop();
+}
+
+esp_err_t adc_digi_read_bytes(uint8_t* buf, uint32_t length_max, uint32_t* out_length, uint32_t timeout_ms) {
+    std::unique_lock<std::mutex> lock(adcMutex);
+    *out_length = 0;
+    if (!adcRunning) return ESP_ERR_INVALID_STATE;
+
+    uint32_t frameConv = adcInit.conv_num_each_intr / SOC_ADC_DIGI_DATA_BYTES_PER_CONV;
+    uint32_t conv = std::min<uint32_t>(frameConv, length_max / SOC_ADC_DIGI_RESULT_BYTES);
+    uint64_t periodUs = 1000000ULL / adcSampleHz;
+
+    // Frame complete once its last conversion is done
+    uint64_t readyUs = adcNextUs + conv * periodUs;
+    uint64_t now = simMicros();
+    if (readyUs > now) {
+        uint64_t waitUs = readyUs - now;
+        if (waitUs > (uint64_t)timeout_ms * 1000) {
+            lock.unlock();
+            usleep((useconds_t)timeout_ms * 1000);
+            return ESP_ERR_TIMEOUT;
+        }
+        lock.unlock();
+        usleep((useconds_t)waitUs);
+        lock.lock();
+    }
+
+    // Reader too slow: the driver ring wrapped, older frames are gone
+    esp_err_t result = ESP_OK;
+    uint64_t bufferedUs = (uint64_t)adcInit.max_store_buf_size / SOC_ADC_DIGI_RESULT_BYTES * periodUs;
+    if (simMicros() > adcNextUs + bufferedUs) {
+        adcNextUs = simMicros() - conv * periodUs;
+        result = ESP_ERR_INVALID_STATE;
+    }
+
+    int pin = adcPattern.channel + 1;
+    for (uint32_t i = 0; i < conv; i++) {
+        adc_digi_output_data_t out = {};
+        out.type2.unit = 0;
+        out.type2.channel = adcPattern.channel;
+        out.type2.data = pin == FLAME_ANALOG_PIN ? simFlameAnalog(adcNextUs) : 0;
+        memcpy(buf + i * SOC_ADC_DIGI_RESULT_BYTES, &out, SOC_ADC_DIGI_RESULT_BYTES);
+        adcNextUs += periodUs;
+    }
+    *out_length = conv * SOC_ADC_DIGI_RESULT_BYTES;
+    return result;
+}
+
+// 📺 16x2 LCD
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t addr, uint8_t cols, uint8_t rows)
+    : cols(cols > 40 ? 40 : cols), rows(rows > 4 ? 4 : rows), col(0), row(0) {
+    (void)addr;
+    memset(text, 0, sizeof(text));
+}
+
+void LiquidCrystal_I2C::init() {
+    clear();
+}
+
+void LiquidCrystal_I2C::clear() {
+    for (uint8_t r = 0; r < 4; r++) {
+        memset(text[r], ' ', cols);
+        text[r][cols] = 0;
+    }
+    col = row = 0;
+    simCountLcdBytes(SIM_LCD_BYTES_PER_CHAR);
+    simI2CTransfer(SIM_LCD_BYTES_PER_CHAR, SIM_LCD_I2C_HZ);
+    usleep(2000);  // HD44780 clear command execution time
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row) {
+    this->col = col;
+    this->row = row < rows ? row : rows - 1;
+    simCountLcdBytes(SIM_LCD_BYTES_PER_CHAR);
+    simI2CTransfer(SIM_LCD_BYTES_PER_CHAR, SIM_LCD_I2C_HZ);
+}
+
+void LiquidCrystal_I2C::createChar(uint8_t location, uint8_t charmap[]) {
+    (void)location; (void)charmap;
+    simCountLcdBytes(9 * SIM_LCD_BYTES_PER_CHAR);
+    simI2CTransfer(9 * SIM_LCD_BYTES_PER_CHAR, SIM_LCD_I2C_HZ);
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t c) {
+    if (col < cols) {
+        text[row][col] = (c >= 0x20 && c < 0x7F) ? (char)c : '#';
+    }
+    col++;
+    simCountLcdBytes(SIM_LCD_BYTES_PER_CHAR);
+    simI2CTransfer(SIM_LCD_BYTES_PER_CHAR, SIM_LCD_I2C_HZ);
+    return 1;
+}
+
+const char* LiquidCrystal_I2C::rowText(uint8_t row) const {
+    return row < rows ? text[row] : "";
+}
+
+// 🖥️ 128x64 SH1106 OLED
+SH1106Wire::SH1106Wire(uint8_t address, int sda, int scl, OLEDDISPLAY_GEOMETRY geometry,
+                       int bus, uint32_t frequency)
+    : address(address), frequency(frequency), color(WHITE), align(TEXT_ALIGN_LEFT),
+      font(ArialMT_Plain_10), inverted(false), textItems(0), shownTextCount(0) {
+    (void)sda; (void)scl; (void)geometry; (void)bus;
+}
+
+bool SH1106Wire::init() {
+    if (buffer == nullptr) {
+        buffer = (uint8_t*)malloc(SIM_OLED_WIDTH * SIM_OLED_HEIGHT / 8);
+        if (buffer == nullptr) return false;
+    }
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    if (buffer_back == nullptr) {
+        buffer_back = (uint8_t*)malloc(SIM_OLED_WIDTH * SIM_OLED_HEIGHT / 8);
+        if (buffer_back == nullptr) return false;
+    }
+    memset(buffer_back, 0, SIM_OLED_WIDTH * SIM_OLED_HEIGHT / 8);
+#endif
+    clear();
+    simI2CTransfer(32, frequency);  // Init command sequence
+    return true;
+}
+
+bool SH1106Wire::sameText(const TextItem& a, const TextItem& b) {
+    return a.x == b.x && a.y == b.y && strcmp(a.text, b.text) == 0;
+}
+
+void SH1106Wire::display() {
+    // SH1106 has no horizontal addressing mode: each page of the box costs
+    // 3 command transfers, its data goes out in 16-byte transfers
+    int minX = SIM_OLED_WIDTH, maxX = -1, minPage = SIM_OLED_HEIGHT / 8, maxPage = -1;
+    auto mark = [&](int x0, int x1, int y0, int y1) {
+        x0 = x0 < 0 ? 0 : x0;
+        x1 = x1 >= SIM_OLED_WIDTH ? SIM_OLED_WIDTH - 1 : x1;
+        y0 = y0 < 0 ? 0 : y0;
+        y1 = y1 >= SIM_OLED_HEIGHT ? SIM_OLED_HEIGHT - 1 : y1;
+        if (x0 > x1 || y0 > y1) return;
+        minX = std::min(minX, x0);
+        maxX = std::max(maxX, x1);
+        minPage = std::min(minPage, y0 / 8);
+        maxPage = std::max(maxPage, y1 / 8);
+    };
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+    for (int page = 0; page < SIM_OLED_HEIGHT / 8; page++) {
+        for (int x = 0; x < SIM_OLED_WIDTH; x++) {
+            int pos = x + page * SIM_OLED_WIDTH;
+            if (buffer[pos] != buffer_back[pos]) mark(x, x, page * 8, page * 8);
+        }
+    }
+    memcpy(buffer_back, buffer, SIM_OLED_WIDTH * SIM_OLED_HEIGHT / 8);
+    // Text items stand in for their glyphs: one that appeared, moved or
+    // changed marks its box, one that went away marks where it was
+    for (int pass = 0; pass < 2; pass++) {
+        const TextItem* from = pass ? shown : text;
+        const TextItem* other = pass ? text : shown;
+        uint8_t count = pass ? shownTextCount : textItems;
+        uint8_t otherCount = pass ? textItems : shownTextCount;
+        for (uint8_t i = 0; i < count; i++) {
+            bool kept = false;
+            for (uint8_t j = 0; j < otherCount && !kept; j++) kept = sameText(from[i], other[j]);
+            if (!kept) mark(from[i].x, from[i].x + from[i].width - 1, from[i].y, from[i].y + from[i].height - 1);
+        }
+    }
+#else
+    mark(0, SIM_OLED_WIDTH - 1, 0, SIM_OLED_HEIGHT - 1);
+#endif
+    memcpy(shown, text, sizeof(TextItem) * textItems);
+    shownTextCount = textItems;
+    simCountOledFrame();
+    if (maxX < 0) return;
+    uint32_t span = maxX - minX + 1;
+    uint32_t bytes = (maxPage - minPage + 1) * (3 * 2 + span + (span + 15) / 16);
+    simCountOledBytes(bytes);
+    simI2CTransfer(bytes, frequency);
+}
+
+void SH1106Wire::clear() {
+    memset(buffer, 0, SIM_OLED_WIDTH * SIM_OLED_HEIGHT / 8);
+    textItems = 0;
+}
+
+void SH1106Wire::invertDisplay() {
+    inverted = true;
+    simI2CTransfer(1, frequency);
+}
+
+void SH1106Wire::normalDisplay() {
+    inverted = false;
+    simI2CTransfer(1, frequency);
+}
+
+void SH1106Wire::setPixel(int16_t x, int16_t y) {
+    if (x < 0 || x >= SIM_OLED_WIDTH || y < 0 || y >= SIM_OLED_HEIGHT) return;
+    uint8_t& cell = buffer[x + (y / 8) * SIM_OLED_WIDTH];
+    uint8_t bit = 1 << (y & 7);
+    switch (color) {
+        case WHITE:   cell |= bit; break;
+        case BLACK:   cell &= ~bit; break;
+        case INVERSE: cell ^= bit; break;
+    }
+}
+
+void SH1106Wire::clearPixel(int16_t x, int16_t y) {
+    if (x < 0 || x >= SIM_OLED_WIDTH || y < 0 || y >= SIM_OLED_HEIGHT) return;
+    buffer[x + (y / 8) * SIM_OLED_WIDTH] &= ~(1 << (y & 7));
+}
+
+bool SH1106Wire::getPixel(int16_t x, int16_t y) const {
+    if (x < 0 || x >= SIM_OLED_WIDTH || y < 0 || y >= SIM_OLED_HEIGHT) return false;
+    return buffer[x + (y / 8) * SIM_OLED_WIDTH] & (1 << (y & 7));
+}
+
+void SH1106Wire::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    int16_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int16_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int16_t err = dx + dy;
+    for (;;) {
+        setPixel(x0, y0);
+        if (x0 == x1 && y0 == y1) break;
+        int16_t e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+void SH1106Wire::drawHorizontalLine(int16_t x, int16_t y, int16_t length) {
+    for (int16_t i = 0; i < length; i++) setPixel(x + i, y);
+}
+
+void SH1106Wire::drawVerticalLine(int16_t x, int16_t y, int16_t length) {
+    for (int16_t i = 0; i < length; i++) setPixel(x, y + i);
+}
+
+void SH1106Wire::drawRect(int16_t x, int16_t y, int16_t width, int16_t height) {
+    drawHorizontalLine(x, y, width);
+    drawHorizontalLine(x, y + height - 1, width);
+    drawVerticalLine(x, y, height);
+    drawVerticalLine(x + width - 1, y, height);
+}
+
+void SH1106Wire::fillRect(int16_t x, int16_t y, int16_t width, int16_t height) {
+    for (int16_t i = 0; i < width; i++) drawVerticalLine(x + i, y, height);
+}
+
+void SH1106Wire::drawCircle(int16_t x0, int16_t y0, int16_t radius) {
+    for (int16_t y = -radius; y <= radius; y++) {
+        for (int16_t x = -radius; x <= radius; x++) {
+            int16_t d = x * x + y * y;
+            if (d <= radius * radius && d > (radius - 1) * (radius - 1)) setPixel(x0 + x, y0 + y);
+        }
+    }
+}
+
+void SH1106Wire::fillCircle(int16_t x0, int16_t y0, int16_t radius) {
+    for (int16_t y = -radius; y <= radius; y++) {
+        for (int16_t x = -radius; x <= radius; x++) {
+            if (x * x + y * y <= radius * radius) setPixel(x0 + x, y0 + y);
+        }
+    }
+}
+
+void SH1106Wire::drawXbm(int16_t x, int16_t y, int16_t width, int16_t height, const uint8_t* xbm) {
+    int16_t rowBytes = (width + 7) / 8;
+    for (int16_t j = 0; j < height; j++) {
+        for (int16_t i = 0; i < width; i++) {
+            if (pgm_read_byte(xbm + j * rowBytes + i / 8) & (1 << (i & 7))) {
+                setPixel(x + i, y + j);
+            }
+        }
+    }
+}
+
+void SH1106Wire::drawString(int16_t x, int16_t y, const String& str) {
+    drawStringInternal(x, y, str.c_str(), str.length(), getStringWidth(str), true);
+}
+
+uint16_t SH1106Wire::drawStringInternal(int16_t x, int16_t y, const char* str, uint16_t length,
+                                        uint16_t width, bool utf8) {
+    (void)utf8;
+    if (textItems >= SIM_OLED_MAX_TEXT) return 0;
+    if (align == TEXT_ALIGN_CENTER || align == TEXT_ALIGN_CENTER_BOTH) {
+        x -= width / 2;
+    } else if (align == TEXT_ALIGN_RIGHT) {
+        x -= width;
+    }
+    TextItem& item = text[textItems++];
+    item.x = x;
+    item.y = y;
+    item.width = width;
+    item.height = font[1];
+    size_t copied = length < sizeof(item.text) - 1 ? length : sizeof(item.text) - 1;
+    memcpy(item.text, str, copied);
+    item.text[copied] = 0;
+    return length;
+}
+
+uint16_t SH1106Wire::getStringWidth(const String& str) const {
+    return getStringWidth(str.c_str(), str.length());
+}
+
+uint16_t SH1106Wire::getStringWidth(const char* str, uint16_t length, bool utf8) const {
+    // Proportional fonts average a bit over half their height per glyph
+    (void)str;
+    (void)utf8;
+    return (uint16_t)(length * (font[1] * 6 / 10));
+}
+
+const char* SH1106Wire::textAt(uint8_t i, int16_t* x, int16_t* y) const {
+    if (i >= shownTextCount) return nullptr;
+    if (x) *x = shown[i].x;
+    if (y) *y = shown[i].y;
+    return shown[i].text;
+}
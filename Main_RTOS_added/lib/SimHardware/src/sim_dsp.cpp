@@ -0,0 +1,94 @@
+#include "esp_dsp.h"
+
+#include <math.h>
+
+// 🧪 ESP-DSP reference kernels (radix-2 decimation in frequency, like dsps_fft2r)
+
+#define ESP_ERR_DSP_INVALID_LENGTH  0x70002
+#define ESP_ERR_DSP_UNINITIALIZED   0x70004
+
+static int fftMaxSize = 0;
+
+static bool isPowerOfTwo(int n) {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+esp_err_t dsps_fft2r_init_fc32(float* fft_table_buff, int table_size) {
+    (void)fft_table_buff;
+    if (!isPowerOfTwo(table_size) || table_size > CONFIG_DSP_MAX_FFT_SIZE) return ESP_ERR_DSP_INVALID_LENGTH;
+    fftMaxSize = table_size;
+    return ESP_OK;
+}
+
+void dsps_fft2r_deinit_fc32(void) {
+    fftMaxSize = 0;
+}
+
+esp_err_t dsps_fft2r_fc32(float* data, int N) {
+    if (!fftMaxSize) return ESP_ERR_DSP_UNINITIALIZED;
+    if (!isPowerOfTwo(N) || N > fftMaxSize) return ESP_ERR_DSP_INVALID_LENGTH;
+    for (int len = N; len >= 2; len >>= 1) {
+        int half = len / 2;
+        for (int j = 0; j < half; j++) {
+            float angle = -2.0f * (float)M_PI * j / len;
+            float wr = cosf(angle), wi = sinf(angle);
+            for (int i = j; i < N; i += len) {
+                float* a = &data[2 * i];
+                float* b = &data[2 * (i + half)];
+                float dr = a[0] - b[0], di = a[1] - b[1];
+                a[0] += b[0];
+                a[1] += b[1];
+                b[0] = dr * wr - di * wi;
+                b[1] = dr * wi + di * wr;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_bit_rev_fc32(float* data, int N) {
+    if (!isPowerOfTwo(N)) return ESP_ERR_DSP_INVALID_LENGTH;
+    for (int i = 1, j = 0; i < N; i++) {
+        int bit = N >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            float r = data[2 * i], im = data[2 * i + 1];
+            data[2 * i] = data[2 * j];
+            data[2 * i + 1] = data[2 * j + 1];
+            data[2 * j] = r;
+            data[2 * j + 1] = im;
+        }
+    }
+    return ESP_OK;
+}
+
+void dsps_wind_hann_f32(float* window, int len) {
+    for (int i = 0; i < len; i++) {
+        window[i] = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / (len - 1));
+    }
+}
+
+esp_err_t dsps_mul_f32(const float* input1, const float* input2, float* output, int len,
+                       int step1, int step2, int step_out) {
+    for (int i = 0; i < len; i++) {
+        output[i * step_out] = input1[i * step1] * input2[i * step2];
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_addc_f32(const float* input, float* output, int len, float C, int step_in, int step_out) {
+    for (int i = 0; i < len; i++) {
+        output[i * step_out] = input[i * step_in] + C;
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_dotprod_f32(const float* src1, const float* src2, float* dest, int len) {
+    float acc = 0;
+    for (int i = 0; i < len; i++) {
+        acc += src1[i] * src2[i];
+    }
+    *dest = acc;
+    return ESP_OK;
+}
@@ -0,0 +1,72 @@
+#include "esp_partition.h"
+
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+// 💾 Simulated SPI flash: erased bytes read 0xFF and programming can only
+// clear bits, as on the real part
+
+#define SIM_FLASH_SECTOR_SIZE  4096
+
+struct SimPartition {
+    esp_partition_t info;
+    std::vector<uint8_t> bytes;   // Allocated on first access
+};
+
+static SimPartition partitions[] = {
+    { { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x400000, 0x400000, "trace", false }, {} },
+    { { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x41, 0x800000, 0x40000, "alerts", false }, {} },
+};
+
+static std::mutex flashMutex;
+
+static SimPartition* lookup(const esp_partition_t* partition) {
+    for (SimPartition& p : partitions) {
+        if (&p.info == partition) {
+            if (p.bytes.empty()) p.bytes.assign(p.info.size, 0xFF);
+            return &p;
+        }
+    }
+    return nullptr;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+    for (SimPartition& p : partitions) {
+        if ((type == ESP_PARTITION_TYPE_ANY || p.info.type == type) &&
+            (subtype == ESP_PARTITION_SUBTYPE_ANY || p.info.subtype == subtype) &&
+            (label == nullptr || strcmp(label, p.info.label) == 0)) {
+            return &p.info;
+        }
+    }
+    return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size) {
+    std::lock_guard<std::mutex> lock(flashMutex);
+    SimPartition* p = lookup(partition);
+    if (!p || offset + size > p->info.size) return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, &p->bytes[offset], size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t size) {
+    std::lock_guard<std::mutex> lock(flashMutex);
+    SimPartition* p = lookup(partition);
+    if (!p || offset + size > p->info.size) return ESP_ERR_INVALID_SIZE;
+    const uint8_t* in = static_cast<const uint8_t*>(src);
+    for (size_t i = 0; i < size; i++) {
+        p->bytes[offset + i] &= in[i];
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+    std::lock_guard<std::mutex> lock(flashMutex);
+    SimPartition* p = lookup(partition);
+    if (!p || offset + size > p->info.size) return ESP_ERR_INVALID_SIZE;
+    if (offset % SIM_FLASH_SECTOR_SIZE || size % SIM_FLASH_SECTOR_SIZE) return ESP_ERR_INVALID_ARG;
+    memset(&p->bytes[offset], 0xFF, size);
+    return ESP_OK;
+}
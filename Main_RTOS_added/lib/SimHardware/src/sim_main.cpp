@@ -0,0 +1,268 @@
+#ifndef PIO_UNIT_TESTING
+
+#include <Arduino.h>
+#include "sim_hw.h"
+#include "config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+// 🧪 Host entry point: runs the unmodified setup()/loop() and the firmware
+// tasks against the simulated board while a scenario drives the inputs.
+//
+// Scenario lines:  <ms> <input> <value> [expect <output> <value>]
+//   inputs:  flame, ir, motion, distance, distance<n>, echofault, temp, humidity, next, prev, wifi
+//            (distance<n> = ultrasonic sensor n of ULTRASONIC_SENSORS, distance = sensor 0)
+//   outputs: relay, fan, servo, buzzer (buzzer value 1 = any tone)
+//   "<ms> end" closes one pass; --repeat replays the whole script.
+// Each "expect" measures stimulus-to-output latency across all passes.
+
+void setup();
+void loop();
+
+#define SIM_EXPECT_TIMEOUT_MS  5000
+
+static const char* const defaultScenario[] = {
+    "0     temp 22",
+    "0     humidity 45",
+    "0     distance 100",
+    "1000  flame 1      expect relay 1",
+    "4000  flame 0      expect relay 0",
+    "6000  distance 8   expect servo 180",
+    "7000  distance 100",
+    "11000 temp 30      expect fan 1",
+    "14500 temp 22      expect fan 0",
+    "17000 motion 1",
+    "19000 motion 0",
+    "21000 end",
+};
+
+struct ScenarioStep {
+    uint32_t atMs;
+    std::string input;
+    float value;
+    int expectOutput;     // SimOutput or -1
+    int expectValue;
+    std::string label;
+};
+
+struct ExpectStats {
+    std::string label;
+    std::vector<double> latencyMs;
+    uint32_t missed;
+};
+
+struct PendingExpect {
+    size_t statIndex;
+    SimOutput output;
+    int value;
+    uint64_t stimulusUs;
+};
+
+static std::mutex expectMutex;
+static std::vector<ExpectStats> expectStats;
+static std::vector<PendingExpect> pendingExpects;
+static std::atomic<bool> scenarioDone(false);
+
+static bool outputMatches(SimOutput output, int actual, int expected) {
+    if (output == SIM_OUT_BUZZER) {
+        return (actual != 0) == (expected != 0);
+    }
+    return actual == expected;
+}
+
+static void onOutput(SimOutput output, int value, uint64_t tUs) {
+    std::lock_guard<std::mutex> lock(expectMutex);
+    for (size_t i = 0; i < pendingExpects.size();) {
+        PendingExpect& p = pendingExpects[i];
+        if (p.output == output && outputMatches(output, value, p.value)) {
+            expectStats[p.statIndex].latencyMs.push_back((tUs - p.stimulusUs) / 1000.0);
+            pendingExpects.erase(pendingExpects.begin() + i);
+        } else {
+            i++;
+        }
+    }
+}
+
+static void expireExpects(uint64_t nowUs) {
+    std::lock_guard<std::mutex> lock(expectMutex);
+    for (size_t i = 0; i < pendingExpects.size();) {
+        if (nowUs - pendingExpects[i].stimulusUs > (uint64_t)SIM_EXPECT_TIMEOUT_MS * 1000) {
+            expectStats[pendingExpects[i].statIndex].missed++;
+            pendingExpects.erase(pendingExpects.begin() + i);
+        } else {
+            i++;
+        }
+    }
+}
+
+static int outputByName(const std::string& name) {
+    for (int i = 0; i < SIM_OUT_COUNT; i++) {
+        if (name == simOutputName((SimOutput)i)) return i;
+    }
+    return -1;
+}
+
+static bool parseStep(const char* line, ScenarioStep* step) {
+    char input[32], expectWord[16], output[32];
+    float value = 0;
+    int expectValue = 0;
+    unsigned atMs;
+    int fields = sscanf(line, "%u %31s %f %15s %31s %d", &atMs, input, &value, expectWord, output, &expectValue);
+    if (fields < 2) return false;
+    step->atMs = atMs;
+    step->input = input;
+    step->value = value;
+    step->expectOutput = -1;
+    if (fields == 6 && std::string(expectWord) == "expect") {
+        step->expectOutput = outputByName(output);
+        step->expectValue = expectValue;
+        char label[96];
+        snprintf(label, sizeof(label), "%s %g -> %s %d", input, value, output, expectValue);
+        step->label = label;
+    }
+    return step->input == "end" || fields >= 3;
+}
+
+static void applyInput(const ScenarioStep& step) {
+    const std::string& in = step.input;
+    if (in == "flame") simSetFlame(step.value != 0);
+    else if (in == "ir") simSetIrSource(step.value != 0);
+    else if (in == "motion") simSetMotion(step.value != 0);
+    else if (in == "distance") simSetDistanceCm(step.value);
+    else if (in.compare(0, 8, "distance") == 0) simSetSonarDistanceCm(atoi(in.c_str() + 8), step.value);
+    else if (in == "echofault") simSetEchoFaults((int)step.value);
+    else if (in == "temp" || in == "humidity") {
+        static float temp = 22, humidity = 45;
+        (in == "temp" ? temp : humidity) = step.value;
+        simSetClimate(temp, humidity);
+    }
+    else if (in == "next") simSetButton(BUTTON_NEXT, step.value != 0);
+    else if (in == "prev") simSetButton(BUTTON_PREV, step.value != 0);
+    else if (in == "wifi") simSetWiFiAvailable(step.value != 0);
+    else if (in == "dhcpip") simSetDhcpAddress((uint8_t)step.value);
+}
+
+static void runScenario(std::vector<ScenarioStep> steps, uint32_t repeat, uint32_t settleMs) {
+    usleep(settleMs * 1000);
+    for (uint32_t pass = 0; pass < repeat; pass++) {
+        uint64_t passStart = simMicros();
+        for (const ScenarioStep& step : steps) {
+            uint64_t due = passStart + (uint64_t)step.atMs * 1000;
+            while (simMicros() < due) {
+                expireExpects(simMicros());
+                usleep((useconds_t)std::min<uint64_t>(due - simMicros(), 10000));
+            }
+            if (step.input == "end") break;
+
+            if (step.expectOutput >= 0) {
+                std::lock_guard<std::mutex> lock(expectMutex);
+                size_t idx = 0;
+                while (idx < expectStats.size() && expectStats[idx].label != step.label) idx++;
+                if (idx == expectStats.size()) expectStats.push_back({ step.label, {}, 0 });
+                pendingExpects.push_back({ idx, (SimOutput)step.expectOutput, step.expectValue, simMicros() });
+            }
+            applyInput(step);
+        }
+    }
+    usleep(SIM_EXPECT_TIMEOUT_MS * 1000);
+    expireExpects(UINT64_MAX / 2);
+    scenarioDone = true;
+}
+
+static double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    size_t idx = (size_t)(p / 100.0 * (v.size() - 1) + 0.5);
+    return v[idx];
+}
+
+static void printReport(uint64_t runUs) {
+    SimBusStats bus;
+    simGetBusStats(&bus);
+    double runS = runUs / 1e6;
+
+    printf("\n=== 🧪 Simulation report (%.1f s) ===\n", runS);
+    printf("%-32s %6s %6s %9s %9s %9s\n", "stimulus -> output", "n", "miss", "p50 ms", "p95 ms", "max ms");
+    for (const ExpectStats& s : expectStats) {
+        printf("%-32s %6zu %6u %9.1f %9.1f %9.1f\n", s.label.c_str(), s.latencyMs.size(), s.missed,
+               percentile(s.latencyMs, 50), percentile(s.latencyMs, 95), percentile(s.latencyMs, 100));
+    }
+    printf("I2C busy: %.1f%% (%llu ms), OLED frames: %u (%.0f B/s sent), LCD bytes: %u\n",
+           runS > 0 ? bus.i2cBusyUs / 1e4 / runS : 0.0, (unsigned long long)(bus.i2cBusyUs / 1000),
+           bus.oledFrames, runS > 0 ? bus.oledBytes / runS : 0.0, bus.lcdBytes);
+    double serialLoad = (bus.serialBaud && runS > 0) ? bus.serialBytes * 10.0 / bus.serialBaud / runS * 100 : 0;
+    printf("Serial: %llu bytes at %u baud (%.0f%% of line time), DHT reads: %u, echo pulses: %u\n",
+           (unsigned long long)bus.serialBytes, bus.serialBaud, serialLoad, bus.dhtReads, bus.echoPulses);
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [--scenario FILE] [--repeat N] [--settle MS] [--blynk HOST:PORT]\n"
+            "          [--offline] [--quiet]\n", prog);
+}
+
+int main(int argc, char** argv) {
+    const char* scenarioPath = nullptr;
+    uint32_t repeat = 1;
+    uint32_t settleMs = 3000;
+    bool offline = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const char* next = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--scenario" && next) { scenarioPath = next; i++; }
+        else if (arg == "--repeat" && next) { repeat = (uint32_t)atoi(next); i++; }
+        else if (arg == "--settle" && next) { settleMs = (uint32_t)atoi(next); i++; }
+        else if (arg == "--blynk" && next) {
+            std::string hostPort = next;
+            size_t colon = hostPort.rfind(':');
+            std::string host = colon == std::string::npos ? hostPort : hostPort.substr(0, colon);
+            uint16_t port = colon == std::string::npos ? 8080 : (uint16_t)atoi(hostPort.c_str() + colon + 1);
+            simSetBlynkServer(host.c_str(), port);
+            i++;
+        }
+        else if (arg == "--offline") offline = true;
+        else if (arg == "--quiet") simSetSerialEcho(false);
+        else { usage(argv[0]); return 2; }
+    }
+
+    std::vector<ScenarioStep> steps;
+    if (scenarioPath) {
+        FILE* f = fopen(scenarioPath, "r");
+        if (!f) { perror(scenarioPath); return 1; }
+        char line[256];
+        while (fgets(line, sizeof(line), f)) {
+            ScenarioStep step;
+            if (line[0] != '#' && parseStep(line, &step)) steps.push_back(step);
+        }
+        fclose(f);
+    } else {
+        for (const char* line : defaultScenario) {
+            ScenarioStep step;
+            if (parseStep(line, &step)) steps.push_back(step);
+        }
+    }
+
+    simSetOutputHook(onOutput);
+    if (offline) simSetWiFiAvailable(false);
+
+    setup();
+    uint64_t scenarioStart = simMicros();
+    std::thread scenario(runScenario, steps, repeat, settleMs);
+    while (!scenarioDone) {
+        loop();
+    }
+    scenario.join();
+
+    printReport(simMicros() - scenarioStart);
+    fflush(stdout);
+    _exit(0);  // Firmware tasks never return
+}
+
+#endif // PIO_UNIT_TESTING
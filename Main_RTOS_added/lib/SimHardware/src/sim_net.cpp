@@ -0,0 +1,381 @@
+#include <Arduino.h>
+#include <WiFi.h>
+#include <Preferences.h>
+#include "sim_hw.h"
+#include "config.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// 🌐 Simulated access point and TCP stack
+// WiFi events are delivered from a dedicated thread, like the Arduino event
+// task on the ESP32. Every WiFiClient connects to the loopback Blynk server.
+
+#define SIM_REASON_ASSOC_LEAVE     8
+#define SIM_REASON_BEACON_TIMEOUT  200
+#define SIM_REASON_NO_AP_FOUND     201
+
+WiFiClass WiFi;
+
+static std::mutex wifiMutex;
+static std::condition_variable wifiCond;
+static bool apAvailable = true;
+static bool staConnected = false;
+static uint32_t fastConnectMs = 300;       // Known BSSID/channel, static lease
+static uint32_t fullConnectMs = 2500;      // Scan all channels + DHCP
+static uint32_t attemptSeq = 0;            // Invalidates a pending attempt
+static std::vector<WiFiEventFuncCb> eventHandlers;
+static std::thread eventThread;
+
+static std::string blynkHost = "127.0.0.1";
+static uint16_t blynkPort = 8080;
+
+static const uint8_t simBssid[6] = { 0x02, 0x53, 0x49, 0x4D, 0x41, 0x50 };
+static IPAddress leaseIP(192, 168, 4, 2);         // What the DHCP server hands out now
+static IPAddress staticIP = INADDR_NONE;           // WiFi.config(); INADDR_NONE = DHCP
+static const IPAddress simGateway(192, 168, 4, 1);
+static const IPAddress simSubnet(255, 255, 255, 0);
+
+struct PendingEvent {
+    uint64_t dueUs;
+    WiFiEvent_t event;
+    uint8_t reason;
+    uint32_t seq;        // 0 = not tied to an attempt
+};
+static std::vector<PendingEvent> pendingEvents;
+
+// Runs handlers outside wifiMutex so they may call back into WiFi
+static void dispatchEvent(WiFiEvent_t event, uint8_t reason) {
+    std::vector<WiFiEventFuncCb> handlers;
+    {
+        std::lock_guard<std::mutex> lock(wifiMutex);
+        handlers = eventHandlers;
+    }
+    WiFiEventInfo_t info = {};
+    info.wifi_sta_disconnected.reason = reason;
+    for (WiFiEventFuncCb cb : handlers) {
+        cb(event, info);
+    }
+}
+
+static void eventLoop() {
+    std::unique_lock<std::mutex> lock(wifiMutex);
+    for (;;) {
+        if (pendingEvents.empty()) {
+            wifiCond.wait(lock);
+            continue;
+        }
+        size_t next = 0;
+        for (size_t i = 1; i < pendingEvents.size(); i++) {
+            if (pendingEvents[i].dueUs < pendingEvents[next].dueUs) next = i;
+        }
+        uint64_t now = simMicros();
+        if (pendingEvents[next].dueUs > now) {
+            wifiCond.wait_for(lock, std::chrono::microseconds(pendingEvents[next].dueUs - now));
+            continue;
+        }
+        PendingEvent ev = pendingEvents[next];
+        pendingEvents.erase(pendingEvents.begin() + next);
+        if (ev.seq != 0 && ev.seq != attemptSeq) {
+            continue;  // Superseded by disconnect() or a newer begin()
+        }
+        if (ev.event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+            if (!apAvailable) {
+                ev.event = ARDUINO_EVENT_WIFI_STA_DISCONNECTED;
+                ev.reason = SIM_REASON_NO_AP_FOUND;
+            } else {
+                staConnected = true;
+            }
+        }
+        lock.unlock();
+        dispatchEvent(ev.event, ev.reason);
+        lock.lock();
+    }
+}
+
+// Caller holds wifiMutex. A static address the server has since given to
+// someone else gets no replies
+static bool addressRoutes() {
+    return (uint32_t)staticIP == 0 || staticIP == leaseIP;
+}
+
+// Caller holds wifiMutex
+static void postEvent(uint32_t delayMs, WiFiEvent_t event, uint8_t reason, uint32_t seq) {
+    if (!eventThread.joinable()) {
+        eventThread = std::thread(eventLoop);
+        eventThread.detach();
+    }
+    pendingEvents.push_back({ simMicros() + (uint64_t)delayMs * 1000, event, reason, seq });
+    wifiCond.notify_one();
+}
+
+void simSetWiFiAvailable(bool available) {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    apAvailable = available;
+    if (!available && staConnected) {
+        staConnected = false;
+        attemptSeq++;
+        postEvent(0, ARDUINO_EVENT_WIFI_STA_DISCONNECTED, SIM_REASON_BEACON_TIMEOUT, 0);
+    }
+}
+
+void simSetWiFiConnectDelay(uint32_t fastMs, uint32_t fullScanMs) {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    fastConnectMs = fastMs;
+    fullConnectMs = fullScanMs;
+}
+
+void simSetDhcpAddress(uint8_t host) {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    leaseIP = IPAddress(192, 168, 4, host);
+}
+
+void simSetBlynkServer(const char* host, uint16_t port) {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    blynkHost = host;
+    blynkPort = port;
+}
+
+// 📡 WiFiClass
+bool WiFiClass::mode(wifi_mode_t m) {
+    (void)m;
+    return true;
+}
+
+int WiFiClass::onEvent(WiFiEventFuncCb cb) {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    eventHandlers.push_back(cb);
+    return (int)eventHandlers.size();
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* pass, int32_t channel,
+                             const uint8_t* bssid, bool connect) {
+    (void)ssid; (void)pass;
+    if (!connect) return WL_DISCONNECTED;
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    staConnected = false;
+    uint32_t seq = ++attemptSeq;
+    bool fast = channel > 0 && bssid != nullptr;
+    postEvent(fast ? fastConnectMs : fullConnectMs, ARDUINO_EVENT_WIFI_STA_GOT_IP, 0, seq);
+    return WL_DISCONNECTED;
+}
+
+bool WiFiClass::config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1) {
+    (void)gateway; (void)subnet; (void)dns1;
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    bool dhcpRestart = staConnected && (uint32_t)staticIP != 0 && (uint32_t)local == 0;
+    staticIP = local;
+    if (dhcpRestart) {
+        // Back to DHCP on a live association: the client binds a lease shortly
+        postEvent(fastConnectMs, ARDUINO_EVENT_WIFI_STA_GOT_IP, 0, attemptSeq);
+    }
+    return true;
+}
+
+bool WiFiClass::disconnect(bool wifiOff) {
+    (void)wifiOff;
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    bool wasConnected = staConnected;
+    staConnected = false;
+    attemptSeq++;
+    if (wasConnected) {
+        postEvent(0, ARDUINO_EVENT_WIFI_STA_DISCONNECTED, SIM_REASON_ASSOC_LEAVE, 0);
+    }
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    return staConnected ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+String WiFiClass::SSID() { return String(WIFI_SSID); }
+uint8_t* WiFiClass::BSSID() { return const_cast<uint8_t*>(simBssid); }
+int32_t WiFiClass::channel() { return 6; }
+int8_t WiFiClass::RSSI() { return -55; }
+IPAddress WiFiClass::localIP() {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    if (!staConnected) return INADDR_NONE;
+    return (uint32_t)staticIP != 0 ? staticIP : leaseIP;
+}
+IPAddress WiFiClass::gatewayIP() { return simGateway; }
+IPAddress WiFiClass::subnetMask() { return simSubnet; }
+IPAddress WiFiClass::dnsIP(uint8_t index) { (void)index; return simGateway; }
+
+// 🔌 WiFiClient (real TCP socket to the loopback server)
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    (void)ip;
+    return connect("", port);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    (void)host; (void)port;
+    stop();
+    std::string targetHost;
+    uint16_t targetPort;
+    {
+        std::lock_guard<std::mutex> lock(wifiMutex);
+        if (!staConnected) return 0;
+        if (!addressRoutes()) return 0;
+        targetHost = blynkHost;
+        targetPort = blynkPort;
+    }
+
+    struct addrinfo hints = {};
+    struct addrinfo* res = nullptr;
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    char portStr[8];
+    snprintf(portStr, sizeof(portStr), "%u", targetPort);
+    if (getaddrinfo(targetHost.c_str(), portStr, &hints, &res) != 0 || res == nullptr) {
+        return 0;
+    }
+    int fd = ::socket(res->ai_family, res->ai_socktype | SOCK_CLOEXEC, res->ai_protocol);
+    if (fd >= 0 && ::connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) return 0;
+
+    sock = fd;
+    setNoDelay(true);
+    return 1;
+}
+
+int WiFiClient::setNoDelay(bool nodelay) {
+    int one = nodelay ? 1 : 0;
+    return sock >= 0 ? setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) : -1;
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+    if (!connected()) return 0;
+    ssize_t n = ::send(sock, buf, size, MSG_NOSIGNAL);
+    return n > 0 ? (size_t)n : 0;
+}
+
+int WiFiClient::available() {
+    if (sock < 0) return 0;
+    int count = 0;
+    if (ioctl(sock, FIONREAD, &count) != 0) return 0;
+    return count;
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+    if (sock < 0) return -1;
+    ssize_t n = ::recv(sock, buf, size, MSG_DONTWAIT);
+    return n > 0 ? (int)n : -1;
+}
+
+size_t WiFiClient::readBytes(char* buf, size_t length) {
+    size_t got = 0;
+    uint64_t deadline = simMicros() + (uint64_t)timeoutMs * 1000;
+    while (got < length && sock >= 0) {
+        uint64_t now = simMicros();
+        if (now >= deadline) break;
+        struct pollfd pfd = { sock, POLLIN, 0 };
+        if (poll(&pfd, 1, (int)((deadline - now + 999) / 1000)) <= 0) continue;
+        ssize_t n = ::recv(sock, buf + got, length - got, 0);
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    return got;
+}
+
+void WiFiClient::stop() {
+    if (sock >= 0) {
+        ::close(sock);
+        sock = -1;
+    }
+}
+
+uint8_t WiFiClient::connected() {
+    if (sock < 0) return 0;
+    {
+        std::lock_guard<std::mutex> lock(wifiMutex);
+        if (!staConnected || !addressRoutes()) return 0;
+    }
+    uint8_t probe;
+    ssize_t n = ::recv(sock, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) return 0;  // Peer closed
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return 0;
+    return 1;
+}
+
+// 💾 Preferences (in-memory NVS)
+typedef std::map<std::string, std::vector<uint8_t>> NvsNamespace;
+static std::mutex nvsMutex;
+static std::map<std::string, NvsNamespace> nvs;
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    ns = name;
+    this->readOnly = readOnly;
+    opened = true;
+    return true;
+}
+
+void Preferences::end() {
+    opened = false;
+}
+
+bool Preferences::clear() {
+    if (!opened || readOnly) return false;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    nvs[ns.c_str()].clear();
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!opened || readOnly) return false;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return nvs[ns.c_str()].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!opened) return false;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    return nvs[ns.c_str()].count(key) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (!opened || readOnly) return 0;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    nvs[ns.c_str()][key].assign(bytes, bytes + len);
+    return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    if (!opened) return 0;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    NvsNamespace& space = nvs[ns.c_str()];
+    NvsNamespace::iterator it = space.find(key);
+    if (it == space.end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!opened) return 0;
+    std::lock_guard<std::mutex> lock(nvsMutex);
+    NvsNamespace& space = nvs[ns.c_str()];
+    NvsNamespace::iterator it = space.find(key);
+    return it == space.end() ? 0 : it->second.size();
+}
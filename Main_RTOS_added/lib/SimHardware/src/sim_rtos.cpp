@@ -0,0 +1,583 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "sim_hw.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string.h>
+#include <time.h>
+
+// 🧵 FreeRTOS on pthreads
+// Blocking calls map to condition variables with steady_clock deadlines, so
+// queue/notification latencies seen by the firmware are real host latencies.
+
+struct SimTask {
+    std::string name;
+    UBaseType_t priority;
+    BaseType_t coreId;
+    uint32_t stackDepth;
+    TaskFunction_t code;
+    void* param;
+    pthread_t thread;
+    bool started = false;
+
+    std::mutex notifyMutex;
+    std::condition_variable notifyCond;
+    uint32_t notifyValue = 0;
+    bool notifyPending = false;
+};
+
+struct SimQueue {
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::vector<uint8_t> storage;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head = 0;
+    UBaseType_t count = 0;
+};
+
+static std::mutex tasksMutex;
+static std::vector<SimTask*> tasks;
+static thread_local SimTask* currentTask = nullptr;
+static thread_local bool inIsr = false;
+static SimRtosTraceHook rtosTraceHook = nullptr;
+
+// Arduino runs setup()/loop() in "loopTask" on core 1
+static SimTask loopTask = { "loopTask", 1, 1, 8192, nullptr, nullptr };
+
+static SimTask* selfTask();
+
+static void traceRtos(SimRtosEvent event, void* object, const char* name = nullptr) {
+    if (rtosTraceHook) {
+        rtosTraceHook(event, object, name);
+    }
+}
+
+typedef std::chrono::steady_clock::time_point Deadline;
+
+static Deadline deadlineAfter(TickType_t ticks) {
+    return std::chrono::steady_clock::now() + std::chrono::milliseconds(ticks * portTICK_PERIOD_MS);
+}
+
+// Waits on cond until pred() holds; portMAX_DELAY waits forever.
+// A wait that actually blocks is traced as the task switching out and back in.
+template <typename Pred>
+static bool waitFor(std::condition_variable& cond, std::unique_lock<std::mutex>& lock,
+                    TickType_t ticks, Pred pred) {
+    if (pred()) {
+        return true;
+    }
+    if (ticks == 0) {
+        return false;
+    }
+    traceRtos(SIM_RTOS_TASK_OUT, selfTask());
+    bool got = true;
+    if (ticks == portMAX_DELAY) {
+        cond.wait(lock, pred);
+    } else {
+        got = cond.wait_until(lock, deadlineAfter(ticks), pred);
+    }
+    traceRtos(SIM_RTOS_TASK_IN, selfTask());
+    return got;
+}
+
+static SimTask* selfTask() {
+    return currentTask ? currentTask : &loopTask;
+}
+
+void simSetIsrContext(bool active) {
+    inIsr = active;
+}
+
+void simSetRtosTraceHook(SimRtosTraceHook hook) {
+    rtosTraceHook = hook;
+    if (!hook) {
+        return;
+    }
+    hook(SIM_RTOS_TASK_CREATE, &loopTask, loopTask.name.c_str());
+    std::lock_guard<std::mutex> lock(tasksMutex);
+    for (SimTask* task : tasks) {
+        hook(SIM_RTOS_TASK_CREATE, task, task->name.c_str());
+    }
+}
+
+// ⚙️ Port layer
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    pthread_mutex_lock(&mux->mutex);
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    pthread_mutex_unlock(&mux->mutex);
+}
+
+BaseType_t xPortGetCoreID(void) {
+    BaseType_t core = selfTask()->coreId;
+    return core == tskNO_AFFINITY ? 0 : core;
+}
+
+BaseType_t xPortInIsrContext(void) {
+    return inIsr ? pdTRUE : pdFALSE;
+}
+
+// 📋 Tasks
+static void* taskEntry(void* arg) {
+    SimTask* task = static_cast<SimTask*>(arg);
+    currentTask = task;
+    pthread_setname_np(pthread_self(), task->name.substr(0, 15).c_str());
+    traceRtos(SIM_RTOS_TASK_IN, task);
+    task->code(task->param);
+    return nullptr;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* created,
+                                   BaseType_t coreId) {
+    SimTask* task = new SimTask();
+    task->name = name ? name : "";
+    task->priority = priority;
+    task->coreId = coreId;
+    task->stackDepth = stackDepth;
+    task->code = code;
+    task->param = param;
+
+    pthread_t thread;
+    if (pthread_create(&thread, nullptr, taskEntry, task) != 0) {
+        delete task;
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+    task->thread = thread;
+    task->started = true;
+
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        tasks.push_back(task);
+    }
+    traceRtos(SIM_RTOS_TASK_CREATE, task, task->name.c_str());
+    if (created) {
+        *created = task;
+    }
+    return pdPASS;
+}
+
+// Static variants: the stack and TCB buffers are accepted but host threads
+// keep their own, so the firmware's static layout only matters on the target
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                          void* param, UBaseType_t priority, StackType_t* stackBuffer,
+                                          StaticTask_t* taskBuffer, BaseType_t coreId) {
+    if (stackBuffer == nullptr || taskBuffer == nullptr) {
+        return nullptr;
+    }
+    TaskHandle_t task = nullptr;
+    xTaskCreatePinnedToCore(code, name, stackDepth, param, priority, &task, coreId);
+    return task;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr || task == currentTask) {
+        pthread_exit(nullptr);
+    }
+    // Deleting another task is not supported on the host; it keeps running
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (ticks == 0) {
+        std::this_thread::yield();
+        return;
+    }
+    traceRtos(SIM_RTOS_TASK_OUT, selfTask());
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+    traceRtos(SIM_RTOS_TASK_IN, selfTask());
+}
+
+BaseType_t xTaskDelayUntil(TickType_t* previousWake, TickType_t increment) {
+    TickType_t wakeAt = *previousWake + increment;
+    TickType_t now = xTaskGetTickCount();
+    *previousWake = wakeAt;
+    if ((int32_t)(wakeAt - now) <= 0) {
+        return pdFALSE;  // Already late: no delay, like FreeRTOS
+    }
+    vTaskDelay(wakeAt - now);
+    return pdTRUE;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(simMicros() / (1000 * portTICK_PERIOD_MS));
+}
+
+TickType_t xTaskGetTickCountFromISR(void) {
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return selfTask();
+}
+
+char* pcTaskGetName(TaskHandle_t task) {
+    return const_cast<char*>((task ? task : selfTask())->name.c_str());
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+    return (task ? task : selfTask())->priority;
+}
+
+BaseType_t xTaskGetAffinity(TaskHandle_t task) {
+    return (task ? task : selfTask())->coreId;
+}
+
+uint64_t simTaskCpuTimeUs(void* handle) {
+    SimTask* task = static_cast<SimTask*>(handle);
+    clockid_t clock;
+    struct timespec ts;
+    if (!task || !task->started || pthread_getcpuclockid(task->thread, &clock) != 0 ||
+        clock_gettime(clock, &ts) != 0) {
+        return 0;
+    }
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+UBaseType_t uxTaskGetNumberOfTasks(void) {
+    std::lock_guard<std::mutex> lock(tasksMutex);
+    return (UBaseType_t)tasks.size() + 1;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return (task ? task : selfTask())->stackDepth;
+}
+
+// 🔔 Task notifications
+static BaseType_t notifyTask(SimTask* task, uint32_t value, eNotifyAction action) {
+    BaseType_t result = pdPASS;
+    {
+        std::lock_guard<std::mutex> lock(task->notifyMutex);
+        switch (action) {
+            case eSetBits:
+                task->notifyValue |= value;
+                break;
+            case eIncrement:
+                task->notifyValue++;
+                break;
+            case eSetValueWithOverwrite:
+                task->notifyValue = value;
+                break;
+            case eSetValueWithoutOverwrite:
+                if (task->notifyPending) {
+                    result = pdFAIL;
+                } else {
+                    task->notifyValue = value;
+                }
+                break;
+            case eNoAction:
+                break;
+        }
+        task->notifyPending = true;
+    }
+    task->notifyCond.notify_one();
+    return result;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+    return notifyTask(task, value, action);
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action,
+                              BaseType_t* higherPriorityTaskWoken) {
+    if (higherPriorityTaskWoken) {
+        *higherPriorityTaskWoken = pdFALSE;
+    }
+    return notifyTask(task, value, action);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit,
+                           uint32_t* value, TickType_t ticksToWait) {
+    SimTask* task = selfTask();
+    std::unique_lock<std::mutex> lock(task->notifyMutex);
+    if (!task->notifyPending) {
+        task->notifyValue &= ~clearOnEntry;
+    }
+    bool got = waitFor(task->notifyCond, lock, ticksToWait, [task] { return task->notifyPending; });
+    if (value) {
+        *value = task->notifyValue;
+    }
+    if (!got) {
+        return pdFALSE;
+    }
+    task->notifyPending = false;
+    task->notifyValue &= ~clearOnExit;
+    return pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+    SimTask* task = selfTask();
+    std::unique_lock<std::mutex> lock(task->notifyMutex);
+    waitFor(task->notifyCond, lock, ticksToWait, [task] { return task->notifyValue != 0; });
+    uint32_t value = task->notifyValue;
+    if (value != 0) {
+        task->notifyValue = clearOnExit ? 0 : value - 1;
+    }
+    task->notifyPending = false;
+    return value;
+}
+
+// 📬 Queues and semaphores
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    if (length == 0) {
+        return nullptr;
+    }
+    SimQueue* queue = new SimQueue();
+    queue->length = length;
+    queue->itemSize = itemSize;
+    queue->storage.resize((size_t)length * itemSize);
+    traceRtos(SIM_RTOS_QUEUE_CREATE, queue);
+    return queue;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize,
+                                 uint8_t* storage, StaticQueue_t* queueBuffer) {
+    if (queueBuffer == nullptr || (itemSize != 0 && storage == nullptr)) {
+        return nullptr;
+    }
+    return xQueueCreate(length, itemSize);
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    delete queue;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->head = 0;
+        queue->count = 0;
+    }
+    queue->notFull.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait, BaseType_t position) {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (position == queueOVERWRITE && queue->count == queue->length) {
+        queue->count--;  // Only valid for length-1 queues, as in FreeRTOS
+    }
+    if (queue->count == queue->length && ticksToWait != 0) {
+        traceRtos(SIM_RTOS_BLOCKING_ON_SEND, queue);
+    }
+    if (!waitFor(queue->notFull, lock, ticksToWait, [queue] { return queue->count < queue->length; })) {
+        traceRtos(SIM_RTOS_QUEUE_SEND_FAILED, queue);
+        return errQUEUE_FULL;
+    }
+    traceRtos(SIM_RTOS_QUEUE_SEND, queue);
+
+    UBaseType_t slot;
+    if (position == queueSEND_TO_FRONT) {
+        queue->head = (queue->head + queue->length - 1) % queue->length;
+        slot = queue->head;
+    } else {
+        slot = (queue->head + queue->count) % queue->length;
+    }
+    if (queue->itemSize && item) {
+        memcpy(&queue->storage[(size_t)slot * queue->itemSize], item, queue->itemSize);
+    }
+    queue->count++;
+    lock.unlock();
+    queue->notEmpty.notify_one();
+    return pdPASS;
+}
+
+static BaseType_t queueTake(QueueHandle_t queue, void* item, TickType_t ticksToWait, bool remove) {
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (queue->count == 0 && ticksToWait != 0) {
+        traceRtos(SIM_RTOS_BLOCKING_ON_RECEIVE, queue);
+    }
+    if (!waitFor(queue->notEmpty, lock, ticksToWait, [queue] { return queue->count > 0; })) {
+        traceRtos(SIM_RTOS_QUEUE_RECEIVE_FAILED, queue);
+        return pdFALSE;
+    }
+    traceRtos(remove ? SIM_RTOS_QUEUE_RECEIVE : SIM_RTOS_QUEUE_PEEK, queue);
+    if (queue->itemSize && item) {
+        memcpy(item, &queue->storage[(size_t)queue->head * queue->itemSize], queue->itemSize);
+    }
+    if (!remove) {
+        lock.unlock();
+        queue->notEmpty.notify_one();  // Let other peekers/receivers see it too
+        return pdTRUE;
+    }
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    lock.unlock();
+    queue->notFull.notify_one();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait) {
+    return queueTake(queue, item, ticksToWait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t ticksToWait) {
+    return queueTake(queue, item, ticksToWait, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->length - queue->count;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    SemaphoreHandle_t sem = xQueueCreate(1, 0);
+    sem->count = 1;  // Mutexes start available
+    traceRtos(SIM_RTOS_MUTEX_CREATE, sem);
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    SemaphoreHandle_t sem = xQueueCreate(1, 0);
+    traceRtos(SIM_RTOS_SEMAPHORE_CREATE, sem);
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+    SemaphoreHandle_t sem = xQueueCreate(maxCount, 0);
+    if (sem) {
+        sem->count = initialCount;
+        traceRtos(SIM_RTOS_SEMAPHORE_CREATE, sem);
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* mutexBuffer) {
+    return mutexBuffer ? xSemaphoreCreateMutex() : nullptr;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t* semaphoreBuffer) {
+    return semaphoreBuffer ? xSemaphoreCreateBinary() : nullptr;
+}
+
+// ⏲️ esp_timer
+// One dispatcher task runs every due callback in deadline order; periodic
+// timers keep their grid (no skipped events), as on the target.
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    uint64_t periodUs;   // 0 = one-shot
+    uint64_t dueUs;
+    bool armed = false;
+};
+
+static std::mutex timerMutex;
+static std::condition_variable timerCond;
+static std::vector<esp_timer*> timers;
+static bool timerTaskStarted = false;
+
+static void timerTaskMain(void*) {
+    std::unique_lock<std::mutex> lock(timerMutex);
+    for (;;) {
+        esp_timer* next = nullptr;
+        for (esp_timer* t : timers) {
+            if (t->armed && (!next || t->dueUs < next->dueUs)) next = t;
+        }
+        if (!next) {
+            timerCond.wait(lock);
+            continue;
+        }
+        uint64_t now = simMicros();
+        if (next->dueUs > now) {
+            timerCond.wait_for(lock, std::chrono::microseconds(next->dueUs - now));
+            continue;   // Re-scan: the set may have changed
+        }
+        if (next->periodUs) {
+            next->dueUs += next->periodUs;
+        } else {
+            next->armed = false;
+        }
+        esp_timer_cb_t callback = next->callback;
+        void* arg = next->arg;
+        lock.unlock();
+        callback(arg);
+        lock.lock();
+    }
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+    if (!args || !args->callback || !out) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_timer* timer = new esp_timer();
+    timer->callback = args->callback;
+    timer->arg = args->arg;
+    bool startTask;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        timers.push_back(timer);
+        startTask = !timerTaskStarted;
+        timerTaskStarted = true;
+    }
+    if (startTask) {
+        xTaskCreatePinnedToCore(timerTaskMain, "esp_timer", 4096, nullptr, 22, nullptr, 0);
+    }
+    *out = timer;
+    return ESP_OK;
+}
+
+static esp_err_t startTimer(esp_timer_handle_t timer, uint64_t afterUs, uint64_t periodUs) {
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        if (timer->armed) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        timer->periodUs = periodUs;
+        timer->dueUs = simMicros() + afterUs;
+        timer->armed = true;
+    }
+    timerCond.notify_one();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+    return startTimer(timer, timeoutUs, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+    return startTimer(timer, periodUs, periodUs);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    std::lock_guard<std::mutex> lock(timerMutex);
+    if (!timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    std::lock_guard<std::mutex> lock(timerMutex);
+    if (timer->armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (size_t i = 0; i < timers.size(); i++) {
+        if (timers[i] == timer) {
+            timers.erase(timers.begin() + i);
+            break;
+        }
+    }
+    delete timer;
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time(void) {
+    return (int64_t)simMicros();
+}
@@ -1,64 +1,76 @@
 #include "actuators.h"
 #include "sensors.h"
 #include "system.h"
+#include "servo_motion.h"
+#include "fan_control.h"
+
+// ⚡ Actuator state
+// Fan (fan_control) and servo (servo_motion) only write their outputs when
+// they change. The task handle is only set once, by TaskActuators itself.
+static TaskHandle_t actuatorTask = nullptr;
+static uint32_t wakeCount = 0;
 
 void initActuators() {
     // Set pin modes for actuators
-    pinMode(FAN_PIN, OUTPUT);
     // BUZZER_PIN initialization handled by audio.cpp to avoid conflicts
     pinMode(RELAY_PIN, OUTPUT);
     
-    // Initialize servo
-    myServo.attach(SERVO_PIN);
+    // Initialize servo (parked closed, moved by profiles from here on)
+    initServoMotion();
     
-    // Initialize all actuators to OFF state
-    turnOffFan();
+    // Initialize all actuators to OFF state (fan PWM starts at 0)
+    initFanControl();
     // turnOffBuzzer(); // Buzzer handled by audio.cpp
     deactivateRelay();
 }
 
-void controlFan(int temperature, int humidity) {
-    if (temperature > TEMP_THRESHOLD || humidity > HUMIDITY_THRESHOLD || AC) {
-        turnOnFan();
-    } else {
-        turnOffFan();
-    }
+// 🔔 Event-driven wakeups
+void attachActuatorTask() {
+    actuatorTask = xTaskGetCurrentTaskHandle();
 }
 
-void turnOnFan() {
-    digitalWrite(FAN_PIN, HIGH);
+void notifyActuators(uint32_t bits) {
+    if (actuatorTask) {
+        xTaskNotify(actuatorTask, bits, eSetBits);
+    }
 }
 
-void turnOffFan() {
-    digitalWrite(FAN_PIN, LOW);
+// Open servo: time left until its close deadline, UINT32_MAX when closed
+static uint32_t servoCloseDueInMs() {
+    if (getServoGoal() != SERVO_GOAL_OPEN) return UINT32_MAX;
+    unsigned long held = millis() - lastTime;
+    return held >= SERVO_DELAY ? 0 : SERVO_DELAY - held;
 }
 
-void initServo() {
-    myServo.attach(SERVO_PIN);
-}
+uint32_t waitActuatorEvents() {
+    // Wake at the next deadline (servo close, fan loop step) even if nothing is posted
+    uint32_t waitMs = min(servoCloseDueInMs(), fanControlDueInMs(millis()));
+    TickType_t timeout = waitMs == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(waitMs) + 1;
 
-void moveServo() {
-    // Get distance from sensor data queue
-    SensorData latest{};
-    if (xQueuePeek(sensorDataQueue, &latest, 0) == pdTRUE) {
-        if (latest.distanceCm <= DISTANCE_THRESHOLD) {
-            degree = 180;
-            lastTime = millis();
-        }
+    uint32_t bits = ACT_EVT_NONE;
+    xTaskNotifyWait(0, ACT_EVT_ALL, &bits, timeout);
+    if (servoCloseDueInMs() == 0) bits |= ACT_EVT_SERVO_DUE;
+    if (fanControlDueInMs(millis()) == 0) bits |= ACT_EVT_FAN_DUE;
+    wakeCount++;
+    return bits;
+}
 
-        if (millis() - lastTime >= SERVO_DELAY) {
-            degree = 0;
-        }
+uint32_t getActuatorWakeCount() {
+    return wakeCount;
+}
 
-        myServo.write(degree);
-        // Non-blocking: removed delay(15)
-    }
+void controlFan(int temperature, int humidity) {
+    updateFanControl(temperature, humidity, AC, millis());
 }
 
-void setServoPosition(int position) {
-    degree = position;
-    myServo.write(degree);
-    // Non-blocking: removed delay(15)
+// Goals only: a sighting while the door closes reverses it mid-motion
+void moveServo(int distanceCm) {
+    if (distanceCm <= DISTANCE_THRESHOLD) {
+        lastTime = millis();
+        setServoGoal(SERVO_GOAL_OPEN);
+    } else if (millis() - lastTime >= SERVO_DELAY) {
+        setServoGoal(SERVO_GOAL_CLOSE);
+    }
 }
 
 void activateRelay() {
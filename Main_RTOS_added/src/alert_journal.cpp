@@ -0,0 +1,404 @@
+#include "alert_journal.h"
+#include "esp_partition.h"
+#include "esp_timer.h"
+#include "mem_placement.h"
+
+// 🗒️ Alert Journal
+// Record seq is written to slot seq % totalSlots of the partition, so the
+// sector of a record, and the sector the writer enters next, follow from
+// the sequence number alone. recent[seq % ALERT_JOURNAL_RECENT] holds the
+// newest records; those from flushedSeq on are not on flash yet. A sector
+// being erased reads back as erased records, which every reader skips, so
+// readers need no lock against the writer (TaskSystemMonitor).
+// Records pushed out of RAM before the flush leave their slots to type 0
+// fillers, so the programmed part of a sector always is a prefix.
+
+#define JOURNAL_PARTITION_LABEL    "alerts"
+#define JOURNAL_PARTITION_SUBTYPE  0x41     // Custom data subtype, see partitions_trace.csv
+#define JOURNAL_SECTOR_SIZE        4096     // Flash erase unit
+#define JOURNAL_SECTOR_SLOTS       (JOURNAL_SECTOR_SIZE / sizeof(AlertRecord))
+#define JOURNAL_MAX_SECTORS        64       // Index entries; a bigger partition is used up to this
+#define JOURNAL_ERASED             0xFFFFFFFFu
+
+#define JOURNAL_EXPORT_PREFIX      "#A:"
+#define JOURNAL_EXPORT_VERSION     1
+
+static_assert(sizeof(AlertRecord) == 16, "AlertRecord must stay 16 bytes (256 per sector)");
+static_assert(ALERT_JOURNAL_BATCH * sizeof(AlertRecord) <= 256, "A batch must fit one flash page");
+static_assert(ALERT_JOURNAL_RECENT >= ALERT_JOURNAL_BATCH, "The RAM ring must hold a whole batch");
+
+static const esp_partition_t* journalPartition = nullptr;
+static uint32_t sectors = 0;
+static uint32_t totalSlots = 0;
+static uint32_t sectorSeq[JOURNAL_MAX_SECTORS];    // First slot's seq, JOURNAL_ERASED if unused
+static uint32_t sectorTime[JOURNAL_MAX_SECTORS];   // Its time: the sparse index
+static uint32_t openSectorSeq = JOURNAL_ERASED;    // Sector the writer is filling
+static uint32_t writtenSeq = 0;                    // Next slot the writer programs
+
+static AlertRecord recent[ALERT_JOURNAL_RECENT];
+static AlertRecord staging[ALERT_JOURNAL_BATCH];   // Flash write source
+static uint32_t nextSeq = 0;                       // Next record added
+static uint32_t flushedSeq = 0;                    // First record not on flash yet
+static uint32_t firstSeq = 0;                      // Oldest record still on flash
+static uint32_t pendingSinceMs = 0;                // When recent[flushedSeq] was added
+static uint32_t timeBaseS = 0;
+static uint16_t bootCount = 1;
+static portMUX_TYPE journalMux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t added = 0;
+static uint32_t dropped = 0;                       // Pushed out of RAM before the flush
+static uint32_t pageWrites = 0;
+static uint32_t erases = 0;
+
+static bool exportRequested = false;
+static bool exportActive = false;
+static uint32_t exportRecords = 0;
+static uint32_t exportCursor = 0;
+static uint32_t exportEnd = 0;
+static uint32_t exportLines = 0;
+
+static const char* const TYPE_NAMES[ALERT_TYPES] = {"?", "Fire", "Fire clear", "Thief", "Thief clear", "Relay reset"};
+
+const char* alertTypeName(uint8_t type) {
+    return type < ALERT_TYPES ? TYPE_NAMES[type] : TYPE_NAMES[0];
+}
+
+// 🔒 Record checks
+static uint8_t recordCheck(const AlertRecord* r) {
+    const uint8_t* p = (const uint8_t*)r;
+    uint8_t c = 0xA5;                    // An all-zero record does not pass
+    for (size_t i = 0; i < sizeof(AlertRecord); i++) {
+        if (i == offsetof(AlertRecord, check)) continue;
+        c = (uint8_t)(((c << 1) | (c >> 7)) ^ p[i]);
+    }
+    return c;
+}
+
+// Programmed completely: an alert, or a filler (type 0) standing in for dropped ones
+static bool intactRecord(const AlertRecord* r) {
+    return r->seq != JOURNAL_ERASED && r->check == recordCheck(r);
+}
+
+static bool validRecord(const AlertRecord* r) {
+    return intactRecord(r) && r->type > 0 && r->type < ALERT_TYPES;
+}
+
+static uint32_t slotOffset(uint32_t seq) {
+    return (seq % totalSlots) * sizeof(AlertRecord);
+}
+
+static bool readSlot(uint32_t seq, AlertRecord* out) {
+    if (esp_partition_read(journalPartition, slotOffset(seq), out, sizeof(*out)) != ESP_OK) return false;
+    return out->seq == seq && intactRecord(out);
+}
+
+static bool readFlash(uint32_t seq, AlertRecord* out) {
+    return readSlot(seq, out) && validRecord(out);
+}
+
+static uint32_t oldestSeq() {
+    if (journalPartition) return firstSeq;
+    return nextSeq > ALERT_JOURNAL_RECENT ? nextSeq - ALERT_JOURNAL_RECENT : 0;
+}
+
+// RAM ring first, then flash
+static bool readRecord(uint32_t seq, AlertRecord* out) {
+    portENTER_CRITICAL(&journalMux);
+    bool inRam = seq < nextSeq && nextSeq - seq <= ALERT_JOURNAL_RECENT;
+    if (inRam) *out = recent[seq % ALERT_JOURNAL_RECENT];
+    portEXIT_CRITICAL(&journalMux);
+    if (inRam) return out->seq == seq;
+    if (!journalPartition || seq < firstSeq) return false;
+    return readFlash(seq, out);
+}
+
+// 🔍 Boot Scan
+// Sector s can only hold seqs with (seq / 256) % sectors == s, so a valid
+// first record also proves which lap the sector belongs to
+static void indexSectors() {
+    for (uint32_t s = 0; s < sectors; s++) {
+        AlertRecord r;
+        esp_partition_read(journalPartition, s * JOURNAL_SECTOR_SIZE, &r, sizeof(r));
+        bool ok = intactRecord(&r) && r.seq % totalSlots == s * JOURNAL_SECTOR_SLOTS;
+        sectorSeq[s] = ok ? r.seq : JOURNAL_ERASED;
+        sectorTime[s] = ok ? r.timeS : 0;
+    }
+}
+
+// Records are programmed in order: the erased slots of the newest sector are a suffix
+static void findAppendPoint() {
+    uint32_t head = JOURNAL_ERASED;
+    firstSeq = JOURNAL_ERASED;
+    for (uint32_t s = 0; s < sectors; s++) {
+        if (sectorSeq[s] == JOURNAL_ERASED) continue;
+        if (head == JOURNAL_ERASED || sectorSeq[s] > sectorSeq[head]) head = s;
+        if (sectorSeq[s] < firstSeq) firstSeq = sectorSeq[s];
+    }
+    if (head == JOURNAL_ERASED) {
+        firstSeq = nextSeq = 0;
+        return;
+    }
+
+    uint32_t base = head * JOURNAL_SECTOR_SIZE;
+    uint32_t lo = 1, hi = JOURNAL_SECTOR_SLOTS;    // Slot 0 holds the indexed record
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        uint32_t seq = JOURNAL_ERASED;
+        esp_partition_read(journalPartition, base + mid * sizeof(AlertRecord), &seq, sizeof(seq));
+        if (seq == JOURNAL_ERASED) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    nextSeq = sectorSeq[head] + lo;
+    if (lo < JOURNAL_SECTOR_SLOTS) openSectorSeq = sectorSeq[head];   // Carry on filling it
+
+    // Time and boot carry on from the newest record that survived
+    for (uint32_t seq = nextSeq; seq > sectorSeq[head]; seq--) {
+        AlertRecord r;
+        if (readSlot(seq - 1, &r)) {
+            timeBaseS = r.timeS + 1;
+            bootCount = r.boot + 1;
+            break;
+        }
+    }
+}
+
+static void loadRecent() {
+    uint32_t from = nextSeq - firstSeq > ALERT_JOURNAL_RECENT ? nextSeq - ALERT_JOURNAL_RECENT : firstSeq;
+    for (uint32_t seq = from; seq < nextSeq; seq++) {
+        AlertRecord* slot = &recent[seq % ALERT_JOURNAL_RECENT];
+        if (!readFlash(seq, slot)) slot->seq = JOURNAL_ERASED;
+    }
+}
+
+// 🚀 Setup
+bool initAlertJournal() {
+    for (AlertRecord& r : recent) r.seq = JOURNAL_ERASED;
+    journalPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                (esp_partition_subtype_t)JOURNAL_PARTITION_SUBTYPE,
+                                                JOURNAL_PARTITION_LABEL);
+    if (journalPartition) {
+        sectors = journalPartition->size / JOURNAL_SECTOR_SIZE;
+        if (sectors > JOURNAL_MAX_SECTORS) sectors = JOURNAL_MAX_SECTORS;
+        if (sectors < 2) journalPartition = nullptr;   // Entering a sector would erase the whole log
+    }
+    if (!journalPartition) {
+        Serial.println("⚠️ Journal: no \"alerts\" partition - alerts kept in RAM only");
+        return false;
+    }
+    MEM_DECLARE("journalStaging", staging, MEM_HOT);   // Flash write source: cache is off meanwhile
+
+    totalSlots = sectors * JOURNAL_SECTOR_SLOTS;
+    indexSectors();
+    findAppendPoint();
+    flushedSeq = writtenSeq = nextSeq;
+    loadRecent();
+    Serial.printf("🗒️ Journal: seq %u..%u on flash (%u sectors of %u), boot %u\n",
+                  (unsigned)firstSeq, (unsigned)nextSeq, (unsigned)sectors, (unsigned)JOURNAL_SECTOR_SLOTS,
+                  (unsigned)bootCount);
+    return true;
+}
+
+uint32_t alertJournalNowS() {
+    return timeBaseS + (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+uint16_t alertJournalBoot() {
+    return bootCount;
+}
+
+// ✍️ Append
+void alertJournalAdd(AlertType type, int16_t detail) {
+    AlertRecord r = {0, 0, bootCount, (uint8_t)type, 0, detail, 0xFFFF};
+    portENTER_CRITICAL(&journalMux);
+    r.seq = nextSeq;
+    r.timeS = alertJournalNowS();        // Under the lock: times follow seq
+    r.check = recordCheck(&r);
+    recent[nextSeq % ALERT_JOURNAL_RECENT] = r;
+    if (nextSeq == flushedSeq) pendingSinceMs = millis();
+    nextSeq++;
+    if (nextSeq - flushedSeq > ALERT_JOURNAL_RECENT) {
+        flushedSeq++;                     // Flash stalled or absent: the oldest is lost
+        if (journalPartition) dropped++;
+    }
+    added++;
+    portEXIT_CRITICAL(&journalMux);
+}
+
+// 💾 Flush
+// Entering a sector erases it; firstSeq then moves past what it held
+static void enterSector(uint32_t sectorStart) {
+    uint32_t s = (sectorStart / JOURNAL_SECTOR_SLOTS) % sectors;
+    esp_partition_erase_range(journalPartition, s * JOURNAL_SECTOR_SIZE, JOURNAL_SECTOR_SIZE);
+    erases++;
+    sectorSeq[s] = JOURNAL_ERASED;
+    openSectorSeq = sectorStart;
+    uint32_t kept = totalSlots - JOURNAL_SECTOR_SLOTS;
+    if (sectorStart > kept && firstSeq < sectorStart - kept) firstSeq = sectorStart - kept;
+}
+
+// staging[0, count) to slots from.., all in one sector
+static void writeChunk(uint32_t from, uint32_t count) {
+    uint32_t sectorStart = from - from % JOURNAL_SECTOR_SLOTS;
+    if (sectorStart != openSectorSeq) enterSector(sectorStart);
+    esp_partition_write(journalPartition, slotOffset(from), staging, count * sizeof(AlertRecord));
+    pageWrites++;
+    writtenSeq = from + count;
+    if (from == sectorStart) {
+        uint32_t s = (sectorStart / JOURNAL_SECTOR_SLOTS) % sectors;
+        sectorTime[s] = staging[0].timeS;
+        sectorSeq[s] = sectorStart;
+    }
+}
+
+static void flushRecords() {
+    portENTER_CRITICAL(&journalMux);
+    uint32_t pending = nextSeq - flushedSeq;
+    uint32_t waitedMs = millis() - pendingSinceMs;
+    portEXIT_CRITICAL(&journalMux);
+    if (!pending || (pending < ALERT_JOURNAL_BATCH && waitedMs < ALERT_JOURNAL_FLUSH_MS)) return;
+
+    for (;;) {
+        portENTER_CRITICAL(&journalMux);
+        uint32_t from = flushedSeq;
+        uint32_t count = nextSeq - from;
+        uint32_t room = JOURNAL_SECTOR_SLOTS - from % JOURNAL_SECTOR_SLOTS;
+        if (count > ALERT_JOURNAL_BATCH) count = ALERT_JOURNAL_BATCH;
+        if (count > room) count = room;    // One sector per write
+        for (uint32_t i = 0; i < count; i++) staging[i] = recent[(from + i) % ALERT_JOURNAL_RECENT];
+        portEXIT_CRITICAL(&journalMux);
+        if (!count) break;
+
+        uint32_t sectorStart = from - from % JOURNAL_SECTOR_SLOTS;
+        uint32_t fillFrom = writtenSeq > sectorStart ? writtenSeq : sectorStart;
+        if (fillFrom < from) {
+            // Dropped records: fillers keep the sector a programmed prefix for the boot scan
+            count = from - fillFrom < ALERT_JOURNAL_BATCH ? from - fillFrom : ALERT_JOURNAL_BATCH;
+            uint32_t timeS = staging[0].timeS;
+            for (uint32_t i = 0; i < count; i++) {
+                staging[i] = {fillFrom + i, timeS, bootCount, 0, 0, 0, 0xFFFF};
+                staging[i].check = recordCheck(&staging[i]);
+            }
+            writeChunk(fillFrom, count);
+            continue;
+        }
+        writeChunk(from, count);
+
+        portENTER_CRITICAL(&journalMux);
+        if (flushedSeq == from) flushedSeq = from + count;   // Unless dropped meanwhile
+        pendingSinceMs = millis();
+        portEXIT_CRITICAL(&journalMux);
+    }
+}
+
+// 🔎 Queries
+size_t alertJournalLast(size_t n, AlertRecord* out) {
+    size_t got = 0;
+    uint32_t lo = oldestSeq();
+    for (uint32_t seq = nextSeq; seq > lo && got < n; seq--) {
+        if (readRecord(seq - 1, &out[got])) got++;
+    }
+    return got;
+}
+
+// Newest sector whose first record is before fromS. Sectors not indexed
+// count as late, which can only start the scan earlier.
+static uint32_t rangeStart(uint32_t fromS) {
+    uint32_t first = oldestSeq();
+    if (!journalPartition || nextSeq == first) return first;
+    uint32_t base = first - first % JOURNAL_SECTOR_SLOTS;
+    uint32_t lo = 0, hi = (nextSeq - 1 - base) / JOURNAL_SECTOR_SLOTS + 1;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        uint32_t start = base + mid * JOURNAL_SECTOR_SLOTS;
+        uint32_t s = (start / JOURNAL_SECTOR_SLOTS) % sectors;
+        if (sectorSeq[s] == start && sectorTime[s] < fromS) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    uint32_t start = lo ? base + (lo - 1) * JOURNAL_SECTOR_SLOTS : first;
+    return start < first ? first : start;
+}
+
+size_t alertJournalRange(uint32_t fromS, uint32_t toS, AlertRecord* out, size_t max) {
+    size_t got = 0;
+    uint32_t end = nextSeq;
+    for (uint32_t seq = rangeStart(fromS); seq < end && got < max; seq++) {
+        AlertRecord r;
+        if (!readRecord(seq, &r)) continue;
+        if (r.timeS >= toS) break;
+        if (r.timeS >= fromS) out[got++] = r;
+    }
+    return got;
+}
+
+// 📤 Export
+void alertJournalRequestExport(uint32_t records) {
+    exportRecords = records;
+    exportRequested = true;
+}
+
+bool alertJournalExportPending() {
+    return exportRequested || exportActive;
+}
+
+static void writeLine(const char* line, size_t len) {
+    Serial.write((const uint8_t*)line, len);   // One write per line: never split by the log drain
+}
+
+static void serviceExport() {
+    char line[80];
+    size_t n;
+    if (exportRequested && !exportActive) {
+        exportRequested = false;
+        exportEnd = nextSeq;
+        exportCursor = oldestSeq();
+        if (exportRecords && exportEnd - exportCursor > exportRecords) exportCursor = exportEnd - exportRecords;
+        exportLines = 0;
+        exportActive = true;
+        // H version boot now_s from_seq to_seq
+        n = snprintf(line, sizeof(line), JOURNAL_EXPORT_PREFIX "H %u %u %u %u %u\n", JOURNAL_EXPORT_VERSION,
+                     (unsigned)bootCount, (unsigned)alertJournalNowS(), (unsigned)exportCursor,
+                     (unsigned)exportEnd);
+        writeLine(line, n);
+        return;
+    }
+    if (!exportActive) return;
+
+    // E seq time_s boot type detail name
+    for (uint32_t visited = 0; visited < ALERT_JOURNAL_EXPORT_LINES && exportCursor < exportEnd; visited++) {
+        AlertRecord r;
+        if (readRecord(exportCursor++, &r)) {
+            n = snprintf(line, sizeof(line), JOURNAL_EXPORT_PREFIX "E %u %u %u %u %d %s\n", (unsigned)r.seq,
+                         (unsigned)r.timeS, (unsigned)r.boot, (unsigned)r.type, r.detail, alertTypeName(r.type));
+            writeLine(line, n);
+            exportLines++;
+        }
+    }
+    if (exportCursor >= exportEnd) {
+        n = snprintf(line, sizeof(line), JOURNAL_EXPORT_PREFIX "Z %u\n", (unsigned)exportLines);
+        writeLine(line, n);
+        exportActive = false;
+    }
+}
+
+void serviceAlertJournal() {
+    if (journalPartition) flushRecords();
+    serviceExport();
+}
+
+// 📊 Statistics
+void printAlertJournalStats() {
+    uint32_t first = oldestSeq();
+    char line[160];
+    snprintf(line, sizeof(line),
+             "🗒️ Journal: %u added, seq %u..%u kept, %u unwritten, %u writes, %u erases, %u dropped, boot %u",
+             (unsigned)added, (unsigned)first, (unsigned)nextSeq,
+             (unsigned)(nextSeq - flushedSeq), (unsigned)pageWrites, (unsigned)erases, (unsigned)dropped,
+             (unsigned)bootCount);
+    Serial.println(line);
+}
@@ -1,10 +1,8 @@
 #include "audio.h"
+#include "deferred_log.h"
 #include <Arduino.h>
 
-// Use LEDC for buzzer on ESP32
-#ifndef BUZZER_LEDC_CHANNEL
-#define BUZZER_LEDC_CHANNEL 7
-#endif
+// Use LEDC for buzzer on ESP32 (BUZZER_LEDC_CHANNEL, timer map in config.h)
 #ifndef BUZZER_LEDC_RES
 #define BUZZER_LEDC_RES LEDC_TIMER_10_BIT
 #endif
@@ -37,16 +35,16 @@ void initAudio() {
 }
 
 void playStartupTone() {
-    Serial.println("Playing startup tone...");
+    logEvent(LOG_AUDIO_STARTUP_BEGIN);
     int startupNotes[] = {523, 659, 784, 1047, 1319, 1568};
     int duration = 150;
     for (unsigned i = 0; i < sizeof(startupNotes) / sizeof(startupNotes[0]); i++) {
-        Serial.printf("Playing note %d Hz\n", startupNotes[i]);
+        logEvent(LOG_AUDIO_NOTE, startupNotes[i]);
         writeTone(startupNotes[i]);
         vTaskDelay(pdMS_TO_TICKS(duration + 20));
     }
     writeTone(0);
-    Serial.println("Startup tone complete");
+    logEvent(LOG_AUDIO_STARTUP_DONE);
 }
 
 void playModeSwitchTone() {
@@ -60,12 +58,12 @@ void playModeSwitchTone() {
 }
 
 void playAlertTone() {
-    Serial.println("Playing alert tone...");
+    logEvent(LOG_AUDIO_ALERT_BEGIN);
     int duration = 150; 
     int tone1 = 880;
     int tone2 = 440;
     for (int i = 0; i < 3; i++) { 
-        Serial.printf("Alert tone cycle %d: %d Hz\n", i+1, tone1);
+        logEvent(LOG_AUDIO_ALERT_CYCLE, i + 1, tone1);
         writeTone(tone1);
         vTaskDelay(pdMS_TO_TICKS(duration));
         writeTone(tone2);
@@ -74,7 +72,7 @@ void playAlertTone() {
     writeTone(tone1);
     vTaskDelay(pdMS_TO_TICKS(250));
     writeTone(0);
-    Serial.println("Alert tone complete");
+    logEvent(LOG_AUDIO_ALERT_DONE);
 }
 
 void playTone(int frequency, int duration) {
@@ -3,6 +3,12 @@
 #include "display.h"
 #include "oled_display.h"
 #include "system.h"
+#include "actuators.h"
+#include "rtos_trace.h"
+#include "task_stats.h"
+#include "history_store.h"
+#include "history_rollup.h"
+#include "alert_journal.h"
 
 void initBlynk() {
     Blynk.config(BLYNK_AUTH_TOKEN);
@@ -35,10 +41,10 @@ BLYNK_WRITE(VPIN_DAY_NIGHT) {
     }
     
     // Update both displays under I2C mutex
-    if (i2cMutex && xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    if (i2cMutex && i2cBusTake(pdMS_TO_TICKS(100))) {
         displayModeStatus();  // LCD
         displayOLEDModeStatus();  // OLED
-        xSemaphoreGive(i2cMutex);
+        i2cBusGive();
     } else {
         // fallback without mutex if not yet created
         displayModeStatus();
@@ -48,8 +54,47 @@ BLYNK_WRITE(VPIN_DAY_NIGHT) {
 
 BLYNK_WRITE(VPIN_AC_CONTROL) {
     AC = param.asInt();
+    notifyActuators(ACT_EVT_AC);   // Fan follows without waiting for a climate change
 }
 
+BLYNK_WRITE(VPIN_TRACE_DUMP) {
+    if (param.asInt()) {
+        rtosTraceRequestDump();  // TaskSystemMonitor writes it out
+    }
+}
+
+BLYNK_WRITE(VPIN_FIRE_RESET) {
+    if (param.asInt()) {
+        notifyActuators(ACT_EVT_FIRE_RESET);   // Ignored while the fire is still active
+    }
+}
+
+BLYNK_WRITE(VPIN_HISTORY_EXPORT) {
+    historyRequestExport((uint32_t)max(param.asInt(), 0));  // TaskSystemMonitor writes it out
+}
+
+BLYNK_WRITE(VPIN_ALERT_EXPORT) {
+    alertJournalRequestExport((uint32_t)max(param.asInt(), 0));  // TaskSystemMonitor writes it out
+}
+
+#ifdef BLYNK_USE_DENSE_HANDLERS
+// 📋 Dense virtual pin table - only the pins this project uses (sorted by pin)
+BLYNK_DENSE_HANDLERS(
+    BLYNK_DENSE_PIN(VPIN_TEMPERATURE),  // V0
+    BLYNK_DENSE_PIN(VPIN_HUMIDITY),     // V1
+    BLYNK_DENSE_PIN(VPIN_MOTION),       // V3
+    BLYNK_DENSE_PIN(VPIN_FLAME),        // V4
+    BLYNK_DENSE_PIN(VPIN_DAY_NIGHT),    // V5
+    BLYNK_DENSE_PIN(VPIN_AC_CONTROL),   // V6
+    BLYNK_DENSE_PIN(VPIN_TRACE_DUMP),   // V7
+    BLYNK_DENSE_PIN(VPIN_TASK_STATS),   // V8
+    BLYNK_DENSE_PIN(VPIN_FIRE_RESET),   // V9
+    BLYNK_DENSE_PIN(VPIN_HISTORY_EXPORT),  // V10
+    BLYNK_DENSE_PIN(VPIN_ROLLUP_SUMMARY),  // V11
+    BLYNK_DENSE_PIN(VPIN_ALERT_EXPORT)     // V12
+);
+#endif
+
 void sendSensorDataToBlynk(int temperature, int humidity, bool flame, bool motion) {
     if (Blynk.connected()) {
         Blynk.virtualWrite(VPIN_TEMPERATURE, temperature);
@@ -57,4 +102,20 @@ void sendSensorDataToBlynk(int temperature, int humidity, bool flame, bool motio
         Blynk.virtualWrite(VPIN_FLAME, flame);
         Blynk.virtualWrite(VPIN_MOTION, motion);
     }
+}
+
+void sendTaskStatsToBlynk() {
+    if (Blynk.connected()) {
+        char summary[128];
+        formatTaskStatsSummary(summary, sizeof(summary));
+        Blynk.virtualWrite(VPIN_TASK_STATS, summary);
+    }
+}
+
+void sendRollupToBlynk() {
+    if (Blynk.connected()) {
+        char summary[200];
+        formatRollupSummary(summary, sizeof(summary));   // Bucket trees, no raw samples scanned
+        Blynk.virtualWrite(VPIN_ROLLUP_SUMMARY, summary);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include "deferred_log.h"
+#include "task_stats.h"
+#include "periodic_task.h"
+#include "mem_placement.h"
+#include <atomic>
+
+// 🪵 Deferred Logging
+// Bounded multi-producer / single-consumer ring: each slot carries a sequence
+// number, producers claim a slot with one compare-and-swap on the head index,
+// and TaskLogDrain is the only reader. Nobody ever waits on the UART except
+// the drain task.
+
+#define LOG_RING_MASK (LOG_RING_SLOTS - 1)
+static_assert((LOG_RING_SLOTS & LOG_RING_MASK) == 0, "LOG_RING_SLOTS must be a power of two");
+
+struct LogSlot {
+    std::atomic<uint32_t> seq;
+    LogRecord rec;
+};
+
+static LogSlot ring[LOG_RING_SLOTS];
+static std::atomic<uint32_t> ringHead(0);     // Next slot producers claim
+static uint32_t ringTail = 0;                 // Next slot TaskLogDrain reads
+static std::atomic<uint32_t> droppedCount(0);
+static bool ringReady = false;
+static uint32_t writtenBytes = 0;
+
+#define LOG_CATALOG_FORMAT(id, fmt) fmt,
+static const char* const logFormats[LOG_ID_COUNT] = {
+    LOG_CATALOG(LOG_CATALOG_FORMAT)
+};
+#undef LOG_CATALOG_FORMAT
+
+// 🔧 Setup
+bool initDeferredLog() {
+    for (uint32_t i = 0; i < LOG_RING_SLOTS; i++) {
+        ring[i].seq.store(i, std::memory_order_relaxed);
+    }
+    ringHead.store(0, std::memory_order_relaxed);
+    ringTail = 0;
+    ringReady = true;
+    MEM_DECLARE("logRing", ring, MEM_HOT);   // Written from ISRs
+    logEvent(LOG_BOOT, getLogCatalogHash());
+    return true;
+}
+
+// ✍️ Producer
+bool IRAM_ATTR logRecord(LogId id, uint8_t argc, const int32_t* args) {
+    if (!ringReady) return false;
+
+    uint32_t pos = ringHead.load(std::memory_order_relaxed);
+    LogSlot* slot;
+    for (;;) {
+        slot = &ring[pos & LOG_RING_MASK];
+        int32_t diff = (int32_t)(slot->seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (ringHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);   // Ring full
+            return false;
+        } else {
+            pos = ringHead.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->rec.id = id;
+    slot->rec.tsUs = (uint32_t)micros();
+    slot->rec.core = (uint8_t)xPortGetCoreID();
+    slot->rec.argc = argc > LOG_MAX_ARGS ? LOG_MAX_ARGS : argc;
+    for (uint8_t i = 0; i < slot->rec.argc; i++) {
+        slot->rec.args[i] = args[i];
+    }
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+static bool takeRecord(LogRecord* out) {
+    LogSlot* slot = &ring[ringTail & LOG_RING_MASK];
+    if (slot->seq.load(std::memory_order_acquire) != ringTail + 1) {
+        return false;   // Empty, or the producer is still filling it in
+    }
+    *out = slot->rec;
+    slot->seq.store(ringTail + LOG_RING_SLOTS, std::memory_order_release);
+    ringTail++;
+    return true;
+}
+
+// 📊 Statistics
+uint32_t getLogDroppedCount() {
+    return droppedCount.load(std::memory_order_relaxed);
+}
+
+uint32_t getLogWrittenBytes() {
+    return writtenBytes;
+}
+
+// 📖 Catalog
+const char* getLogFormat(uint16_t id) {
+    return id < LOG_ID_COUNT ? logFormats[id] : nullptr;
+}
+
+uint32_t getLogCatalogHash() {
+    uint32_t hash = 2166136261u;
+    for (uint16_t i = 0; i < LOG_ID_COUNT; i++) {
+        for (const char* p = logFormats[i]; ; p++) {
+            hash = (hash ^ (uint8_t)*p) * 16777619u;
+            if (*p == 0) break;
+        }
+    }
+    return hash;
+}
+
+// 📝 Text Formatting: one 32-bit argument per conversion
+size_t formatLogRecord(const LogRecord* rec, char* out, size_t outSize) {
+    const char* fmt = getLogFormat(rec->id);
+    if (!fmt) {
+        return snprintf(out, outSize, "<unknown log id %u>", rec->id);
+    }
+
+    size_t n = 0;
+    uint8_t arg = 0;
+    while (*fmt && n + 1 < outSize) {
+        if (*fmt != '%') {
+            out[n++] = *fmt++;
+            continue;
+        }
+        if (fmt[1] == '%') {
+            out[n++] = '%';
+            fmt += 2;
+            continue;
+        }
+
+        // Copy one conversion spec: flags, width, precision, type
+        char spec[16];
+        size_t s = 0;
+        spec[s++] = *fmt++;
+        while (*fmt && strchr("-+ #0123456789.", *fmt) && s < sizeof(spec) - 2) {
+            spec[s++] = *fmt++;
+        }
+        char type = *fmt ? *fmt++ : 'd';
+        spec[s++] = type;
+        spec[s] = 0;
+
+        int32_t v = arg < rec->argc ? rec->args[arg] : 0;
+        arg++;
+        int written;
+        if (strchr("fgeFGE", type)) {
+            float f;
+            memcpy(&f, &v, sizeof(f));
+            written = snprintf(out + n, outSize - n, spec, (double)f);
+        } else if (strchr("uxX", type)) {
+            written = snprintf(out + n, outSize - n, spec, (unsigned)v);
+        } else {
+            written = snprintf(out + n, outSize - n, spec, (int)v);
+        }
+        if (written < 0) break;
+        n += (size_t)written < outSize - n ? (size_t)written : outSize - n - 1;
+    }
+    out[n] = 0;
+    return n;
+}
+
+// 📦 Binary Frames
+static size_t putVarint(uint8_t* out, int32_t v) {
+    uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);   // Zigzag: small negatives stay short
+    size_t n = 0;
+    do {
+        uint8_t b = z & 0x7F;
+        z >>= 7;
+        out[n++] = b | (z ? 0x80 : 0);
+    } while (z);
+    return n;
+}
+
+static bool getVarint(const uint8_t* in, size_t len, size_t* pos, int32_t* v) {
+    uint32_t z = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*pos >= len) return false;
+        uint8_t b = in[(*pos)++];
+        z |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = (int32_t)((z >> 1) ^ (~(z & 1) + 1));
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint8_t checksum(const uint8_t* data, size_t len) {
+    uint8_t sum = 0;
+    for (size_t i = 0; i < len; i++) {
+        sum = (uint8_t)((sum << 1) | (sum >> 7)) ^ data[i];
+    }
+    return sum;
+}
+
+size_t encodeLogFrame(const LogRecord* rec, uint8_t* out) {
+    uint8_t raw[LOG_MAX_FRAME];
+    size_t n = 0;
+    raw[n++] = (uint8_t)rec->id;
+    raw[n++] = (uint8_t)(rec->id >> 8);
+    for (int i = 0; i < 4; i++) {
+        raw[n++] = (uint8_t)(rec->tsUs >> (8 * i));
+    }
+    raw[n++] = (uint8_t)((rec->core << 7) | rec->argc);
+    for (uint8_t i = 0; i < rec->argc; i++) {
+        n += putVarint(raw + n, rec->args[i]);
+    }
+    raw[n] = checksum(raw, n);
+    n++;
+
+    // COBS: no 0x00 inside the frame, so 0x00 always ends it
+    size_t o = 0;
+    out[o++] = LOG_FRAME_START;
+    size_t codeAt = o++;
+    uint8_t code = 1;
+    for (size_t i = 0; i < n; i++) {
+        if (raw[i] == 0) {
+            out[codeAt] = code;
+            codeAt = o++;
+            code = 1;
+        } else {
+            out[o++] = raw[i];
+            code++;
+        }
+    }
+    out[codeAt] = code;
+    out[o++] = LOG_FRAME_END;
+    return o;
+}
+
+bool decodeLogFrame(const uint8_t* cobs, size_t len, LogRecord* rec) {
+    uint8_t raw[LOG_MAX_FRAME + 2];
+    size_t n = 0;
+    for (size_t i = 0; i < len;) {
+        uint8_t code = cobs[i++];
+        if (code == 0) return false;
+        for (uint8_t k = 1; k < code; k++) {
+            if (i >= len || n >= sizeof(raw)) return false;
+            raw[n++] = cobs[i++];
+        }
+        if (code < 0xFF && i < len) {
+            if (n >= sizeof(raw)) return false;
+            raw[n++] = 0;
+        }
+    }
+    if (n < 8 || checksum(raw, n - 1) != raw[n - 1]) return false;
+
+    rec->id = (uint16_t)(raw[0] | (raw[1] << 8));
+    rec->tsUs = (uint32_t)raw[2] | ((uint32_t)raw[3] << 8) | ((uint32_t)raw[4] << 16) | ((uint32_t)raw[5] << 24);
+    rec->core = raw[6] >> 7;
+    rec->argc = raw[6] & 0x7F;
+    if (rec->argc > LOG_MAX_ARGS) return false;
+    size_t pos = 7;
+    for (uint8_t i = 0; i < rec->argc; i++) {
+        if (!getVarint(raw, n - 1, &pos, &rec->args[i])) return false;
+    }
+    return pos == n - 1;
+}
+
+// 📤 Drain Task (Core 0, lowest priority)
+// Released every LOG_DRAIN_INTERVAL_MS (its PeriodicTask) and writes
+// everything queued in one burst
+void TaskLogDrain(void* pvParameters) {
+    PeriodicTask* schedule = (PeriodicTask*)pvParameters;
+    LogRecord rec;
+    uint32_t reportedDrops = 0;
+    periodicStart(schedule);
+    for (;;) {
+        taskStatsLoop();
+        while (takeRecord(&rec)) {
+#if DEFERRED_LOG_FORMAT == LOG_FORMAT_BINARY
+            uint8_t frame[LOG_MAX_FRAME + 4];
+            size_t len = encodeLogFrame(&rec, frame);
+            Serial.write(frame, len);
+#else
+            char line[160];
+            size_t len = formatLogRecord(&rec, line, sizeof(line));
+            Serial.println(line);
+            len += 2;
+#endif
+            writtenBytes += len;
+        }
+
+        uint32_t drops = getLogDroppedCount();
+        if (drops != reportedDrops) {
+            logEvent(LOG_DROPPED, drops - reportedDrops);
+            reportedDrops = drops;
+        }
+        periodicWait(schedule);
+    }
+}
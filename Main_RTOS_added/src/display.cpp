@@ -1,4 +1,5 @@
 #include "display.h"
+#include "deferred_log.h"
 
 void initDisplay() {
     lcd.init();
@@ -67,7 +68,7 @@ void displayFireAlert() {
     lcd.print("FIRE ALERT!");
     lcd.setCursor(0, 1);
     lcd.print("EVACUATE NOW!");
-    Serial.println("LCD: Fire alert displayed");
+    logEvent(LOG_LCD_FIRE);
 }
 
 void displayNormalStatus() {
@@ -154,5 +155,5 @@ void displayThiefAlert() {
     lcd.print("THIEF ALERT!");
     lcd.setCursor(0, 1);
     lcd.print("Security Breach!");
-    Serial.println("LCD: Thief alert displayed");
+    logEvent(LOG_LCD_THIEF);
 }
\ No newline at end of file
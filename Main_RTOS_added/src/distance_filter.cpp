@@ -0,0 +1,98 @@
+#include "distance_filter.h"
+
+// 📏 Distance Filter
+// Same scale as the old float path (0.034 / 2 cm per us of echo, sound at
+// 340 m/s): mm = us * 0.17 = (us * 11141) >> 16. Gains are Q8 (DIST_ALPHA_Q8 / 256). The innovation is shifted
+// down to Q8 before the gain multiply so nothing overflows 32 bits for any
+// echo up to the 30 ms pulseIn timeout.
+
+#define DIST_MM_PER_US_Q16 11141u
+#define DIST_MAX_DT_MS 1000          // Longer gaps are predicted as if 1 s passed
+
+static_assert(DIST_MEDIAN_N % 2 == 1 && DIST_MEDIAN_N <= 7, "DIST_MEDIAN_N must be odd and at most 7");
+
+static uint16_t echoToMm(uint16_t echoUs) {
+    return (uint16_t)(((uint32_t)echoUs * DIST_MM_PER_US_Q16) >> 16);
+}
+
+int echoToCm(uint16_t echoUs) {
+    return echoUs ? (echoToMm(echoUs) + 5) / 10 : DISTANCE_NONE;
+}
+
+// Insertion sort of a copy: at most 21 compares for 7 entries
+static uint16_t median(const uint16_t* window) {
+    uint16_t v[DIST_MEDIAN_N];
+    for (int i = 0; i < DIST_MEDIAN_N; i++) {
+        uint16_t x = window[i];
+        int j = i;
+        for (; j > 0 && v[j - 1] > x; j--) v[j] = v[j - 1];
+        v[j] = x;
+    }
+    return v[DIST_MEDIAN_N / 2];
+}
+
+static DistanceEstimate estimate(const DistanceFilter* f) {
+    DistanceEstimate e;
+    if (!f->tracking) {
+        e.distanceCm = DISTANCE_NONE;
+        e.velocityCmS = 0;
+        e.valid = false;
+        return e;
+    }
+    int32_t mm = f->posQ16 >> 16;
+    e.distanceCm = (int16_t)((mm + 5) / 10);
+    e.velocityCmS = (int16_t)((f->velQ16 * 100) >> 16);   // mm/ms = m/s
+    e.valid = true;
+    return e;
+}
+
+void distanceFilterReset(DistanceFilter* f) {
+    memset(f, 0, sizeof(*f));
+    for (int i = 0; i < DIST_MEDIAN_N; i++) f->window[i] = DIST_FAR_MM;   // Start from "nothing there"
+}
+
+DistanceEstimate distanceFilterUpdate(DistanceFilter* f, uint16_t echoUs, uint32_t tsMs) {
+    f->pings++;
+    uint16_t mm = echoUs ? echoToMm(echoUs) : DIST_FAR_MM;
+    if (!echoUs) f->dropouts++;
+    f->window[f->head] = mm;
+    if (++f->head == DIST_MEDIAN_N) f->head = 0;
+    uint16_t med = median(f->window);
+
+    uint32_t dt = tsMs - f->lastMs;
+    if (dt > DIST_MAX_DT_MS) dt = DIST_MAX_DT_MS;
+    f->lastMs = tsMs;
+
+    if (med == DIST_FAR_MM) {
+        if (echoUs) f->spikes++;              // Lone echo in an empty window
+        if (!f->tracking) return estimate(f);
+        if (++f->misses > DIST_MAX_COAST) {
+            f->tracking = false;              // Target gone
+            return estimate(f);
+        }
+        f->coasted++;
+        f->posQ16 += f->velQ16 * (int32_t)dt;
+        if (f->posQ16 < 0) f->posQ16 = 0;
+        return estimate(f);
+    }
+    f->misses = 0;
+    if (echoUs && abs((int)mm - (int)med) > DIST_SNAP_MM) f->spikes++;
+
+    int32_t medQ16 = (int32_t)med << 16;
+    if (!f->tracking || abs((int32_t)med - (f->posQ16 >> 16)) > DIST_SNAP_MM) {
+        f->tracking = true;                   // New target, or one far from the track
+        f->posQ16 = medQ16;
+        f->velQ16 = 0;
+        f->snaps++;
+        return estimate(f);
+    }
+
+    // Alpha-beta: predict, then correct position and velocity by the innovation
+    int32_t predicted = f->posQ16 + f->velQ16 * (int32_t)dt;
+    int32_t residualQ8 = (medQ16 - predicted) >> 8;
+    f->posQ16 = predicted + residualQ8 * DIST_ALPHA_Q8;
+    if (dt > 0) {
+        f->velQ16 += residualQ8 * DIST_BETA_Q8 / (int32_t)dt;
+    }
+    return estimate(f);
+}
@@ -0,0 +1,94 @@
+#include "fan_control.h"
+
+// 🌀 Fan Control
+// Errors are milli-degrees, duty is permille. The integral is kept in
+// permille/1000 so small errors over short steps still accumulate. Only the
+// actuator task steps the loop; readers get a copy under the spinlock.
+
+#define LEDC_FULL ((1u << FAN_PWM_BITS) - 1)
+
+static FanControlState state = {};
+static int64_t integralMicro = 0;         // Integral term, permille x 1000
+static uint32_t lastStepMs = 0;
+static bool stepped = false;
+static uint32_t ledcDuty = 0;
+static portMUX_TYPE fanMux = portMUX_INITIALIZER_UNLOCKED;
+
+static void writeDuty(uint16_t permille) {
+    uint32_t duty = ((uint32_t)permille * LEDC_FULL + 500) / 1000;
+    if (duty == ledcDuty) return;
+    ledcWrite(FAN_LEDC_CHANNEL, duty);
+    ledcDuty = duty;
+    state.writes++;
+}
+
+// 🔧 Setup
+bool initFanControl() {
+    ledcSetup(FAN_LEDC_CHANNEL, FAN_PWM_FREQ_HZ, FAN_PWM_BITS);
+    ledcAttachPin(FAN_PIN, FAN_LEDC_CHANNEL);
+    ledcWrite(FAN_LEDC_CHANNEL, 0);
+    ledcDuty = 0;
+    return true;
+}
+
+// 🔁 Loop step
+uint16_t updateFanControl(int temperatureC, int humidityPct, bool forceMax, uint32_t nowMs) {
+    // Steps after a quiet spell count as one period, not as the whole gap
+    uint32_t dtMs = stepped ? nowMs - lastStepMs : 0;
+    if (dtMs > FAN_CONTROL_PERIOD_MS) dtMs = FAN_CONTROL_PERIOD_MS;
+    lastStepMs = nowMs;
+    stepped = true;
+
+    int32_t tempError = (temperatureC - FAN_TEMP_SETPOINT_C) * 1000;
+    int32_t humidityError = (humidityPct - FAN_HUMIDITY_SETPOINT_PCT) * 1000 / FAN_HUMIDITY_PCT_PER_C;
+    int32_t error = max(tempError, humidityError);
+
+    uint16_t duty;
+    if (forceMax) {
+        duty = FAN_MAX_DUTY;
+    } else {
+        int32_t proportional = (int32_t)((int64_t)FAN_KP * error / 1000);
+        int32_t demand = proportional + (int32_t)(integralMicro / 1000);
+
+        // Anti-windup: no further growth while the output is pinned at max
+        if (!(error > 0 && demand >= FAN_MAX_DUTY)) {
+            integralMicro += (int64_t)FAN_KI * error * dtMs / 1000;
+            integralMicro = constrain(integralMicro, (int64_t)0, (int64_t)FAN_MAX_DUTY * 1000);
+            demand = proportional + (int32_t)(integralMicro / 1000);
+        }
+
+        // Hysteresis around the stall limit
+        int32_t offBelow = state.dutyPermille > 0 ? FAN_MIN_DUTY - FAN_HYSTERESIS : FAN_MIN_DUTY;
+        if (demand < offBelow) {
+            duty = 0;
+        } else {
+            duty = (uint16_t)constrain(demand, (int32_t)FAN_MIN_DUTY, (int32_t)FAN_MAX_DUTY);
+        }
+    }
+    writeDuty(duty);
+
+    portENTER_CRITICAL(&fanMux);
+    state.dutyPermille = duty;
+    state.errorMdeg = error;
+    state.integralPermille = (int32_t)(integralMicro / 1000);
+    state.forced = forceMax;
+    portEXIT_CRITICAL(&fanMux);
+    return duty;
+}
+
+uint32_t fanControlDueInMs(uint32_t nowMs) {
+    // At rest: fan off, nothing integrated and no demand, or held by the override
+    if (!stepped || state.forced ||
+        (state.dutyPermille == 0 && integralMicro == 0 && state.errorMdeg <= 0)) {
+        return UINT32_MAX;
+    }
+    uint32_t since = nowMs - lastStepMs;
+    return since >= FAN_CONTROL_PERIOD_MS ? 0 : FAN_CONTROL_PERIOD_MS - since;
+}
+
+// 📤 Readers
+void getFanControlState(FanControlState* out) {
+    portENTER_CRITICAL(&fanMux);
+    *out = state;
+    portEXIT_CRITICAL(&fanMux);
+}
@@ -0,0 +1,111 @@
+#include "fire_fastpath.h"
+#include "actuators.h"
+#include "sensors.h"
+#include "deferred_log.h"
+#include "rtos_trace.h"
+#include "esp_timer.h"
+
+// 🔥 Fire Fast Path
+// The edge ISR only timestamps and (re)starts the glitch timer, so it stays
+// in IRAM-safe calls (digitalRead, esp_timer). The relay is written from the
+// esp_timer task (priority 22), which preempts every application task.
+// After a trip the path stays disarmed until the debounced clear, so a
+// flickering flame doesn't keep restarting the timer.
+
+static esp_timer_handle_t glitchTimer = nullptr;
+static volatile bool armed = false;
+static volatile int64_t edgeUs = 0;          // Start of the pending flame pulse
+static volatile uint32_t glitches = 0;
+
+static FireFastPathStats stats = {};
+static uint64_t latencySumUs = 0;
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+#if FIRE_FAST_PATH
+// ⚡ Flame pin edge (ISR)
+static void IRAM_ATTR flameEdgeISR() {
+    RTOS_TRACE_ISR(FLAME_SENSOR_PIN);
+    if (!armed) return;
+    if (digitalRead(FLAME_SENSOR_PIN) == LOW) {      // Active low: flame appeared
+        edgeUs = esp_timer_get_time();
+        esp_timer_stop(glitchTimer);
+        esp_timer_start_once(glitchTimer, FIRE_FAST_GLITCH_US);
+    } else if (esp_timer_stop(glitchTimer) == ESP_OK) {
+        glitches++;                                  // Gone before the window closed
+    }
+}
+
+// ⏲️ Glitch window expired (esp_timer task)
+static void glitchWindowDone(void* arg) {
+    (void)arg;
+    if (!armed) return;
+    if (digitalRead(FLAME_SENSOR_PIN) != LOW) {
+        glitches++;
+        return;
+    }
+    armed = false;
+    if (isFireAlertRaised()) return;                 // Debouncer got there first, relay is on
+
+    activateRelay();
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - edgeUs);
+
+    portENTER_CRITICAL(&statsMux);
+    stats.trips++;
+    stats.lastLatencyUs = latency;
+    if (stats.trips == 1 || latency < stats.minLatencyUs) stats.minLatencyUs = latency;
+    if (latency > stats.maxLatencyUs) stats.maxLatencyUs = latency;
+    latencySumUs += latency;
+    portEXIT_CRITICAL(&statsMux);
+
+    if (raiseFireAlert(millis())) {
+        notifyActuators(ACT_EVT_HAZARD);
+    }
+    logEvent(LOG_FIRE_FAST_TRIP, latency);
+}
+#endif
+
+// 🔧 Setup
+bool initFireFastPath() {
+#if FIRE_FAST_PATH
+    esp_timer_create_args_t args = {};
+    args.callback = glitchWindowDone;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "fire";
+    if (esp_timer_create(&args, &glitchTimer) != ESP_OK) {
+        Serial.println("❌ Fire fast path: timer create failed");
+        return false;
+    }
+    armed = true;
+    attachInterrupt(digitalPinToInterrupt(FLAME_SENSOR_PIN), flameEdgeISR, CHANGE);
+    Serial.printf("🔥 Fire fast path armed (%u us glitch window)\n", (unsigned)FIRE_FAST_GLITCH_US);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void rearmFireFastPath() {
+    if (glitchTimer) {
+        armed = true;
+    }
+}
+
+// 📤 Statistics
+void getFireFastPathStats(FireFastPathStats* out) {
+    portENTER_CRITICAL(&statsMux);
+    *out = stats;
+    out->avgLatencyUs = stats.trips ? (uint32_t)(latencySumUs / stats.trips) : 0;
+    portEXIT_CRITICAL(&statsMux);
+    out->glitches = glitches;
+}
+
+void printFireFastPathStats() {
+    if (!glitchTimer) return;
+    FireFastPathStats s;
+    getFireFastPathStats(&s);
+    char line[128];
+    snprintf(line, sizeof(line), "🔥 Fire fast path: %u trips, %u glitches, edge to relay last %u us (min %u avg %u max %u)",
+             (unsigned)s.trips, (unsigned)s.glitches, (unsigned)s.lastLatencyUs,
+             (unsigned)s.minLatencyUs, (unsigned)s.avgLatencyUs, (unsigned)s.maxLatencyUs);
+    Serial.println(line);
+}
@@ -0,0 +1,242 @@
+#include "flame_flicker.h"
+#include "task_stats.h"
+#include "periodic_task.h"
+#include "deferred_log.h"
+#include "mem_placement.h"
+#include "esp_timer.h"
+#include "driver/adc.h"
+#include "esp_dsp.h"
+#include <math.h>
+
+// 🕯️ Flame Flicker Detection
+// The DMA driver fills its ring in the background; the task wakes once per
+// frame (FLAME_ADC_FRAME_CONV conversions) and only does DSP work every
+// FLAME_FFT_HOP decimated samples, so with the defaults that is one 256-point
+// FFT every 512 ms. The analysis history is kept oldest-first and shifted by a
+// hop after each window (memmove of 128 floats, cheaper than indexing a ring
+// through the window multiply).
+// Bin powers are weighted by the response of a first difference (4 sin^2 of
+// half the bin angle). A step - a lamp or IR source switching on - has a
+// 1/f^2 spectrum that would otherwise sit mostly in the low flicker bins; after
+// the weighting it is flat and only its in-band fraction counts.
+
+#define FLAME_ANALYSIS_HZ (FLAME_ADC_SAMPLE_HZ / FLAME_ADC_DECIMATE)
+#define FLAME_FRAME_BYTES (FLAME_ADC_FRAME_CONV * SOC_ADC_DIGI_RESULT_BYTES)
+
+static_assert((FLAME_FFT_SIZE & (FLAME_FFT_SIZE - 1)) == 0, "FLAME_FFT_SIZE must be a power of two");
+static_assert(FLAME_FFT_HOP > 0 && FLAME_FFT_HOP <= FLAME_FFT_SIZE, "FLAME_FFT_HOP must be 1..FLAME_FFT_SIZE");
+static_assert(FLAME_ADC_SAMPLE_HZ >= SOC_ADC_SAMPLE_FREQ_THRES_LOW, "FLAME_ADC_SAMPLE_HZ below the ADC minimum");
+
+static bool running = false;
+static volatile uint8_t confidence = 0;
+
+static FlameFlickerStats stats = {};
+static uint64_t workSumUs = 0;
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+#if FLAME_FLICKER
+static uint8_t adcChannel = 0;
+static uint8_t frame[FLAME_FRAME_BYTES] __attribute__((aligned(4)));
+static float history[FLAME_FFT_SIZE];                            // Decimated samples, oldest first
+static float hann[FLAME_FFT_SIZE];
+static float spectrum[2 * FLAME_FFT_SIZE] __attribute__((aligned(16)));   // Interleaved re/im
+static float twiddle[FLAME_FFT_SIZE] __attribute__((aligned(16)));
+static float slopeWeight[FLAME_FFT_SIZE / 2];
+
+// Flicker band in FFT bins (bin k is k * FLAME_ANALYSIS_HZ / FLAME_FFT_SIZE Hz)
+static const int bandLo = max(1, (FLAME_FLICKER_LO_HZ * FLAME_FFT_SIZE + FLAME_ANALYSIS_HZ / 2) / FLAME_ANALYSIS_HZ);
+static const int bandHi = min(FLAME_FFT_SIZE / 2 - 1,
+                              (FLAME_FLICKER_HI_HZ * FLAME_FFT_SIZE + FLAME_ANALYSIS_HZ / 2) / FLAME_ANALYSIS_HZ);
+
+// 📊 One window: mean removal, Hann, FFT, band share
+static void analyseWindow() {
+    int64_t startUs = esp_timer_get_time();
+
+    float sum = 0.0f, sumSq = 0.0f;
+    for (int i = 0; i < FLAME_FFT_SIZE; i++) {
+        sum += history[i];
+        sumSq += history[i] * history[i];
+    }
+    float mean = sum / FLAME_FFT_SIZE;
+    float variance = sumSq / FLAME_FFT_SIZE - mean * mean;
+    float rms = variance > 0.0f ? sqrtf(variance) : 0.0f;
+
+    // Real parts into the even slots, imaginary parts stay zero
+    memset(spectrum, 0, sizeof(spectrum));
+    dsps_addc_f32(history, spectrum, FLAME_FFT_SIZE, -mean, 1, 2);
+    dsps_mul_f32(spectrum, hann, spectrum, FLAME_FFT_SIZE, 2, 1, 2);
+    dsps_fft2r_fc32(spectrum, FLAME_FFT_SIZE);
+    dsps_bit_rev_fc32(spectrum, FLAME_FFT_SIZE);
+
+    float total = 0.0f, band = 0.0f, peak = 0.0f;
+    int peakBin = 0;
+    for (int k = 1; k < FLAME_FFT_SIZE / 2; k++) {
+        float re = spectrum[2 * k], im = spectrum[2 * k + 1];
+        float p = re * re + im * im;
+        float w = p * slopeWeight[k];
+        total += w;
+        if (k >= bandLo && k <= bandHi) {
+            band += w;
+            if (p > peak) {
+                peak = p;
+                peakBin = k;
+            }
+        }
+    }
+    uint8_t c = 0;
+    if (rms >= FLAME_MIN_AC_COUNTS && total > 0.0f) {
+        c = (uint8_t)(100.0f * band / total + 0.5f);
+    }
+    confidence = c;
+
+    uint32_t us = (uint32_t)(esp_timer_get_time() - startUs);
+    bool over = us > FLAME_DSP_BUDGET_US;
+    portENTER_CRITICAL(&statsMux);
+    stats.windows++;
+    stats.lastUs = us;
+    if (us > stats.maxUs) stats.maxUs = us;
+    if (over) stats.overBudget++;
+    workSumUs += us;
+    stats.rmsCounts = (uint16_t)min(rms, 65535.0f);
+    stats.peakCentiHz = (uint16_t)(peakBin * 100UL * FLAME_ANALYSIS_HZ / FLAME_FFT_SIZE);
+    stats.confidence = c;
+    portEXIT_CRITICAL(&statsMux);
+    if (over) {
+        logEvent(LOG_FLAME_DSP_OVER_BUDGET, us, (unsigned)FLAME_DSP_BUDGET_US);
+    }
+}
+#endif
+
+// 🔧 Setup
+bool initFlameFlicker() {
+#if FLAME_FLICKER
+    int channel = digitalPinToAnalogChannel(FLAME_ANALOG_PIN);
+    if (channel < 0 || channel >= 10) {
+        Serial.println("❌ Flame flicker: FLAME_ANALOG_PIN is not an ADC1 pin");
+        return false;
+    }
+    adcChannel = (uint8_t)channel;
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = 4 * FLAME_FRAME_BYTES;     // 256 ms of slack at 1 kHz
+    init.conv_num_each_intr = FLAME_FRAME_BYTES;
+    init.adc1_chan_mask = 1u << adcChannel;
+    init.adc2_chan_mask = 0;
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = ADC_ATTEN_DB_11;
+    pattern.channel = adcChannel;
+    pattern.unit = 0;
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_digi_configure_t config = {};
+    config.conv_limit_en = false;
+    config.conv_limit_num = 250;
+    config.pattern_num = 1;
+    config.adc_pattern = &pattern;
+    config.sample_freq_hz = FLAME_ADC_SAMPLE_HZ;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    if (adc_digi_initialize(&init) != ESP_OK || adc_digi_controller_configure(&config) != ESP_OK) {
+        Serial.println("❌ Flame flicker: ADC DMA setup failed");
+        return false;
+    }
+    if (dsps_fft2r_init_fc32(twiddle, FLAME_FFT_SIZE) != ESP_OK) {
+        Serial.println("❌ Flame flicker: FFT init failed");
+        adc_digi_deinitialize();
+        return false;
+    }
+    dsps_wind_hann_f32(hann, FLAME_FFT_SIZE);
+    for (int k = 0; k < FLAME_FFT_SIZE / 2; k++) {
+        float s = sinf((float)M_PI * k / FLAME_FFT_SIZE);
+        slopeWeight[k] = 4.0f * s * s;
+    }
+    MEM_DECLARE("flameFrame", frame, MEM_HOT);
+    MEM_DECLARE("flameSpectrum", spectrum, MEM_HOT);
+    if (adc_digi_start() != ESP_OK) {
+        Serial.println("❌ Flame flicker: ADC DMA start failed");
+        return false;
+    }
+    running = true;
+    Serial.printf("🕯️ Flame flicker: %u Hz ADC on GPIO%u, %u-point FFT every %u ms, %u-%u Hz band\n",
+                  (unsigned)FLAME_ADC_SAMPLE_HZ, (unsigned)FLAME_ANALOG_PIN, (unsigned)FLAME_FFT_SIZE,
+                  (unsigned)(FLAME_FFT_HOP * 1000UL / FLAME_ANALYSIS_HZ),
+                  (unsigned)FLAME_FLICKER_LO_HZ, (unsigned)FLAME_FLICKER_HI_HZ);
+    return true;
+#else
+    return false;
+#endif
+}
+
+// 🕯️ ADC Drain & Analysis Task (event driven: blocks on the DMA frames)
+void TaskFlameFlicker(void* pvParameters) {
+    (void)pvParameters;
+#if FLAME_FLICKER
+    uint32_t decimSum = 0;
+    uint8_t decimCount = 0;
+    int filled = 0;              // Valid samples in history
+#endif
+    for (;;) {
+        taskStatsLoop();
+        if (!running) {
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            continue;
+        }
+#if FLAME_FLICKER
+        uint32_t len = 0;
+        esp_err_t err = adc_digi_read_bytes(frame, sizeof(frame), &len, 100);
+        if (err == ESP_ERR_TIMEOUT) continue;
+        if (err == ESP_ERR_INVALID_STATE) {
+            portENTER_CRITICAL(&statsMux);
+            stats.adcOverruns++;     // Data is still valid, just not contiguous with the last frame
+            portEXIT_CRITICAL(&statsMux);
+        }
+
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            adc_digi_output_data_t conv;
+            memcpy(&conv, frame + i, sizeof(conv));
+            if (conv.type2.unit != 0 || conv.type2.channel != adcChannel) continue;
+            decimSum += conv.type2.data;
+            if (++decimCount < FLAME_ADC_DECIMATE) continue;
+
+            float sample = (float)decimSum / FLAME_ADC_DECIMATE;
+            decimSum = 0;
+            decimCount = 0;
+            history[filled++] = sample;
+            if (filled == FLAME_FFT_SIZE) {
+                analyseWindow();
+                memmove(history, history + FLAME_FFT_HOP, (FLAME_FFT_SIZE - FLAME_FFT_HOP) * sizeof(float));
+                filled = FLAME_FFT_SIZE - FLAME_FFT_HOP;
+            }
+        }
+#endif
+    }
+}
+
+uint8_t getFlameConfidence() {
+    return confidence;
+}
+
+// 📤 Statistics
+void getFlameFlickerStats(FlameFlickerStats* out) {
+    portENTER_CRITICAL(&statsMux);
+    *out = stats;
+    out->avgUs = stats.windows ? (uint32_t)(workSumUs / stats.windows) : 0;
+    portEXIT_CRITICAL(&statsMux);
+}
+
+void printFlameFlickerStats() {
+    if (!running) return;
+    FlameFlickerStats s;
+    getFlameFlickerStats(&s);
+    char line[192];
+    snprintf(line, sizeof(line),
+             "🕯️ Flame flicker: %u windows, confidence %u%% (rms %u, peak %u.%02u Hz), "
+             "dsp last %u avg %u max %u us (budget %u, %u over), %u ADC overruns",
+             (unsigned)s.windows, (unsigned)s.confidence, (unsigned)s.rmsCounts,
+             (unsigned)(s.peakCentiHz / 100), (unsigned)(s.peakCentiHz % 100),
+             (unsigned)s.lastUs, (unsigned)s.avgUs, (unsigned)s.maxUs,
+             (unsigned)FLAME_DSP_BUDGET_US, (unsigned)s.overBudget, (unsigned)s.adcOverruns);
+    Serial.println(line);
+}
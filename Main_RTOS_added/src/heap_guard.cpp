@@ -0,0 +1,125 @@
+#include "heap_guard.h"
+
+#ifndef SIM_NATIVE
+#include "esp_heap_caps.h"
+#include "soc/soc_memory_layout.h"
+#endif
+
+// 🧱 Heap Guard
+// Wrappers only count and remember the last call under a spinlock; the report
+// runs in TaskSystemMonitor and never allocates itself (stack buffer, one
+// Serial write).
+
+static volatile bool armed = false;
+static portMUX_TYPE guardMux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t allocs = 0;
+static uint32_t internalAllocs = 0;
+static uint32_t bytes = 0;
+static uint32_t lastSize = 0;
+static uintptr_t lastCaller = 0;
+static TaskHandle_t lastTask = nullptr;
+static uint32_t reportedAllocs = 0;
+
+#ifdef HEAP_GUARD_WRAP
+static void IRAM_ATTR noteAlloc(void* ptr, size_t size, void* caller) {
+    if (!armed || ptr == nullptr) return;
+#ifdef SIM_NATIVE
+    bool internal = true;
+#else
+    bool internal = !esp_ptr_external_ram(ptr);
+#endif
+    TaskHandle_t task = xPortInIsrContext() ? nullptr : xTaskGetCurrentTaskHandle();
+    portENTER_CRITICAL_ISR(&guardMux);
+    allocs++;
+    if (internal) internalAllocs++;
+    bytes += size;
+    lastSize = size;
+    lastCaller = (uintptr_t)caller;
+    lastTask = task;
+    portEXIT_CRITICAL_ISR(&guardMux);
+}
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* IRAM_ATTR __wrap_malloc(size_t size) {
+    void* ptr = __real_malloc(size);
+    noteAlloc(ptr, size, __builtin_return_address(0));
+    return ptr;
+}
+
+void* IRAM_ATTR __wrap_calloc(size_t count, size_t size) {
+    void* ptr = __real_calloc(count, size);
+    noteAlloc(ptr, count * size, __builtin_return_address(0));
+    return ptr;
+}
+
+// A realloc that shrinks or frees is not an allocation
+void* IRAM_ATTR __wrap_realloc(void* ptr, size_t size) {
+    void* moved = __real_realloc(ptr, size);
+    if (size != 0 && (ptr == nullptr || moved != ptr)) {
+        noteAlloc(moved, size, __builtin_return_address(0));
+    }
+    return moved;
+}
+}
+#endif
+
+// 🔧 Setup
+void armHeapGuard() {
+    portENTER_CRITICAL(&guardMux);
+    allocs = 0;
+    internalAllocs = 0;
+    bytes = 0;
+    portEXIT_CRITICAL(&guardMux);
+    reportedAllocs = 0;
+    armed = true;
+
+#ifdef HEAP_GUARD_WRAP
+    Serial.println("🧱 Heap guard: counting allocations from here on");
+#else
+    Serial.println("🧱 Heap guard: allocation counting not linked in (HEAP_GUARD_WRAP)");
+#endif
+}
+
+// 📤 Readers
+void getHeapGuardStats(HeapGuardStats* out) {
+    portENTER_CRITICAL(&guardMux);
+    out->allocs = allocs;
+    out->internalAllocs = internalAllocs;
+    out->bytes = bytes;
+    out->lastSize = lastSize;
+    out->lastCaller = lastCaller;
+    out->lastTask = lastTask;
+    portEXIT_CRITICAL(&guardMux);
+
+#ifdef HEAP_GUARD_WRAP
+    out->counting = true;
+#else
+    out->counting = false;
+#endif
+    out->armed = armed;
+#ifdef SIM_NATIVE
+    out->freeInternal = ESP.getFreeHeap();
+    out->minFreeInternal = ESP.getMinFreeHeap();
+#else
+    out->freeInternal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    out->minFreeInternal = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+#endif
+}
+
+bool checkHeapGuard() {
+    HeapGuardStats s;
+    getHeapGuardStats(&s);
+    if (!s.armed || s.allocs == reportedAllocs) return false;
+
+    char line[128];
+    snprintf(line, sizeof(line), "⚠️ Heap: %u allocations after boot (%u internal, +%u), last %u B in %s from 0x%08x",
+             (unsigned)s.allocs, (unsigned)s.internalAllocs, (unsigned)(s.allocs - reportedAllocs),
+             (unsigned)s.lastSize, s.lastTask ? pcTaskGetName(s.lastTask) : "ISR/boot", (unsigned)s.lastCaller);
+    Serial.println(line);
+    reportedAllocs = s.allocs;
+    return true;
+}
@@ -0,0 +1,273 @@
+#include "history_rollup.h"
+#include "history_store.h"   // HIST_HAZ_* bits
+#include "mem_placement.h"
+#include "esp_timer.h"
+
+// 📊 Sensor History Rollups
+// Bucket index i of a level covers seconds [i * width, (i + 1) * width) and
+// lives in ring slot i % buckets; the ring holds indices oldest()..head.
+// Each level's tree has 2 * buckets nodes: leaves at [buckets, 2 * buckets),
+// node p = merge(2p, 2p + 1). Merging is commutative, so the bottom-up
+// layout works for any bucket count. One spinlock covers appends and
+// queries: both touch a few dozen nodes per level. Clearing the buckets a
+// gap skipped (up to a whole tree) happens outside it: the buckets whose
+// slots get reused are first retired under the lock (floor), so no query
+// reads those slots, or any node above them, while they are cleared.
+
+enum RollupLevelId : uint8_t {
+    LV_MINUTE = 0,
+    LV_HOUR,
+    LV_DAY,
+    LV_COUNT
+};
+
+struct RollupLevel {
+    const char* name;
+    uint32_t widthSec;
+    uint32_t buckets;
+    RollupAgg* tree;         // PSRAM
+    uint32_t head;           // Bucket of the newest point
+    uint32_t floor;          // Oldest bucket queries may read
+};
+
+static RollupLevel levels[LV_COUNT] = {
+    {"rollup-minutes", 60, ROLLUP_MINUTE_BUCKETS, nullptr, 0, 0},
+    {"rollup-hours", 3600, ROLLUP_HOUR_BUCKETS, nullptr, 0, 0},
+    {"rollup-days", 86400, ROLLUP_DAY_BUCKETS, nullptr, 0, 0},
+};
+
+static bool started = false;
+static bool ready = false;
+static uint32_t newestSec = 0;
+static uint32_t added = 0;
+static uint8_t prevHazards = 0;              // TaskSensorPoll only
+static portMUX_TYPE rollMux = portMUX_INITIALIZER_UNLOCKED;
+
+static const RollupAgg EMPTY_AGG = {0, 0, 0, INT16_MAX, INT16_MIN, INT16_MAX, INT16_MIN, 0, 0, 0, 0};
+
+static inline void merge(RollupAgg* a, const RollupAgg* b) {
+    a->tempSum += b->tempSum;
+    a->humSum += b->humSum;
+    a->samples += b->samples;
+    if (b->tempMin < a->tempMin) a->tempMin = b->tempMin;
+    if (b->tempMax > a->tempMax) a->tempMax = b->tempMax;
+    if (b->humMin < a->humMin) a->humMin = b->humMin;
+    if (b->humMax > a->humMax) a->humMax = b->humMax;
+    a->motionEvents += b->motionEvents;
+    a->intrusionAlarms += b->intrusionAlarms;
+    a->fireEvents += b->fireEvents;
+    a->doorOpenings += b->doorOpenings;
+}
+
+static inline uint32_t oldest(const RollupLevel* L) {
+    uint32_t first = L->head >= L->buckets ? L->head - L->buckets + 1 : 0;
+    return first > L->floor ? first : L->floor;
+}
+
+// 🌲 Tree maintenance
+static void clearSlot(RollupLevel* L, uint32_t slot) {
+    uint32_t p = L->buckets + slot;
+    L->tree[p] = EMPTY_AGG;
+    for (p >>= 1; p > 0; p >>= 1) {
+        L->tree[p] = L->tree[2 * p];
+        merge(&L->tree[p], &L->tree[2 * p + 1]);
+    }
+}
+
+// Under rollMux: retire the buckets whose slots bucket index reuses
+static void retire(RollupLevel* L, uint32_t index) {
+    if (index <= L->head) return;
+    uint32_t first = index >= L->buckets ? index - L->buckets + 1 : 0;
+    if (first > L->floor) L->floor = first;
+}
+
+// Outside rollMux (TaskSensorPoll is the only writer): clear the slots of the
+// buckets skipped since the last point, all retired by retire()
+static void clearSkipped(RollupLevel* L, uint32_t index) {
+    if (index <= L->head) return;
+    if (index - L->head >= L->buckets) {
+        for (uint32_t p = 1; p < 2 * L->buckets; p++) L->tree[p] = EMPTY_AGG;
+    } else {
+        for (uint32_t i = L->head + 1; i <= index; i++) clearSlot(L, i % L->buckets);
+    }
+}
+
+// A leaf and its ancestors all absorb the sample: no sibling is read
+static void addToHead(RollupLevel* L, const RollupAgg* sample) {
+    for (uint32_t p = L->buckets + L->head % L->buckets; p > 0; p >>= 1) merge(&L->tree[p], sample);
+}
+
+// 🔎 Queries
+static void treeRange(const RollupLevel* L, uint32_t l, uint32_t r, RollupAgg* out) {
+    for (l += L->buckets, r += L->buckets; l < r; l >>= 1, r >>= 1) {
+        if (l & 1) merge(out, &L->tree[l++]);
+        if (r & 1) merge(out, &L->tree[--r]);
+    }
+}
+
+// Buckets [i0, i1) of one level, clipped to what the ring still holds
+static void addBuckets(const RollupLevel* L, uint32_t i0, uint32_t i1, RollupAgg* out) {
+    if (i0 < oldest(L)) i0 = oldest(L);
+    if (i1 > L->head + 1) i1 = L->head + 1;
+    if (i0 >= i1) return;
+    uint32_t s0 = i0 % L->buckets;
+    uint32_t len = i1 - i0;
+    if (s0 + len <= L->buckets) {
+        treeRange(L, s0, s0 + len, out);
+    } else {
+        treeRange(L, s0, L->buckets, out);
+        treeRange(L, 0, s0 + len - L->buckets, out);
+    }
+}
+
+static void queryLevel(uint8_t lv, uint32_t fromSec, uint32_t toSec, RollupAgg* out);
+
+// A piece [from, to) inside one bucket of level lv: the finer level if it
+// still holds the piece, else the whole bucket
+static void queryEdge(uint8_t lv, uint32_t fromSec, uint32_t toSec, RollupAgg* out) {
+    if (fromSec >= toSec) return;
+    const RollupLevel* finer = &levels[lv - 1];
+    if (fromSec / finer->widthSec >= oldest(finer)) {
+        queryLevel(lv - 1, fromSec, toSec, out);
+    } else {
+        uint32_t index = fromSec / levels[lv].widthSec;
+        addBuckets(&levels[lv], index, index + 1, out);
+    }
+}
+
+static void queryLevel(uint8_t lv, uint32_t fromSec, uint32_t toSec, RollupAgg* out) {
+    if (fromSec >= toSec) return;
+    const RollupLevel* L = &levels[lv];
+    uint32_t w = L->widthSec;
+    if (lv == LV_MINUTE) {
+        addBuckets(L, fromSec / w, (toSec - 1) / w + 1, out);
+        return;
+    }
+    uint32_t first = (fromSec + w - 1) / w;  // Whole buckets [first, last)
+    uint32_t last = toSec / w;
+    if (first < last) {
+        addBuckets(L, first, last, out);
+        queryEdge(lv, fromSec, first * w, out);
+        queryEdge(lv, last * w, toSec, out);
+    } else if (first * w > fromSec && first * w < toSec) {
+        queryEdge(lv, fromSec, first * w, out);   // Straddles one boundary
+        queryEdge(lv, first * w, toSec, out);
+    } else {
+        queryEdge(lv, fromSec, toSec, out);
+    }
+}
+
+// 🚀 Setup
+bool initHistoryRollup() {
+    size_t bytes = 0;
+    for (RollupLevel& L : levels) {
+        L.tree = (RollupAgg*)memPlace(L.name, sizeof(RollupAgg) * 2 * L.buckets, MEM_BULK);
+        if (!L.tree) {
+            Serial.println("⚠️ Rollup: no room for the bucket trees, rollups disabled");
+            return false;
+        }
+        for (uint32_t p = 0; p < 2 * L.buckets; p++) L.tree[p] = EMPTY_AGG;
+        bytes += sizeof(RollupAgg) * 2 * L.buckets;
+    }
+    ready = true;
+    Serial.printf("📊 Rollup: %u minutes, %u hours, %u days of buckets (%u KB)\n",
+                  (unsigned)ROLLUP_MINUTE_BUCKETS, (unsigned)ROLLUP_HOUR_BUCKETS,
+                  (unsigned)ROLLUP_DAY_BUCKETS, (unsigned)(bytes / 1024));
+    return true;
+}
+
+uint32_t rollupNowSec() {
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+// ✍️ Append
+void rollupAdd(uint32_t sec, int16_t tempC, int16_t humPct, uint8_t hazards) {
+    if (!ready) return;
+    uint8_t rising = hazards & ~prevHazards;
+    prevHazards = hazards;
+
+    RollupAgg sample = {tempC, humPct, 1, tempC, tempC, humPct, humPct,
+                        (rising & HIST_HAZ_MOTION) ? 1u : 0u, (rising & HIST_HAZ_INTRUSION) ? 1u : 0u,
+                        (rising & HIST_HAZ_FIRE) ? 1u : 0u, (rising & HIST_HAZ_DOOR) ? 1u : 0u};
+
+    if (started && sec < newestSec) {
+        sec = newestSec;                     // Never step back into a closed bucket
+    }
+    if (started) {
+        portENTER_CRITICAL(&rollMux);
+        for (RollupLevel& L : levels) retire(&L, sec / L.widthSec);
+        portEXIT_CRITICAL(&rollMux);
+        for (RollupLevel& L : levels) clearSkipped(&L, sec / L.widthSec);
+    }
+
+    portENTER_CRITICAL(&rollMux);
+    for (RollupLevel& L : levels) {
+        uint32_t index = sec / L.widthSec;
+        if (!started || index > L.head) L.head = index;
+        addToHead(&L, &sample);
+    }
+    started = true;
+    newestSec = sec;
+    added++;
+    portEXIT_CRITICAL(&rollMux);
+}
+
+void rollupQuery(uint32_t fromSec, uint32_t toSec, RollupAgg* out) {
+    *out = EMPTY_AGG;
+    if (!ready) return;
+    portENTER_CRITICAL(&rollMux);
+    if (started) queryLevel(LV_DAY, fromSec, toSec, out);
+    portEXIT_CRITICAL(&rollMux);
+}
+
+void rollupLast(uint32_t seconds, RollupAgg* out) {
+    uint32_t toSec = newestSec + 1;
+    rollupQuery(toSec > seconds ? toSec - seconds : 0, toSec, out);
+}
+
+static int32_t avg10(int64_t sum, uint32_t samples) {
+    if (!samples) return 0;
+    int64_t scaled = sum * 10;
+    return (int32_t)((scaled + (scaled >= 0 ? samples / 2 : -(int64_t)(samples / 2))) / (int64_t)samples);
+}
+
+int32_t rollupTempAvg10(const RollupAgg* agg) {
+    return avg10(agg->tempSum, agg->samples);
+}
+
+int32_t rollupHumAvg10(const RollupAgg* agg) {
+    return avg10(agg->humSum, agg->samples);
+}
+
+// 📤 Summary
+static const struct {
+    const char* label;
+    uint32_t seconds;
+} SUMMARY_WINDOWS[] = {{"1h", 3600}, {"24h", 86400}, {"7d", 7 * 86400}};
+
+size_t formatRollupSummary(char* out, size_t size) {
+    int n = 0;
+    for (size_t i = 0; i < sizeof(SUMMARY_WINDOWS) / sizeof(SUMMARY_WINDOWS[0]) && n >= 0 && (size_t)n < size; i++) {
+        RollupAgg a;
+        rollupLast(SUMMARY_WINDOWS[i].seconds, &a);
+        const char* sep = i ? " | " : "";
+        if (!a.samples) {
+            n += snprintf(out + n, size - n, "%s%s -", sep, SUMMARY_WINDOWS[i].label);
+            continue;
+        }
+        int32_t t10 = rollupTempAvg10(&a), h10 = rollupHumAvg10(&a);
+        n += snprintf(out + n, size - n, "%s%s T %d/%s%d.%d/%dC H %d/%d.%d/%d%% M%u I%u F%u",
+                      sep, SUMMARY_WINDOWS[i].label, a.tempMin, t10 < 0 ? "-" : "", (int)(abs(t10) / 10),
+                      (int)(abs(t10) % 10), a.tempMax, a.humMin, (int)(h10 / 10), (int)(h10 % 10), a.humMax,
+                      (unsigned)a.motionEvents, (unsigned)a.intrusionAlarms, (unsigned)a.fireEvents);
+    }
+    return n < 0 ? 0 : ((size_t)n < size ? (size_t)n : size - 1);
+}
+
+void printRollupStats() {
+    if (!ready) return;
+    char line[200];
+    int n = snprintf(line, sizeof(line), "📊 Rollup: %u points, ", (unsigned)added);
+    formatRollupSummary(line + n, sizeof(line) - n);
+    Serial.println(line);
+}
@@ -0,0 +1,444 @@
+#include "history_store.h"
+#include "mem_placement.h"
+#include "system.h"     // historyMutex
+
+// 🗄️ Sensor History Store
+// Block sequence numbers count from 1 since boot; block seq lives in ring
+// slot seq % HISTORY_BLOCKS, so the ring holds seqs oldestSeq()..openSeq in
+// time order. The writer fills the open block's payload beyond header.bits
+// and only then publishes count/bits under histMux: a reader that copies a
+// block under the same lock sees a consistent prefix. Bits are packed MSB
+// first; a block's payload is zeroed when it is opened.
+
+#define HISTORY_MASK (HISTORY_BLOCKS - 1)
+static_assert((HISTORY_BLOCKS & HISTORY_MASK) == 0, "HISTORY_BLOCKS must be a power of two");
+
+#define SCAN_MARGIN_MS 60000         // Points appended while a scan runs stay "newer than now"
+#define HIST_EXPORT_PREFIX "#H:"
+#define HIST_EXPORT_VERSION 1
+
+struct HistoryBlockHeader {
+    uint32_t seq;                            // 0 = never used
+    uint32_t firstMs;
+    uint32_t lastMs;
+    uint16_t count;                          // Points, the first one raw in first[]
+    uint16_t bits;                           // Payload bits used
+    int16_t first[HIST_CHANNELS];
+};
+
+#define PAYLOAD_BYTES (HISTORY_BLOCK_BYTES - sizeof(HistoryBlockHeader))
+#define PAYLOAD_BITS (PAYLOAD_BYTES * 8)
+
+struct HistoryBlock {
+    HistoryBlockHeader h;
+    uint8_t payload[PAYLOAD_BYTES];
+};
+static_assert(sizeof(HistoryBlock) == HISTORY_BLOCK_BYTES, "HistoryBlock must fill HISTORY_BLOCK_BYTES");
+static_assert(PAYLOAD_BITS < 65536, "HISTORY_BLOCK_BYTES too large for 16-bit bit counts");
+
+static HistoryBlock* blocks = nullptr;       // PSRAM
+static uint32_t openSeq = 0;                 // Block being filled
+static uint32_t appended = 0;
+static portMUX_TYPE histMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Writer state (TaskSensorPoll only)
+static HistoryPoint prev;
+static uint32_t prevDeltaMs = HISTORY_INTERVAL_MS;
+
+// Export state (TaskSystemMonitor only)
+static volatile bool exportRequested = false;
+static volatile uint32_t exportMinutes = 0;
+static bool exportActive = false;
+static uint32_t exportCursorMs = 0;
+static uint32_t exportEndMs = 0;
+static uint32_t exportLines = 0;
+
+static inline uint32_t oldestSeq() {
+    return openSeq >= HISTORY_BLOCKS ? openSeq - HISTORY_BLOCKS + 1 : 1;
+}
+
+// Scans order timestamps by their age against a reference just after the
+// newest point, which stays right across the millis() wrap
+static inline bool before(uint32_t a, uint32_t b, uint32_t refMs) {
+    return refMs - a > refMs - b;
+}
+
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// ✍️ Bit packing
+struct BitWriter {
+    uint8_t* buf;                            // nullptr = only count
+    uint16_t pos;
+};
+
+static void putBits(BitWriter* w, uint32_t value, uint8_t n) {
+    if (w->buf) {
+        for (int i = n - 1; i >= 0; i--) {
+            if ((value >> i) & 1) w->buf[w->pos >> 3] |= (uint8_t)(0x80u >> (w->pos & 7));
+            w->pos++;
+        }
+    } else {
+        w->pos += n;
+    }
+}
+
+struct BitReader {
+    const uint8_t* buf;
+    uint16_t pos;
+};
+
+static uint32_t getBits(BitReader* r, uint8_t n) {
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < n; i++, r->pos++) {
+        v = (v << 1) | ((r->buf[r->pos >> 3] >> (7 - (r->pos & 7))) & 1);
+    }
+    return v;
+}
+
+// Reads up to `max` one-bits of a unary prefix ('0', '10', '110', ...)
+static uint8_t getPrefix(BitReader* r, uint8_t max) {
+    uint8_t ones = 0;
+    while (ones < max && getBits(r, 1)) ones++;
+    return ones;
+}
+
+// 🧮 Field codes
+static void putTimestamp(BitWriter* w, int32_t dod) {
+    uint32_t z = zigzag(dod);
+    if (dod == 0) {
+        putBits(w, 0, 1);
+    } else if (z < (1u << 7)) {
+        putBits(w, 0b10, 2);
+        putBits(w, z, 7);
+    } else if (z < (1u << 12)) {
+        putBits(w, 0b110, 3);
+        putBits(w, z, 12);
+    } else if (z < (1u << 20)) {
+        putBits(w, 0b1110, 4);
+        putBits(w, z, 20);
+    } else {
+        putBits(w, 0b1111, 4);
+        putBits(w, (uint32_t)dod, 32);
+    }
+}
+
+static int32_t getTimestamp(BitReader* r) {
+    switch (getPrefix(r, 4)) {
+        case 0: return 0;
+        case 1: return unzigzag(getBits(r, 7));
+        case 2: return unzigzag(getBits(r, 12));
+        case 3: return unzigzag(getBits(r, 20));
+        default: return (int32_t)getBits(r, 32);
+    }
+}
+
+static void putNumeric(BitWriter* w, int16_t last, int16_t value) {
+    uint32_t z = zigzag((int32_t)value - last);
+    if (value == last) {
+        putBits(w, 0, 1);
+    } else if (z < (1u << 4)) {
+        putBits(w, 0b10, 2);
+        putBits(w, z, 4);
+    } else if (z < (1u << 8)) {
+        putBits(w, 0b110, 3);
+        putBits(w, z, 8);
+    } else {
+        putBits(w, 0b111, 3);
+        putBits(w, (uint16_t)value, 16);
+    }
+}
+
+static int16_t getNumeric(BitReader* r, int16_t last) {
+    switch (getPrefix(r, 3)) {
+        case 0: return last;
+        case 1: return (int16_t)(last + unzigzag(getBits(r, 4)));
+        case 2: return (int16_t)(last + unzigzag(getBits(r, 8)));
+        default: return (int16_t)getBits(r, 16);
+    }
+}
+
+static void putHazards(BitWriter* w, int16_t last, int16_t value) {
+    uint32_t x = (uint32_t)(last ^ value) & ((1u << HIST_HAZ_BITS) - 1);
+    if (!x) {
+        putBits(w, 0, 1);
+    } else {
+        putBits(w, 1, 1);
+        putBits(w, x, HIST_HAZ_BITS);
+    }
+}
+
+static int16_t getHazards(BitReader* r, int16_t last) {
+    if (!getBits(r, 1)) return last;
+    return (int16_t)(last ^ getBits(r, HIST_HAZ_BITS));
+}
+
+static void putPoint(BitWriter* w, const HistoryPoint* p, int32_t dod) {
+    bool repeat = dod == 0;
+    for (uint8_t c = 0; c < HIST_CHANNELS && repeat; c++) repeat = p->value[c] == prev.value[c];
+    if (repeat) {
+        putBits(w, 0, 1);
+        return;
+    }
+    putBits(w, 1, 1);
+    putTimestamp(w, dod);
+    putNumeric(w, prev.value[HIST_TEMPERATURE], p->value[HIST_TEMPERATURE]);
+    putNumeric(w, prev.value[HIST_HUMIDITY], p->value[HIST_HUMIDITY]);
+    putNumeric(w, prev.value[HIST_DISTANCE], p->value[HIST_DISTANCE]);
+    putHazards(w, prev.value[HIST_HAZARDS], p->value[HIST_HAZARDS]);
+}
+
+// 🧱 Blocks
+static void openBlock(const HistoryPoint* p) {
+    uint32_t seq = openSeq + 1;
+    HistoryBlock* b = &blocks[seq & HISTORY_MASK];
+    portENTER_CRITICAL(&histMux);
+    b->h.seq = seq;
+    b->h.firstMs = b->h.lastMs = p->tsMs;
+    b->h.count = 1;
+    b->h.bits = 0;
+    memcpy(b->h.first, p->value, sizeof(b->h.first));
+    openSeq = seq;
+    portEXIT_CRITICAL(&histMux);
+    memset(b->payload, 0, sizeof(b->payload));   // Beyond bits: no reader looks at it
+}
+
+void historyAppend(const HistoryPoint* point) {
+    if (!blocks) return;
+    HistoryPoint p = *point;
+    if (appended && abs(p.value[HIST_DISTANCE] - prev.value[HIST_DISTANCE]) < HISTORY_DISTANCE_DEADBAND_CM) {
+        p.value[HIST_DISTANCE] = prev.value[HIST_DISTANCE];
+    }
+    appended++;
+
+    HistoryBlock* b = &blocks[openSeq & HISTORY_MASK];
+    uint32_t deltaMs = p.tsMs - prev.tsMs;
+    int32_t dod = (int32_t)(deltaMs - prevDeltaMs);
+    BitWriter size = { nullptr, b->h.bits };
+    putPoint(&size, &p, dod);
+
+    if (openSeq == 0 || size.pos > PAYLOAD_BITS) {
+        openBlock(&p);                         // Starts raw: the interval restarts too
+        prev = p;
+        prevDeltaMs = HISTORY_INTERVAL_MS;
+        return;
+    }
+    BitWriter w = { b->payload, b->h.bits };
+    putPoint(&w, &p, dod);
+    portENTER_CRITICAL(&histMux);
+    b->h.bits = w.pos;
+    b->h.count++;
+    b->h.lastMs = p.tsMs;
+    portEXIT_CRITICAL(&histMux);
+    prev = p;
+    prevDeltaMs = deltaMs;
+}
+
+// 📖 Readers
+static bool readHeader(uint32_t seq, HistoryBlockHeader* out) {
+    const HistoryBlock* b = &blocks[seq & HISTORY_MASK];
+    portENTER_CRITICAL(&histMux);
+    *out = b->h;
+    portEXIT_CRITICAL(&histMux);
+    return out->seq == seq && out->count > 0;
+}
+
+static bool copyBlock(uint32_t seq, HistoryBlock* out) {
+    const HistoryBlock* b = &blocks[seq & HISTORY_MASK];
+    portENTER_CRITICAL(&histMux);
+    out->h = b->h;
+    memcpy(out->payload, b->payload, (out->h.bits + 7) / 8);
+    portEXIT_CRITICAL(&histMux);
+    return out->h.seq == seq && out->h.count > 0;
+}
+
+// First block whose last point is not before fromMs
+static uint32_t findBlock(uint32_t fromMs, uint32_t refMs) {
+    uint32_t lo = oldestSeq(), hi = openSeq;
+    HistoryBlockHeader h;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (!readHeader(mid, &h) || before(h.lastMs, fromMs, refMs)) {
+            lo = mid + 1;                      // Overwritten blocks count as old
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Decodes one block copy; false when the visitor stopped or toMs was passed
+static bool visitBlock(const HistoryBlock* b, uint32_t fromMs, uint32_t toMs, uint32_t refMs,
+                       HistoryVisitor visit, void* ctx, uint32_t* visited) {
+    HistoryPoint p;
+    p.tsMs = b->h.firstMs;
+    memcpy(p.value, b->h.first, sizeof(p.value));
+    uint32_t deltaMs = HISTORY_INTERVAL_MS;
+    BitReader r = { b->payload, 0 };
+
+    for (uint16_t i = 0; i < b->h.count; i++) {
+        if (i > 0) {
+            if (getBits(&r, 1)) {
+                deltaMs += getTimestamp(&r);
+                p.value[HIST_TEMPERATURE] = getNumeric(&r, p.value[HIST_TEMPERATURE]);
+                p.value[HIST_HUMIDITY] = getNumeric(&r, p.value[HIST_HUMIDITY]);
+                p.value[HIST_DISTANCE] = getNumeric(&r, p.value[HIST_DISTANCE]);
+                p.value[HIST_HAZARDS] = getHazards(&r, p.value[HIST_HAZARDS]);
+            }
+            p.tsMs += deltaMs;
+        }
+        if (before(toMs, p.tsMs, refMs)) return false;
+        if (before(p.tsMs, fromMs, refMs)) continue;
+        (*visited)++;
+        if (!visit(&p, ctx)) return false;
+    }
+    return true;
+}
+
+uint32_t historyScan(uint32_t fromMs, uint32_t toMs, HistoryVisitor visit, void* ctx) {
+    if (!blocks || !openSeq) return 0;
+    static HistoryBlock copy;                  // Scans take turns on historyMutex
+    uint32_t visited = 0;
+
+    xSemaphoreTake(historyMutex, portMAX_DELAY);
+    portENTER_CRITICAL(&histMux);
+    uint32_t refMs = blocks[openSeq & HISTORY_MASK].h.lastMs + SCAN_MARGIN_MS;
+    portEXIT_CRITICAL(&histMux);
+    for (uint32_t seq = findBlock(fromMs, refMs); seq <= openSeq; seq++) {
+        if (!copyBlock(seq, &copy)) continue;  // Overwritten while we got here
+        if (before(toMs, copy.h.firstMs, refMs)) break;
+        if (!visitBlock(&copy, fromMs, toMs, refMs, visit, ctx, &visited)) break;
+    }
+    xSemaphoreGive(historyMutex);
+    return visited;
+}
+
+bool historyNewest(HistoryPoint* out) {
+    if (!blocks || !appended) return false;
+    portENTER_CRITICAL(&histMux);
+    uint32_t newestMs = blocks[openSeq & HISTORY_MASK].h.lastMs;
+    portEXIT_CRITICAL(&histMux);
+    struct Last {
+        static bool keep(const HistoryPoint* p, void* ctx) {
+            *(HistoryPoint*)ctx = *p;
+            return true;
+        }
+    };
+    return historyScan(newestMs, newestMs, Last::keep, out) > 0;
+}
+
+// 🔧 Setup
+bool initHistoryStore() {
+    blocks = (HistoryBlock*)memPlace("history", sizeof(HistoryBlock) * HISTORY_BLOCKS, MEM_BULK);
+    if (!blocks) {
+        Serial.println("⚠️ History: no PSRAM, sensor history disabled");
+        return false;
+    }
+    memset(blocks, 0, sizeof(HistoryBlock) * HISTORY_BLOCKS);
+    Serial.printf("🗄️ History: %u blocks of %u B in PSRAM (%u KB), one point per %u ms\n",
+                  (unsigned)HISTORY_BLOCKS, (unsigned)HISTORY_BLOCK_BYTES,
+                  (unsigned)(sizeof(HistoryBlock) * HISTORY_BLOCKS / 1024), (unsigned)HISTORY_INTERVAL_MS);
+    return true;
+}
+
+// 📤 Statistics
+void getHistoryStats(HistoryStats* out) {
+    memset(out, 0, sizeof(*out));
+    out->points = appended;
+    if (!blocks || !openSeq) return;
+    uint64_t bits = 0;
+    HistoryBlockHeader h;
+    for (uint32_t seq = oldestSeq(); seq <= openSeq; seq++) {
+        if (!readHeader(seq, &h)) continue;
+        if (!out->blocksUsed) out->oldestMs = h.firstMs;
+        out->blocksUsed++;
+        out->storedPoints += h.count;
+        out->newestMs = h.lastMs;
+        bits += h.bits + sizeof(HistoryBlockHeader) * 8;
+    }
+    out->bytesUsed = out->blocksUsed * HISTORY_BLOCK_BYTES;
+    out->centiBitsPerPoint = out->storedPoints ? (uint16_t)(bits * 100 / out->storedPoints) : 0;
+}
+
+void printHistoryStats() {
+    if (!blocks) return;
+    HistoryStats s;
+    getHistoryStats(&s);
+    char line[160];
+    snprintf(line, sizeof(line),
+             "🗄️ History: %u points, %u stored in %u/%u blocks (%u KB), %u.%02u bits/point, span %u s",
+             (unsigned)s.points, (unsigned)s.storedPoints, (unsigned)s.blocksUsed, (unsigned)HISTORY_BLOCKS,
+             (unsigned)(s.bytesUsed / 1024), (unsigned)(s.centiBitsPerPoint / 100),
+             (unsigned)(s.centiBitsPerPoint % 100), (unsigned)((s.newestMs - s.oldestMs) / 1000));
+    Serial.println(line);
+}
+
+// 📤 Export
+void historyRequestExport(uint32_t minutes) {
+    exportMinutes = minutes;
+    exportRequested = true;
+}
+
+bool historyExportPending() {
+    return exportRequested || exportActive;
+}
+
+static void writeLine(const char* line, size_t len) {
+    Serial.write((const uint8_t*)line, len);   // One write per line: never split by the log drain
+}
+
+struct ExportPass {
+    uint32_t lines;
+};
+
+// P ts_ms temperature humidity distance hazards
+static bool exportPoint(const HistoryPoint* p, void* ctx) {
+    ExportPass* pass = (ExportPass*)ctx;
+    char line[64];
+    size_t n = snprintf(line, sizeof(line), HIST_EXPORT_PREFIX "P %u %d %d %d %d\n", (unsigned)p->tsMs,
+                        p->value[HIST_TEMPERATURE], p->value[HIST_HUMIDITY], p->value[HIST_DISTANCE],
+                        p->value[HIST_HAZARDS]);
+    writeLine(line, n);
+    exportCursorMs = p->tsMs + 1;
+    exportLines++;
+    return ++pass->lines < HISTORY_EXPORT_LINES;
+}
+
+void serviceHistoryExport() {
+    if (!blocks) {
+        exportRequested = false;
+        return;
+    }
+    char line[64];
+    size_t n;
+    if (exportRequested && !exportActive) {
+        exportRequested = false;
+        HistoryStats s;
+        getHistoryStats(&s);
+        exportEndMs = s.newestMs;
+        exportCursorMs = s.oldestMs;
+        uint32_t spanMs = exportMinutes * 60000u;
+        if (exportMinutes && spanMs < exportEndMs - s.oldestMs) exportCursorMs = exportEndMs - spanMs;
+        exportLines = 0;
+        exportActive = true;
+        // H version channels from_ms to_ms
+        n = snprintf(line, sizeof(line), HIST_EXPORT_PREFIX "H %u %u %u %u\n", HIST_EXPORT_VERSION,
+                     (unsigned)HIST_CHANNELS, (unsigned)exportCursorMs, (unsigned)exportEndMs);
+        writeLine(line, n);
+        return;
+    }
+    if (!exportActive) return;
+
+    ExportPass pass = { 0 };
+    historyScan(exportCursorMs, exportEndMs, exportPoint, &pass);
+    if (pass.lines < HISTORY_EXPORT_LINES) {
+        n = snprintf(line, sizeof(line), HIST_EXPORT_PREFIX "Z %u\n", (unsigned)exportLines);
+        writeLine(line, n);
+        exportActive = false;
+    }
+}
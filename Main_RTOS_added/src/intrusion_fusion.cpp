@@ -0,0 +1,191 @@
+#include "intrusion_fusion.h"
+#include "system.h"         // Event, EventType
+#include "deferred_log.h"
+#include "freertos/queue.h"
+
+// 🕵️ Intrusion Fusion
+// One slot per sensor sample, each a bitmask of the sources seen during it.
+// Pushing a slot adds its bits to the per-source counts and subtracts the
+// bits of the slot it overwrites. The PIR is event driven (edge capture in
+// the esp_timer task, or readMotion), so the slot under way also remembers a
+// PIR pulse that came and went between two samples. Both producers update
+// under fusionMux; the alert transitions are decided inside it and posted
+// outside, so each one is posted exactly once.
+
+#define INTRUSION_SLOTS (INTRUSION_WINDOW_MS / SENSOR_POLL_INTERVAL_MS)
+static_assert(INTRUSION_SLOTS >= 1 && INTRUSION_SLOTS <= 255, "INTRUSION_WINDOW_MS out of range");
+static_assert(INTRUSION_W_PIR + INTRUSION_W_MOVE + INTRUSION_W_DOOR == 100, "INTRUSION_W_* must add up to 100");
+static_assert(INTRUSION_W_MOVE + INTRUSION_W_DOOR < INTRUSION_ALARM_ON, "An alert must need the PIR");
+
+enum : uint8_t {
+    SRC_PIR  = (1u << 0),
+    SRC_MOVE = (1u << 1),
+    SRC_DOOR = (1u << 2)
+};
+
+static uint8_t slots[INTRUSION_SLOTS];
+static uint8_t slotHead = 0;                  // Oldest slot, overwritten next
+static uint8_t pirCount = 0, moveCount = 0, doorCount = 0;
+
+static bool pirLevel = false;                 // Debounced PIR output
+static bool pirSeen = false;                  // PIR high at some point in the slot under way
+static int lastDistanceCm = -1;
+
+static bool alertOn = false;
+static bool alertPosted = false;              // EVENT_MOTION_DETECTED sent, CLEARED owed
+static bool episode = false;                  // PIR evidence in the window
+static bool episodeAlerted = false;
+static uint32_t pirRiseMs = 0;
+
+static IntrusionStats stats = {};
+static portMUX_TYPE fusionMux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint8_t weigh(uint8_t count, uint8_t need, uint8_t weight) {
+    return count >= need ? weight : (uint8_t)(weight * count / need);
+}
+
+// The slot under way counts for the PIR so a fresh edge scores at once
+static uint8_t scoreLocked() {
+    uint8_t pir = pirCount + ((pirLevel || pirSeen) ? 1 : 0);
+    return weigh(pir, INTRUSION_PIR_SLOTS, INTRUSION_W_PIR) +
+           weigh(moveCount, INTRUSION_MOVE_SLOTS, INTRUSION_W_MOVE) +
+           weigh(doorCount, INTRUSION_DOOR_SLOTS, INTRUSION_W_DOOR);
+}
+
+static void postEvent(EventType type, uint32_t tsMs) {
+    extern QueueHandle_t eventQueue;
+    if (!eventQueue) return;
+    Event e{type, tsMs};
+    xQueueSend(eventQueue, &e, 0);  // Non-blocking event queue
+}
+
+// 🚨 Score, hysteresis and the thief alert
+static void evaluate(uint32_t tsMs) {
+    extern bool isDay;  // Thief-alert mode flag
+    bool raise = false, clear = false, veto = false;
+    uint8_t peak = 0;
+
+    portENTER_CRITICAL(&fusionMux);
+    uint8_t score = scoreLocked();
+    stats.score = score;
+    if (episode && score > stats.peakScore) stats.peakScore = score;
+    bool crossed = false;
+    if (!alertOn && score >= INTRUSION_ALARM_ON) {
+        alertOn = true;
+        crossed = true;
+    } else if (alertOn && score <= INTRUSION_ALARM_OFF) {
+        alertOn = false;
+        clear = alertPosted;
+        alertPosted = false;
+    }
+    // Also catches an alarm latched at night when the mode switches to day
+    if (alertOn && !alertPosted && isDay) {
+        raise = true;
+        alertPosted = true;
+        episodeAlerted = true;
+        stats.alarms++;
+        if (crossed) {
+            // A PIR edge stamped after this sample's time counts as no latency
+            uint32_t latency = (int32_t)(tsMs - pirRiseMs) > 0 ? tsMs - pirRiseMs : 0;
+            stats.lastLatencyMs = latency;
+            if (latency > stats.maxLatencyMs) stats.maxLatencyMs = latency;
+        }
+    }
+    if (episode && !alertOn && pirCount == 0 && !pirLevel && !pirSeen) {
+        episode = false;                      // PIR evidence has left the window
+        if (!episodeAlerted && isDay) {
+            veto = true;
+            peak = stats.peakScore;
+            stats.vetoed++;
+        }
+    }
+    portEXIT_CRITICAL(&fusionMux);
+
+    if (raise) {
+        postEvent(EVENT_MOTION_DETECTED, tsMs);
+        logEvent(LOG_MOTION_NIGHT);
+    }
+    if (clear) {
+        postEvent(EVENT_MOTION_CLEARED, tsMs);
+        logEvent(LOG_MOTION_CLEARED);
+    }
+    if (veto) {
+        logEvent(LOG_INTRUSION_VETOED, peak);
+    }
+}
+
+// 🚶 PIR stream
+void updateIntrusionPir(bool motion, uint32_t tsMs) {
+    portENTER_CRITICAL(&fusionMux);
+    if (motion && !pirLevel) {
+        pirSeen = true;
+        if (!episode) {
+            episode = true;
+            episodeAlerted = false;
+            pirRiseMs = tsMs;
+            stats.peakScore = 0;
+        }
+    }
+    pirLevel = motion;
+    portEXIT_CRITICAL(&fusionMux);
+    evaluate(tsMs);
+}
+
+// 📏 Distance and door streams, one window slot per sample
+void updateIntrusionSample(int distanceCm, bool doorIsOpen, uint32_t tsMs) {
+    portENTER_CRITICAL(&fusionMux);
+    uint8_t slot = 0;
+    if (pirLevel || pirSeen) slot |= SRC_PIR;
+    if (lastDistanceCm >= 0 && abs(distanceCm - lastDistanceCm) >= INTRUSION_MOVE_CM) slot |= SRC_MOVE;
+    if (doorIsOpen) slot |= SRC_DOOR;
+    lastDistanceCm = distanceCm;
+    pirSeen = false;
+
+    uint8_t old = slots[slotHead];
+    pirCount += ((slot & SRC_PIR) != 0) - ((old & SRC_PIR) != 0);
+    moveCount += ((slot & SRC_MOVE) != 0) - ((old & SRC_MOVE) != 0);
+    doorCount += ((slot & SRC_DOOR) != 0) - ((old & SRC_DOOR) != 0);
+    slots[slotHead] = slot;
+    slotHead = (slotHead + 1) % INTRUSION_SLOTS;
+    portEXIT_CRITICAL(&fusionMux);
+    evaluate(tsMs);
+}
+
+uint8_t getIntrusionScore() {
+    return stats.score;
+}
+
+bool isIntrusionAlarm() {
+    return alertOn;
+}
+
+void resetIntrusionFusion() {
+    portENTER_CRITICAL(&fusionMux);
+    memset(slots, 0, sizeof(slots));
+    slotHead = 0;
+    pirCount = moveCount = doorCount = 0;
+    pirLevel = pirSeen = false;
+    lastDistanceCm = -1;
+    alertOn = alertPosted = episode = episodeAlerted = false;
+    stats.score = stats.peakScore = 0;
+    portEXIT_CRITICAL(&fusionMux);
+}
+
+// 📤 Statistics
+void getIntrusionStats(IntrusionStats* out) {
+    portENTER_CRITICAL(&fusionMux);
+    *out = stats;
+    portEXIT_CRITICAL(&fusionMux);
+}
+
+void printIntrusionStats() {
+    IntrusionStats s;
+    getIntrusionStats(&s);
+    char line[160];
+    snprintf(line, sizeof(line),
+             "🕵️ Intrusion: score %u (alert at %u), %u alerts, %u PIR-only vetoed (last peak %u), "
+             "PIR to alert last %u max %u ms",
+             (unsigned)s.score, (unsigned)INTRUSION_ALARM_ON, (unsigned)s.alarms, (unsigned)s.vetoed,
+             (unsigned)s.peakScore, (unsigned)s.lastLatencyMs, (unsigned)s.maxLatencyMs);
+    Serial.println(line);
+}
@@ -10,18 +10,34 @@
 #include "oled_display.h"   // OLED display functions
 #include "audio.h"
 #include "blynk_handlers.h"
+#include "net_events.h"
+#include "sensor_trace.h"
+#include "deferred_log.h"
+#include "rtos_trace.h"
+#include "task_stats.h"
+#include "periodic_task.h"
+#include "heap_guard.h"
+#include "mem_placement.h"
+#include "fire_fastpath.h"
+#include "pir_capture.h"
+#include "flame_flicker.h"
+#include "intrusion_fusion.h"
+#include "servo_motion.h"
+#include "ultrasonic_array.h"
+#include "history_store.h"
+#include "history_rollup.h"
+#include "alert_journal.h"
 
 #include <DHT.h>
 #include <LiquidCrystal_I2C.h>
 #include <Wire.h>
-#include <ESP32Servo.h>         
 #include <WiFi.h>
+#include <limits.h>
 #include "blynk_instance.h"
 
 // 🔧 Hardware Interface Objects
 LiquidCrystal_I2C lcd(LCD_ADDRESS, LCD_COLUMNS, LCD_ROWS);  // 16x2 LCD Display
 DHT dht(DHTPIN, DHTTYPE);                                    // Temperature & Humidity Sensor
-Servo myServo;                                               // Security Door Control
 
 // 🌐 Network Configuration
 char ssid[] = WIFI_SSID;      // WiFi Network Name
@@ -43,12 +59,14 @@ unsigned long lastOLEDUpdate = 0;  // Last OLED Screen Update
 // 🚨 Alert State Management
 static bool fireAlertActive = false;    // Fire Detection Active Flag
 static bool motionAlertActive = false;  // Motion Detection Active Flag
+static bool fireRelayLatched = false;   // Relay held after the clear (FIRE_CLEAR_LATCH)
 
 // 🔄 FreeRTOS Communication Resources
 QueueHandle_t sensorDataQueue = nullptr;  // Sensor Data Transfer Queue
 QueueHandle_t eventQueue = nullptr;       // Event Notification Queue
 SemaphoreHandle_t i2cMutex = nullptr;    // I2C Bus Access Protection
 SemaphoreHandle_t dataMutex = nullptr;   // Shared Data Access Protection
+SemaphoreHandle_t historyMutex = nullptr;   // Sensor History Scans
 
 // ⏱️ Performance Optimization Settings
 const unsigned long oledUpdateInterval = 1000;  // OLED Refresh Rate (ms)
@@ -60,6 +78,10 @@ static TaskHandle_t hTaskLCD = nullptr;        // LCD Display Task
 static TaskHandle_t hTaskOLED = nullptr;       // OLED Display Task
 static TaskHandle_t hTaskWiFi = nullptr;       // WiFi & Blynk Task
 static TaskHandle_t hTaskSysMon = nullptr;     // System Monitor Task
+static TaskHandle_t hTaskLog = nullptr;        // Deferred Log Drain Task
+#if FLAME_FLICKER
+static TaskHandle_t hTaskFlame = nullptr;      // Flame Flicker Analysis Task
+#endif
 
 // 📚 Legacy Function Declarations (FreeRTOS Migration)
 // These functions have been replaced by RTOS task-based architecture
@@ -69,32 +91,59 @@ static TaskHandle_t hTaskSysMon = nullptr;     // System Monitor Task
 
 // 🌐 Network Management Task (Core 0)
 // Handles WiFi connectivity, Blynk cloud communication, and sensor data transmission
+// Sleeps in waitNetEvents() until the socket is readable, telemetry is posted,
+// a WiFi event arrives or the next heartbeat/reconnect/send deadline is due
 void TaskWiFiBlynk(void* pvParameters) {
   
   Serial.printf("[CORE %d] TaskWiFiBlynk started\n", xPortGetCoreID());
   SensorData latest{};     // Latest sensor data buffer
   unsigned long lastBlynkSend = 0;           // Last transmission timestamp
+  unsigned long lastStatsSend = 0;           // Last task statistics summary
+  unsigned long lastRollupSend = 0;          // Last rollup summary
   const unsigned long blynkSendInterval = 2000;  // Cloud data update interval (ms)
+  uint32_t wakeReason = NET_EVT_NONE;        // Why the last wait returned
   
   for(;;) {
+    taskStatsLoop();
+    
     // Handle WiFi reconnection
     handleWiFiReconnection();
     
+    uint32_t waitMs = getWiFiReconnectDelay();  // Offline: sleep until next attempt
+    int blynkFd = -1;                           // Socket to watch while online
+    
     // Run Blynk if connected
     if (isWiFiConnected()) {
       Blynk.run();
+      checkWiFiLease(isBlynkConnected(), !isFireAlertRaised() && !isIntrusionAlarm());
       
-      // Send sensor data periodically
-      if (millis() - lastBlynkSend >= blynkSendInterval) {
+      // Send sensor data periodically, or right away for hazard changes
+      unsigned long sinceSend = millis() - lastBlynkSend;
+      if ((wakeReason & NET_EVT_TELEMETRY) || sinceSend >= blynkSendInterval) {
         if (xQueuePeek(sensorDataQueue, &latest, 0) == pdTRUE) {
           sendSensorDataToBlynk(latest.temperatureC, latest.humidityPct, latest.flame, latest.pirMotion);
           lastBlynkSend = millis();
+          sinceSend = 0;
         }
       }
+      
+      if (millis() - lastStatsSend >= TASK_STATS_BLYNK_MS) {
+        sendTaskStatsToBlynk();
+        lastStatsSend = millis();
+      }
+      
+      if (millis() - lastRollupSend >= ROLLUP_BLYNK_MS) {
+        sendRollupToBlynk();
+        lastRollupSend = millis();
+      }
+      
+      unsigned long nextSendMs = (sinceSend >= blynkSendInterval) ? blynkSendInterval
+                                                                   : blynkSendInterval - sinceSend;
+      waitMs = min((uint32_t)Blynk.timeToNextEvent(), (uint32_t)nextSendMs);
+      blynkFd = _blynkWifiClient.fd();
     }
     
-    
-    vTaskDelay(pdMS_TO_TICKS(50));
+    wakeReason = waitNetEvents(blynkFd, waitMs);
   }
 }
 
@@ -103,20 +152,22 @@ void TaskWiFiBlynk(void* pvParameters) {
 void TaskLCD(void* pvParameters) {
   
   Serial.printf("[CORE %d] TaskLCD started\n", xPortGetCoreID());
+  PeriodicTask* schedule = (PeriodicTask*)pvParameters;
   static unsigned long lastNormalUpdate = 0;  // Normal status update timestamp
   
+  periodicStart(schedule);
   for(;;) {
+    taskStatsLoop();
     // Only update normal status if no alerts are active
     if (!fireAlertActive && !motionAlertActive && (millis() - lastNormalUpdate > 5000)) {
-      if (xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+      if (i2cBusTake(pdMS_TO_TICKS(50))) {
         displayNormalStatus();
-        xSemaphoreGive(i2cMutex);
+        i2cBusGive();
         lastNormalUpdate = millis();
       }
     }
     
-    
-    vTaskDelay(pdMS_TO_TICKS(1000));
+    periodicWait(schedule);
   }
 }
 
@@ -125,15 +176,19 @@ void TaskLCD(void* pvParameters) {
 void TaskOLED(void* pvParameters) {
   
   Serial.printf("[CORE %d] TaskOLED started\n", xPortGetCoreID());
+  PeriodicTask* schedule = (PeriodicTask*)pvParameters;
+  periodicStart(schedule);
   for(;;) {
+    taskStatsLoop();
     handleOLEDButtons();
-    // refresh page if no hazards (updateOLEDDisplay internally draws current page)
-    if (xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+    // refresh page if no hazards (updateOLEDDisplay internally draws current page);
+    // after an overrun the last frame stays up for a few periods
+    if (periodicOptional(schedule) && i2cBusTake(pdMS_TO_TICKS(50))) {
       updateOLEDDisplay();
-      xSemaphoreGive(i2cMutex);
+      i2cBusGive();
     }
     
-    vTaskDelay(pdMS_TO_TICKS(200));
+    periodicWait(schedule);
   }
 }
 
@@ -142,62 +197,103 @@ void TaskOLED(void* pvParameters) {
 void TaskSensorPoll(void* pvParameters) {
   
   Serial.printf("[CORE %d] TaskSensorPoll started\n", xPortGetCoreID());
+  PeriodicTask* schedule = (PeriodicTask*)pvParameters;
   SensorData msg{};         // Sensor data message buffer
-  // 🔥 Fire Detection Stability Tracking
-  static bool fireStable = false;        // Stable fire state
-  static int fireChangeCounter = 0;      // Fire state change counter
+  static bool publishedFlame = false;    // Last flame state pushed to the network task
+  static bool publishedMotion = false;   // Last motion state pushed to the network task
+  static int actedTemp = INT_MIN;        // Climate last handed to the actuator task
+  static int actedHumidity = INT_MIN;
+  uint32_t historyMs = millis();          // Last history point
+  uint8_t historyHazards = 0;             // HIST_HAZ_* seen since then
+  periodicStart(schedule);
   for(;;) {
-    readTemperatureHumidity();
+    taskStatsLoop();
+    sampleSensors();   // DHT, flame, PIR and ultrasonic in one raw sample (also traced)
     msg.temperatureC = t;
     msg.humidityPct = h;
 
-    readFlameSensor();
-    bool fireRaw = isFlameDetected();
-
-    // Debounce fire: require 3 consecutive samples to change state
-    if (fireRaw != fireStable) {
-      fireChangeCounter++;
-      if (fireChangeCounter >= 3) {
-        fireStable = fireRaw;
-        Event e{fireStable ? EVENT_FIRE_DETECTED : EVENT_FIRE_CLEARED, (uint32_t)millis()};
-        xQueueSend(eventQueue, &e, 0);
-        fireChangeCounter = 0;
-      }
-    } else {
-      fireChangeCounter = 0;
-    }
-
-    msg.flame = fireStable;
+    // Debounce fire: require FIRE_DEBOUNCE_SAMPLES consecutive samples to change state
+    msg.flame = readFlameSensor();
 
-    // Read motion with debouncing (this will send events internally)
-    readMotion();
+    // Motion: edge capture posts its own events; poll only without it
+    if (!isPirCaptureActive()) {
+      readMotion();
+    }
     
-    triggerUltrasonicSensor();
-    msg.distanceCm = getDistance();
+    msg.distanceCm = getDistance();             // Median + alpha-beta filtered
+    msg.velocityCmS = getDistanceEstimate()->velocityCmS;
+
+    // Intrusion evidence: movement in the ultrasonic beam and the door position
+    doorOpen = getServoAngle() != SERVO_CLOSED_DEG;
+    updateIntrusionSample(msg.distanceCm, doorOpen, millis());  // msg.tsMs is still last cycle's
     
-    // Log distance for debugging
-    Serial.print("📏 Distance: ");
-    Serial.print(msg.distanceCm);
-    Serial.println(" cm");
+    // Log distance for debugging (deferred: no UART time in this loop), shed after an overrun
+    if (periodicOptional(schedule)) {
+      logEvent(LOG_DISTANCE, msg.distanceCm, msg.velocityCmS);
+    }
     
     msg.pirMotion = isMotionDetected();
     msg.tsMs = millis();
     xQueueOverwrite(sensorDataQueue, &msg);
 
-    
-    vTaskDelay(pdMS_TO_TICKS(250));
+    // History: one point per HISTORY_INTERVAL_MS (half a poll period early is on
+    // time: samples jitter by a tick), hazards of every sample in between
+    historyHazards |= (msg.flame ? HIST_HAZ_FIRE : 0) | (msg.pirMotion ? HIST_HAZ_MOTION : 0) |
+                      (isIntrusionAlarm() ? HIST_HAZ_INTRUSION : 0) | (doorOpen ? HIST_HAZ_DOOR : 0);
+    if (msg.tsMs - historyMs >= HISTORY_INTERVAL_MS - SENSOR_POLL_INTERVAL_MS / 2) {
+      HistoryPoint point;
+      point.tsMs = msg.tsMs;
+      point.value[HIST_TEMPERATURE] = (int16_t)msg.temperatureC;
+      point.value[HIST_HUMIDITY] = (int16_t)msg.humidityPct;
+      point.value[HIST_DISTANCE] = (int16_t)msg.distanceCm;
+      point.value[HIST_HAZARDS] = historyHazards;
+      historyAppend(&point);
+      rollupAdd(rollupNowSec(), point.value[HIST_TEMPERATURE], point.value[HIST_HUMIDITY], historyHazards);
+      historyMs = msg.tsMs;
+      historyHazards = 0;
+    }
+
+    // Push hazard changes to Blynk now instead of at the next 2 s send
+    if (msg.flame != publishedFlame || msg.pirMotion != publishedMotion) {
+      publishedFlame = msg.flame;
+      publishedMotion = msg.pirMotion;
+      notifyNetTask(NET_EVT_TELEMETRY);
+    }
+
+    // Wake the actuator task only for what it acts on: hazard events, a climate
+    // change, or someone at the door (each sighting extends the servo hold)
+    uint32_t actuatorEvents = ACT_EVT_NONE;
+    if (uxQueueMessagesWaiting(eventQueue) > 0) {
+      actuatorEvents |= ACT_EVT_HAZARD;
+    }
+    if (msg.temperatureC != actedTemp || msg.humidityPct != actedHumidity ||
+        msg.distanceCm <= DISTANCE_THRESHOLD) {
+      actedTemp = msg.temperatureC;
+      actedHumidity = msg.humidityPct;
+      actuatorEvents |= ACT_EVT_SAMPLE;
+    }
+    if (actuatorEvents != ACT_EVT_NONE) {
+      notifyActuators(actuatorEvents);
+    }
+
+    periodicWait(schedule);
   }
 }
 
 // ⚡ Actuator Control & Alert Management Task (Core 1)
-// Processes emergency events and controls all output devices (relay, fan, servo)
+// Processes emergency events and controls all output devices (relay, fan, servo).
+// Sleeps on its notification bits (ACT_EVT_*) until an input changes or the
+// open servo is due to close; outputs are written on transitions only
 void TaskActuators(void* pvParameters) {
   
   Serial.printf("[CORE %d] TaskActuators started\n", xPortGetCoreID());
   SensorData latest{};      // Latest sensor data buffer
   Event ev{};               // Event notification buffer
+  uint32_t events = ACT_EVT_ALL;   // First pass looks at every input
+  attachActuatorTask();
   for(;;) {
-    if (xQueueReceive(eventQueue, &ev, pdMS_TO_TICKS(10)) == pdTRUE) {
+    taskStatsLoop();
+    while (xQueueReceive(eventQueue, &ev, 0) == pdTRUE) {
       switch (ev.type) {
         case EVENT_FIRE_DETECTED:
           fireAlertActive = true;
@@ -207,22 +303,30 @@ void TaskActuators(void* pvParameters) {
             xQueueSend(audioQueue, &fireAudio, 0);
           }
           activateRelay();
-          if (xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+          if (i2cBusTake(pdMS_TO_TICKS(50))) {
             displayFireAlert();
             displayOLEDFireAlert();
-            xSemaphoreGive(i2cMutex);
+            i2cBusGive();
           }
-          Serial.println("[CORE 1] FIRE ALERT ACTIVATED - Display locked, audio queued");
+          logEvent(LOG_FIRE_ALERT_ON);
+          alertJournalAdd(ALERT_FIRE, (int16_t)t);
           break;
         case EVENT_FIRE_CLEARED:
           fireAlertActive = false;
+#if FIRE_CLEAR_MODE == FIRE_CLEAR_LATCH
+          fireRelayLatched = true;   // Released from VPIN_FIRE_RESET
+          logEvent(LOG_FIRE_RELAY_LATCHED);
+#else
           deactivateRelay();
-          if (xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+#endif
+          rearmFireFastPath();
+          if (i2cBusTake(pdMS_TO_TICKS(50))) {
             displaySafeStatus();
             displayOLEDSafeStatus();
-            xSemaphoreGive(i2cMutex);
+            i2cBusGive();
           }
-          Serial.println("[CORE 1] FIRE ALERT CLEARED - Display returned to normal");
+          logEvent(LOG_FIRE_ALERT_OFF);
+          alertJournalAdd(ALERT_FIRE_CLEAR, (int16_t)t);
           break;
         case EVENT_MOTION_DETECTED:
           motionAlertActive = true;
@@ -231,37 +335,47 @@ void TaskActuators(void* pvParameters) {
             AudioEvent motionAudio{AUDIO_MOTION_ALERT, (uint32_t)millis()};
             xQueueSend(audioQueue, &motionAudio, 0);
           }
-          if (xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+          if (i2cBusTake(pdMS_TO_TICKS(50))) {
             displayThiefAlert();
             displayOLEDThiefAlert();
-            xSemaphoreGive(i2cMutex);
+            i2cBusGive();
           }
-          Serial.println("[CORE 1] MOTION ALERT ACTIVATED - Display locked, audio queued");
+          logEvent(LOG_MOTION_ALERT_ON);
+          alertJournalAdd(ALERT_THIEF, getIntrusionScore());
           break;
         case EVENT_MOTION_CLEARED:
           motionAlertActive = false;
-          if (xSemaphoreTake(i2cMutex, pdMS_TO_TICKS(50)) == pdTRUE) {
+          if (i2cBusTake(pdMS_TO_TICKS(50))) {
             displayNormalStatus();
             displayOLEDMotionCleared();
-            xSemaphoreGive(i2cMutex);
+            i2cBusGive();
           }
-          Serial.println("[CORE 1] MOTION ALERT CLEARED - Display returned to normal");
+          logEvent(LOG_MOTION_ALERT_OFF);
+          alertJournalAdd(ALERT_THIEF_CLEAR, getIntrusionScore());
           break;
         default: break;
       }
     }
-    // consume latest sensor sample for fan control
-    if (xQueuePeek(sensorDataQueue, &latest, 0) == pdTRUE) {
-      controlFan(latest.temperatureC, latest.humidityPct);
-      moveServo();
+    // Latched fire relay released from Blynk (only once the fire has cleared)
+    if ((events & ACT_EVT_FIRE_RESET) && fireRelayLatched && !fireAlertActive) {
+      fireRelayLatched = false;
+      deactivateRelay();
+      logEvent(LOG_FIRE_RELAY_RESET);
+      alertJournalAdd(ALERT_RELAY_RESET, 0);
+    }
+    // consume latest sensor sample for fan and servo control
+    if ((events & (ACT_EVT_SAMPLE | ACT_EVT_AC | ACT_EVT_SERVO_DUE | ACT_EVT_FAN_DUE)) &&
+        xQueuePeek(sensorDataQueue, &latest, 0) == pdTRUE) {
+      if (events & (ACT_EVT_SAMPLE | ACT_EVT_AC | ACT_EVT_FAN_DUE)) {
+        controlFan(latest.temperatureC, latest.humidityPct);
+      }
+      moveServo(latest.distanceCm);
     }
     
-    vTaskDelay(pdMS_TO_TICKS(20));
+    events = waitActuatorEvents();
   }
 }
 
-// PIR ISR removed - motion detection now handled in TaskSensorPoll with debouncing
-
 // Audio event queue for Core 0 audio processing
 QueueHandle_t audioQueue = nullptr;
 
@@ -270,28 +384,32 @@ QueueHandle_t audioQueue = nullptr;
 void TaskSystemMonitor(void* pvParameters) {
   // esp_task_wdt_add(NULL);  // Watchdog disabled
   Serial.printf("[CORE %d] TaskSystemMonitor started\n", xPortGetCoreID());
+  PeriodicTask* schedule = (PeriodicTask*)pvParameters;
   AudioEvent audioEvent{};
   unsigned long lastHeapReport = 0;
   unsigned long lastTaskReport = 0;
   
+  periodicStart(schedule);
   for(;;) {
+    taskStatsLoop();
+    
     // Process audio events
     if (xQueueReceive(audioQueue, &audioEvent, pdMS_TO_TICKS(10)) == pdTRUE) {
       switch (audioEvent.type) {
         case AUDIO_STARTUP:
-          Serial.println("[CORE 0] Playing startup tone");
+          logEvent(LOG_PLAY_STARTUP);
           playStartupTone();
           break;
         case AUDIO_MODE_SWITCH:
-          Serial.println("[CORE 0] Playing mode switch tone");
+          logEvent(LOG_PLAY_MODE_SWITCH);
           playModeSwitchTone();
           break;
         case AUDIO_FIRE_ALERT:
-          Serial.println("[CORE 0] Playing fire alert tone");
+          logEvent(LOG_PLAY_FIRE);
           playAlertTone();
           break;
         case AUDIO_MOTION_ALERT:
-          Serial.println("[CORE 0] Playing motion alert tone");
+          logEvent(LOG_PLAY_MOTION);
           playAlertTone();
           break;
         default: break;
@@ -300,33 +418,138 @@ void TaskSystemMonitor(void* pvParameters) {
     
     // System monitoring (every 30 seconds)
     if (millis() - lastHeapReport > 30000) {
-      Serial.printf("[CORE 0] Free heap: %d bytes, Min free: %d bytes\n", 
-                    ESP.getFreeHeap(), ESP.getMinFreeHeap());
+      logEvent(LOG_HEAP, ESP.getFreeHeap(), ESP.getMinFreeHeap());
+      checkHeapGuard();   // Reports allocations made since boot completed
       lastHeapReport = millis();
     }
     
-    // Task stack monitoring (every 60 seconds)
-    if (millis() - lastTaskReport > 60000) {
-      if (hTaskSensors) {
-        Serial.printf("[CORE 0] TaskSensor stack high water: %d\n", 
-                      uxTaskGetStackHighWaterMark(hTaskSensors));
-      }
-      if (hTaskActuators) {
-        Serial.printf("[CORE 0] TaskActuators stack high water: %d\n", 
-                      uxTaskGetStackHighWaterMark(hTaskActuators));
-      }
-      if (hTaskWiFi) {
-        Serial.printf("[CORE 0] TaskWiFi stack high water: %d\n", 
-                      uxTaskGetStackHighWaterMark(hTaskWiFi));
-      }
+    // Task statistics: CPU, idle, loop jitter and stack of every task
+    updateTaskStats();
+    if (millis() - lastTaskReport > TASK_STATS_REPORT_MS) {
+      printTaskStats();
+      printFireFastPathStats();
+      printPirCaptureStats();
+      printFlameFlickerStats();
+      printUltrasonicStats();
+      printIntrusionStats();
+      printHistoryStats();
+      printRollupStats();
+      printAlertJournalStats();
       lastTaskReport = millis();
     }
     
+    // RTOS trace dump and history and alert exports, a few lines per pass (requested from Blynk)
+    serviceRtosTraceDump();
+    serviceHistoryExport();
+    serviceAlertJournal();   // Also writes batched alerts to flash
+    
     // esp_task_wdt_reset(); // Watchdog disabled
-    vTaskDelay(pdMS_TO_TICKS(100));
+    if (rtosTraceDumpPending() || historyExportPending() || alertJournalExportPending()) {
+      vTaskDelay(pdMS_TO_TICKS(10));   // Off the schedule until the dump is out
+      periodicStart(schedule);
+    } else {
+      periodicWait(schedule);
+    }
   }
 }
 
+// 📋 RTOS Resource Table
+// Every task, queue and mutex the firmware creates. With RTOS_STATIC_ALLOCATION
+// the stacks, TCBs and queue storage are static arrays (internal RAM .bss) and
+// nothing below touches the heap; otherwise the same table goes through the
+// heap-allocating APIs. Stack sizes are bytes (ESP-IDF StackType_t). Period
+// and deadline (ms after the release) go to the task as its PeriodicTask;
+// period 0 = event driven.
+//   X(function, name, stack, priority, core, handle, period, deadline)
+#define RTOS_TASKS(X) \
+  X(TaskSensorPoll,    "tSensors", 4096, 4, 1, hTaskSensors,   SENSOR_POLL_INTERVAL_MS, 150) \
+  X(TaskActuators,     "tAct",     4096, 5, 1, hTaskActuators, 0,                       0) \
+  X(TaskLCD,           "tLCD",     3072, 2, 1, hTaskLCD,       1000,                    200) \
+  X(TaskOLED,          "tOLED",    3072, 2, 1, hTaskOLED,      200,                     100) \
+  X(TaskWiFiBlynk,     "tWiFi",    4096, 3, 0, hTaskWiFi,      0,                       0) \
+  X(TaskSystemMonitor, "tSysMon",  3072, 1, 0, hTaskSysMon,    100,                     100) \
+  X(TaskLogDrain,      "tLog",     3072, 1, 0, hTaskLog,       LOG_DRAIN_INTERVAL_MS,   LOG_DRAIN_INTERVAL_MS) \
+  FLAME_TASKS(X)
+
+// Flame flicker analysis, only built in with FLAME_FLICKER (blocks on the ADC DMA frames)
+#if FLAME_FLICKER
+#define FLAME_TASKS(X) \
+  X(TaskFlameFlicker,  "tFlame",   4096, 2, 0, hTaskFlame,     0,                       0)
+#else
+#define FLAME_TASKS(X)
+#endif
+
+//   X(handle, length, item type, trace name)
+#define RTOS_QUEUES(X) \
+  X(sensorDataQueue, 1,  SensorData, "sensorData") \
+  X(eventQueue,      10, Event,      "eventQueue") \
+  X(audioQueue,      5,  AudioEvent, "audioQueue")
+
+//   X(handle, trace name)
+#define RTOS_MUTEXES(X) \
+  X(i2cMutex,  "i2cMutex") \
+  X(dataMutex, "dataMutex") \
+  X(historyMutex, "historyMutex")
+
+#define TASK_SCHEDULE(fn, name, stack, prio, core, handle, period, deadline) \
+  static PeriodicTask fn##Schedule = PERIODIC_TASK(period, deadline);
+RTOS_TASKS(TASK_SCHEDULE)
+
+#if RTOS_STATIC_ALLOCATION
+#define TASK_STORAGE(fn, name, stack, prio, core, handle, period, deadline) \
+  static StackType_t fn##Stack[stack] __attribute__((aligned(16))); \
+  static StaticTask_t fn##Tcb;
+#define QUEUE_STORAGE(handle, length, type, name) \
+  static uint8_t handle##Storage[(length) * sizeof(type)]; \
+  static StaticQueue_t handle##Buffer;
+#define MUTEX_STORAGE(handle, name) \
+  static StaticSemaphore_t handle##Buffer;
+
+RTOS_TASKS(TASK_STORAGE)
+RTOS_QUEUES(QUEUE_STORAGE)
+RTOS_MUTEXES(MUTEX_STORAGE)
+#endif
+
+// Queues and mutexes, named for RTOS trace dumps
+static void createRtosObjects() {
+#if RTOS_STATIC_ALLOCATION
+#define CREATE_QUEUE(handle, length, type, name) \
+  handle = xQueueCreateStatic(length, sizeof(type), handle##Storage, &handle##Buffer); \
+  MEM_DECLARE("queue " name, handle##Storage, MEM_HOT); \
+  rtosTraceObject(handle, RTOS_OBJ_QUEUE, name);
+#define CREATE_MUTEX(handle, name) \
+  handle = xSemaphoreCreateMutexStatic(&handle##Buffer); \
+  rtosTraceObject(handle, RTOS_OBJ_MUTEX, name);
+#else
+#define CREATE_QUEUE(handle, length, type, name) \
+  handle = xQueueCreate(length, sizeof(type)); \
+  rtosTraceObject(handle, RTOS_OBJ_QUEUE, name);
+#define CREATE_MUTEX(handle, name) \
+  handle = xSemaphoreCreateMutex(); \
+  rtosTraceObject(handle, RTOS_OBJ_MUTEX, name);
+#endif
+  RTOS_QUEUES(CREATE_QUEUE)
+  RTOS_MUTEXES(CREATE_MUTEX)
+}
+
+// Tasks, each started with and registered for runtime statistics with its schedule
+static void createRtosTasks() {
+#if RTOS_STATIC_ALLOCATION
+#define CREATE_TASK(fn, name, stack, prio, core, handle, period, deadline) \
+  handle = xTaskCreateStaticPinnedToCore(fn, name, stack, &fn##Schedule, prio, fn##Stack, &fn##Tcb, core); \
+  MEM_DECLARE("stack " name, fn##Stack, MEM_HOT);
+#else
+#define CREATE_TASK(fn, name, stack, prio, core, handle, period, deadline) \
+  xTaskCreatePinnedToCore(fn, name, stack, &fn##Schedule, prio, &handle, core);
+#endif
+#define REGISTER_TASK(fn, name, stack, prio, core, handle, period, deadline) \
+  registerTaskStats(handle, &fn##Schedule);
+
+  RTOS_TASKS(CREATE_TASK)
+  initTaskStats();
+  RTOS_TASKS(REGISTER_TASK)
+}
+
 // 🚀 System Initialization & Task Creation
 // Sets up hardware, creates FreeRTOS resources, and launches all system tasks
 void setup() {
@@ -339,13 +562,12 @@ void setup() {
   
   // 🔧 System Component Initialization
   initSystem();  // Initialize core system functions
+  initDeferredLog();  // Runtime messages are queued from here on, printed by TaskLogDrain
+  initRtosTrace();    // Task/queue/I2C timeline into PSRAM, dumped via VPIN_TRACE_DUMP
   
-  // 🔄 FreeRTOS Resource Creation
-  sensorDataQueue = xQueueCreate(1, sizeof(SensorData));    // Sensor data transfer queue
-  eventQueue = xQueueCreate(10, sizeof(Event));             // Event notification queue
-  audioQueue = xQueueCreate(5, sizeof(AudioEvent));         // Audio event processing queue
-  i2cMutex = xSemaphoreCreateMutex();                       // I2C bus access protection
-  dataMutex = xSemaphoreCreateMutex();                      // Shared data access protection
+  // 🔄 FreeRTOS Resource Creation (RTOS_QUEUES / RTOS_MUTEXES table)
+  createRtosObjects();
+  initNetEvents();                                          // Network task wakeup sources
   
   // 📺 Display System Initialization
   Serial.println("🖥️ Initializing display systems...");
@@ -360,10 +582,17 @@ void setup() {
   // 🔍 Sensor System Initialization
   Serial.println("🔍 Initializing sensor systems...");
   initSensors();  // Initialize all monitoring sensors
-  // Note: PIR interrupt removed - motion detection now handled in TaskSensorPoll
+  initSensorTrace();  // Raw sample recorder (SENSOR_TRACE_SINK)
+  initHistoryStore(); // Compressed 1 Hz sensor history in PSRAM, exported via VPIN_HISTORY_EXPORT
+  initHistoryRollup(); // Minute/hour/day buckets for range aggregates (VPIN_ROLLUP_SUMMARY, OLED)
+  initAlertJournal();  // Alert log on the "alerts" flash partition, exported via VPIN_ALERT_EXPORT
   
   // ⚡ Actuator & Audio System Setup
   initActuators();  // Initialize relay, fan, and servo motors
+  initFireFastPath();  // Flame pin interrupt -> relay (FIRE_FAST_PATH)
+  initPirCapture();    // PIR edge timestamps + settle timer (PIR_EDGE_CAPTURE)
+  initFlameFlicker();  // Flame AO via ADC DMA + FFT flicker band (FLAME_FLICKER)
+  initUltrasonicArray();  // Echo interrupts + interleaved trigger slots (ULTRASONIC_ARRAY)
   initAudio();      // Initialize buzzer and audio system
   
   // 🔊 Startup Audio Queue
@@ -374,36 +603,29 @@ void setup() {
   }
   
   // 🌐 Network & Cloud Services Setup
-  Serial.println("🌐 Attempting WiFi connection (5 second timeout)...");
+  // Neither call blocks: the WiFi state machine and Blynk login run in TaskWiFiBlynk
+  initBlynk();
   if (initWiFi()) {
-    Serial.println("✅ WiFi connected, initializing Blynk cloud service...");
-    initBlynk();
-    connectBlynk();
-    Serial.println("☁️ Cloud services initialized successfully!");
+    Serial.println("🌐 WiFi connecting in background - Blynk logs in once it is up");
   } else {
     Serial.println("⚠️ Starting in offline mode...");
-    Serial.println("🔄 System will attempt WiFi reconnection every 30 seconds");
   }
   
   //  Task Creation & Core Assignment
   Serial.println("=== 🚀 Task Creation with Optimized Core Assignment ===");
-  Serial.println("🔥 Core 0: WiFi + Blynk, system monitoring, alerts/buzzer");
+  Serial.println("🔥 Core 0: WiFi + Blynk, system monitoring, alerts/buzzer, log output");
   Serial.println("⚡ Core 1: Sensors, LCD, OLED, actuators, motion processing");
   
-  //  Core 1: Real-time Processing Tasks (High Priority)
-  xTaskCreatePinnedToCore(TaskSensorPoll, "tSensors", 4096, nullptr, 4, &hTaskSensors, 1);
-  xTaskCreatePinnedToCore(TaskActuators,  "tAct",     4096, nullptr, 5, &hTaskActuators, 1);
-  xTaskCreatePinnedToCore(TaskLCD,        "tLCD",     3072, nullptr, 2, &hTaskLCD,      1);
-  xTaskCreatePinnedToCore(TaskOLED,       "tOLED",    3072, nullptr, 2, &hTaskOLED,     1);
-  
-  //  Core 0: Network & System Services (Background Priority)
-  xTaskCreatePinnedToCore(TaskWiFiBlynk,     "tWiFi",   4096, nullptr, 3, &hTaskWiFi,   0);
-  xTaskCreatePinnedToCore(TaskSystemMonitor, "tSysMon", 3072, nullptr, 1, &hTaskSysMon, 0);
+  //  Core 1: sensors, actuators, displays - Core 0: network, monitor, log (RTOS_TASKS table)
+  createRtosTasks();
+  Serial.println(RTOS_STATIC_ALLOCATION ? "📦 RTOS objects: static (.bss)" : "📦 RTOS objects: heap");
   
   //  System Resource Information
   Serial.printf("💾 Free heap: %d bytes\n", ESP.getFreeHeap());
   Serial.printf("⚡ CPU0 freq: %d MHz, CPU1 freq: %d MHz\n", ESP.getCpuFreqMHz(), ESP.getCpuFreqMHz());
+  printMemPlacement();
   Serial.println("🎯 Setup complete! System ready for operation.");
+  armHeapGuard();   // Steady state from here: no more heap allocations expected
 }
 
 // 🔄 Main Loop (Minimal in FreeRTOS Design)
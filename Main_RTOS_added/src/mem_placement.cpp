@@ -0,0 +1,130 @@
+#include "mem_placement.h"
+
+#ifndef SIM_NATIVE
+#include "esp_heap_caps.h"
+#include "soc/soc_memory_layout.h"
+#endif
+
+// 📐 Memory Placement
+// Fixed table of what was placed where; the check against the class runs
+// once per entry when it is recorded, the report only prints it.
+
+enum MemWhere : uint8_t {
+    WHERE_INTERNAL = 0,
+    WHERE_PSRAM,
+    WHERE_NONE        // Allocation failed
+};
+
+struct MemEntry {
+    const char* name;
+    uint32_t size;
+    MemClass cls;
+    MemWhere where;
+    bool isStatic;
+    bool misplaced;   // HOT/DMA outside internal RAM, or DMA not DMA-capable
+};
+
+static MemEntry entries[MEM_PLACEMENT_MAX_ENTRIES];
+static uint8_t entryCount = 0;
+static uint8_t droppedEntries = 0;
+
+static const char* const classNames[MEM_CLASS_COUNT] = { "hot", "dma", "bulk" };
+static const char* const whereNames[] = { "internal", "PSRAM", "FAILED" };
+
+bool memIsInternal(const void* ptr) {
+#ifdef SIM_NATIVE
+    (void)ptr;
+    return true;
+#else
+    return esp_ptr_internal(ptr);
+#endif
+}
+
+static bool isDmaCapable(const void* ptr) {
+#ifdef SIM_NATIVE
+    (void)ptr;
+    return true;
+#else
+    return esp_ptr_dma_capable(ptr);
+#endif
+}
+
+static void record(const char* name, const void* ptr, size_t size, MemClass cls, MemWhere where, bool isStatic) {
+    if (entryCount >= MEM_PLACEMENT_MAX_ENTRIES) {
+        droppedEntries++;
+        return;
+    }
+    MemEntry& e = entries[entryCount++];
+    e.name = name;
+    e.size = size;
+    e.cls = cls;
+    e.where = where;
+    e.isStatic = isStatic;
+    e.misplaced = ptr != nullptr &&
+                  ((cls != MEM_BULK && where != WHERE_INTERNAL) || (cls == MEM_DMA && !isDmaCapable(ptr)));
+}
+
+// 🔧 Boot-time allocation
+void* memPlace(const char* name, size_t size, MemClass cls) {
+    void* ptr = nullptr;
+    MemWhere where = WHERE_INTERNAL;
+
+#ifdef SIM_NATIVE
+    ptr = (cls == MEM_BULK) ? ps_malloc(size) : malloc(size);
+    where = (cls == MEM_BULK && psramFound()) ? WHERE_PSRAM : WHERE_INTERNAL;
+#else
+    switch (cls) {
+        case MEM_HOT:
+            ptr = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            break;
+        case MEM_DMA:
+            ptr = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+            break;
+        case MEM_BULK:
+            ptr = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+            if (ptr) {
+                where = WHERE_PSRAM;
+            } else if (size <= MEM_BULK_FALLBACK_MAX) {
+                ptr = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            }
+            break;
+        default: break;
+    }
+#endif
+
+    record(name, ptr, size, cls, ptr ? where : WHERE_NONE, false);
+    return ptr;
+}
+
+void memDeclare(const char* name, const void* ptr, size_t size, MemClass cls) {
+    record(name, ptr, size, cls, memIsInternal(ptr) ? WHERE_INTERNAL : WHERE_PSRAM, true);
+}
+
+// 📤 Boot report
+void printMemPlacement() {
+    char line[96];
+    uint32_t classTotals[MEM_CLASS_COUNT] = { 0 };
+
+#ifdef SIM_NATIVE
+    uint32_t freeInternal = ESP.getFreeHeap();
+    uint32_t freePsram = psramFound() ? ESP.getFreePsram() : 0;
+#else
+    uint32_t freeInternal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    uint32_t freePsram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+#endif
+    snprintf(line, sizeof(line), "📐 Memory placement: %u buffers, internal free %u KB, PSRAM free %u KB",
+             entryCount, (unsigned)(freeInternal / 1024), (unsigned)(freePsram / 1024));
+    Serial.println(line);
+
+    for (uint8_t i = 0; i < entryCount; i++) {
+        const MemEntry& e = entries[i];
+        classTotals[e.cls] += e.size;
+        snprintf(line, sizeof(line), "   %-16s %-4s %-8s %7u B %s%s", e.name, classNames[e.cls], whereNames[e.where],
+                 (unsigned)e.size, e.isStatic ? "static" : "heap", e.misplaced ? "  ⚠️ misplaced" : "");
+        Serial.println(line);
+    }
+    snprintf(line, sizeof(line), "   total: hot %u B, dma %u B, bulk %u B%s", (unsigned)classTotals[MEM_HOT],
+             (unsigned)classTotals[MEM_DMA], (unsigned)classTotals[MEM_BULK],
+             droppedEntries ? " (table full, some buffers not listed)" : "");
+    Serial.println(line);
+}
@@ -0,0 +1,100 @@
+#include "net_events.h"
+#include <sys/select.h>
+#include <unistd.h>
+#include "esp_vfs_eventfd.h"
+
+// 🔔 Event-driven wakeups for the network task
+// One eventfd is shared by every producer; select() waits on it together with
+// the Blynk socket, so the task sleeps until there is real work or a deadline.
+
+#ifndef NET_POLL_FALLBACK_MS
+#define NET_POLL_FALLBACK_MS 50   // Used only if the eventfd cannot be created
+#endif
+
+static int wakeFd = -1;                                   // eventfd shared by producers
+static volatile uint32_t pendingBits = NET_EVT_NONE;      // reasons set by notifyNetTask()
+static portMUX_TYPE pendingMux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t wakeCount = 0;                            // select() returns (diagnostics)
+
+bool initNetEvents() {
+  esp_vfs_eventfd_config_t cfg = ESP_VFS_EVENTD_CONFIG_DEFAULT();
+  if (esp_vfs_eventfd_register(&cfg) != ESP_OK) {
+    Serial.println("⚠️ eventfd unavailable - network task falls back to polling");
+  } else {
+    wakeFd = eventfd(0, 0);
+  }
+
+  return wakeFd >= 0;
+}
+
+void notifyNetTask(uint32_t bits) {
+  portENTER_CRITICAL(&pendingMux);
+  pendingBits |= bits;
+  portEXIT_CRITICAL(&pendingMux);
+
+  if (wakeFd >= 0) {
+    uint64_t one = 1;
+    write(wakeFd, &one, sizeof(one));
+  }
+}
+
+uint32_t waitNetEvents(int sockFd, uint32_t timeoutMs) {
+  // ⚡ Don't sleep if something was posted since the last wait
+  portENTER_CRITICAL(&pendingMux);
+  uint32_t bits = pendingBits;
+  pendingBits = NET_EVT_NONE;
+  portEXIT_CRITICAL(&pendingMux);
+  if (bits != NET_EVT_NONE) {
+    return bits;
+  }
+
+  if (wakeFd < 0) {
+    timeoutMs = min(timeoutMs, (uint32_t)NET_POLL_FALLBACK_MS);
+  }
+
+  fd_set readSet;
+  FD_ZERO(&readSet);
+  int maxFd = -1;
+  if (wakeFd >= 0) {
+    FD_SET(wakeFd, &readSet);
+    maxFd = wakeFd;
+  }
+  if (sockFd >= 0) {
+    FD_SET(sockFd, &readSet);
+    maxFd = max(maxFd, sockFd);
+  }
+
+  struct timeval tv;
+  tv.tv_sec = timeoutMs / 1000;
+  tv.tv_usec = (timeoutMs % 1000) * 1000;
+
+  int ready = 0;
+  if (maxFd >= 0) {
+    ready = select(maxFd + 1, &readSet, nullptr, nullptr, &tv);
+  } else {
+    vTaskDelay(pdMS_TO_TICKS(timeoutMs));
+  }
+  wakeCount++;
+
+  if (ready > 0 && wakeFd >= 0 && FD_ISSET(wakeFd, &readSet)) {
+    uint64_t count;
+    read(wakeFd, &count, sizeof(count));  // Reset the eventfd counter
+  }
+
+  portENTER_CRITICAL(&pendingMux);
+  bits = pendingBits;
+  pendingBits = NET_EVT_NONE;
+  portEXIT_CRITICAL(&pendingMux);
+
+  if (ready > 0 && sockFd >= 0 && FD_ISSET(sockFd, &readSet)) {
+    bits |= NET_EVT_SOCKET;
+  }
+  if (ready <= 0 && bits == NET_EVT_NONE) {
+    bits = NET_EVT_TIMEOUT;
+  }
+  return bits;
+}
+
+uint32_t getNetWakeCount() {
+  return wakeCount;
+}
@@ -1,16 +1,48 @@
 #include "oled_display.h"
 #include "sensors.h"
 #include "system.h"
+#include "deferred_log.h"
+#include "task_stats.h"
+#include "mem_placement.h"
+#include "intrusion_fusion.h"
+#include "history_rollup.h"
+#include "oled_trend.h"
+#include "alert_journal.h"
 
 // OLED Display object - 1.3" 128x64 display
-SH1106Wire display(0x3C, OLED_SDA_PIN, OLED_SCL_PIN);
+OledCanvas display(0x3C, OLED_SDA_PIN, OLED_SCL_PIN);
+
+// Drawn into on every tOLED pass and streamed out over I2C: internal RAM.
+// Set before init(), so allocateBuffer() leaves them alone.
+bool OledCanvas::placeBuffers() {
+  size_t size = width() * height() / 8;
+  buffer = (uint8_t*)memPlace("oledFrame", size, MEM_HOT);
+#ifdef OLEDDISPLAY_DOUBLE_BUFFER
+  buffer_back = (uint8_t*)memPlace("oledFrameBack", size, MEM_HOT);
+#endif
+  return buffer != nullptr;
+}
+
+uint16_t OledCanvas::drawText(int16_t x, int16_t y, const char* text) {
+  uint16_t length = strlen(text);
+  return drawStringInternal(x, y, text, length, getStringWidth(text, length, true), true);
+}
+
+uint16_t OledCanvas::drawTextf(int16_t x, int16_t y, const char* format, ...) {
+  char line[OLED_TEXT_MAX];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  return drawText(x, y, line);
+}
 
 // Global OLED variables
 int currentPage = 0;
 int currentSetting = 0;
 MenuState currentState = STATE_PAGES;
 OLEDConfig oledConfig = {true}; // auto_swipe only
-const int totalPages = 5;
+const int totalPages = 6;
 const int totalSettings = 2; // Auto-swipe and Pages info
 
 // Animation and status variables
@@ -29,6 +61,8 @@ const unsigned long longPressDelay = 1000;
 const unsigned long autoSwipeDelay = 15000;
 
 void initOLEDDisplay() {
+  display.placeBuffers();
+  initOLEDTrend();
   display.init();
   display.flipScreenVertically();
   display.setFont(ArialMT_Plain_16);
@@ -49,7 +83,7 @@ void initOLEDButtons() {
   // Small delay to stabilize button states
   vTaskDelay(pdMS_TO_TICKS(100));
   
-  Serial.println("OLED buttons initialized - NEXT: " + String(BUTTON_NEXT) + ", PREV: " + String(BUTTON_PREV));
+  Serial.printf("OLED buttons initialized - NEXT: %d, PREV: %d\n", BUTTON_NEXT, BUTTON_PREV);
 }
 
 void showIntro() {
@@ -60,10 +94,10 @@ void showIntro() {
   display.setFont(ArialMT_Plain_16);
   
   // Show "Smart Shop" letter by letter
-  String line1 = "Smart Shop";
-  for (int i = 0; i <= line1.length(); i++) {
+  const char* line1 = "Smart Shop";
+  for (int i = 0; i <= (int)strlen(line1); i++) {
     display.clear();
-    display.drawString(15, 15, line1.substring(0, i));
+    display.drawTextf(15, 15, "%.*s", i, line1);
     display.display();
     vTaskDelay(pdMS_TO_TICKS(100)); // Reduced from 150ms
   }
@@ -71,14 +105,14 @@ void showIntro() {
   vTaskDelay(pdMS_TO_TICKS(200)); // Reduced from 300ms
   
   // Show "Guard" letter by letter with shield icon
-  String line2 = "Guard";
-  for (int i = 0; i <= line2.length(); i++) {
+  const char* line2 = "Guard";
+  for (int i = 0; i <= (int)strlen(line2); i++) {
     display.clear();
-    display.drawString(15, 15, line1); // Keep first line
-    display.drawString(35, 30, line2.substring(0, i));
+    display.drawText(15, 15, line1); // Keep first line
+    display.drawTextf(35, 30, "%.*s", i, line2);
     
     // Add shield icon next to Guard when text is complete
-    if (i == line2.length()) {
+    if (i == (int)strlen(line2)) {
       display.drawXbm(80, 32, 16, 16, shield_icon);
     }
     
@@ -95,8 +129,8 @@ void showIntro() {
     vTaskDelay(pdMS_TO_TICKS(150)); // Reduced from 200ms
     
     display.clear();
-    display.drawString(15, 15, "Smart Shop");
-    display.drawString(35, 30, "Guard");
+    display.drawText(15, 15, "Smart Shop");
+    display.drawText(35, 30, "Guard");
     display.drawXbm(80, 32, 16, 16, shield_icon);
     display.display();
     vTaskDelay(pdMS_TO_TICKS(200)); // Reduced from 300ms
@@ -105,8 +139,8 @@ void showIntro() {
   // Animation 3: Border animation with shield icon (simplified)
   for (int i = 0; i < 32; i += 16) { // Reduced iterations and increased step
     display.clear();
-    display.drawString(15, 15, "Smart Shop");
-    display.drawString(35, 30, "Guard");
+    display.drawText(15, 15, "Smart Shop");
+    display.drawText(35, 30, "Guard");
     display.drawXbm(80, 32, 16, 16, shield_icon);
     
     // Draw animated border (simplified)
@@ -124,8 +158,8 @@ void showIntro() {
   
   // Final display with shield icon
   display.clear();
-  display.drawString(15, 15, "Smart Shop");
-  display.drawString(35, 30, "Guard");
+  display.drawText(15, 15, "Smart Shop");
+  display.drawText(35, 30, "Guard");
   display.drawXbm(80, 32, 16, 16, shield_icon);
   display.display();
   vTaskDelay(pdMS_TO_TICKS(400)); // Reduced from 800ms
@@ -149,8 +183,8 @@ void displayOLEDWelcomeMessage() {
 void displayOLEDModeStatus() {
   display.clear();
   display.setFont(ArialMT_Plain_16);
-  display.drawString(15, 15, "Mode: ");
-  display.drawString(15, 35, isDay ? "Night" : "Day");
+  display.drawText(15, 15, "Mode: ");
+  display.drawText(15, 35, isDay ? "Night" : "Day");
   display.display();
   vTaskDelay(pdMS_TO_TICKS(1000));  // Reduced delay for better sync
   updateOLEDDisplay();  // Return to normal display after mode status
@@ -167,7 +201,7 @@ void displayOLEDFireAlert() {
   // Update OLED immediately to show fire alert
   updateOLEDDisplay();
   
-  Serial.println("OLED: Fire alert displayed - page cycling paused");
+  logEvent(LOG_OLED_FIRE);
 }
 
 void displayOLEDSafeStatus() {
@@ -181,7 +215,7 @@ void displayOLEDSafeStatus() {
   // Update OLED immediately to show normal status
   updateOLEDDisplay();
   
-  Serial.println("OLED: Safe status - resuming normal operation and page cycling");
+  logEvent(LOG_OLED_SAFE);
 }
 
 void displayOLEDThiefAlert() {
@@ -195,7 +229,7 @@ void displayOLEDThiefAlert() {
   // Update OLED immediately to show thief alert
   updateOLEDDisplay();
   
-  Serial.println("OLED: Thief alert displayed - page cycling paused");
+  logEvent(LOG_OLED_THIEF);
 }
 
 void displayOLEDMotionCleared() {
@@ -209,7 +243,7 @@ void displayOLEDMotionCleared() {
   // Update OLED immediately to show normal status
   updateOLEDDisplay();
   
-  Serial.println("OLED: Motion cleared - resuming normal operation and page cycling");
+  logEvent(LOG_OLED_MOTION_CLEARED);
 }
 
 void updateOLEDDisplay() {
@@ -261,7 +295,7 @@ void handleButtons() {
       lastAutoSwipe = millis();
       bothButtonsStart = 0;
       lastButtonPress = millis();
-      Serial.println("Auto-swipe toggled: " + String(oledConfig.auto_swipe ? "ON" : "OFF"));
+      Serial.printf("Auto-swipe toggled: %s\n", oledConfig.auto_swipe ? "ON" : "OFF");
       
       // Visual feedback - flash the display
       display.invertDisplay();
@@ -296,7 +330,7 @@ void handleButtons() {
         lastDebounce = millis();
         lastAutoSwipe = millis();
         lastButtonPress = millis();
-        Serial.println("Page changed to: " + String(currentPage));
+        Serial.printf("Page changed to: %d\n", currentPage);
       }
       
       if (prevState && !prevPressed) {
@@ -304,7 +338,7 @@ void handleButtons() {
         lastDebounce = millis();
         lastAutoSwipe = millis();
         lastButtonPress = millis();
-        Serial.println("Page changed to: " + String(currentPage));
+        Serial.printf("Page changed to: %d\n", currentPage);
       }
     } else {
       // Settings navigation
@@ -312,7 +346,7 @@ void handleButtons() {
         currentSetting = (currentSetting + 1) % totalSettings;
         lastDebounce = millis();
         lastButtonPress = millis();
-        Serial.println("Setting selected: " + String(currentSetting));
+        Serial.printf("Setting selected: %d\n", currentSetting);
       }
       
       if (prevState && !prevPressed) {
@@ -334,6 +368,9 @@ void showCurrentPage() {
     case PAGE_SENSORS:
       showSensorPage();
       break;
+    case PAGE_TREND:
+      showTrendPage();
+      break;
     case PAGE_SYSTEM:
       showSystemPage();
       break;
@@ -367,28 +404,39 @@ void showStatusPage() {
   } 
   
   display.setFont(ArialMT_Plain_10);
-  display.drawString(18, 5, "Status");
+  display.drawText(18, 5, "Status");
   
   // Status info - COMPACT LIKE OLED_1 (moved up 8 pixels)
   if (fireDetected && alertFlashing) {
-    display.drawString(0, 20, "FIRE DETECTED!");
-    display.drawString(0, 30, "EMERGENCY!");
-    display.drawString(0, 40, "EVACUATE NOW!");
+    display.drawText(0, 20, "FIRE DETECTED!");
+    display.drawText(0, 30, "EMERGENCY!");
+    display.drawText(0, 40, "EVACUATE NOW!");
   } else if (motionDetected && alertFlashing) {
-    display.drawString(0, 20, "MOTION DETECTED!");
-    display.drawString(0, 30, "Location: Door");
-    display.drawString(0, 40, "Alert: ACTIVE");
+    display.drawText(0, 20, "MOTION DETECTED!");
+    display.drawText(0, 30, "Location: Door");
+    display.drawText(0, 40, "Alert: ACTIVE");
   } else {
-    display.drawString(0, 20, "System: SECURE");
-    display.drawString(0, 30, "Temp: " + String(t) + "C");
-    display.drawString(0, 40, "Humid: " + String(h) + "%");
+    display.drawText(0, 20, "System: SECURE");
+    display.drawTextf(0, 30, "Temp: %dC", t);
+    display.drawTextf(0, 40, "Humid: %d%%", h);
     
     // Add WiFi status indicator on status page
     display.setFont(ArialMT_Plain_10);
     if (isWiFiConnected()) {
-      display.drawString(90, 20, "WiFi:OK");
+      display.drawText(90, 20, "WiFi:OK");
     } else {
-      display.drawString(90, 20, "WiFi:--");
+      display.drawText(90, 20, "WiFi:--");
+    }
+    
+    // Last hour, day and week from the rollup buckets, one window every 3 s
+    static const char* const windowNames[] = {"1h", "24h", "7d"};
+    static const uint32_t windowSeconds[] = {3600, 86400, 7 * 86400};
+    uint8_t w = (millis() / 3000) % 3;
+    RollupAgg agg;
+    rollupLast(windowSeconds[w], &agg);
+    if (agg.samples) {
+      display.drawTextf(0, 50, "%s %d-%dC %d-%d%% M%u", windowNames[w], agg.tempMin, agg.tempMax,
+                        agg.humMin, agg.humMax, (unsigned)agg.motionEvents);
     }
   }
 }
@@ -409,15 +457,15 @@ void showSensorPage() {
     display.drawXbm(110, 5, 8, 8, Bluetooth_icon_disconnected);
   }  
   display.setFont(ArialMT_Plain_10);
-  display.drawString(18, 5, "Sensors");
+  display.drawText(18, 5, "Sensors");
   
   // Sensor readings (moved up 8 pixels)
-  display.drawString(0, 20, "Temperature: " + String(t) + "C");
-  display.drawString(0, 30, "Humidity: " + String(h) + "%");
-  display.drawString(0, 40, "AC: " + String(AC ? "ON" : "OFF"));
+  display.drawTextf(0, 20, "Temperature: %dC", t);
+  display.drawTextf(0, 30, "Humidity: %d%%", h);
+  display.drawTextf(0, 40, "AC: %s", AC ? "ON" : "OFF");
   
   // Fire sensor status
-  display.drawString(0, 48, fireDetected ? "Fire: YES" : "Fire: NO");
+  display.drawText(0, 48, fireDetected ? "Fire: YES" : "Fire: NO");
 }
 
 void showSystemPage() {
@@ -435,13 +483,40 @@ void showSystemPage() {
     display.drawXbm(110, 5, 8, 8, Bluetooth_icon_disconnected);
   }  
   display.setFont(ArialMT_Plain_10);
-  display.drawString(18, 5, "System");
+  display.drawText(18, 5, "System");
   
   // System information with dynamic WiFi status
-  display.drawString(0, 20, getWiFiStatus());
-  display.drawString(0, 30, "Mode: " + String(isDay ? "Night" : "Day"));
-  display.drawString(0, 40, "Uptime: " + String(millis() / 1000) + "s");
-  display.drawString(0, 50, "Memory: " + String(ESP.getFreeHeap()/1000) + "KB");
+  char line[OLED_TEXT_MAX];
+  getWiFiStatus(line, sizeof(line));
+  display.drawText(0, 20, line);
+  display.drawTextf(0, 30, "%s  Up %lus  %uKB", isDay ? "Night" : "Day", millis() / 1000,
+                    (unsigned)(ESP.getFreeHeap() / 1000));
+  
+  // Per-core idle and one task per second: CPU share, worst overrun, stack headroom
+  TaskStatsSnapshot stats;
+  getTaskStats(&stats);
+  display.drawTextf(0, 40, "Idle C0 %u%%  C1 %u%%", stats.idlePermille[0] / 10, stats.idlePermille[1] / 10);
+  if (stats.count > 0) {
+    const TaskStatsEntry& task = stats.tasks[(millis() / 1000) % stats.count];
+    display.drawTextf(0, 50, "%s %u%% +%ums %uB", task.name, task.cpuPermille / 10,
+                      task.worstLateMs, (unsigned)task.stackFreeMin);
+  }
+}
+
+// "42s" / "17m" / "5h" / "3d" ago; "~" when logged in an earlier boot, whose
+// powered-off time the journal clock does not count
+static void formatAlertAge(const AlertRecord* r, char* out, size_t size) {
+  uint32_t age = alertJournalNowS() - r->timeS;
+  const char* approx = r->boot != alertJournalBoot() ? "~" : "";
+  if (age < 60) {
+    snprintf(out, size, "%s%us", approx, (unsigned)age);
+  } else if (age < 3600) {
+    snprintf(out, size, "%s%um", approx, (unsigned)(age / 60));
+  } else if (age < 86400) {
+    snprintf(out, size, "%s%uh", approx, (unsigned)(age / 3600));
+  } else {
+    snprintf(out, size, "%s%ud", approx, (unsigned)(age / 86400));
+  }
 }
 
 void showAlertsPage() {
@@ -459,27 +534,35 @@ void showAlertsPage() {
     display.drawXbm(110, 5, 8, 8, Bluetooth_icon_disconnected);
   }  
   display.setFont(ArialMT_Plain_10);
-  display.drawString(18, 5, "Alerts");
+  display.drawText(18, 5, "Alerts");
   
   // Enhanced alert status with detailed information
   if (fireDetected) {
     // Fire alert - match LCD display
-    display.drawString(0, 20, "FIRE ALERT!");
-    display.drawString(0, 30, "EVACUATE NOW!");
-    display.drawString(0, 40, "System: EMERGENCY");
-    display.drawString(0, 50, "Status: ACTIVE");
+    display.drawText(0, 20, "FIRE ALERT!");
+    display.drawText(0, 30, "EVACUATE NOW!");
+    display.drawText(0, 40, "System: EMERGENCY");
+    display.drawText(0, 50, "Status: ACTIVE");
   } else if (motionDetected) {
     // Thief alert - match LCD display
-    display.drawString(0, 20, "THIEF ALERT!");
-    display.drawString(0, 30, "Security Breach!");
-    display.drawString(0, 40, "Location: Door");
-    display.drawString(0, 50, "Status: ACTIVE");
+    display.drawText(0, 20, "THIEF ALERT!");
+    display.drawText(0, 30, "Security Breach!");
+    display.drawText(0, 40, "Location: Door");
+    display.drawText(0, 50, "Status: ACTIVE");
   } else {
-    // All clear - show normal status
-    display.drawString(0, 20, "All Clear");
-    display.drawString(0, 30, "No active alerts");
-    display.drawString(0, 40, "System secure");
-    display.drawString(0, 50, "Status: NORMAL");
+    // All clear - show normal status and the last alerts from the journal
+    display.drawText(0, 20, "All Clear");
+    display.drawTextf(0, 30, "Door %s  Score %u", doorOpen ? "open" : "closed", getIntrusionScore());
+    AlertRecord last[2];
+    size_t n = alertJournalLast(2, last);   // From its RAM copy, no flash read
+    if (!n) {
+      display.drawText(0, 40, "No alerts logged");
+    }
+    for (size_t i = 0; i < n; i++) {
+      char age[12];
+      formatAlertAge(&last[i], age, sizeof(age));
+      display.drawTextf(0, 40 + 10 * i, "%s  %s", age, alertTypeName(last[i].type));
+    }
   }
 }
 
@@ -498,11 +581,13 @@ void showSettingsPage() {
     display.drawXbm(110, 5, 8, 8, Bluetooth_icon_disconnected);
   }  
   display.setFont(ArialMT_Plain_10);
-  display.drawString(18, 5, "Settings");
+  display.drawText(18, 5, "Settings");
   
   // Settings menu with better formatting
-  String autoSwipeText = "Auto-Swipe: " + String(oledConfig.auto_swipe ? "ON" : "OFF");
-  String pagesText = "Pages: " + String(totalPages);
+  char autoSwipeText[24];
+  char pagesText[16];
+  snprintf(autoSwipeText, sizeof(autoSwipeText), "Auto-Swipe: %s", oledConfig.auto_swipe ? "ON" : "OFF");
+  snprintf(pagesText, sizeof(pagesText), "Pages: %d", totalPages);
   
   // Show current setting selection indicator
   if (currentState == STATE_SETTINGS) {
@@ -510,26 +595,26 @@ void showSettingsPage() {
     if (currentSetting == 0) {
       display.fillRect(0, 18, 128, 12);
       display.setFont(ArialMT_Plain_10);
-      display.drawString(0, 20, "> " + autoSwipeText);
-      display.drawString(0, 30, pagesText);
+      display.drawTextf(0, 20, "> %s", autoSwipeText);
+      display.drawText(0, 30, pagesText);
     } else if (currentSetting == 1) {
-      display.drawString(0, 20, autoSwipeText);
+      display.drawText(0, 20, autoSwipeText);
       display.fillRect(0, 28, 128, 12);
       display.setFont(ArialMT_Plain_10);
-      display.drawString(0, 30, "> " + pagesText);
+      display.drawTextf(0, 30, "> %s", pagesText);
     }
     
     // Show navigation hint
     display.setFont(ArialMT_Plain_10);
-    display.drawString(0, 50, "NEXT: Select  PREV: Execute");
+    display.drawText(0, 50, "NEXT: Select  PREV: Execute");
   } else {
     // Normal display when not in settings mode
-    display.drawString(0, 20, autoSwipeText);
-    display.drawString(0, 30, pagesText);
+    display.drawText(0, 20, autoSwipeText);
+    display.drawText(0, 30, pagesText);
     
     // Show access hint
     display.setFont(ArialMT_Plain_10);
-    display.drawString(0, 50, "Hold both buttons to toggle auto-swipe");
+    display.drawText(0, 50, "Hold both buttons to toggle auto-swipe");
   }
 }
 
@@ -567,11 +652,11 @@ void executeSetting() {
   switch (currentSetting) {
     case 0: // Auto-swipe
       oledConfig.auto_swipe = !oledConfig.auto_swipe;
-      Serial.println("Auto-swipe: " + String(oledConfig.auto_swipe ? "ON" : "OFF"));
+      Serial.printf("Auto-swipe: %s\n", oledConfig.auto_swipe ? "ON" : "OFF");
       break;
       
     case 1: // Pages (just show info for now)
-      Serial.println("Total pages: " + String(totalPages));
+      Serial.printf("Total pages: %d\n", totalPages);
       break;
   }
   updateOLEDDisplay();
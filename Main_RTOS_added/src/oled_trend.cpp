@@ -0,0 +1,168 @@
+#include "oled_trend.h"
+#include "oled_display.h"
+#include "history_rollup.h"
+#include "mem_placement.h"
+
+// 📈 OLED Trend Page
+// canvas[page][x] holds 8 vertical pixels per byte like the frame buffer;
+// page 0 of the canvas is frame page TREND_FIRST_PAGE. Column x shows
+// bucket trendColumn - (TREND_WIDTH - 1 - x), bucket n being the uptime
+// seconds [n * TREND_COLUMN_S, (n + 1) * TREND_COLUMN_S). Only TaskOLED
+// touches this state.
+
+static_assert(TREND_COLUMN_S % 60 == 0, "TREND_COLUMN_S must be whole rollup minutes");
+
+#define TREND_FIRST_PAGE 2             // Plot rows y 16..63
+#define TREND_PAGES 6
+#define TREND_BAND_ROWS 23             // Per sparkline, one blank row between them
+#define TREND_HUM_ROW 24               // First canvas row of the humidity band
+
+static uint8_t canvas[TREND_PAGES][TREND_WIDTH];
+static uint32_t trendColumn = UINT32_MAX;   // Bucket in the rightmost column
+static RollupAgg drawnNewest;               // What the rightmost column shows
+static int16_t tempLo = 0, tempHi = 2 * TREND_SCALE_STEP;
+static int16_t humLo = 0, humHi = 100;
+static char header[OLED_TEXT_MAX];          // t/h line as last drawn
+
+void initOLEDTrend() {
+    MEM_DECLARE("oledTrend", canvas, MEM_HOT);   // Copied into the frame every pass
+}
+
+static void bucketAgg(uint32_t column, RollupAgg* out) {
+    rollupQuery(column * TREND_COLUMN_S, (column + 1) * TREND_COLUMN_S, out);
+}
+
+static bool sameBar(const RollupAgg* a, const RollupAgg* b) {
+    return a->samples == b->samples && a->tempMin == b->tempMin && a->tempMax == b->tempMax &&
+           a->humMin == b->humMin && a->humMax == b->humMax;
+}
+
+// ✏️ Drawing
+static int bandRow(int16_t value, int16_t lo, int16_t hi) {
+    int32_t row = (TREND_BAND_ROWS - 1) - (int32_t)(value - lo) * (TREND_BAND_ROWS - 1) / (hi - lo);
+    return row < 0 ? 0 : (row >= TREND_BAND_ROWS ? TREND_BAND_ROWS - 1 : row);
+}
+
+static void setSpan(uint8_t x, int top, int bottom) {
+    for (int y = top; y <= bottom; y++) canvas[y >> 3][x] |= (uint8_t)(1 << (y & 7));
+}
+
+static void drawColumn(uint8_t x, const RollupAgg* a) {
+    for (int page = 0; page < TREND_PAGES; page++) canvas[page][x] = 0;
+    if (!a->samples) return;
+    setSpan(x, bandRow(a->tempMax, tempLo, tempHi), bandRow(a->tempMin, tempLo, tempHi));
+    setSpan(x, TREND_HUM_ROW + bandRow(a->humMax, humLo, humHi), TREND_HUM_ROW + bandRow(a->humMin, humLo, humHi));
+}
+
+static bool outsideScale(const RollupAgg* a) {
+    return a->samples && (a->tempMin < tempLo || a->tempMax > tempHi || a->humMin < humLo || a->humMax > humHi);
+}
+
+// 📏 Axis limits: the whole window in one query, snapped so they rarely move
+static int16_t snapDown(int16_t v) {
+    return v >= 0 ? v / TREND_SCALE_STEP * TREND_SCALE_STEP
+                  : -((-v + TREND_SCALE_STEP - 1) / TREND_SCALE_STEP * TREND_SCALE_STEP);
+}
+
+static void snapRange(int16_t mn, int16_t mx, int16_t* lo, int16_t* hi) {
+    *lo = snapDown(mn);
+    *hi = -snapDown(-mx);
+    if (*hi - *lo < 2 * TREND_SCALE_STEP) *hi = *lo + 2 * TREND_SCALE_STEP;
+}
+
+static bool rescale(uint32_t column) {
+    uint32_t first = column >= TREND_WIDTH - 1 ? column - (TREND_WIDTH - 1) : 0;
+    RollupAgg all;
+    rollupQuery(first * TREND_COLUMN_S, (column + 1) * TREND_COLUMN_S, &all);
+    if (!all.samples) return false;
+    int16_t tl, th, hl, hh;
+    snapRange(all.tempMin, all.tempMax, &tl, &th);
+    snapRange(all.humMin, all.humMax, &hl, &hh);
+    bool changed = tl != tempLo || th != tempHi || hl != humLo || hh != humHi;
+    tempLo = tl;
+    tempHi = th;
+    humLo = hl;
+    humHi = hh;
+    return changed;
+}
+
+static void redrawAll(uint32_t column) {
+    for (uint8_t x = 0; x < TREND_WIDTH; x++) {
+        RollupAgg a;
+        uint32_t back = TREND_WIDTH - 1 - x;
+        if (column >= back) {
+            bucketAgg(column - back, &a);
+        } else {
+            memset(&a, 0, sizeof(a));            // Before boot: empty
+        }
+        drawColumn(x, &a);
+        if (back == 0) drawnNewest = a;
+    }
+}
+
+static void scroll(uint32_t n) {
+    for (int page = 0; page < TREND_PAGES; page++) {
+        memmove(canvas[page], canvas[page] + n, TREND_WIDTH - n);
+        memset(canvas[page] + TREND_WIDTH - n, 0, n);
+    }
+}
+
+// Returns whether the canvas changed
+static bool updateCanvas() {
+    uint32_t column = rollupNowSec() / TREND_COLUMN_S;
+    bool changed = true;
+    if (trendColumn == UINT32_MAX || column - trendColumn >= TREND_WIDTH) {
+        rescale(column);
+        redrawAll(column);
+    } else if (column != trendColumn) {
+        if (rescale(column)) {
+            redrawAll(column);
+        } else {
+            // Shift, then redraw the old newest bucket (its last points came
+            // after it was drawn) and draw the new ones
+            scroll(column - trendColumn);
+            for (uint32_t c = trendColumn; c <= column; c++) {
+                RollupAgg a;
+                bucketAgg(c, &a);
+                drawColumn(TREND_WIDTH - 1 - (column - c), &a);
+                if (c == column) drawnNewest = a;
+            }
+        }
+    } else {
+        RollupAgg a;
+        bucketAgg(column, &a);
+        if (!sameBar(&a, &drawnNewest)) {
+            if (outsideScale(&a) && rescale(column)) {
+                redrawAll(column);
+            } else {
+                drawColumn(TREND_WIDTH - 1, &a);
+                drawnNewest = a;
+            }
+        } else {
+            changed = false;
+        }
+    }
+    trendColumn = column;
+    return changed;
+}
+
+// 🖥️ Page
+// The frame is cleared every pass, so the header is drawn every pass too,
+// but its text only changes on a pass where the canvas did not: the flush
+// is one bounding box, and header plus plot column would span the frame.
+void showTrendPage() {
+    bool plotChanged = updateCanvas();
+    for (int page = 0; page < TREND_PAGES; page++) {
+        memcpy(display.buffer + (TREND_FIRST_PAGE + page) * display.width() + TREND_X, canvas[page], TREND_WIDTH);
+    }
+
+    display.setFont(ArialMT_Plain_10);
+    if (!plotChanged || !header[0]) {
+        snprintf(header, sizeof(header), "%dC %d%%  last %u min", t, h, (unsigned)(TREND_WIDTH * TREND_COLUMN_S / 60));
+    }
+    display.drawText(0, 0, header);
+    display.drawTextf(0, 14, "%d", tempHi);
+    display.drawTextf(0, 27, "%d", tempLo);
+    display.drawTextf(0, 38, "%d", humHi);
+    display.drawTextf(0, 51, "%d", humLo);
+}
@@ -0,0 +1,40 @@
+#include "periodic_task.h"
+
+// ⏱️ Periodic Tasks
+// All times are ticks against the task's own release grid; the counters are
+// only written by the owning task and read by the statistics.
+
+void periodicStart(PeriodicTask* schedule) {
+    schedule->lastWake = xTaskGetTickCount();
+    schedule->shedCycles = 0;
+}
+
+bool periodicOptional(const PeriodicTask* schedule) {
+    return schedule->shedCycles == 0;
+}
+
+void periodicWait(PeriodicTask* schedule) {
+    TickType_t period = pdMS_TO_TICKS(schedule->periodMs);
+    TickType_t response = xTaskGetTickCount() - schedule->lastWake;
+    uint32_t responseMs = response * portTICK_PERIOD_MS;
+
+    schedule->releases++;
+    if (responseMs > schedule->worstResponseMs) {
+        schedule->worstResponseMs = responseMs > 0xFFFF ? 0xFFFF : (uint16_t)responseMs;
+    }
+    if (schedule->shedCycles > 0) {
+        schedule->shedCycles--;
+    }
+    if (responseMs > schedule->deadlineMs) {
+        schedule->overruns++;
+        schedule->shedCycles = PERIODIC_SHED_CYCLES;
+    }
+
+    // Ran into the next release or beyond: keep the grid, drop the missed ones
+    if (period > 0 && response >= period) {
+        TickType_t missed = response / period;
+        schedule->lastWake += missed * period;
+        schedule->skipped += missed;
+    }
+    vTaskDelayUntil(&schedule->lastWake, period > 0 ? period : 1);
+}
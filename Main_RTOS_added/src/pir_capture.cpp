@@ -0,0 +1,180 @@
+#include "pir_capture.h"
+#include "sensors.h"
+#include "actuators.h"
+#include "deferred_log.h"
+#include "rtos_trace.h"
+#include "mem_placement.h"
+#include "esp_timer.h"
+#include <atomic>
+
+// 🚶 PIR Edge Capture
+// Single-producer / single-consumer ring: the ISR is the only writer of the
+// head, the esp_timer callback the only reader. Timestamps are the low 32
+// bits of esp_timer_get_time(), so all arithmetic on them is modular
+// (differences stay valid for 71 minutes).
+
+#define PIR_RING_MASK (PIR_RING_EDGES - 1)
+static_assert((PIR_RING_EDGES & PIR_RING_MASK) == 0, "PIR_RING_EDGES must be a power of two");
+
+struct PirEdge {
+    uint32_t tsUs;
+    uint8_t level;
+};
+
+static esp_timer_handle_t settleTimer = nullptr;
+static volatile uint32_t overflows = 0;
+static bool stableLevel = false;              // Debounced PIR output
+
+static PirCaptureStats stats = {};
+static uint64_t pulseSumMs = 0;
+static uint64_t latencySumUs = 0;
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+#if PIR_EDGE_CAPTURE
+static PirEdge ring[PIR_RING_EDGES];
+static std::atomic<uint32_t> ringHead(0);     // Next slot the ISR writes
+static std::atomic<uint32_t> ringTail(0);     // Next slot the callback reads
+
+// Consumer state (esp_timer task only)
+static bool changePending = false;            // Edges away from stableLevel seen
+static uint32_t changeStartUs = 0;            // First of them
+static bool highPending = false;              // Rising edge seen, pulse not ended
+static uint32_t highStartUs = 0;
+
+// ⚡ PIR pin edge (ISR)
+static void IRAM_ATTR pirEdgeISR() {
+    RTOS_TRACE_ISR(PIR_PIN);
+    uint32_t head = ringHead.load(std::memory_order_relaxed);
+    if (head - ringTail.load(std::memory_order_acquire) < PIR_RING_EDGES) {
+        PirEdge& e = ring[head & PIR_RING_MASK];
+        e.tsUs = (uint32_t)esp_timer_get_time();
+        e.level = digitalRead(PIR_PIN) == HIGH;
+        ringHead.store(head + 1, std::memory_order_release);
+    } else {
+        overflows++;
+    }
+    // Settle window restarts on every edge
+    esp_timer_stop(settleTimer);
+    esp_timer_start_once(settleTimer, PIR_SETTLE_MS * 1000ULL);
+}
+
+static void recordPulse(uint32_t widthUs) {
+    uint32_t ms = widthUs / 1000;
+    portENTER_CRITICAL(&statsMux);
+    stats.pulses++;
+    stats.lastPulseMs = ms;
+    if (stats.pulses == 1 || ms < stats.minPulseMs) stats.minPulseMs = ms;
+    if (ms > stats.maxPulseMs) stats.maxPulseMs = ms;
+    pulseSumMs += ms;
+    portEXIT_CRITICAL(&statsMux);
+    logEvent(LOG_PIR_PULSE, ms);
+}
+
+// ⏲️ Pin quiet for PIR_SETTLE_MS (esp_timer task)
+static void settleDone(void* arg) {
+    (void)arg;
+    uint32_t tail = ringTail.load(std::memory_order_relaxed);
+    uint32_t head = ringHead.load(std::memory_order_acquire);
+    uint32_t edges = head - tail;
+    for (; tail != head; tail++) {
+        const PirEdge& e = ring[tail & PIR_RING_MASK];
+        if (e.level) {
+            highPending = true;
+            highStartUs = e.tsUs;
+        } else if (highPending) {
+            highPending = false;
+            recordPulse(e.tsUs - highStartUs);
+        }
+        if (!changePending && (bool)e.level != stableLevel) {
+            changePending = true;
+            changeStartUs = e.tsUs;
+        }
+    }
+    ringTail.store(tail, std::memory_order_release);
+
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    uint32_t nowMs = millis();
+    bool level = digitalRead(PIR_PIN) == HIGH;
+
+    portENTER_CRITICAL(&statsMux);
+    stats.edges += edges;
+    portEXIT_CRITICAL(&statsMux);
+
+    if (!changePending) {
+        if (level == stableLevel) return;
+        changeStartUs = nowUs;                  // Its edges were lost on a full ring
+    }
+    changePending = false;
+    if (level == stableLevel) {
+        portENTER_CRITICAL(&statsMux);
+        stats.glitches++;                       // Went away and came back inside the window
+        portEXIT_CRITICAL(&statsMux);
+        return;
+    }
+
+    stableLevel = level;
+    uint32_t latency = nowUs - changeStartUs;
+    portENTER_CRITICAL(&statsMux);
+    stats.changes++;
+    stats.lastLatencyUs = latency;
+    if (latency > stats.maxLatencyUs) stats.maxLatencyUs = latency;
+    latencySumUs += latency;
+    portEXIT_CRITICAL(&statsMux);
+
+    postMotionChange(level, nowMs - latency / 1000);   // Stamped with the edge, not the settle
+    notifyActuators(ACT_EVT_HAZARD);
+}
+#endif
+
+// 🔧 Setup
+bool initPirCapture() {
+#if PIR_EDGE_CAPTURE
+    esp_timer_create_args_t args = {};
+    args.callback = settleDone;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "pir";
+    if (esp_timer_create(&args, &settleTimer) != ESP_OK) {
+        Serial.println("❌ PIR capture: timer create failed");
+        return false;
+    }
+    MEM_DECLARE("pirRing", ring, MEM_HOT);     // Written from the ISR
+    stableLevel = digitalRead(PIR_PIN) == HIGH;
+    attachInterrupt(digitalPinToInterrupt(PIR_PIN), pirEdgeISR, CHANGE);
+    Serial.printf("🚶 PIR edge capture armed (%u ms settle)\n", (unsigned)PIR_SETTLE_MS);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool isPirCaptureActive() {
+    return settleTimer != nullptr;
+}
+
+bool getPirLevel() {
+    return stableLevel;
+}
+
+// 📤 Statistics
+void getPirCaptureStats(PirCaptureStats* out) {
+    portENTER_CRITICAL(&statsMux);
+    *out = stats;
+    out->avgPulseMs = stats.pulses ? (uint32_t)(pulseSumMs / stats.pulses) : 0;
+    out->avgLatencyUs = stats.changes ? (uint32_t)(latencySumUs / stats.changes) : 0;
+    portEXIT_CRITICAL(&statsMux);
+    out->overflows = overflows;
+}
+
+void printPirCaptureStats() {
+    if (!settleTimer) return;
+    PirCaptureStats s;
+    getPirCaptureStats(&s);
+    char line[192];
+    snprintf(line, sizeof(line),
+             "🚶 PIR capture: %u edges (%u lost), %u changes, %u glitches, pulses %u (last %u min %u avg %u max %u ms), "
+             "latency avg %u max %u us",
+             (unsigned)s.edges, (unsigned)s.overflows, (unsigned)s.changes, (unsigned)s.glitches, (unsigned)s.pulses,
+             (unsigned)s.lastPulseMs, (unsigned)s.minPulseMs, (unsigned)s.avgPulseMs, (unsigned)s.maxPulseMs,
+             (unsigned)s.avgLatencyUs, (unsigned)s.maxLatencyUs);
+    Serial.println(line);
+}
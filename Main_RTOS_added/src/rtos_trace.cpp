@@ -0,0 +1,279 @@
+#include "rtos_trace.h"
+#include <atomic>
+#include "mem_placement.h"
+
+#ifdef SIM_NATIVE
+#include "sim_hw.h"
+#else
+#include "esp_freertos_hooks.h"
+#include "esp_spi_flash.h"
+#endif
+
+// 🔬 RTOS Timeline Trace
+// Producers claim a slot with one atomic increment and overwrite the oldest
+// event (flight recorder). Each core drops a SYNC event (cycle count +
+// micros()) at least once a second so the host can put both cores' cycle
+// counters on one timeline. Recording pauses while a dump is written, so the
+// dumped window is stable.
+
+#define RTOS_TRACE_MASK (RTOS_TRACE_RING_EVENTS - 1)
+static_assert((RTOS_TRACE_RING_EVENTS & RTOS_TRACE_MASK) == 0, "RTOS_TRACE_RING_EVENTS must be a power of two");
+static_assert(sizeof(RtosTraceEvent) == 16, "dump format expects 16-byte events");
+
+#define RTOS_TRACE_SYNC_CYCLES (240u * 1000000u)   // Max distance between SYNC events (1 s at 240 MHz)
+#define RTOS_TRACE_CORES 2
+
+struct RtosTraceObjectEntry {
+    uint32_t id;
+    uint8_t kind;
+    char name[16];
+};
+
+static RtosTraceEvent* ring = nullptr;          // PSRAM
+static std::atomic<uint32_t> ringHead(0);       // Events recorded since boot
+static volatile bool recording = false;
+static uint8_t taskSource = RTOS_SRC_TICK;
+static bool synced[RTOS_TRACE_CORES];
+static uint32_t lastSyncCycles[RTOS_TRACE_CORES];
+
+// Name table: filled by the kernel create hooks, the tick sampler and setup()
+static RtosTraceObjectEntry objects[RTOS_TRACE_MAX_OBJECTS];
+static std::atomic<uint32_t> objectCount(0);
+
+// Dump state (TaskSystemMonitor only)
+static volatile bool dumpRequested = false;
+static bool dumpActive = false;
+static uint32_t dumpPos = 0;
+static uint32_t dumpEnd = 0;
+
+static inline uint32_t traceHandle(const void* p) {
+    return (uint32_t)(uintptr_t)p;
+}
+
+// PSRAM sits behind the flash cache: nothing may be recorded while an NVS or
+// partition write has the cache disabled
+static inline bool IRAM_ATTR ringAccessible() {
+#ifdef SIM_NATIVE
+    return true;
+#else
+    return spi_flash_cache_enabled();
+#endif
+}
+
+// ✍️ Producer
+static inline void IRAM_ATTR putEvent(uint8_t type, uint8_t core, uint32_t cycles,
+                                      uint32_t obj, uint32_t task, uint16_t aux) {
+    uint32_t i = ringHead.fetch_add(1, std::memory_order_relaxed);
+    RtosTraceEvent* e = &ring[i & RTOS_TRACE_MASK];
+    e->cycles = cycles;
+    e->type = type;
+    e->core = core;
+    e->aux = aux;
+    e->obj = obj;
+    e->task = task;
+}
+
+extern "C" void IRAM_ATTR rtosTraceRecord(uint8_t type, const void* obj, const void* task, uint16_t aux) {
+    if (!recording || !ringAccessible()) return;
+
+    uint8_t core = (uint8_t)xPortGetCoreID() & (RTOS_TRACE_CORES - 1);
+    uint32_t cycles = ESP.getCycleCount();
+    if (!synced[core] || cycles - lastSyncCycles[core] >= RTOS_TRACE_SYNC_CYCLES) {
+        synced[core] = true;
+        lastSyncCycles[core] = cycles;
+        putEvent(RTOS_EV_SYNC, core, cycles, (uint32_t)micros(), 0, 0);
+    }
+    putEvent(type, core, cycles, traceHandle(obj), traceHandle(task), aux);
+}
+
+void IRAM_ATTR rtosTraceEvent(uint8_t type, const void* obj, uint16_t aux) {
+    const void* task = xPortInIsrContext() ? nullptr : xTaskGetCurrentTaskHandle();
+    rtosTraceRecord(type, obj, task, aux);
+}
+
+// 📖 Name table
+static RtosTraceObjectEntry* IRAM_ATTR findObject(uint32_t id) {
+    uint32_t n = objectCount.load(std::memory_order_acquire);
+    if (n > RTOS_TRACE_MAX_OBJECTS) n = RTOS_TRACE_MAX_OBJECTS;
+    for (uint32_t i = 0; i < n; i++) {
+        if (objects[i].id == id) return &objects[i];
+    }
+    return nullptr;
+}
+
+extern "C" void IRAM_ATTR rtosTraceObject(const void* obj, uint8_t kind, const char* name) {
+    if (!obj) return;
+    uint32_t id = traceHandle(obj);
+    RtosTraceObjectEntry* entry = findObject(id);
+    if (!entry) {
+        uint32_t i = objectCount.fetch_add(1, std::memory_order_acq_rel);
+        if (i >= RTOS_TRACE_MAX_OBJECTS) return;   // Table full: shows up unnamed
+        entry = &objects[i];
+        entry->id = id;
+    }
+    entry->kind = kind;
+    if (name) {
+        strncpy(entry->name, name, sizeof(entry->name) - 1);
+    }
+}
+
+// ⏱️ Tick sampler: the stock Arduino core ships a prebuilt kernel without
+// trace hooks, so the running task of each core is checked every tick
+#if !defined(SIM_NATIVE) && !defined(RTOS_TRACE_KERNEL_HOOKS)
+static TaskHandle_t sampledTask[RTOS_TRACE_CORES];
+
+static void IRAM_ATTR sampleRunningTask() {
+    if (!recording || !ringAccessible()) return;
+    BaseType_t core = xPortGetCoreID();
+    TaskHandle_t running = xTaskGetCurrentTaskHandleForCPU(core);
+    if (running == sampledTask[core]) return;
+    sampledTask[core] = running;
+    if (!findObject(traceHandle(running))) {
+        rtosTraceObject(running, RTOS_OBJ_TASK, pcTaskGetName(running));
+    }
+    rtosTraceRecord(RTOS_EV_TASK_IN, running, running, 1);
+}
+#endif
+
+#ifdef SIM_NATIVE
+static void onSimRtosEvent(SimRtosEvent event, void* object, const char* name) {
+    uint8_t type;
+    switch (event) {
+        case SIM_RTOS_TASK_CREATE:          rtosTraceObject(object, RTOS_OBJ_TASK, name); return;
+        case SIM_RTOS_QUEUE_CREATE:         rtosTraceObject(object, RTOS_OBJ_QUEUE, name); return;
+        case SIM_RTOS_MUTEX_CREATE:         rtosTraceObject(object, RTOS_OBJ_MUTEX, name); return;
+        case SIM_RTOS_SEMAPHORE_CREATE:     rtosTraceObject(object, RTOS_OBJ_SEMAPHORE, name); return;
+        case SIM_RTOS_TASK_IN:              type = RTOS_EV_TASK_IN; break;
+        case SIM_RTOS_TASK_OUT:             type = RTOS_EV_TASK_OUT; break;
+        case SIM_RTOS_QUEUE_SEND:           type = RTOS_EV_QUEUE_SEND; break;
+        case SIM_RTOS_QUEUE_SEND_FAILED:    type = RTOS_EV_QUEUE_SEND_FAIL; break;
+        case SIM_RTOS_QUEUE_RECEIVE:        type = RTOS_EV_QUEUE_RECV; break;
+        case SIM_RTOS_QUEUE_RECEIVE_FAILED: type = RTOS_EV_QUEUE_RECV_FAIL; break;
+        case SIM_RTOS_QUEUE_PEEK:           type = RTOS_EV_QUEUE_PEEK; break;
+        case SIM_RTOS_BLOCKING_ON_SEND:     type = RTOS_EV_QUEUE_BLOCK_SEND; break;
+        case SIM_RTOS_BLOCKING_ON_RECEIVE:  type = RTOS_EV_QUEUE_BLOCK_RECV; break;
+        default: return;
+    }
+    rtosTraceEvent(type, object, 0);
+}
+#endif
+
+// 🔧 Setup
+bool initRtosTrace() {
+#if RTOS_TRACE_ENABLED
+    ring = (RtosTraceEvent*)memPlace("rtosTrace", sizeof(RtosTraceEvent) * RTOS_TRACE_RING_EVENTS, MEM_BULK);
+    if (!ring) {
+        Serial.println("⚠️ RTOS trace: no PSRAM, recorder disabled");
+        return false;
+    }
+
+#if defined(SIM_NATIVE)
+    taskSource = RTOS_SRC_SIM;
+    simSetRtosTraceHook(onSimRtosEvent);
+#elif defined(RTOS_TRACE_KERNEL_HOOKS)
+    taskSource = RTOS_SRC_KERNEL;
+#else
+    taskSource = RTOS_SRC_TICK;
+    for (UBaseType_t core = 0; core < portNUM_PROCESSORS; core++) {
+        esp_register_freertos_tick_hook_for_cpu(sampleRunningTask, core);
+    }
+#endif
+    recording = true;
+
+    static const char* const sourceNames[] = { "tick-sampled switches", "kernel hooks", "simulated kernel" };
+    Serial.printf("🔬 RTOS trace: %u events in PSRAM (%u KB), %s\n", RTOS_TRACE_RING_EVENTS,
+                  (unsigned)(sizeof(RtosTraceEvent) * RTOS_TRACE_RING_EVENTS / 1024), sourceNames[taskSource]);
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t getRtosTraceEventCount() {
+    return ringHead.load(std::memory_order_relaxed);
+}
+
+// 📤 Dump
+void rtosTraceRequestDump() {
+    dumpRequested = true;
+}
+
+bool rtosTraceDumpPending() {
+    return dumpRequested || dumpActive;
+}
+
+static void writeLine(const char* line, size_t len) {
+    Serial.write((const uint8_t*)line, len);   // One write per line: never split by the log drain
+}
+
+static void startDump() {
+    char line[96];
+    size_t n;
+
+    recording = false;
+    vTaskDelay(pdMS_TO_TICKS(2));   // Producers that passed the check finish their slot
+
+    uint32_t head = ringHead.load(std::memory_order_acquire);
+    uint32_t count = head < RTOS_TRACE_RING_EVENTS ? head : RTOS_TRACE_RING_EVENTS;
+    dumpPos = head - count;
+    dumpEnd = head;
+    dumpActive = true;
+
+    // H version source cpu_mhz events_in_dump events_since_boot
+    n = snprintf(line, sizeof(line), RTOS_TRACE_DUMP_PREFIX "H %u %u %u %u %u\n", RTOS_TRACE_VERSION,
+                 taskSource, (unsigned)ESP.getCpuFreqMHz(), (unsigned)count, (unsigned)head);
+    writeLine(line, n);
+
+    // O id kind name
+    uint32_t objectsUsed = objectCount.load(std::memory_order_acquire);
+    if (objectsUsed > RTOS_TRACE_MAX_OBJECTS) objectsUsed = RTOS_TRACE_MAX_OBJECTS;
+    for (uint32_t i = 0; i < objectsUsed; i++) {
+        n = snprintf(line, sizeof(line), RTOS_TRACE_DUMP_PREFIX "O %08x %u %s\n", (unsigned)objects[i].id,
+                     objects[i].kind, objects[i].name[0] ? objects[i].name : "?");
+        writeLine(line, n);
+    }
+}
+
+static void finishDump() {
+    char line[48];
+    size_t n = snprintf(line, sizeof(line), RTOS_TRACE_DUMP_PREFIX "Z %u\n", (unsigned)dumpEnd);
+    writeLine(line, n);
+    dumpActive = false;
+
+    for (uint8_t core = 0; core < RTOS_TRACE_CORES; core++) {
+        synced[core] = false;       // Fresh anchor after the gap
+#if !defined(SIM_NATIVE) && !defined(RTOS_TRACE_KERNEL_HOOKS)
+        sampledTask[core] = nullptr;
+#endif
+    }
+    recording = true;
+}
+
+void serviceRtosTraceDump() {
+    if (!ring) return;
+    if (dumpRequested && !dumpActive) {
+        dumpRequested = false;
+        startDump();
+        return;
+    }
+    if (!dumpActive) return;
+
+    // E <hex of up to RTOS_TRACE_EVENTS_PER_LINE raw events>
+    static const char hexDigits[] = "0123456789abcdef";
+    char line[8 + RTOS_TRACE_EVENTS_PER_LINE * sizeof(RtosTraceEvent) * 2];
+    for (int l = 0; l < RTOS_TRACE_DUMP_LINES && dumpPos != dumpEnd; l++) {
+        size_t n = snprintf(line, sizeof(line), RTOS_TRACE_DUMP_PREFIX "E ");
+        for (int k = 0; k < RTOS_TRACE_EVENTS_PER_LINE && dumpPos != dumpEnd; k++, dumpPos++) {
+            const uint8_t* bytes = (const uint8_t*)&ring[dumpPos & RTOS_TRACE_MASK];
+            for (size_t b = 0; b < sizeof(RtosTraceEvent); b++) {
+                line[n++] = hexDigits[bytes[b] >> 4];
+                line[n++] = hexDigits[bytes[b] & 0x0F];
+            }
+        }
+        line[n++] = '\n';
+        writeLine(line, n);
+    }
+    if (dumpPos == dumpEnd) {
+        finishDump();
+    }
+}
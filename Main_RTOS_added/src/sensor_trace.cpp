@@ -0,0 +1,275 @@
+#include "sensor_trace.h"
+#include "esp_partition.h"
+#include "mem_placement.h"
+
+// 📼 Sensor Trace Recorder
+// Encodes every raw TaskSensorPoll sample into a page buffer. Full pages go to
+// the "trace" flash partition or out over Serial as "#T:" hex lines, which the
+// host tools in tools/sensor_trace pull back out of a monitor log.
+
+#define TRACE_PARTITION_LABEL    "trace"
+#define TRACE_PARTITION_SUBTYPE  0x40     // Custom data subtype, see partitions_trace.csv
+#define TRACE_SECTOR_SIZE        4096     // Flash erase unit
+
+static TraceEncoder encoder = {};
+static uint8_t page[TRACE_PAGE_SIZE];
+static size_t pageFill = 0;
+static bool traceOpen = false;
+
+static const esp_partition_t* tracePartition = nullptr;
+static uint32_t flashOffset = 0;          // Next page to program
+
+// ✍️ Encoding
+static size_t putU16(uint8_t* out, uint16_t v) {
+    out[0] = (uint8_t)v;
+    out[1] = (uint8_t)(v >> 8);
+    return 2;
+}
+
+static size_t putU32(uint8_t* out, uint32_t v) {
+    putU16(out, (uint16_t)v);
+    putU16(out + 2, (uint16_t)(v >> 16));
+    return 4;
+}
+
+size_t traceEncodeSession(TraceEncoder* enc, uint32_t startMs, uint8_t* out) {
+    size_t n = 0;
+    out[n++] = TRACE_REC_SESSION;
+    out[n++] = 'S';
+    out[n++] = 'G';
+    out[n++] = 'T';
+    out[n++] = TRACE_VERSION;
+    n += putU16(out + n, SENSOR_POLL_INTERVAL_MS);
+    n += putU32(out + n, startMs);
+    enc->lastTsMs = startMs;
+    enc->lastTemperatureC = INT32_MIN;   // Force climate and echo into the first sample
+    enc->lastHumidityPct = INT32_MIN;
+    enc->lastEchoUs = 0xFFFF;
+    return n;
+}
+
+size_t traceEncodeSample(TraceEncoder* enc, const SensorSample* s, uint8_t* out) {
+    size_t n = 0;
+    uint32_t dt = s->tsMs - enc->lastTsMs;
+    if (dt > 0xFFFF) {
+        // Long gap (task stalled, clock jump): restate the absolute time
+        out[n++] = TRACE_REC_TIME;
+        n += putU32(out + n, s->tsMs);
+        dt = 0;
+    }
+
+    int temp = constrain(s->temperatureC, -128, 127);
+    int hum = constrain(s->humidityPct, 0, 255);
+    uint8_t flags = 0;
+    if (s->flame) flags |= TRACE_F_FLAME;
+    if (s->pirMotion) flags |= TRACE_F_PIR;
+    if (temp != enc->lastTemperatureC || hum != enc->lastHumidityPct) flags |= TRACE_F_CLIMATE;
+    if (s->echoUs != enc->lastEchoUs) flags |= TRACE_F_ECHO;
+    int32_t jitter = (int32_t)dt - SENSOR_POLL_INTERVAL_MS;
+    if (jitter < -128 || jitter > 127) flags |= TRACE_F_WIDE_DT;
+
+    out[n++] = flags;
+    if (flags & TRACE_F_WIDE_DT) {
+        n += putU16(out + n, (uint16_t)dt);
+    } else {
+        out[n++] = (uint8_t)(int8_t)jitter;
+    }
+    if (flags & TRACE_F_CLIMATE) {
+        out[n++] = (uint8_t)(int8_t)temp;
+        out[n++] = (uint8_t)hum;
+    }
+    if (flags & TRACE_F_ECHO) {
+        n += putU16(out + n, s->echoUs);
+    }
+
+    enc->lastTsMs = s->tsMs;
+    enc->lastTemperatureC = temp;
+    enc->lastHumidityPct = hum;
+    enc->lastEchoUs = s->echoUs;
+    return n;
+}
+
+// 📖 Decoding
+static uint16_t getU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t getU32(const uint8_t* p) {
+    return getU16(p) | ((uint32_t)getU16(p + 2) << 16);
+}
+
+void traceReaderInit(TraceReader* r, const uint8_t* data, size_t len) {
+    memset(r, 0, sizeof(*r));
+    r->data = data;
+    r->len = len;
+}
+
+TraceRecordKind traceReaderNext(TraceReader* r, SensorSample* out) {
+    while (r->pos < r->len) {
+        const uint8_t* p = r->data + r->pos;
+        size_t left = r->len - r->pos;
+        uint8_t tag = p[0];
+
+        if (tag == TRACE_REC_END) {
+            return TRACE_KIND_END;
+        }
+        if (tag == TRACE_REC_PAD) {
+            r->pos++;
+            continue;
+        }
+        if (tag == TRACE_REC_SESSION) {
+            if (left < 11 || p[1] != 'S' || p[2] != 'G' || p[3] != 'T' || p[4] != TRACE_VERSION) {
+                return TRACE_KIND_ERROR;
+            }
+            r->samplePeriodMs = getU16(p + 5);
+            r->tsMs = getU32(p + 7);
+            memset(&r->last, 0, sizeof(r->last));
+            r->pos += 11;
+            return TRACE_KIND_SESSION;
+        }
+        if (tag == TRACE_REC_TIME) {
+            if (left < 5) return TRACE_KIND_ERROR;
+            r->tsMs = getU32(p + 1);
+            r->pos += 5;
+            continue;
+        }
+        if (tag & 0xE0) {
+            return TRACE_KIND_ERROR;   // Reserved bits set: not a sample
+        }
+
+        size_t need = 1 + ((tag & TRACE_F_WIDE_DT) ? 2 : 1) + ((tag & TRACE_F_CLIMATE) ? 2 : 0) +
+                      ((tag & TRACE_F_ECHO) ? 2 : 0);
+        if (left < need) return TRACE_KIND_ERROR;
+
+        size_t n = 1;
+        if (tag & TRACE_F_WIDE_DT) {
+            r->tsMs += getU16(p + n);
+            n += 2;
+        } else {
+            r->tsMs += r->samplePeriodMs + (int8_t)p[n++];
+        }
+        if (tag & TRACE_F_CLIMATE) {
+            r->last.temperatureC = (int8_t)p[n];
+            r->last.humidityPct = p[n + 1];
+            n += 2;
+        }
+        if (tag & TRACE_F_ECHO) {
+            r->last.echoUs = getU16(p + n);
+            n += 2;
+        }
+        r->last.tsMs = r->tsMs;
+        r->last.flame = tag & TRACE_F_FLAME;
+        r->last.pirMotion = tag & TRACE_F_PIR;
+        r->pos += n;
+        *out = r->last;
+        return TRACE_KIND_SAMPLE;
+    }
+    return TRACE_KIND_END;
+}
+
+// 💾 Flash Sink
+// Pages are programmed in order, so the first erased page (0xFF where a record
+// tag would be) is the append point; a binary search finds it at boot
+static bool openFlashSink() {
+    tracePartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                              (esp_partition_subtype_t)TRACE_PARTITION_SUBTYPE,
+                                              TRACE_PARTITION_LABEL);
+    if (!tracePartition) {
+        Serial.println("⚠️ Trace: no \"trace\" partition - flash the partitions_trace.csv table");
+        return false;
+    }
+
+    uint32_t lo = 0, hi = tracePartition->size / TRACE_PAGE_SIZE;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        uint8_t tag = TRACE_REC_END;
+        esp_partition_read(tracePartition, mid * TRACE_PAGE_SIZE, &tag, 1);
+        if (tag == TRACE_REC_END) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    flashOffset = lo * TRACE_PAGE_SIZE;
+    Serial.printf("📼 Trace: recording to flash at %u/%u KB\n",
+                  (unsigned)(flashOffset / 1024), (unsigned)(tracePartition->size / 1024));
+    return true;
+}
+
+static void writeFlashPage() {
+    if (flashOffset + TRACE_PAGE_SIZE > tracePartition->size) {
+        Serial.println("⚠️ Trace: partition full - recording stopped");
+        traceOpen = false;
+        return;
+    }
+    if (flashOffset % TRACE_SECTOR_SIZE == 0) {
+        esp_partition_erase_range(tracePartition, flashOffset, TRACE_SECTOR_SIZE);
+    }
+    esp_partition_write(tracePartition, flashOffset, page, TRACE_PAGE_SIZE);
+    flashOffset += TRACE_PAGE_SIZE;
+}
+
+// 📡 Serial Sink
+static void writeSerialLine() {
+    static const char hex[] = "0123456789ABCDEF";
+    char line[sizeof(TRACE_SERIAL_PREFIX) + 2 * TRACE_PAGE_SIZE];
+    size_t n = sizeof(TRACE_SERIAL_PREFIX) - 1;
+    memcpy(line, TRACE_SERIAL_PREFIX, n);
+    for (size_t i = 0; i < pageFill; i++) {
+        line[n++] = hex[page[i] >> 4];
+        line[n++] = hex[page[i] & 0x0F];
+    }
+    line[n] = 0;
+    Serial.println(line);
+}
+
+// 📤 Page Buffer
+static size_t pageLimit() {
+    return SENSOR_TRACE_SINK == TRACE_SINK_SERIAL ? TRACE_SERIAL_LINE_BYTES : TRACE_PAGE_SIZE;
+}
+
+static void flushPage() {
+    if (pageFill == 0) return;
+    if (SENSOR_TRACE_SINK == TRACE_SINK_FLASH) {
+        memset(page + pageFill, TRACE_REC_PAD, TRACE_PAGE_SIZE - pageFill);
+        writeFlashPage();
+    } else {
+        writeSerialLine();
+    }
+    pageFill = 0;
+}
+
+static void appendRecord(const uint8_t* rec, size_t len) {
+    if (pageFill + len > pageLimit()) {
+        flushPage();
+    }
+    memcpy(page + pageFill, rec, len);
+    pageFill += len;
+}
+
+// 🔧 Recorder
+bool initSensorTrace() {
+    if (SENSOR_TRACE_SINK == TRACE_SINK_NONE) {
+        return false;
+    }
+    if (SENSOR_TRACE_SINK == TRACE_SINK_FLASH && !openFlashSink()) {
+        return false;
+    }
+    if (SENSOR_TRACE_SINK == TRACE_SINK_FLASH) {
+        MEM_DECLARE("tracePage", page, MEM_HOT);   // Flash write source: cache is off meanwhile
+    }
+    if (SENSOR_TRACE_SINK == TRACE_SINK_SERIAL) {
+        Serial.println("📼 Trace: streaming samples as " TRACE_SERIAL_PREFIX " lines");
+    }
+
+    uint8_t rec[TRACE_MAX_RECORD];
+    traceOpen = true;
+    appendRecord(rec, traceEncodeSession(&encoder, millis(), rec));
+    return true;
+}
+
+void recordSensorSample(const SensorSample* s) {
+    if (!traceOpen) return;
+    uint8_t rec[TRACE_MAX_RECORD];
+    appendRecord(rec, traceEncodeSample(&encoder, s, rec));
+}
@@ -1,12 +1,42 @@
 #include "sensors.h"
-#include "blynk_instance.h"
+#include "sensor_trace.h"
+#include "deferred_log.h"
 #include "system.h"  // For Event struct and EventType
+#include "flame_flicker.h"
+#include "intrusion_fusion.h"
+#include "distance_filter.h"
+#include "ultrasonic_array.h"
 
 // 🔍 PIR Motion Detection State Tracking
 // Moved from ISR to task-based debouncing for better stability
 static bool lastPirState = false;        // Previous PIR sensor state
 static int pirStabilityCounter = 0;      // State stability counter for debouncing
 
+// 🔥 Fire Detection Stability Tracking
+static bool fireStable = false;          // Stable fire state
+static int fireChangeCounter = 0;        // Fire state change counter
+
+// Alert raised and not yet cleared, by the debouncer or the fire fast path
+static volatile bool fireAlertRaised = false;
+static portMUX_TYPE fireAlertMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Consecutive samples needed to accept a state change
+static int fireDebounceSamples = FIRE_DEBOUNCE_SAMPLES;
+static int pirDebounceSamples = PIR_DEBOUNCE_SAMPLES;
+
+// 📥 Sample Source
+// Every debounce decision works on lastSample, so a recorded trace fed
+// through setSensorSource() exercises exactly the logic the pins do
+static void readLiveSensors(SensorSample* out);
+static SensorSource sensorSource = readLiveSensors;
+static SensorSample lastSample = {};
+
+// 📏 Filtered ultrasonic stream (median + alpha-beta), one update per sample.
+// Live with the ultrasonic array, the array filters every ping of the door
+// sensor and this filter only runs on replayed samples
+static DistanceFilter distanceFilter;
+static DistanceEstimate distanceEstimate = {DISTANCE_NONE, 0, false};
+
 // 🔧 Sensor System Initialization
 // Sets up all monitoring sensors and configures pin modes
 void initSensors() {
@@ -20,6 +50,65 @@ void initSensors() {
     
     // 🔍 PIR Initial State Setup
     lastPirState = digitalRead(PIR_PIN);  // Capture initial motion sensor state
+    distanceFilterReset(&distanceFilter);
+}
+
+void setSensorSource(SensorSource source) {
+    sensorSource = source ? source : readLiveSensors;
+}
+
+// Also restarts both debouncers from the idle (no fire, no motion) state and
+// the distance filter from "nothing in range"
+void setDebounceSamples(int fireSamples, int pirSamples) {
+    fireDebounceSamples = fireSamples;
+    pirDebounceSamples = pirSamples;
+    fireStable = false;
+    fireChangeCounter = 0;
+    fireAlertRaised = false;
+    lastPirState = false;
+    pirStabilityCounter = 0;
+    distanceFilterReset(&distanceFilter);
+    distanceEstimate = {DISTANCE_NONE, 0, false};
+}
+
+// 📡 Live Source: DHT (library-cached), flame, PIR and the door sensor's
+// latest echo (array) or one blocking ping
+static void readLiveSensors(SensorSample* out) {
+    readTemperatureHumidity();
+    if (isUltrasonicArrayActive()) {
+        duration = getUltrasonicEcho(ULTRA_DOOR);
+    } else {
+        triggerUltrasonicSensor();
+    }
+    out->tsMs = millis();
+    out->temperatureC = t;
+    out->humidityPct = h;
+    out->flame = (digitalRead(FLAME_SENSOR_PIN) == 0);  // Flame sensor is active low
+#if FLAME_FLICKER
+    // A steady IR source trips the comparator too; a flame also flickers
+    out->flame = out->flame && getFlameConfidence() >= FLAME_FLICKER_CONFIDENCE;
+#endif
+    out->pirMotion = (digitalRead(PIR_PIN) == HIGH);
+    out->echoUs = (uint16_t)duration;
+}
+
+// 📥 Raw Sample Acquisition
+// Updates the shared readings and hands the sample to the trace recorder
+void sampleSensors() {
+    sensorSource(&lastSample);
+    t = lastSample.temperatureC;
+    h = lastSample.humidityPct;
+    duration = lastSample.echoUs;
+    if (sensorSource == readLiveSensors && isUltrasonicArrayActive()) {
+        distanceEstimate = getUltrasonicEstimate(ULTRA_DOOR);
+    } else {
+        distanceEstimate = distanceFilterUpdate(&distanceFilter, lastSample.echoUs, lastSample.tsMs);
+    }
+    recordSensorSample(&lastSample);
+}
+
+const SensorSample* getLastSample() {
+    return &lastSample;
 }
 
 // 🌡️ Temperature & Humidity Reading
@@ -40,45 +129,83 @@ int getHumidity() {
     return h;  // Return current humidity reading
 }
 
-// 🔥 Flame Detection Functions
-void readFlameSensor() {
-    // Sensor reading function - actual data transmission handled by TaskWiFiBlynk
-    // Current flame status available via isFlameDetected()
+// 🔥 Fire Alert
+// Whoever sees the fire first posts EVENT_FIRE_DETECTED; later callers don't
+bool raiseFireAlert(uint32_t tsMs) {
+    portENTER_CRITICAL(&fireAlertMux);
+    bool first = !fireAlertRaised;
+    fireAlertRaised = true;
+    portEXIT_CRITICAL(&fireAlertMux);
+    if (first) {
+        Event e{EVENT_FIRE_DETECTED, tsMs};
+        xQueueSend(eventQueue, &e, 0);
+    }
+    return first;
+}
+
+bool isFireAlertRaised() {
+    return fireAlertRaised;
+}
+
+// 🔥 Flame Detection with Debouncing
+// Requires FIRE_DEBOUNCE_SAMPLES consecutive samples to change state
+bool readFlameSensor() {
+    // A fast-path trip counts as detected: the debouncer only has to clear it
+    if (!fireStable && fireAlertRaised) {
+        fireStable = true;
+        fireChangeCounter = 0;
+    }
+
+    bool fireRaw = lastSample.flame;
+    if (fireRaw != fireStable) {
+        fireChangeCounter++;
+        if (fireChangeCounter >= fireDebounceSamples) {
+            fireStable = fireRaw;
+            if (fireStable) {
+                raiseFireAlert(lastSample.tsMs);
+            } else {
+                fireAlertRaised = false;
+                Event e{EVENT_FIRE_CLEARED, lastSample.tsMs};
+                xQueueSend(eventQueue, &e, 0);
+            }
+            fireChangeCounter = 0;
+        }
+    } else {
+        fireChangeCounter = 0;
+    }
+    return fireStable;
 }
 
 bool isFlameDetected() {
-    return (digitalRead(FLAME_SENSOR_PIN) == 0);  // Flame sensor is active low
+    return lastSample.flame;  // Raw flame output of the last sample
+}
+
+// 🚶 Motion Events
+// Hands the debounced PIR change, stamped with tsMs, to the intrusion fusion,
+// which raises and clears the thief alert. Shared by readMotion() and the PIR
+// edge capture (pir_capture)
+void postMotionChange(bool motion, uint32_t tsMs) {
+    extern bool isDay;  // Access day/night mode flag
+
+    if (motion && !isDay) {
+        // ☀️ Day Mode Motion Detection (Normal Operation)
+        logEvent(LOG_MOTION_DAY);
+    }
+    updateIntrusionPir(motion, tsMs);
 }
 
 // 🚶 Motion Detection with Intelligent Debouncing
-// Implements day/night aware motion detection with stability filtering
+// Polled variant: PIR_DEBOUNCE_SAMPLES stable samples (trace replay, or
+// builds without PIR_EDGE_CAPTURE)
 void readMotion() {
-    bool currentPirState = digitalRead(PIR_PIN);  // Read current PIR sensor state
+    bool currentPirState = lastSample.pirMotion;  // PIR state of the last sample
     
     // 🔍 PIR State Change Detection & Debouncing
     if (currentPirState != lastPirState) {
         pirStabilityCounter++;  // Increment stability counter
-        if (pirStabilityCounter >= 2) {  // Require 2 stable samples for state change
+        if (pirStabilityCounter >= pirDebounceSamples) {  // Require stable samples for state change
             // State has stabilized, process motion event
-            extern QueueHandle_t eventQueue;
-            extern bool isDay;  // Access day/night mode flag
-            
-            if (eventQueue) {
-                // 🌙 Night Mode Motion Detection (Thief Alert)
-                if (currentPirState && isDay) {
-                    Event e{EVENT_MOTION_DETECTED, (uint32_t)millis()};
-                    xQueueSend(eventQueue, &e, 0);  // Non-blocking event queue
-                    Serial.println("🚨 Motion detected at NIGHT - Thief alert triggered");
-                } else if (currentPirState && isDay) {
-                    // ☀️ Day Mode Motion Detection (Normal Operation)
-                    Serial.println("👥 Motion detected during DAY - No thief alert (normal operation)");
-                } else if (!currentPirState) {
-                    // ✅ Motion Cleared (Any Mode)
-                    Event e{EVENT_MOTION_CLEARED, (uint32_t)millis()};
-                    xQueueSend(eventQueue, &e, 0);  // Non-blocking event queue
-                    Serial.println("✅ Motion cleared");
-                }
-            }
+            postMotionChange(currentPirState, lastSample.tsMs);
             lastPirState = currentPirState;     // Update stable state
             pirStabilityCounter = 0;            // Reset stability counter
         }
@@ -89,7 +216,7 @@ void readMotion() {
 
 // 📊 Motion Status Access
 bool isMotionDetected() {
-    return (digitalRead(PIR_PIN) == HIGH);  // Return current motion detection status
+    return lastSample.pirMotion;  // Raw PIR output of the last sample
 }
 
 // 📏 Ultrasonic Distance Measurement
@@ -112,11 +239,11 @@ void triggerUltrasonicSensor() {
 }
 
 // 📏 Distance Data Access
+// Filtered: a single spurious or lost echo does not move it
 int getDistance() {
-    // Calculate distance from duration (speed of sound calculation)
-    if (duration == 0) {
-        return 999;  // Out of range
-    } else {
-        return duration * 0.034 / 2;  // Convert to cm
-    }
+    return distanceEstimate.distanceCm;
+}
+
+const DistanceEstimate* getDistanceEstimate() {
+    return &distanceEstimate;
 }
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "servo_motion.h"
+#include <ESP32Servo.h>
+#include "esp_timer.h"
+
+// 🚪 Door Servo Motion
+// Profile state is in millidegrees and millidegrees/s. The step timer is a
+// one-shot that the callback re-arms while the door moves, so it stops by
+// itself at the goal and a new goal only has to start it when it is idle.
+// Goal and profile share a spinlock; the duty write happens outside it.
+
+#define MDEG(deg) ((int32_t)(deg) * 1000)
+
+static const int32_t accelStep = SERVO_ACCEL_DPS2 * SERVO_STEP_MS;          // mdeg/s gained per step
+static const int64_t accel2 = 2LL * SERVO_ACCEL_DPS2 * 1000;               // 2a in mdeg/s^2
+
+static ESP32PWM servoPwm;
+static esp_timer_handle_t stepTimer = nullptr;
+static portMUX_TYPE motionMux = portMUX_INITIALIZER_UNLOCKED;
+
+static ServoGoal goal = SERVO_GOAL_CLOSE;
+static int32_t targetMdeg = MDEG(SERVO_CLOSED_DEG);
+static int32_t posMdeg = MDEG(SERVO_CLOSED_DEG);
+static int32_t velMdps = 0;
+static bool running = false;
+static uint32_t lastDuty = UINT32_MAX;
+
+// Pulse width for an angle, as LEDC duty at SERVO_PWM_FREQ_HZ / SERVO_PWM_BITS
+static void writeAngle(int32_t mdeg) {
+    int64_t ns = (int64_t)SERVO_MIN_US * 1000 + (int64_t)mdeg * (SERVO_MAX_US - SERVO_MIN_US) / 180;
+    uint32_t duty = (uint32_t)((ns * SERVO_PWM_FREQ_HZ * (1LL << SERVO_PWM_BITS) + 500000000LL) / 1000000000LL);
+    if (duty == lastDuty) return;
+    servoPwm.write(duty);
+    lastDuty = duty;
+}
+
+// Braking distance from the current speed, plus half a step of margin
+static int32_t stoppingMdeg(int32_t vel) {
+    int32_t speed = abs(vel);
+    return (int32_t)((int64_t)speed * speed / accel2) + speed * SERVO_STEP_MS / 2000;
+}
+
+// ⏲️ One profile step (esp_timer task)
+static void stepServo(void* arg) {
+    (void)arg;
+    portENTER_CRITICAL(&motionMux);
+    int32_t remaining = targetMdeg - posMdeg;
+    int32_t dir = remaining > 0 ? 1 : (remaining < 0 ? -1 : 0);
+
+    // Brake when moving away from the goal or once it is within braking distance
+    if (dir == 0 || (int64_t)velMdps * dir < 0 || stoppingMdeg(velMdps) >= abs(remaining)) {
+        if (velMdps > 0) {
+            velMdps = velMdps > accelStep ? velMdps - accelStep : 0;
+        } else {
+            velMdps = -velMdps > accelStep ? velMdps + accelStep : 0;
+        }
+    } else {
+        velMdps += dir * accelStep;
+        if (abs(velMdps) > MDEG(SERVO_MAX_SPEED_DPS)) velMdps = dir * MDEG(SERVO_MAX_SPEED_DPS);
+    }
+
+    // Land on the goal instead of stepping over it
+    int32_t move = velMdps * SERVO_STEP_MS / 1000;
+    if (dir != 0 && move * dir > 0 && abs(move) >= abs(remaining)) {
+        posMdeg = targetMdeg;
+        velMdps = 0;
+    } else {
+        posMdeg += move;
+    }
+
+    bool done = posMdeg == targetMdeg && velMdps == 0;
+    if (done) running = false;
+    int32_t pos = posMdeg;
+    portEXIT_CRITICAL(&motionMux);
+
+    writeAngle(pos);
+    if (!done) {
+        esp_timer_start_once(stepTimer, SERVO_STEP_MS * 1000ULL);
+    }
+}
+
+// 🔧 Setup
+bool initServoMotion() {
+    ESP32PWM::allocateTimer(SERVO_LEDC_TIMER);  // ESP32PWM may only use this timer (config.h)
+    servoPwm.attachPin(SERVO_PIN, SERVO_PWM_FREQ_HZ, SERVO_PWM_BITS);
+    writeAngle(posMdeg);
+
+    esp_timer_create_args_t args = {};
+    args.callback = stepServo;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "servo";
+    return esp_timer_create(&args, &stepTimer) == ESP_OK;
+}
+
+// 🎯 Goals
+void setServoGoal(ServoGoal next) {
+    if (!stepTimer) return;
+
+    bool start = false;
+    portENTER_CRITICAL(&motionMux);
+    if (next != goal) {
+        goal = next;
+        switch (next) {
+            case SERVO_GOAL_OPEN:
+                targetMdeg = MDEG(SERVO_OPEN_DEG);
+                break;
+            case SERVO_GOAL_CLOSE:
+                targetMdeg = MDEG(SERVO_CLOSED_DEG);
+                break;
+            case SERVO_GOAL_HOLD: {
+                int32_t stop = posMdeg + (velMdps >= 0 ? 1 : -1) * stoppingMdeg(velMdps);
+                int32_t lo = MDEG(min(SERVO_CLOSED_DEG, SERVO_OPEN_DEG));
+                int32_t hi = MDEG(max(SERVO_CLOSED_DEG, SERVO_OPEN_DEG));
+                targetMdeg = stop < lo ? lo : (stop > hi ? hi : stop);
+                break;
+            }
+        }
+        start = !running && targetMdeg != posMdeg;
+        if (start) running = true;
+    }
+    portEXIT_CRITICAL(&motionMux);
+
+    if (start) {
+        esp_timer_start_once(stepTimer, 0);
+    }
+}
+
+ServoGoal getServoGoal() {
+    return goal;
+}
+
+bool isServoMoving() {
+    return running;
+}
+
+int getServoAngle() {
+    return posMdeg / 1000;
+}
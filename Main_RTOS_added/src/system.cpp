@@ -1,13 +1,54 @@
 #include "system.h"
+#include "net_events.h"
+#include "deferred_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <Preferences.h>
+#include "esp_system.h"
+#include <time.h>
+#ifndef SIM_NATIVE
+#include "esp_netif.h"
+#include "esp_netif_net_stack.h"
+#include "lwip/dhcp.h"
+#endif
 
-// 🌐 WiFi Reconnection Management Variables
-unsigned long lastWiFiReconnectAttempt = 0;        // Timestamp of last reconnection attempt
-const unsigned long wifiReconnectInterval = 30000;  // Reconnection interval (30 seconds)
-bool wifiReconnecting = false;                     // Current reconnection status flag
+// 🌐 WiFi Connection Manager Variables
+// Connection state is driven by WiFi.onEvent(); handleWiFiReconnection() only
+// acts on what the events reported and on backoff / attempt deadlines.
+unsigned long lastWiFiReconnectAttempt = 0;        // Timestamp of last connection attempt
+bool wifiReconnecting = false;                     // True while an attempt is in flight
 bool wifiReconnectionEnabled = true;               // Enable/disable background reconnection
 
+static WiFiConnState wifiState = WIFI_STATE_IDLE;  // Connection state machine
+static unsigned long wifiNextAttemptAt = 0;        // Backoff deadline (millis)
+static uint8_t wifiBackoffStep = 0;                // Consecutive failed attempts
+static bool wifiAttemptFast = false;               // Current attempt uses cached BSSID/channel
+static bool wifiLeaseReused = false;               // Current attempt skips DHCP with the cached lease
+static bool wifiLeaseUnverified = false;           // Lease reused, cloud not reached on it yet
+static bool wifiDhcpRestarted = false;             // Reused lease handed back, waiting for DHCP's GOT_IP
+static unsigned long wifiConnectedAt = 0;          // millis() of the last completed attempt
+static WiFiStats wifiStats = {};                   // Time-to-connect statistics
+
+// 📦 Cached connection parameters (NVS) for fast reconnect
+struct WiFiCache {
+    bool valid;
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t ip, gateway, subnet, dns;
+    uint32_t leaseUntil;     // time() at which the lease is due for renewal (T1)
+};
+static WiFiCache wifiCache = {};
+static Preferences wifiPrefs;
+
+// 📡 Flags posted by the WiFi event handler (runs in the Arduino event task)
+enum : uint32_t {
+    WIFI_FLAG_GOT_IP       = (1u << 0),
+    WIFI_FLAG_DISCONNECTED = (1u << 1)
+};
+static volatile uint32_t wifiEventFlags = 0;
+static volatile uint8_t wifiLastDisconnectReason = 0;
+static portMUX_TYPE wifiEventMux = portMUX_INITIALIZER_UNLOCKED;
+
 // External variables
 extern char ssid[];
 extern char pass[];
@@ -26,48 +67,234 @@ void initSerial() {
     Serial.begin(SERIAL_BAUD_RATE);  // Configure serial communication rate
 }
 
+// 💾 NVS Cache Helpers
+static void loadWiFiCache() {
+    wifiPrefs.begin("wifi", true);
+    wifiCache.valid = wifiPrefs.getBytes("bssid", wifiCache.bssid, sizeof(wifiCache.bssid)) == sizeof(wifiCache.bssid);
+    wifiCache.channel = wifiPrefs.getUChar("chan", 0);
+    wifiCache.ip = wifiPrefs.getUInt("ip", 0);
+    wifiCache.gateway = wifiPrefs.getUInt("gw", 0);
+    wifiCache.subnet = wifiPrefs.getUInt("mask", 0);
+    wifiCache.dns = wifiPrefs.getUInt("dns", 0);
+    wifiCache.leaseUntil = wifiPrefs.getUInt("until", 0);
+    wifiPrefs.end();
+    if (wifiCache.channel == 0) {
+        wifiCache.valid = false;
+    }
+
+    // time() only survives resets that keep the RTC running; after a power
+    // cycle it restarts at 0 and any stored expiry would look valid
+    switch (esp_reset_reason()) {
+        case ESP_RST_SW:
+        case ESP_RST_PANIC:
+        case ESP_RST_INT_WDT:
+        case ESP_RST_TASK_WDT:
+        case ESP_RST_WDT:
+        case ESP_RST_DEEPSLEEP:
+            break;
+        default:
+            wifiCache.ip = 0;
+            break;
+    }
+}
+
+// Renewal time (T1) of the lease the DHCP client holds, in seconds
+static uint32_t dhcpRenewSeconds() {
+#ifndef SIM_NATIVE
+    esp_netif_t* netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    struct netif* lwip = netif ? (struct netif*)esp_netif_get_netif_impl(netif) : nullptr;
+    struct dhcp* dhcp = lwip ? netif_dhcp_data(lwip) : nullptr;
+    if (dhcp && dhcp->offered_t1_renew > 0) {
+        return dhcp->offered_t1_renew;
+    }
+#endif
+    return WIFI_LEASE_DEFAULT_S / 2;
+}
+
+// The cached address may be applied statically until the lease's T1: the
+// server still holds it for us, and nobody else can have been given it
+static bool wifiLeaseValid() {
+    return wifiCache.ip != 0 && (int32_t)(wifiCache.leaseUntil - (uint32_t)time(nullptr)) > 0;
+}
+
+static void saveWiFiCache() {
+    WiFiCache fresh = {};
+    fresh.valid = true;
+    memcpy(fresh.bssid, WiFi.BSSID(), sizeof(fresh.bssid));
+    fresh.channel = WiFi.channel();
+    fresh.ip = (uint32_t)WiFi.localIP();
+    fresh.gateway = (uint32_t)WiFi.gatewayIP();
+    fresh.subnet = (uint32_t)WiFi.subnetMask();
+    fresh.dns = (uint32_t)WiFi.dnsIP();
+    uint32_t renewS = dhcpRenewSeconds();
+    fresh.leaseUntil = (uint32_t)time(nullptr) + renewS;
+
+    // Only touch flash when something changed. A stored T1 that lags the real
+    // one only shortens reuse, so it is rewritten when it would be too late or
+    // has fallen more than half a renewal period behind
+    int32_t leaseGain = (int32_t)(fresh.leaseUntil - wifiCache.leaseUntil);
+    if (wifiCache.valid &&
+        memcmp(fresh.bssid, wifiCache.bssid, sizeof(fresh.bssid)) == 0 &&
+        fresh.channel == wifiCache.channel && fresh.ip == wifiCache.ip &&
+        fresh.gateway == wifiCache.gateway && fresh.subnet == wifiCache.subnet &&
+        fresh.dns == wifiCache.dns && leaseGain >= 0 && (uint32_t)leaseGain <= renewS / 2) {
+        return;
+    }
+    wifiCache = fresh;
+    wifiPrefs.begin("wifi", false);
+    wifiPrefs.putBytes("bssid", wifiCache.bssid, sizeof(wifiCache.bssid));
+    wifiPrefs.putUChar("chan", wifiCache.channel);
+    wifiPrefs.putUInt("ip", wifiCache.ip);
+    wifiPrefs.putUInt("gw", wifiCache.gateway);
+    wifiPrefs.putUInt("mask", wifiCache.subnet);
+    wifiPrefs.putUInt("dns", wifiCache.dns);
+    wifiPrefs.putUInt("until", wifiCache.leaseUntil);
+    wifiPrefs.end();
+}
+
+// Forget the cached address (RAM and NVS) so the next attempt uses DHCP
+static void dropWiFiLease() {
+    wifiCache.ip = 0;
+    wifiPrefs.begin("wifi", false);
+    wifiPrefs.putUInt("ip", 0);
+    wifiPrefs.end();
+}
+
+// 📡 WiFi Driver Event Handler
+// Keep this short: record what happened and wake the network task
+static void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    uint32_t flag = 0;
+    switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            flag = WIFI_FLAG_GOT_IP;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            wifiLastDisconnectReason = info.wifi_sta_disconnected.reason;
+            flag = WIFI_FLAG_DISCONNECTED;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+            flag = WIFI_FLAG_DISCONNECTED;
+            break;
+        default:
+            return;
+    }
+    portENTER_CRITICAL(&wifiEventMux);
+    wifiEventFlags |= flag;
+    portEXIT_CRITICAL(&wifiEventMux);
+    notifyNetTask(NET_EVT_WIFI);
+}
+
+// ⏳ Exponential Backoff With Jitter
+// Half of the window is fixed, the other half random, so a room full of
+// devices does not retry in lockstep after the access point reboots
+static unsigned long nextBackoffDelay() {
+    unsigned long window = WIFI_BACKOFF_MIN_MS;
+    for (uint8_t i = 0; i < wifiBackoffStep && window < WIFI_BACKOFF_MAX_MS; i++) {
+        window *= 2;
+    }
+    if (window > WIFI_BACKOFF_MAX_MS) {
+        window = WIFI_BACKOFF_MAX_MS;
+    }
+    if (wifiBackoffStep < 16) {
+        wifiBackoffStep++;
+    }
+    return window / 2 + esp_random() % (window / 2 + 1);
+}
+
+// 🚀 Start One Connection Attempt (non-blocking)
+static void startWiFiAttempt() {
+    wifiAttemptFast = WIFI_FAST_RECONNECT && wifiCache.valid;
+    lastWiFiReconnectAttempt = millis();
+    wifiReconnecting = true;
+    wifiState = WIFI_STATE_CONNECTING;
+    wifiStats.attempts++;
+
+    wifiLeaseReused = wifiAttemptFast && wifiLeaseValid();
+    if (wifiLeaseReused) {
+        // Reuse the last DHCP lease while it is unexpired - skips the DHCP exchange entirely
+        WiFi.config(IPAddress(wifiCache.ip), IPAddress(wifiCache.gateway),
+                    IPAddress(wifiCache.subnet), IPAddress(wifiCache.dns));
+    } else {
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);  // Back to DHCP
+    }
+
+    if (wifiAttemptFast) {
+        // Known BSSID + channel - no full channel scan
+        WiFi.begin(ssid, pass, wifiCache.channel, wifiCache.bssid);
+        logEvent(LOG_WIFI_FAST_CONNECT, wifiCache.channel);
+    } else {
+        WiFi.begin(ssid, pass);
+        logEvent(LOG_WIFI_SCAN_CONNECT);
+    }
+}
+
+// ⚠️ Attempt Failed - fall back to a full scan or back off
+static void failWiFiAttempt(bool timedOut) {
+    wifiStats.failures++;
+    wifiReconnecting = false;
+    if (timedOut) {
+        WiFi.disconnect();
+    }
+
+    unsigned long delayMs;
+    if (wifiAttemptFast) {
+        // Cached AP/lease went stale: next attempt scans and uses DHCP
+        wifiCache.valid = false;
+        delayMs = WIFI_BACKOFF_MIN_MS;
+    } else {
+        delayMs = nextBackoffDelay();
+    }
+    wifiNextAttemptAt = millis() + delayMs;
+    wifiState = WIFI_STATE_BACKOFF;
+    logEvent(timedOut ? LOG_WIFI_FAIL_TIMEOUT : LOG_WIFI_FAIL_DISCONNECT, delayMs);
+}
+
+// ✅ Connected - record time-to-connect and refresh the cache
+static void completeWiFiAttempt() {
+    uint32_t elapsed = millis() - lastWiFiReconnectAttempt;
+    wifiStats.connects++;
+    wifiStats.lastConnectMs = elapsed;
+    wifiStats.totalConnectMs += elapsed;
+    if (wifiStats.connects == 1 || elapsed < wifiStats.minConnectMs) wifiStats.minConnectMs = elapsed;
+    if (elapsed > wifiStats.maxConnectMs) wifiStats.maxConnectMs = elapsed;
+    wifiStats.lastWasFast = wifiAttemptFast;
+
+    wifiReconnecting = false;
+    wifiBackoffStep = 0;
+    wifiState = WIFI_STATE_CONNECTED;
+    wifiDhcpRestarted = false;
+    wifiConnectedAt = millis();
+    wifiLeaseUnverified = wifiLeaseReused;
+    if (!wifiLeaseReused) {
+        saveWiFiCache();  // Fresh DHCP lease: store it with its renewal time
+    }
+
+    logEvent(wifiAttemptFast ? LOG_WIFI_CONNECTED_FAST : LOG_WIFI_CONNECTED_SCAN, elapsed);
+    IPAddress ip = WiFi.localIP();
+    logEvent(LOG_WIFI_IP, ip[0], ip[1], ip[2], ip[3]);
+}
+
 // 🌐 WiFi Connection Initialization
-// Establishes WiFi connection with fast-fail timeout strategy
+// Starts the connection state machine and returns immediately - boot never waits on WiFi
 bool initWiFi() {
     // 🔐 WiFi Credential Validation
     if (strlen(ssid) == 0 || strlen(pass) == 0) {
         Serial.println("❌ Error: WiFi credentials not configured");
         Serial.println("🔑 Please check your WiFi SSID and password");
+        wifiState = WIFI_STATE_DISABLED;
         return false;
     }
     
-    Serial.print("🌐 Attempting to connect to: ");
+    Serial.print("🌐 Connecting in background to: ");
     Serial.println(ssid);
     
-    WiFi.mode(WIFI_STA);           // Set WiFi to station mode
-    WiFi.disconnect();              // Clear any previous connection attempts
-    vTaskDelay(pdMS_TO_TICKS(100)); // Brief stabilization delay
-    WiFi.begin(ssid, pass);         // Start connection process
-    
-    unsigned long wifiConnectStart = millis();  // Connection attempt start time
-    Serial.print("🔄 Connecting to WiFi");
-    
-    // ⏱️ Fast-Fail Connection Strategy (5 second timeout)
-    while (WiFi.status() != WL_CONNECTED && millis() - wifiConnectStart < 5000) {
-        vTaskDelay(pdMS_TO_TICKS(500));        // 500ms connection check interval
-        Serial.print(".");                      // Visual connection progress indicator
-    }
-    
-    // ✅ Connection Success Handling
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.println();
-        Serial.println("✅ WiFi connected successfully!");
-        Serial.print("🌐 IP address: ");
-        Serial.println(WiFi.localIP());
-        return true;
-    } else {
-        // ⚠️ Connection Failure Handling
-        Serial.println();
-        Serial.println("⚠️ WiFi connection failed - starting in offline mode");
-        Serial.println("🔄 Background reconnection will attempt every 30 seconds");
-        WiFi.disconnect();  // Ensure clean connection state
-        return false;
-    }
+    loadWiFiCache();
+    WiFi.persistent(false);         // Credentials live in config.h, cache in our own NVS namespace
+    WiFi.setAutoReconnect(false);   // The state machine owns reconnection
+    WiFi.mode(WIFI_STA);            // Set WiFi to station mode
+    WiFi.onEvent(onWiFiEvent);
+    startWiFiAttempt();
+    return true;
 }
 
 bool isWiFiConnected() {
@@ -88,19 +315,22 @@ void printWiFiStatus() {
     } else {
         Serial.println("WiFi not connected");
         if (wifiReconnectionEnabled) {
-            unsigned long timeSinceLastAttempt = millis() - lastWiFiReconnectAttempt;
-            if (timeSinceLastAttempt < wifiReconnectInterval) {
-                unsigned long timeToNext = (wifiReconnectInterval - timeSinceLastAttempt) / 1000;
+            if (wifiState == WIFI_STATE_CONNECTING) {
+                Serial.println("Connection attempt in progress");
+            } else {
                 Serial.print("Next reconnection attempt in: ");
-                Serial.print(timeToNext);
+                Serial.print(getWiFiReconnectDelay() / 1000);
                 Serial.println(" seconds");
-            } else {
-                Serial.println("Ready for reconnection attempt");
             }
         } else {
             Serial.println("Background reconnection is disabled");
         }
     }
+    Serial.printf("Connects: %lu/%lu attempts, time-to-connect last %lu ms, min %lu, max %lu, avg %lu\n",
+                  (unsigned long)wifiStats.connects, (unsigned long)wifiStats.attempts,
+                  (unsigned long)wifiStats.lastConnectMs, (unsigned long)wifiStats.minConnectMs,
+                  (unsigned long)wifiStats.maxConnectMs,
+                  (unsigned long)(wifiStats.connects ? wifiStats.totalConnectMs / wifiStats.connects : 0));
 }
 
 // ⏰ System Timing Functions
@@ -112,40 +342,109 @@ unsigned long getUptime() {
     return millis() - startTime;  // Calculate system uptime in milliseconds
 }
 
-// 🔄 Background WiFi Reconnection Handler
-// Manages automatic WiFi reconnection without blocking system operation
+// 🔄 WiFi Connection State Machine Tick
+// Called from the network task whenever it wakes; never blocks
 void handleWiFiReconnection() {
-    // 🔍 Reconnection Condition Check
-    if (wifiReconnectionEnabled && 
-        !isWiFiConnected() && 
-        (millis() - lastWiFiReconnectAttempt > wifiReconnectInterval) &&
-        !wifiReconnecting) {
-        
-        wifiReconnecting = true;                    // Set reconnection flag
-        lastWiFiReconnectAttempt = millis();        // Update attempt timestamp
-        
-        Serial.println("🔄 Background: Attempting WiFi reconnection...");
-        
-        // 🚀 Non-blocking Reconnection Process
-        WiFi.disconnect();                          // Clear current connection
-        vTaskDelay(pdMS_TO_TICKS(50));             // Minimal stabilization delay
-        WiFi.begin(ssid, pass);                     // Initiate new connection
-        
-        // ⚡ Immediate Reset for Non-blocking Operation
-        wifiReconnecting = false;                   // Allow main loop to continue
-        
-        Serial.println("🔄 Background: WiFi reconnection initiated (non-blocking)");
+    portENTER_CRITICAL(&wifiEventMux);
+    uint32_t flags = wifiEventFlags;
+    wifiEventFlags = 0;
+    portEXIT_CRITICAL(&wifiEventMux);
+
+    // 📡 Apply driver events
+    if (flags & WIFI_FLAG_DISCONNECTED) {
+        if (wifiState == WIFI_STATE_CONNECTED) {
+            wifiStats.disconnects++;
+            logEvent(LOG_WIFI_LOST, wifiLastDisconnectReason);
+            wifiState = WIFI_STATE_BACKOFF;
+            wifiNextAttemptAt = millis();  // First retry is immediate and uses the cache
+        } else if (wifiState == WIFI_STATE_CONNECTING && !(flags & WIFI_FLAG_GOT_IP)) {
+            failWiFiAttempt(false);
+        }
     }
-    
-    // ✅ Reconnection Success Verification
-    if (wifiReconnecting && isWiFiConnected()) {
-        Serial.println("✅ Background: WiFi reconnection successful!");
-        Serial.print("🌐 New IP address: ");
-        Serial.println(WiFi.localIP());
-        wifiReconnecting = false;                   // Clear reconnection flag
+    if ((flags & WIFI_FLAG_GOT_IP) && isWiFiConnected() && wifiState != WIFI_STATE_CONNECTED) {
+        completeWiFiAttempt();
+    } else if ((flags & WIFI_FLAG_GOT_IP) && wifiDhcpRestarted && wifiState == WIFI_STATE_CONNECTED) {
+        wifiDhcpRestarted = false;  // DHCP bound after a reused lease was handed back
+        saveWiFiCache();
+        IPAddress ip = WiFi.localIP();
+        logEvent(LOG_WIFI_IP, ip[0], ip[1], ip[2], ip[3]);
+    }
+
+    // ⏱️ Deadlines
+    switch (wifiState) {
+        case WIFI_STATE_CONNECTING:
+            if (millis() - lastWiFiReconnectAttempt > WIFI_TIMEOUT) {
+                failWiFiAttempt(true);
+            }
+            break;
+        case WIFI_STATE_BACKOFF:
+            if (wifiReconnectionEnabled && (long)(millis() - wifiNextAttemptAt) >= 0) {
+                startWiFiAttempt();
+            }
+            break;
+        default:
+            break;
     }
 }
 
+// 🔍 Check a Reused Lease Against the Cloud Connection
+// A statically applied address that the DHCP server has since handed to
+// another device (or that no longer routes) still "connects" to the AP;
+// only traffic shows it. If Blynk has not logged in WIFI_LEASE_VERIFY_MS
+// after such a connect, drop the lease and reconnect over DHCP.
+// Once Blynk has logged in, the static address is handed back to the DHCP
+// client at the next idle moment, and at T1 even if the caller is busy: the
+// server only reserves the address while the lease is being renewed.
+void checkWiFiLease(bool cloudConnected, bool idle) {
+    if (!wifiLeaseReused || wifiState != WIFI_STATE_CONNECTED) {
+        return;
+    }
+    if (wifiLeaseUnverified) {
+        if (cloudConnected) {
+            wifiLeaseUnverified = false;
+        } else if (millis() - wifiConnectedAt >= WIFI_LEASE_VERIFY_MS) {
+            wifiLeaseUnverified = false;
+            wifiLeaseReused = false;
+            dropWiFiLease();
+            logEvent(LOG_WIFI_LEASE_STALE, WIFI_LEASE_VERIFY_MS);
+            WiFi.disconnect();
+            wifiState = WIFI_STATE_BACKOFF;  // The disconnect event lands here and is ignored
+            wifiNextAttemptAt = millis() + WIFI_BACKOFF_MIN_MS;
+        }
+        return;
+    }
+    if (!idle && wifiLeaseValid()) {
+        return;
+    }
+    // Restarts the DHCP client on the live association; its GOT_IP refreshes
+    // the cache. The cloud session drops and logs in again on the new lease.
+    int32_t leftS = (int32_t)(wifiCache.leaseUntil - (uint32_t)time(nullptr));
+    wifiLeaseReused = false;
+    wifiDhcpRestarted = true;
+    logEvent(LOG_WIFI_LEASE_DHCP, leftS > 0 ? (unsigned)leftS : 0u);
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+}
+
+// ⏱️ Time Until the State Machine Needs Attention
+// Lets the network task sleep instead of polling handleWiFiReconnection()
+unsigned long getWiFiReconnectDelay() {
+    switch (wifiState) {
+        case WIFI_STATE_CONNECTING: {
+            unsigned long elapsed = millis() - lastWiFiReconnectAttempt;
+            return (elapsed > WIFI_TIMEOUT) ? 0 : WIFI_TIMEOUT - elapsed + 1;
+        }
+        case WIFI_STATE_BACKOFF:
+            if (wifiReconnectionEnabled) {
+                long left = (long)(wifiNextAttemptAt - millis());
+                return (left > 0) ? (unsigned long)left : 0;
+            }
+            break;
+        default:
+            break;
+    }
+    return WIFI_BACKOFF_MAX_MS;  // Nothing scheduled - WiFi events still wake the task
+}
+
 // 🎛️ WiFi Reconnection Control Functions
 void setWiFiReconnectionEnabled(bool enabled) {
     wifiReconnectionEnabled = enabled;  // Update reconnection setting
@@ -153,6 +452,7 @@ void setWiFiReconnectionEnabled(bool enabled) {
         Serial.println("🔄 Background WiFi reconnection disabled");
     } else {
         Serial.println("🔄 Background WiFi reconnection enabled");
+        notifyNetTask(NET_EVT_WIFI);
     }
 }
 
@@ -162,35 +462,44 @@ void triggerWiFiReconnection() {
         Serial.println("✅ WiFi already connected - no reconnection needed");
         return;
     }
+    if (wifiState != WIFI_STATE_BACKOFF) {
+        return;  // Idle/disabled, or an attempt is already running
+    }
     
     Serial.println("🔄 Manual WiFi reconnection triggered");
-    lastWiFiReconnectAttempt = 0;  // Force immediate reconnection attempt
-    wifiReconnecting = false;       // Reset reconnection state
+    wifiBackoffStep = 0;
+    wifiNextAttemptAt = millis();  // Force immediate reconnection attempt
+    notifyNetTask(NET_EVT_WIFI);
+}
+
+WiFiConnState getWiFiState() {
+    return wifiState;
+}
+
+const WiFiStats& getWiFiStats() {
+    return wifiStats;
 }
 
 // 📊 WiFi Status Information Generator
-// Returns human-readable WiFi connection status with signal quality indicators
-String getWiFiStatus() {
+// Writes human-readable WiFi connection status with signal quality indicators
+// (caller's buffer: the OLED page redraws it every pass without heap use)
+void getWiFiStatus(char* out, size_t size) {
     if (wifiReconnecting) {
-        return "WiFi: 🔄 Connecting...";
+        snprintf(out, size, "WiFi: 🔄 Connecting...");
     } else if (isWiFiConnected()) {
         // 📶 Signal Strength Analysis
         int rssi = WiFi.RSSI();
-        String signalQuality;
+        const char* signalQuality;
         if (rssi >= -50) signalQuality = "Excellent";
         else if (rssi >= -60) signalQuality = "Good";
         else if (rssi >= -70) signalQuality = "Fair";
         else signalQuality = "Poor";
         
-        return "WiFi: " + signalQuality + " (" + String(rssi) + "dBm)";
-    } else {
+        snprintf(out, size, "WiFi: %s (%ddBm)", signalQuality, rssi);
+    } else if (wifiState == WIFI_STATE_BACKOFF && wifiReconnectionEnabled) {
         // ⏱️ Reconnection Countdown Display
-        unsigned long timeSinceLastAttempt = millis() - lastWiFiReconnectAttempt;
-        if (timeSinceLastAttempt < wifiReconnectInterval) {
-            unsigned long timeToNext = (wifiReconnectInterval - timeSinceLastAttempt) / 1000;
-            return "WiFi: 🔄 Retry in " + String(timeToNext) + "s";
-        } else {
-            return "WiFi: ❌ Disconnected";
-        }
+        snprintf(out, size, "WiFi: 🔄 Retry in %lus", (unsigned long)(getWiFiReconnectDelay() / 1000));
+    } else {
+        snprintf(out, size, "WiFi: ❌ Disconnected");
     }
-}
\ No newline at end of file
+}
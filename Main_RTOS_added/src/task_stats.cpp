@@ -0,0 +1,264 @@
+#include "task_stats.h"
+
+#ifdef SIM_NATIVE
+#include "sim_hw.h"
+#else
+#include "esp_freertos_hooks.h"
+#endif
+
+// 📊 Runtime Task Statistics
+// The tick hook only increments counters; updateTaskStats() turns the deltas
+// of one window into per-mille shares. Loop periods are accumulated by each
+// task for itself under a short spinlock and reset when the window closes.
+
+struct TaskSlot {
+    TaskHandle_t handle;
+    const PeriodicTask* schedule;
+    uint16_t periodMs;
+    int8_t core;
+
+    // Tick hook (ISR), monotonic
+    volatile uint32_t ticks;
+    uint32_t ticksAtWindow;
+    uint64_t cpuUsAtWindow;      // Native build: host thread CPU time
+
+    // taskStatsLoop(), reset per window
+    uint32_t lastLoopUs;
+    uint32_t loops;
+    uint32_t periodSumUs;
+    uint32_t periodMaxUs;
+
+    uint16_t worstLateMs;
+    uint32_t stackFreeMin;
+};
+
+static TaskSlot slots[TASK_STATS_MAX_TASKS];
+static volatile uint8_t slotCount = 0;
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+#ifndef SIM_NATIVE
+static volatile uint32_t coreTicks[2];
+static volatile uint32_t idleTicks[2];
+static uint32_t coreTicksAtWindow[2];
+static uint32_t idleTicksAtWindow[2];
+static TaskHandle_t idleTask[2];
+#endif
+
+static uint32_t windowStartUs = 0;
+static TaskStatsSnapshot snapshot = {};
+
+// ⏱️ Tick hook: one counter per tick and core
+#ifndef SIM_NATIVE
+static void IRAM_ATTR countTick() {
+    BaseType_t core = xPortGetCoreID();
+    TaskHandle_t running = xTaskGetCurrentTaskHandleForCPU(core);
+    coreTicks[core]++;
+    if (running == idleTask[core]) {
+        idleTicks[core]++;
+        return;
+    }
+    for (uint8_t i = 0; i < slotCount; i++) {
+        if (slots[i].handle == running) {
+            slots[i].ticks++;
+            return;
+        }
+    }
+}
+#endif
+
+// 🔧 Setup
+bool initTaskStats() {
+    windowStartUs = micros();
+#ifndef SIM_NATIVE
+    for (UBaseType_t core = 0; core < portNUM_PROCESSORS; core++) {
+        idleTask[core] = xTaskGetIdleTaskHandleForCPU(core);
+        esp_register_freertos_tick_hook_for_cpu(countTick, core);
+    }
+#endif
+    return true;
+}
+
+bool registerTaskStats(TaskHandle_t task, const PeriodicTask* schedule) {
+    if (!task || !schedule || slotCount >= TASK_STATS_MAX_TASKS) return false;
+
+    TaskSlot& s = slots[slotCount];
+    memset(&s, 0, sizeof(s));
+    s.schedule = schedule;
+    s.periodMs = schedule->periodMs;
+    BaseType_t affinity = xTaskGetAffinity(task);
+    s.core = (affinity == 0 || affinity == 1) ? (int8_t)affinity : -1;
+    s.stackFreeMin = uxTaskGetStackHighWaterMark(task);
+#ifdef SIM_NATIVE
+    s.cpuUsAtWindow = simTaskCpuTimeUs(task);
+#endif
+    s.handle = task;   // Visible to the tick hook from here on
+
+    TaskStatsEntry& e = snapshot.tasks[slotCount];
+    strncpy(e.name, pcTaskGetName(task), sizeof(e.name) - 1);
+    e.core = s.core;
+    e.periodMs = schedule->periodMs;
+    e.deadlineMs = schedule->deadlineMs;
+    slotCount++;
+    return true;
+}
+
+// 🔁 Loop period, measured by the task itself
+void taskStatsLoop() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    for (uint8_t i = 0; i < slotCount; i++) {
+        TaskSlot& s = slots[i];
+        if (s.handle != self) continue;
+
+        uint32_t now = micros();
+        portENTER_CRITICAL(&statsMux);
+        if (s.lastLoopUs != 0) {
+            uint32_t period = now - s.lastLoopUs;
+            s.loops++;
+            s.periodSumUs += period;
+            if (period > s.periodMaxUs) s.periodMaxUs = period;
+        }
+        s.lastLoopUs = now;
+        portEXIT_CRITICAL(&statsMux);
+        return;
+    }
+}
+
+// 🪟 Window
+void updateTaskStats() {
+    uint32_t now = micros();
+    uint32_t windowUs = now - windowStartUs;
+    if (windowUs < TASK_STATS_WINDOW_MS * 1000UL) return;
+    windowStartUs = now;
+
+    TaskStatsSnapshot next = snapshot;
+    next.windowMs = windowUs / 1000;
+
+#ifndef SIM_NATIVE
+    uint32_t windowTicks = 1;
+    for (int core = 0; core < 2; core++) {
+        uint32_t total = coreTicks[core] - coreTicksAtWindow[core];
+        uint32_t idle = idleTicks[core] - idleTicksAtWindow[core];
+        coreTicksAtWindow[core] += total;
+        idleTicksAtWindow[core] += idle;
+        next.idlePermille[core] = total ? (uint16_t)(idle * 1000ULL / total) : 0;
+        if (total > windowTicks) windowTicks = total;
+    }
+#else
+    uint32_t busyPermille[2] = { 0, 0 };
+#endif
+
+    uint8_t count = slotCount;
+    for (uint8_t i = 0; i < count; i++) {
+        TaskSlot& s = slots[i];
+        TaskStatsEntry& e = next.tasks[i];
+
+#ifndef SIM_NATIVE
+        uint32_t ticks = s.ticks;
+        e.cpuPermille = (uint16_t)((ticks - s.ticksAtWindow) * 1000ULL / windowTicks);
+        s.ticksAtWindow = ticks;
+#else
+        uint64_t cpuUs = simTaskCpuTimeUs(s.handle);
+        uint64_t share = (cpuUs - s.cpuUsAtWindow) * 1000 / windowUs;
+        e.cpuPermille = (uint16_t)(share > 1000 ? 1000 : share);
+        s.cpuUsAtWindow = cpuUs;
+        if (s.core >= 0) busyPermille[s.core] += e.cpuPermille;
+#endif
+
+        portENTER_CRITICAL(&statsMux);
+        uint32_t loops = s.loops;
+        uint32_t sumUs = s.periodSumUs;
+        uint32_t maxUs = s.periodMaxUs;
+        s.loops = 0;
+        s.periodSumUs = 0;
+        s.periodMaxUs = 0;
+        portEXIT_CRITICAL(&statsMux);
+
+        // Tasks slower than the window keep the periods of their last loop
+        e.loops = (uint16_t)loops;
+        if (loops) {
+            e.avgPeriodMs = (uint16_t)((sumUs / loops + 500) / 1000);
+            e.maxPeriodMs = (uint16_t)((maxUs + 500) / 1000);
+        }
+        if (s.periodMs && e.maxPeriodMs > s.periodMs && e.maxPeriodMs - s.periodMs > s.worstLateMs) {
+            s.worstLateMs = e.maxPeriodMs - s.periodMs;
+        }
+        e.worstLateMs = s.worstLateMs;
+        e.overruns = s.schedule->overruns;
+        e.skipped = s.schedule->skipped;
+
+        uint32_t stackFree = uxTaskGetStackHighWaterMark(s.handle);
+        if (stackFree < s.stackFreeMin) s.stackFreeMin = stackFree;
+        e.stackFreeMin = s.stackFreeMin;
+    }
+    next.count = count;
+
+#ifdef SIM_NATIVE
+    // Host threads have no idle task: whatever the pinned tasks did not use
+    for (int core = 0; core < 2; core++) {
+        next.idlePermille[core] = busyPermille[core] >= 1000 ? 0 : (uint16_t)(1000 - busyPermille[core]);
+    }
+#endif
+
+    portENTER_CRITICAL(&statsMux);
+    snapshot = next;
+    portEXIT_CRITICAL(&statsMux);
+}
+
+// 📤 Readers
+void getTaskStats(TaskStatsSnapshot* out) {
+    portENTER_CRITICAL(&statsMux);
+    *out = snapshot;
+    portEXIT_CRITICAL(&statsMux);
+}
+
+size_t formatTaskStatsSummary(char* out, size_t size) {
+    TaskStatsSnapshot s;
+    getTaskStats(&s);
+
+    // Busiest task, worst overrun and least stack headroom
+    int busiest = -1, latest = -1, tightest = -1;
+    for (int i = 0; i < s.count; i++) {
+        const TaskStatsEntry& e = s.tasks[i];
+        if (busiest < 0 || e.cpuPermille > s.tasks[busiest].cpuPermille) busiest = i;
+        if (e.periodMs && (latest < 0 || e.worstLateMs > s.tasks[latest].worstLateMs)) latest = i;
+        if (tightest < 0 || e.stackFreeMin < s.tasks[tightest].stackFreeMin) tightest = i;
+    }
+
+    int n = snprintf(out, size, "idle C0 %u%% C1 %u%%", s.idlePermille[0] / 10, s.idlePermille[1] / 10);
+    if (busiest >= 0 && n >= 0 && (size_t)n < size) {
+        n += snprintf(out + n, size - n, " | top %s %u%% | late %s +%ums | stack %s %uB",
+                      s.tasks[busiest].name, s.tasks[busiest].cpuPermille / 10,
+                      latest >= 0 ? s.tasks[latest].name : "-", latest >= 0 ? s.tasks[latest].worstLateMs : 0,
+                      s.tasks[tightest].name, (unsigned)s.tasks[tightest].stackFreeMin);
+    }
+    return n < 0 ? 0 : ((size_t)n < size ? (size_t)n : size - 1);
+}
+
+// Lines are formatted on the stack and written whole: Serial.printf() would
+// fall back to malloc for anything over 64 bytes
+void printTaskStats() {
+    TaskStatsSnapshot s;
+    getTaskStats(&s);
+
+    char line[144];
+    snprintf(line, sizeof(line), "📊 Tasks (%u ms window): core 0 idle %u.%u%%, core 1 idle %u.%u%%", (unsigned)s.windowMs,
+             s.idlePermille[0] / 10, s.idlePermille[0] % 10, s.idlePermille[1] / 10, s.idlePermille[1] % 10);
+    Serial.println(line);
+    for (int i = 0; i < s.count; i++) {
+        const TaskStatsEntry& e = s.tasks[i];
+        char period[48] = "event driven";
+        if (e.periodMs) {
+            snprintf(period, sizeof(period), "%u ms: avg %u max %u, worst +%u",
+                     e.periodMs, e.avgPeriodMs, e.maxPeriodMs, e.worstLateMs);
+        }
+        char deadline[40] = "";
+        if (e.periodMs) {
+            snprintf(deadline, sizeof(deadline), "deadline %u: %u over, %u skipped",
+                     e.deadlineMs, (unsigned)e.overruns, (unsigned)e.skipped);
+        }
+        snprintf(line, sizeof(line), "   %-9s c%c cpu %3u.%u%%  period %-36s %-32s stack min %u B", e.name,
+                 e.core < 0 ? '*' : '0' + e.core, e.cpuPermille / 10, e.cpuPermille % 10,
+                 period, deadline, (unsigned)e.stackFreeMin);
+        Serial.println(line);
+    }
+}
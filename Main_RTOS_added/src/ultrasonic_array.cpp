@@ -0,0 +1,291 @@
+#include "ultrasonic_array.h"
+#include "mem_placement.h"
+#include "esp_timer.h"
+#include "rtos_trace.h"
+
+// 📡 Ultrasonic Array
+// The echo ISRs and the slot callback (esp_timer task) share the capture
+// state under echoMux. Only the slot callback triggers sensors, feeds the
+// filters and advances the schedule; readers copy the published values under
+// the same lock. Timestamps are the low 32 bits of esp_timer_get_time(), so
+// differences are modular.
+
+#define ECHO_LEAD_US 1000            // Trigger to echo rise (8-cycle 40 kHz burst plus margin)
+#define LISTEN_US ((uint32_t)ULTRA_MAX_RANGE_CM * 1000u / 17u + ECHO_LEAD_US)
+#define TRIGGER_US 10
+#define BUSY_RETRY_US ULTRA_GUARD_US // Re-check of a module still holding its echo line
+
+struct Sonar {
+    const char* name;
+    uint8_t trigPin;
+    uint8_t echoPin;
+    uint8_t group;
+};
+
+#define ULTRA_SONAR_ROW(id, name, trig, echo, group) { name, trig, echo, group },
+static const Sonar sonars[ULTRA_SENSOR_COUNT] = { ULTRASONIC_SENSORS(ULTRA_SONAR_ROW) };
+
+#define ULTRA_GROUP_CHECK(id, name, trig, echo, group) \
+    static_assert((group) < 8, "ULTRASONIC_SENSORS groups must be 0-7");
+ULTRASONIC_SENSORS(ULTRA_GROUP_CHECK)
+static_assert(ULTRA_SENSOR_COUNT <= 8, "At most 8 ultrasonic sensors");
+
+static esp_timer_handle_t slotTimer = nullptr;
+static portMUX_TYPE echoMux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t startMs = 0;
+
+// Published per sensor (under echoMux)
+static UltrasonicStats stats[ULTRA_SENSOR_COUNT];
+
+#if ULTRASONIC_ARRAY
+// Per-sensor echo capture (ISR and slot callback)
+struct EchoCapture {
+    bool listening;                          // Triggered in the slot under way
+    bool rose;                               // Echo rise seen since the trigger
+    bool done;                               // Echo fall seen, widthUs valid
+    uint32_t riseUs;
+    uint32_t widthUs;
+};
+
+static EchoCapture capture[ULTRA_SENSOR_COUNT];
+static uint8_t slotPending = 0;              // Sensors of the slot still waiting for their echo
+static uint8_t slotMask = 0;                 // Sensors triggered in the slot under way
+static uint32_t slotDeadlineUs = 0;          // End of the listen window plus guard
+
+// Schedule state (slot callback only)
+static DistanceFilter filters[ULTRA_SENSOR_COUNT];
+static uint32_t lastTriggerUs[ULTRA_SENSOR_COUNT];
+static uint8_t cursor = 0;                   // Round-robin start of the next slot
+
+// ⚡ Echo pin edge (ISR)
+static void IRAM_ATTR echoISR(void* arg) {
+    uint8_t i = (uint8_t)(uintptr_t)arg;
+    RTOS_TRACE_ISR(sonars[i].echoPin);
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    bool high = digitalRead(sonars[i].echoPin) == HIGH;
+    bool slotDone = false;
+
+    portENTER_CRITICAL_ISR(&echoMux);
+    EchoCapture& c = capture[i];
+    if (!c.listening) {
+        if (high) stats[i].crossTalk++;      // Another sensor's burst, or a late reverberation
+    } else if (high) {
+        c.rose = true;
+        c.riseUs = nowUs;
+    } else if (c.rose) {
+        c.widthUs = nowUs - c.riseUs;
+        c.done = true;
+        c.listening = false;
+        slotDone = --slotPending == 0;
+    }
+    portEXIT_CRITICAL_ISR(&echoMux);
+
+    // Last echo of the slot is in: the next slot only waits out the guard
+    if (slotDone) {
+        esp_timer_stop(slotTimer);
+        esp_timer_start_once(slotTimer, ULTRA_GUARD_US);
+    }
+}
+
+// 📥 Ends the slot: one filter update per sensor that was triggered
+static void harvestSlot() {
+    uint16_t echoUs[ULTRA_SENSOR_COUNT];
+    uint8_t mask;
+    portENTER_CRITICAL(&echoMux);
+    mask = slotMask;
+    for (uint8_t i = 0; i < ULTRA_SENSOR_COUNT; i++) {
+        EchoCapture& c = capture[i];
+        bool inRange = c.done && c.widthUs <= LISTEN_US;
+        echoUs[i] = inRange ? (uint16_t)c.widthUs : 0;
+        c.listening = c.rose = c.done = false;
+    }
+    slotMask = 0;
+    slotPending = 0;
+    portEXIT_CRITICAL(&echoMux);
+
+    uint32_t nowMs = millis();
+    for (uint8_t i = 0; i < ULTRA_SENSOR_COUNT; i++) {
+        if (!(mask & (1u << i))) continue;
+        DistanceEstimate e = distanceFilterUpdate(&filters[i], echoUs[i], nowMs);
+        portENTER_CRITICAL(&echoMux);
+        UltrasonicStats& s = stats[i];
+        if (echoUs[i]) {
+            s.echoes++;
+        } else {
+            s.timeouts++;
+        }
+        s.lastEchoUs = echoUs[i];
+        s.estimate = e;
+        portEXIT_CRITICAL(&echoMux);
+    }
+}
+
+// 🗓️ Picks one rested, idle sensor per group and triggers them together.
+// Returns the time until the next slot.
+static uint32_t fireSlot() {
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    uint8_t groups = 0, mask = 0, count = 0, last = cursor;
+    uint32_t waitUs = ULTRA_CYCLE_MS * 1000u;
+
+    for (uint8_t k = 0; k < ULTRA_SENSOR_COUNT; k++) {
+        uint8_t i = (cursor + k) % ULTRA_SENSOR_COUNT;
+        const Sonar& s = sonars[i];
+        if (groups & (1u << s.group)) continue;
+        uint32_t restedUs = nowUs - lastTriggerUs[i];
+        if (restedUs < ULTRA_CYCLE_MS * 1000u) {
+            uint32_t leftUs = ULTRA_CYCLE_MS * 1000u - restedUs;
+            if (leftUs < waitUs) waitUs = leftUs;
+            continue;
+        }
+        if (digitalRead(s.echoPin) == HIGH) {
+            portENTER_CRITICAL(&echoMux);
+            stats[i].busySkips++;                 // Module still timing out a lost echo
+            portEXIT_CRITICAL(&echoMux);
+            if (BUSY_RETRY_US < waitUs) waitUs = BUSY_RETRY_US;
+            continue;
+        }
+        groups |= (uint8_t)(1u << s.group);
+        mask |= (uint8_t)(1u << i);
+        count++;
+        last = i;
+    }
+    if (!count) return waitUs;
+
+    portENTER_CRITICAL(&echoMux);
+    for (uint8_t i = 0; i < ULTRA_SENSOR_COUNT; i++) {
+        if (!(mask & (1u << i))) continue;
+        capture[i].listening = true;
+        stats[i].pings++;
+    }
+    slotMask = mask;
+    slotPending = count;
+    slotDeadlineUs = nowUs + LISTEN_US + ULTRA_GUARD_US;
+    portEXIT_CRITICAL(&echoMux);
+
+    for (uint8_t i = 0; i < ULTRA_SENSOR_COUNT; i++) {
+        if (mask & (1u << i)) digitalWrite(sonars[i].trigPin, HIGH);
+    }
+    delayMicroseconds(TRIGGER_US);
+    for (uint8_t i = 0; i < ULTRA_SENSOR_COUNT; i++) {
+        if (mask & (1u << i)) {
+            digitalWrite(sonars[i].trigPin, LOW);
+            lastTriggerUs[i] = nowUs;
+        }
+    }
+    cursor = (last + 1) % ULTRA_SENSOR_COUNT;
+    return LISTEN_US + ULTRA_GUARD_US;
+}
+
+// ⏲️ Slot timer (esp_timer task)
+static void slotTick(void* arg) {
+    (void)arg;
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    portENTER_CRITICAL(&echoMux);
+    int32_t leftUs = (int32_t)(slotDeadlineUs - nowUs);
+    bool early = slotPending > 0 && leftUs > 0;
+    portEXIT_CRITICAL(&echoMux);
+    if (early) {
+        // Re-armed by an echo ISR of the previous slot after this one fired
+        esp_timer_stop(slotTimer);
+        esp_timer_start_once(slotTimer, (uint32_t)leftUs);
+        return;
+    }
+    harvestSlot();
+    uint32_t nextUs = fireSlot();
+    esp_timer_stop(slotTimer);
+    esp_timer_start_once(slotTimer, nextUs);
+}
+#endif
+
+// 🔧 Setup
+bool initUltrasonicArray() {
+#if ULTRASONIC_ARRAY
+    esp_timer_create_args_t args = {};
+    args.callback = slotTick;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "sonar";
+    if (esp_timer_create(&args, &slotTimer) != ESP_OK) {
+        Serial.println("❌ Ultrasonic array: timer create failed");
+        slotTimer = nullptr;
+        return false;
+    }
+    MEM_DECLARE("sonarEcho", capture, MEM_HOT);   // Written from the ISRs
+
+    uint8_t groups = 0;
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    for (uint8_t i = 0; i < ULTRA_SENSOR_COUNT; i++) {
+        const Sonar& s = sonars[i];
+        pinMode(s.trigPin, OUTPUT);
+        digitalWrite(s.trigPin, LOW);
+        pinMode(s.echoPin, INPUT);
+        distanceFilterReset(&filters[i]);
+        stats[i].estimate = {DISTANCE_NONE, 0, false};
+        lastTriggerUs[i] = nowUs - ULTRA_CYCLE_MS * 1000u;   // Ready at once
+        groups |= (uint8_t)(1u << s.group);
+        attachInterruptArg(digitalPinToInterrupt(s.echoPin), echoISR, (void*)(uintptr_t)i, CHANGE);
+    }
+    startMs = millis();
+    esp_timer_start_once(slotTimer, ULTRA_GUARD_US);
+    Serial.printf("📡 Ultrasonic array: %u sensors in %u groups, %u ms cycle, %u cm range\n",
+                  (unsigned)ULTRA_SENSOR_COUNT, (unsigned)__builtin_popcount(groups),
+                  (unsigned)ULTRA_CYCLE_MS, (unsigned)ULTRA_MAX_RANGE_CM);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool isUltrasonicArrayActive() {
+    return slotTimer != nullptr;
+}
+
+// 📤 Published streams
+uint16_t getUltrasonicEcho(uint8_t id) {
+    if (id >= ULTRA_SENSOR_COUNT) return 0;
+    portENTER_CRITICAL(&echoMux);
+    uint16_t us = stats[id].lastEchoUs;
+    portEXIT_CRITICAL(&echoMux);
+    return us;
+}
+
+DistanceEstimate getUltrasonicEstimate(uint8_t id) {
+    DistanceEstimate e = {DISTANCE_NONE, 0, false};
+    if (id >= ULTRA_SENSOR_COUNT) return e;
+    portENTER_CRITICAL(&echoMux);
+    e = stats[id].estimate;
+    portEXIT_CRITICAL(&echoMux);
+    return e;
+}
+
+const char* getUltrasonicName(uint8_t id) {
+    return id < ULTRA_SENSOR_COUNT ? sonars[id].name : "?";
+}
+
+// 📤 Statistics
+void getUltrasonicStats(uint8_t id, UltrasonicStats* out) {
+    if (id >= ULTRA_SENSOR_COUNT) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    portENTER_CRITICAL(&echoMux);
+    *out = stats[id];
+    portEXIT_CRITICAL(&echoMux);
+    uint32_t elapsedMs = millis() - startMs;
+    out->pingHz = elapsedMs ? (uint16_t)((uint64_t)out->pings * 1000 / elapsedMs) : 0;
+}
+
+void printUltrasonicStats() {
+    if (!slotTimer) return;
+    for (uint8_t i = 0; i < ULTRA_SENSOR_COUNT; i++) {
+        UltrasonicStats s;
+        getUltrasonicStats(i, &s);
+        char line[192];
+        snprintf(line, sizeof(line),
+                 "📡 Sonar %s: %u pings (%u Hz), %u echoes, %u timeouts, %u cross-talk, %u busy, "
+                 "last %u us, %d cm %d cm/s%s",
+                 sonars[i].name, (unsigned)s.pings, (unsigned)s.pingHz, (unsigned)s.echoes,
+                 (unsigned)s.timeouts, (unsigned)s.crossTalk, (unsigned)s.busySkips, (unsigned)s.lastEchoUs,
+                 s.estimate.distanceCm, s.estimate.velocityCmS, s.estimate.valid ? "" : " (no target)");
+        Serial.println(line);
+    }
+}
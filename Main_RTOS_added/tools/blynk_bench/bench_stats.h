@@ -0,0 +1,38 @@
+// 📊 Latency sample collection and percentile reporting for the bench tools
+
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+class LatencyStats {
+public:
+  void add(uint64_t us) { samples.push_back(us); }
+  size_t count() const { return samples.size(); }
+
+  uint64_t percentile(double p) {
+    if (samples.empty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    size_t idx = (size_t)(p / 100.0 * (samples.size() - 1) + 0.5);
+    return samples[idx];
+  }
+
+  void print(const char* name) {
+    if (samples.empty()) {
+      printf("  %-18s n=0\n", name);
+      return;
+    }
+    printf("  %-18s n=%-8zu p50=%8.2f ms  p95=%8.2f ms  p99=%8.2f ms  max=%8.2f ms\n",
+           name, samples.size(),
+           percentile(50) / 1000.0, percentile(95) / 1000.0,
+           percentile(99) / 1000.0, percentile(100) / 1000.0);
+  }
+
+private:
+  std::vector<uint64_t> samples;
+};
+
+#endif // BENCH_STATS_H
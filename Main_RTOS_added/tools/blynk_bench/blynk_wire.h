@@ -0,0 +1,103 @@
+// 🔌 Blynk binary protocol framing for the host-side benchmark tools
+// Shares command/status codes with the firmware's Blynk library so both
+// ends always agree on the wire format.
+
+#ifndef BLYNK_WIRE_H
+#define BLYNK_WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <arpa/inet.h>
+
+#include <Blynk/BlynkHelpers.h>
+#include <Blynk/BlynkProtocolDefs.h>
+
+// Smart Shop Guard virtual pins (must match include/config.h)
+enum ShopPin {
+  SHOP_PIN_TEMPERATURE = 0,
+  SHOP_PIN_HUMIDITY    = 1,
+  SHOP_PIN_MOTION      = 3,
+  SHOP_PIN_FLAME       = 4,
+  SHOP_PIN_DAY_NIGHT   = 5,
+  SHOP_PIN_AC_CONTROL  = 6
+};
+
+static const size_t BLYNK_WIRE_HDR = 5;
+
+struct BlynkFrame {
+  uint8_t  type;
+  uint16_t msgId;
+  uint16_t length;      // Body length, or status code for BLYNK_CMD_RESPONSE
+  std::string body;
+};
+
+// Monotonic clock shared by every process on the box (one-way latencies are valid)
+static inline uint64_t wireNowUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static inline void wireAppend(std::string& out, uint8_t type, uint16_t msgId,
+                              const void* body, uint16_t len) {
+  uint8_t hdr[BLYNK_WIRE_HDR] = {
+    type,
+    (uint8_t)(msgId >> 8), (uint8_t)msgId,
+    (uint8_t)(len >> 8),   (uint8_t)len
+  };
+  out.append((const char*)hdr, sizeof(hdr));
+  if (type != BLYNK_CMD_RESPONSE && len) {
+    out.append((const char*)body, len);
+  }
+}
+
+static inline void wireAppendResponse(std::string& out, uint16_t msgId, uint16_t status) {
+  wireAppend(out, BLYNK_CMD_RESPONSE, msgId, NULL, status);
+}
+
+// "vw\0<pin>\0<value>" - same layout Blynk.virtualWrite() produces
+static inline std::string wireVirtualWrite(int pin, const std::string& value) {
+  std::string body("vw");
+  body.push_back('\0');
+  body += std::to_string(pin);
+  body.push_back('\0');
+  body += value;
+  return body;
+}
+
+// Pops one complete frame from the front of buf; returns false if incomplete
+static inline bool wireParse(std::string& buf, BlynkFrame& f) {
+  if (buf.size() < BLYNK_WIRE_HDR) {
+    return false;
+  }
+  const uint8_t* p = (const uint8_t*)buf.data();
+  f.type   = p[0];
+  f.msgId  = (uint16_t)(p[1] << 8 | p[2]);
+  f.length = (uint16_t)(p[3] << 8 | p[4]);
+  size_t bodyLen = (f.type == BLYNK_CMD_RESPONSE) ? 0 : f.length;
+  if (buf.size() < BLYNK_WIRE_HDR + bodyLen) {
+    return false;
+  }
+  f.body.assign(buf, BLYNK_WIRE_HDR, bodyLen);
+  buf.erase(0, BLYNK_WIRE_HDR + bodyLen);
+  return true;
+}
+
+// Splits a hardware command body on '\0'
+static inline std::vector<std::string> wireSplit(const std::string& body) {
+  std::vector<std::string> parts;
+  size_t start = 0;
+  for (size_t i = 0; i <= body.size(); i++) {
+    if (i == body.size() || body[i] == '\0') {
+      parts.push_back(body.substr(start, i - start));
+      start = i + 1;
+    }
+  }
+  return parts;
+}
+
+#endif // BLYNK_WIRE_H
@@ -0,0 +1,392 @@
+// 🚦 Multi-device load driver for the Blynk stand-in server
+// Emulates hundreds of Smart Shop Guard boards from one epoll loop. Each client
+// logs in, publishes V0/V1/V4/V3 every telemetry interval exactly like
+// sendSensorDataToBlynk(), pings on the heartbeat and reconnects the way
+// BlynkProtocol::run() does (retry login every 5 s). Reports per-message RTT,
+// downlink latency of server pushes, throughput and reconnect times.
+//
+//   ./load_driver --clients 300 --duration 60 --interval-ms 2000
+
+#include "blynk_wire.h"
+#include "bench_stats.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <random>
+#include <unordered_map>
+
+// ⚙️ Command line options
+struct DriverOptions {
+  const char* host = "127.0.0.1";
+  int port = 8080;
+  int clients = 100;
+  int durationSec = 30;
+  int intervalMs = 2000;        // Telemetry period (blynkSendInterval in main.cpp)
+  int heartbeatSec = 45;        // BLYNK_HEARTBEAT
+  int retryMs = 5000;           // Login retry after a failed connect (BlynkProtocol::run)
+  bool ack = false;             // Server runs with --ack: telemetry writes expect a RESPONSE
+  int ackTimeoutMs = 5000;      // Unanswered messages older than this count as lost
+  int loginTimeoutMs = 6000;    // Connect + login must finish within this (BLYNK_TIMEOUT_MS)
+  int rampMs = 1000;            // Spread initial connects over this window
+};
+
+enum ClientState { CL_IDLE, CL_CONNECTING, CL_LOGIN, CL_ONLINE };
+
+struct Client {
+  int fd = -1;
+  ClientState state = CL_IDLE;
+  std::string in, out;
+  uint16_t msgId = 1;
+  std::unordered_map<uint16_t, uint64_t> inFlight;  // msgId -> send time
+  uint64_t nextConnectUs = 0;
+  uint64_t nextTelemetryUs = 0;
+  uint64_t lastOutUs = 0;
+  uint64_t connectStartUs = 0;
+  uint64_t disconnectedAtUs = 0;    // 0 = first connect, not a reconnect
+  int temperature = 24;
+  int humidity = 55;
+  bool motion = false;
+};
+
+static DriverOptions opt;
+static int epfd = -1;
+static std::vector<Client> clients;
+static std::unordered_map<int, size_t> clientByFd;
+static std::mt19937 rng(4242);
+static struct sockaddr_in serverAddr;
+
+// 📊 Results
+static LatencyStats rttStats;           // Request -> RESPONSE (pings, acked writes)
+static LatencyStats downlinkStats;      // Server push -> client receive
+static LatencyStats reconnectStats;     // Disconnect -> login accepted
+static LatencyStats firstLoginStats;    // First connect -> login accepted
+static uint64_t txMsgs = 0, rxMsgs = 0, lostMsgs = 0, disconnects = 0, connectFailures = 0;
+static uint64_t loginTimeouts = 0;      // Also counted in connectFailures
+
+static void setNonBlocking(int fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static void watch(Client& c, bool wantWrite) {
+  struct epoll_event ev = {};
+  ev.events = EPOLLIN | (wantWrite ? EPOLLOUT : 0);
+  ev.data.fd = c.fd;
+  epoll_ctl(epfd, EPOLL_CTL_MOD, c.fd, &ev);
+}
+
+static void dropClient(Client& c, uint64_t now) {
+  if (c.fd >= 0) {
+    epoll_ctl(epfd, EPOLL_CTL_DEL, c.fd, nullptr);
+    clientByFd.erase(c.fd);
+    close(c.fd);
+  }
+  if (c.state == CL_ONLINE) {
+    disconnects++;
+    c.disconnectedAtUs = now;
+    c.nextConnectUs = now;          // First retry is immediate
+  } else {
+    connectFailures++;
+    c.nextConnectUs = now + (uint64_t)opt.retryMs * 1000;
+  }
+  lostMsgs += c.inFlight.size();
+  c.inFlight.clear();
+  c.fd = -1;
+  c.state = CL_IDLE;
+  c.in.clear();
+  c.out.clear();
+}
+
+static void flush(Client& c, uint64_t now) {
+  while (!c.out.empty()) {
+    ssize_t n = send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL);
+    if (n > 0) {
+      c.out.erase(0, n);
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else {
+      dropClient(c, now);
+      return;
+    }
+  }
+  watch(c, !c.out.empty());
+}
+
+static void sendFrame(Client& c, uint8_t type, const std::string& body, uint64_t now, bool expectAck) {
+  uint16_t id = c.msgId++;
+  if (c.msgId == 0) c.msgId = 1;
+  wireAppend(c.out, type, id, body.data(), (uint16_t)body.size());
+  if (expectAck) c.inFlight[id] = now;
+  c.lastOutUs = now;
+  txMsgs++;
+}
+
+static void startConnect(Client& c, uint64_t now) {
+  c.fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (c.fd < 0) {
+    perror("socket");
+    c.nextConnectUs = now + (uint64_t)opt.retryMs * 1000;
+    return;
+  }
+  setNonBlocking(c.fd);
+  int one = 1;
+  setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  clientByFd[c.fd] = &c - &clients[0];
+  struct epoll_event ev = {};
+  ev.events = EPOLLOUT;
+  ev.data.fd = c.fd;
+  epoll_ctl(epfd, EPOLL_CTL_ADD, c.fd, &ev);
+  c.state = CL_CONNECTING;
+  c.connectStartUs = c.lastOutUs = now;
+  if (connect(c.fd, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0 && errno != EINPROGRESS) {
+    dropClient(c, now);
+  }
+}
+
+static void onConnected(Client& c, uint64_t now) {
+  int err = 0;
+  socklen_t len = sizeof(err);
+  getsockopt(c.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+  if (err) {
+    dropClient(c, now);
+    return;
+  }
+  c.state = CL_LOGIN;
+  c.msgId = 1;                      // Login is always message 1, like BlynkProtocol
+  sendFrame(c, BLYNK_CMD_HW_LOGIN, "bench-token-0123456789abcdefghij", now, false);
+  flush(c, now);
+}
+
+// 🌡️ One telemetry burst, mirroring sendSensorDataToBlynk()
+static void sendTelemetry(Client& c, uint64_t now) {
+  std::uniform_int_distribution<int> step(-1, 1);
+  std::uniform_int_distribution<int> pct(0, 99);
+  c.temperature += step(rng);
+  c.humidity += step(rng);
+  if (pct(rng) < 5) c.motion = !c.motion;
+
+  const std::pair<int, int> values[] = {
+    {SHOP_PIN_TEMPERATURE, c.temperature},
+    {SHOP_PIN_HUMIDITY, c.humidity},
+    {SHOP_PIN_FLAME, 0},
+    {SHOP_PIN_MOTION, c.motion ? 1 : 0},
+  };
+  for (const auto& v : values) {
+    // Extra value carries the send time for the server's uplink latency
+    std::string body = wireVirtualWrite(v.first, std::to_string(v.second));
+    body.push_back('\0');
+    body += std::to_string(now);
+    sendFrame(c, BLYNK_CMD_HARDWARE, body, now, opt.ack);  // Without --ack only pings are timed
+  }
+  flush(c, now);
+}
+
+static void onFrame(Client& c, const BlynkFrame& f, uint64_t now) {
+  rxMsgs++;
+  if (f.type == BLYNK_CMD_RESPONSE) {
+    if (c.state == CL_LOGIN && f.msgId == 1) {
+      if (f.length != BLYNK_SUCCESS) {
+        dropClient(c, now);
+        return;
+      }
+      c.state = CL_ONLINE;
+      if (c.disconnectedAtUs) {
+        reconnectStats.add(now - c.disconnectedAtUs);
+      } else {
+        firstLoginStats.add(now - c.connectStartUs);
+      }
+      c.nextTelemetryUs = now;
+      return;
+    }
+    auto it = c.inFlight.find(f.msgId);
+    if (it != c.inFlight.end()) {
+      rttStats.add(now - it->second);
+      c.inFlight.erase(it);
+    }
+  } else if (f.type == BLYNK_CMD_HARDWARE) {
+    std::vector<std::string> parts = wireSplit(f.body);
+    if (parts.size() >= 4) {
+      uint64_t sentUs = strtoull(parts[3].c_str(), nullptr, 10);
+      if (sentUs && sentUs <= now) downlinkStats.add(now - sentUs);
+    }
+  }
+}
+
+static void onReadable(Client& c, uint64_t now) {
+  char buf[4096];
+  for (;;) {
+    ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+    if (n > 0) {
+      c.in.append(buf, n);
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else {
+      dropClient(c, now);
+      return;
+    }
+  }
+  BlynkFrame f;
+  while (c.fd >= 0 && wireParse(c.in, f)) {
+    onFrame(c, f, now);
+  }
+}
+
+// ⏱️ Per-client timers: connect/retry, telemetry, heartbeat, ack expiry
+static uint64_t runTimers(uint64_t now) {
+  uint64_t next = now + 1000000;
+  const uint64_t ackTimeout = (uint64_t)opt.ackTimeoutMs * 1000;
+  for (Client& c : clients) {
+    if (c.state == CL_IDLE) {
+      if (now >= c.nextConnectUs) startConnect(c, now);
+      else next = std::min(next, c.nextConnectUs);
+      continue;
+    }
+    if (c.state != CL_ONLINE) {
+      // A server that accepts but never answers the login must not park the client
+      uint64_t loginDeadline = c.connectStartUs + (uint64_t)opt.loginTimeoutMs * 1000;
+      if (now >= loginDeadline) {
+        loginTimeouts++;
+        dropClient(c, now);
+        next = std::min(next, c.nextConnectUs);
+      } else {
+        next = std::min(next, loginDeadline);
+      }
+      continue;
+    }
+
+    for (auto it = c.inFlight.begin(); it != c.inFlight.end();) {
+      if (now - it->second > ackTimeout) {
+        lostMsgs++;
+        it = c.inFlight.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (now >= c.nextTelemetryUs) {
+      sendTelemetry(c, now);
+      if (c.fd < 0) continue;
+      c.nextTelemetryUs = now + (uint64_t)opt.intervalMs * 1000;
+    }
+    uint64_t pingAt = c.lastOutUs + (uint64_t)opt.heartbeatSec * 1000000;
+    if (now >= pingAt) {
+      sendFrame(c, BLYNK_CMD_PING, std::string(), now, true);
+      flush(c, now);
+      pingAt = now + (uint64_t)opt.heartbeatSec * 1000000;
+    }
+    next = std::min(next, std::min(c.nextTelemetryUs, pingAt));
+  }
+  return next;
+}
+
+static void usage(const char* prog) {
+  printf("Usage: %s [--host IP] [--port N] [--clients N] [--duration SEC]\n"
+         "          [--interval-ms N] [--heartbeat SEC] [--retry-ms N]\n"
+         "          [--ack] [--ack-timeout-ms N] [--login-timeout-ms N] [--ramp-ms N]\n", prog);
+}
+
+int main(int argc, char** argv) {
+  static const struct option longOpts[] = {
+    {"host",             required_argument, nullptr, 'H'},
+    {"port",             required_argument, nullptr, 'p'},
+    {"clients",          required_argument, nullptr, 'n'},
+    {"duration",         required_argument, nullptr, 't'},
+    {"interval-ms",      required_argument, nullptr, 'i'},
+    {"heartbeat",        required_argument, nullptr, 'b'},
+    {"retry-ms",         required_argument, nullptr, 'r'},
+    {"ack",              no_argument,       nullptr, 'A'},
+    {"ack-timeout-ms",   required_argument, nullptr, 'a'},
+    {"login-timeout-ms", required_argument, nullptr, 'l'},
+    {"ramp-ms",          required_argument, nullptr, 'm'},
+    {"help",             no_argument,       nullptr, 'h'},
+    {nullptr, 0, nullptr, 0}
+  };
+  int ch;
+  while ((ch = getopt_long(argc, argv, "H:p:n:t:h", longOpts, nullptr)) != -1) {
+    switch (ch) {
+      case 'H': opt.host = optarg; break;
+      case 'p': opt.port = atoi(optarg); break;
+      case 'n': opt.clients = atoi(optarg); break;
+      case 't': opt.durationSec = atoi(optarg); break;
+      case 'i': opt.intervalMs = atoi(optarg); break;
+      case 'b': opt.heartbeatSec = atoi(optarg); break;
+      case 'r': opt.retryMs = atoi(optarg); break;
+      case 'A': opt.ack = true; break;
+      case 'a': opt.ackTimeoutMs = atoi(optarg); break;
+      case 'l': opt.loginTimeoutMs = atoi(optarg); break;
+      case 'm': opt.rampMs = atoi(optarg); break;
+      default: usage(argv[0]); return ch == 'h' ? 0 : 1;
+    }
+  }
+
+  // Hundreds of sockets need more than the default 1024 descriptors on some boxes
+  struct rlimit rl;
+  if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+  }
+
+  serverAddr.sin_family = AF_INET;
+  serverAddr.sin_port = htons(opt.port);
+  if (inet_pton(AF_INET, opt.host, &serverAddr.sin_addr) != 1) {
+    fprintf(stderr, "Invalid host address: %s\n", opt.host);
+    return 1;
+  }
+
+  epfd = epoll_create1(0);
+  clients.resize(opt.clients);
+  const uint64_t startUs = wireNowUs();
+  for (int i = 0; i < opt.clients; i++) {
+    clients[i].nextConnectUs = startUs + (uint64_t)opt.rampMs * 1000 * i / std::max(1, opt.clients);
+  }
+
+  printf("🚦 %d Smart Shop Guard clients -> %s:%d for %d s (telemetry every %d ms)\n",
+         opt.clients, opt.host, opt.port, opt.durationSec, opt.intervalMs);
+  fflush(stdout);
+
+  const uint64_t endUs = startUs + (uint64_t)opt.durationSec * 1000000;
+  std::vector<struct epoll_event> events(1024);
+  uint64_t now = startUs;
+  while (now < endUs) {
+    uint64_t next = std::min(runTimers(now), endUs);
+    int timeoutMs = next > now ? (int)((next - now + 999) / 1000) : 0;
+    int n = epoll_wait(epfd, events.data(), (int)events.size(), timeoutMs);
+    now = wireNowUs();
+    for (int i = 0; i < n; i++) {
+      auto it = clientByFd.find(events[i].data.fd);
+      if (it == clientByFd.end()) continue;
+      Client& c = clients[it->second];
+      if (c.state == CL_CONNECTING && (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+        onConnected(c, now);
+        continue;
+      }
+      if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) onReadable(c, now);
+      if (c.fd >= 0 && (events[i].events & EPOLLOUT)) flush(c, now);
+    }
+  }
+
+  size_t online = 0;
+  for (const Client& c : clients) online += (c.state == CL_ONLINE);
+  double seconds = (now - startUs) / 1e6;
+
+  printf("\n📊 Results after %.1f s\n", seconds);
+  printf("  clients online     %zu / %d\n", online, opt.clients);
+  printf("  throughput         tx %.0f msg/s, rx %.0f msg/s\n", txMsgs / seconds, rxMsgs / seconds);
+  printf("  lost (no answer)   %llu\n", (unsigned long long)lostMsgs);
+  printf("  disconnects        %llu, failed connects %llu (login timeouts %llu)\n",
+         (unsigned long long)disconnects, (unsigned long long)connectFailures,
+         (unsigned long long)loginTimeouts);
+  rttStats.print("message RTT");
+  downlinkStats.print("downlink latency");
+  firstLoginStats.print("first login");
+  reconnectStats.print("reconnect time");
+  return 0;
+}
@@ -0,0 +1,424 @@
+// 🖥️ Blynk stand-in server for offline protocol benchmarks
+// Single-threaded epoll server that speaks the Blynk binary protocol well enough
+// for the Smart Shop Guard firmware and the load driver: login, ping, hardware
+// writes, plus V5/V6 command pushes. Adverse network conditions are injected here:
+// per-direction latency with jitter, message loss and periodic reconnect storms.
+//
+//   ./stand_in_server --ack --delay-ms 40 --jitter-ms 20 --loss 1 --push-ms 1000
+//   ./stand_in_server --ack --storm-every 30 --storm-frac 0.5
+
+#include "blynk_wire.h"
+#include "bench_stats.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <map>
+#include <random>
+#include <unordered_map>
+
+// ⚙️ Command line options
+struct ServerOptions {
+  int port = 8080;
+  bool ack = false;            // Answer hardware writes with a RESPONSE (for RTT)
+  int delayMs = 0;             // Injected one-way latency, each direction
+  int jitterMs = 0;            // Uniform +/- jitter on top of delayMs
+  double lossPct = 0;          // Inbound messages silently dropped (%)
+  int pushMs = 0;              // V5/V6 command push interval per client (0 = off)
+  int stormEverySec = 0;       // Reconnect storm period (0 = off)
+  double stormFrac = 0.5;      // Fraction of clients dropped per storm
+  int reportSec = 5;           // Stats print interval
+  int durationSec = 0;         // Exit after N seconds (0 = run forever)
+};
+
+struct Conn {
+  int fd;
+  uint64_t id;                 // Unique, so delayed actions never hit a reused fd
+  std::string in;
+  std::string out;
+  bool authed = false;
+  uint16_t pushMsgId = 1;
+  uint64_t nextPushUs = 0;
+  uint64_t inReleaseUs = 0;    // Delay line: latest release time per direction,
+  uint64_t outReleaseUs = 0;   // so jitter never reorders one TCP stream
+};
+
+// Delayed inbound frame or outbound bytes
+struct Pending {
+  uint64_t connId;
+  bool inbound;
+  BlynkFrame frame;
+  std::string bytes;
+};
+
+static ServerOptions opt;
+static int epfd = -1;
+static std::unordered_map<int, Conn> conns;
+static std::unordered_map<uint64_t, int> connFdById;
+static std::multimap<uint64_t, Pending> pending;
+static std::mt19937 rng(12345);
+static uint64_t nextConnId = 1;
+static volatile sig_atomic_t stopRequested = 0;
+
+// 📊 Counters since the last report
+static struct {
+  uint64_t accepted, logins, closed, storms;
+  uint64_t rxMsgs, txMsgs, dropped, hwWrites, pings;
+  LatencyStats uplink;         // Client send -> server processing (needs timestamped values)
+} stats;
+
+static bool latencyInjected() {
+  return opt.delayMs != 0 || opt.jitterMs != 0;
+}
+
+// Release time of the next message in one direction of a connection: the
+// jittered delay, but never before the message queued ahead of it
+static uint64_t releaseAtUs(uint64_t& lastUs) {
+  std::uniform_int_distribution<int> d(-opt.jitterMs, opt.jitterMs);
+  int ms = opt.delayMs + d(rng);
+  uint64_t at = wireNowUs() + (ms > 0 ? (uint64_t)ms * 1000 : 0);
+  if (at < lastUs) at = lastUs;
+  lastUs = at;
+  return at;
+}
+
+static void setNonBlocking(int fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static void updateInterest(Conn& c) {
+  struct epoll_event ev = {};
+  ev.events = EPOLLIN | (c.out.empty() ? 0 : EPOLLOUT);
+  ev.data.fd = c.fd;
+  epoll_ctl(epfd, EPOLL_CTL_MOD, c.fd, &ev);
+}
+
+static void closeConn(int fd) {
+  auto it = conns.find(fd);
+  if (it == conns.end()) return;
+  connFdById.erase(it->second.id);
+  epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+  close(fd);
+  conns.erase(it);
+  stats.closed++;
+}
+
+static void flushConn(Conn& c) {
+  while (!c.out.empty()) {
+    ssize_t n = send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL);
+    if (n > 0) {
+      c.out.erase(0, n);
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else {
+      closeConn(c.fd);
+      return;
+    }
+  }
+  updateInterest(c);
+}
+
+// 📤 Outbound bytes go through the delay line when latency is injected
+static void sendToConn(Conn& c, const std::string& bytes) {
+  stats.txMsgs++;
+  if (!latencyInjected()) {
+    c.out += bytes;
+    flushConn(c);
+  } else {
+    Pending p;
+    p.connId = c.id;
+    p.inbound = false;
+    p.bytes = bytes;
+    pending.emplace(releaseAtUs(c.outReleaseUs), std::move(p));
+  }
+}
+
+static void processFrame(Conn& c, const BlynkFrame& f) {
+  std::string reply;
+  switch (f.type) {
+    case BLYNK_CMD_HW_LOGIN:
+      c.authed = !f.body.empty();
+      wireAppendResponse(reply, f.msgId, c.authed ? BLYNK_SUCCESS : BLYNK_INVALID_TOKEN);
+      if (c.authed) {
+        stats.logins++;
+        c.nextPushUs = wireNowUs() + (uint64_t)opt.pushMs * 1000;
+      }
+      break;
+    case BLYNK_CMD_PING:
+      stats.pings++;
+      wireAppendResponse(reply, f.msgId, BLYNK_SUCCESS);
+      break;
+    case BLYNK_CMD_HARDWARE: {
+      stats.hwWrites++;
+      // Load driver appends its send time as an extra value: vw, pin, value, tsUs
+      std::vector<std::string> parts = wireSplit(f.body);
+      if (parts.size() >= 4 && parts[0] == "vw") {
+        uint64_t sentUs = strtoull(parts[3].c_str(), nullptr, 10);
+        uint64_t now = wireNowUs();
+        if (sentUs && sentUs <= now) stats.uplink.add(now - sentUs);
+      }
+      if (opt.ack) wireAppendResponse(reply, f.msgId, BLYNK_SUCCESS);
+      break;
+    }
+    case BLYNK_CMD_RESPONSE:
+      break;
+    default:
+      // Internal/property/sync commands are accepted and acknowledged
+      wireAppendResponse(reply, f.msgId, BLYNK_SUCCESS);
+      break;
+  }
+  if (!reply.empty()) sendToConn(c, reply);
+}
+
+// 📥 Inbound frames: loss is applied first, then the delay line
+static void handleFrame(Conn& c, BlynkFrame& f) {
+  stats.rxMsgs++;
+  if (opt.lossPct > 0 && f.type != BLYNK_CMD_HW_LOGIN) {
+    std::uniform_real_distribution<double> d(0, 100);
+    if (d(rng) < opt.lossPct) {
+      stats.dropped++;
+      return;
+    }
+  }
+  if (!latencyInjected()) {
+    processFrame(c, f);
+  } else {
+    Pending p;
+    p.connId = c.id;
+    p.inbound = true;
+    p.frame = std::move(f);
+    pending.emplace(releaseAtUs(c.inReleaseUs), std::move(p));
+  }
+}
+
+// Frames that arrived together with the peer's FIN are still handled before
+// the connection is closed
+static void readConn(Conn& c) {
+  char buf[4096];
+  bool peerGone = false;
+  for (;;) {
+    ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+    if (n > 0) {
+      c.in.append(buf, n);
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else {
+      peerGone = true;
+      break;
+    }
+  }
+  int fd = c.fd;
+  BlynkFrame f;
+  while (conns.count(fd) && wireParse(c.in, f)) {
+    handleFrame(c, f);
+  }
+  if (peerGone) closeConn(fd);
+}
+
+static void acceptAll(int lfd) {
+  for (;;) {
+    int fd = accept(lfd, nullptr, nullptr);
+    if (fd < 0) return;
+    setNonBlocking(fd);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    Conn c;
+    c.fd = fd;
+    c.id = nextConnId++;
+    conns[fd] = c;
+    connFdById[c.id] = fd;
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+    stats.accepted++;
+  }
+}
+
+// ⏱️ Timed work: delay line, command pushes, storms
+static void runDuePending(uint64_t now) {
+  while (!pending.empty() && pending.begin()->first <= now) {
+    Pending p = std::move(pending.begin()->second);
+    pending.erase(pending.begin());
+    auto it = connFdById.find(p.connId);
+    if (it == connFdById.end()) continue;  // Connection went away meanwhile
+    Conn& c = conns[it->second];
+    if (p.inbound) {
+      processFrame(c, p.frame);
+    } else {
+      c.out += p.bytes;
+      flushConn(c);
+    }
+  }
+}
+
+static void runPushes(uint64_t now) {
+  if (opt.pushMs <= 0) return;
+  std::vector<int> fds;
+  for (auto& kv : conns) fds.push_back(kv.first);
+  for (int fd : fds) {
+    auto it = conns.find(fd);
+    if (it == conns.end()) continue;
+    Conn& c = it->second;
+    if (!c.authed || now < c.nextPushUs) continue;
+    c.nextPushUs = now + (uint64_t)opt.pushMs * 1000;
+    // Toggle AC / day-night like the app would; timestamp lets the client measure downlink
+    int pin = (c.pushMsgId & 1) ? SHOP_PIN_AC_CONTROL : SHOP_PIN_DAY_NIGHT;
+    std::string body = wireVirtualWrite(pin, std::to_string(c.pushMsgId & 2 ? 1 : 0));
+    body.push_back('\0');
+    body += std::to_string(now);
+    std::string frame;
+    wireAppend(frame, BLYNK_CMD_HARDWARE, c.pushMsgId++, body.data(), (uint16_t)body.size());
+    sendToConn(c, frame);
+  }
+}
+
+static void runStorm() {
+  std::vector<int> fds;
+  for (auto& kv : conns) fds.push_back(kv.first);
+  std::shuffle(fds.begin(), fds.end(), rng);
+  size_t victims = (size_t)(fds.size() * opt.stormFrac);
+  for (size_t i = 0; i < victims; i++) closeConn(fds[i]);
+  stats.storms++;
+  printf("⚡ Reconnect storm: dropped %zu of %zu clients\n", victims, fds.size());
+}
+
+static void report(double seconds) {
+  printf("📊 clients=%zu accepted=%llu logins=%llu closed=%llu | rx=%.0f/s tx=%.0f/s "
+         "hw=%llu ping=%llu dropped=%llu\n",
+         conns.size(), (unsigned long long)stats.accepted, (unsigned long long)stats.logins,
+         (unsigned long long)stats.closed, stats.rxMsgs / seconds, stats.txMsgs / seconds,
+         (unsigned long long)stats.hwWrites, (unsigned long long)stats.pings,
+         (unsigned long long)stats.dropped);
+  stats.uplink.print("uplink latency");
+  fflush(stdout);
+  stats.rxMsgs = stats.txMsgs = stats.hwWrites = stats.pings = stats.dropped = 0;
+  stats.uplink = LatencyStats();
+}
+
+static void usage(const char* prog) {
+  printf("Usage: %s [--port N] [--ack] [--delay-ms N] [--jitter-ms N] [--loss PCT]\n"
+         "          [--push-ms N] [--storm-every SEC] [--storm-frac F]\n"
+         "          [--report SEC] [--duration SEC]\n", prog);
+}
+
+static void onSignal(int) { stopRequested = 1; }
+
+int main(int argc, char** argv) {
+  static const struct option longOpts[] = {
+    {"port",        required_argument, nullptr, 'p'},
+    {"ack",         no_argument,       nullptr, 'a'},
+    {"delay-ms",    required_argument, nullptr, 'd'},
+    {"jitter-ms",   required_argument, nullptr, 'j'},
+    {"loss",        required_argument, nullptr, 'l'},
+    {"push-ms",     required_argument, nullptr, 'u'},
+    {"storm-every", required_argument, nullptr, 's'},
+    {"storm-frac",  required_argument, nullptr, 'f'},
+    {"report",      required_argument, nullptr, 'r'},
+    {"duration",    required_argument, nullptr, 't'},
+    {"help",        no_argument,       nullptr, 'h'},
+    {nullptr, 0, nullptr, 0}
+  };
+  int c;
+  while ((c = getopt_long(argc, argv, "p:h", longOpts, nullptr)) != -1) {
+    switch (c) {
+      case 'p': opt.port = atoi(optarg); break;
+      case 'a': opt.ack = true; break;
+      case 'd': opt.delayMs = atoi(optarg); break;
+      case 'j': opt.jitterMs = atoi(optarg); break;
+      case 'l': opt.lossPct = atof(optarg); break;
+      case 'u': opt.pushMs = atoi(optarg); break;
+      case 's': opt.stormEverySec = atoi(optarg); break;
+      case 'f': opt.stormFrac = atof(optarg); break;
+      case 'r': opt.reportSec = atoi(optarg); break;
+      case 't': opt.durationSec = atoi(optarg); break;
+      default: usage(argv[0]); return c == 'h' ? 0 : 1;
+    }
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+
+  int lfd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(opt.port);
+  if (bind(lfd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(lfd, 1024) < 0) {
+    perror("bind/listen");
+    return 1;
+  }
+  setNonBlocking(lfd);
+
+  epfd = epoll_create1(0);
+  struct epoll_event lev = {};
+  lev.events = EPOLLIN;
+  lev.data.fd = lfd;
+  epoll_ctl(epfd, EPOLL_CTL_ADD, lfd, &lev);
+
+  printf("🖥️ Blynk stand-in server on :%d (ack=%d delay=%d±%d ms loss=%.1f%% push=%d ms storm=%ds/%.0f%%)\n",
+         opt.port, opt.ack, opt.delayMs, opt.jitterMs, opt.lossPct, opt.pushMs,
+         opt.stormEverySec, opt.stormFrac * 100);
+  fflush(stdout);
+
+  const uint64_t startUs = wireNowUs();
+  uint64_t lastReportUs = startUs;
+  uint64_t nextStormUs = opt.stormEverySec ? startUs + (uint64_t)opt.stormEverySec * 1000000 : 0;
+  struct epoll_event events[256];
+
+  while (!stopRequested) {
+    uint64_t now = wireNowUs();
+    // Sleep until the next timed action (delay line, push tick, storm or report)
+    uint64_t wakeUs = lastReportUs + (uint64_t)opt.reportSec * 1000000;
+    if (!pending.empty()) wakeUs = std::min(wakeUs, pending.begin()->first);
+    if (opt.pushMs > 0) wakeUs = std::min(wakeUs, now + (uint64_t)opt.pushMs * 1000 / 4);
+    if (nextStormUs) wakeUs = std::min(wakeUs, nextStormUs);
+    int timeoutMs = wakeUs > now ? (int)((wakeUs - now + 999) / 1000) : 0;
+
+    int n = epoll_wait(epfd, events, 256, timeoutMs);
+    for (int i = 0; i < n; i++) {
+      int fd = events[i].data.fd;
+      if (fd == lfd) {
+        acceptAll(lfd);
+        continue;
+      }
+      auto it = conns.find(fd);
+      if (it == conns.end()) continue;
+      if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+        closeConn(fd);
+        continue;
+      }
+      if (events[i].events & EPOLLIN) readConn(it->second);
+      it = conns.find(fd);
+      if (it != conns.end() && (events[i].events & EPOLLOUT)) flushConn(it->second);
+    }
+
+    now = wireNowUs();
+    runDuePending(now);
+    runPushes(now);
+    if (nextStormUs && now >= nextStormUs) {
+      runStorm();
+      nextStormUs = now + (uint64_t)opt.stormEverySec * 1000000;
+    }
+    if (now - lastReportUs >= (uint64_t)opt.reportSec * 1000000) {
+      report((now - lastReportUs) / 1e6);
+      lastReportUs = now;
+    }
+    if (opt.durationSec && now - startUs >= (uint64_t)opt.durationSec * 1000000) break;
+  }
+
+  printf("👋 Server stopped after %.1f s, %llu storms\n", (wireNowUs() - startUs) / 1e6,
+         (unsigned long long)stats.storms);
+  return 0;
+}
@@ -0,0 +1,221 @@
+// 🌀 Fan loop against a thermal model
+// Runs the firmware's fan controller (src/fan_control.cpp, linked unchanged)
+// on a lumped thermal model of the shop and compares it with the old
+// bang-bang switch (fan full on while temperature > TEMP_THRESHOLD or
+// humidity > HUMIDITY_THRESHOLD, re-evaluated every 20 ms).
+//
+//   ./fan_model
+//   ./fan_model --hours 4 --heat 120,300,80 --csv trace.csv
+//
+// Model: C dT/dt = heat - (lossWPerK + fanWPerK * duty) * (T - ambient).
+// The controller sees what the firmware sees: a DHT11 reading rounded to
+// whole degrees that changes at most every 2 s, sampled every 250 ms, with a
+// loop step on every changed sample and every FAN_CONTROL_PERIOD_MS while
+// regulating.
+
+#include "fan_control.h"
+
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#define SAMPLE_MS      250     // TaskSensorPoll period
+#define DHT_UPDATE_MS  2000    // DHT library cache
+#define OLD_LOOP_MS    20      // Old TaskActuators loop
+
+// ⚙️ Command line options
+struct ModelOptions {
+  double hours = 3;
+  std::vector<double> heatW = {150, 300, 100};   // Heat load, one step per equal slice of the run
+  double ambientC = 20;
+  double startC = 24;
+  double capJPerK = 20000;     // Air, shelving and stock
+  double lossWPerK = 10;       // Walls with the fan off
+  double fanWPerK = 100;       // Extra exchange at full fan duty
+  int humidityPct = 45;
+  const char* csvPath = nullptr;
+};
+
+struct Plant {
+  double tempC;
+
+  void step(const ModelOptions& o, double heatW, double duty, double dtS) {
+    double exchange = o.lossWPerK + o.fanWPerK * duty;
+    tempC += (heatW - exchange * (tempC - o.ambientC)) * dtS / o.capJPerK;
+  }
+};
+
+struct RunStats {
+  double maxC = -1e9;
+  double sumAbsErr = 0;        // |T - setpoint|, time weighted
+  double overSetpointS = 0;    // Time more than 1 C above the setpoint
+  double dutySum = 0;          // Mean duty ~ fan energy
+  double seconds = 0;
+  uint32_t toggles = 0;        // Off <-> on transitions
+  uint32_t writes = 0;         // Pin or duty writes
+
+  void sample(double tempC, double duty, double dtS) {
+    if (tempC > maxC) maxC = tempC;
+    sumAbsErr += fabs(tempC - FAN_TEMP_SETPOINT_C) * dtS;
+    if (tempC > FAN_TEMP_SETPOINT_C + 1) overSetpointS += dtS;
+    dutySum += duty * dtS;
+    seconds += dtS;
+  }
+};
+
+static double heatAt(const ModelOptions& o, uint32_t nowMs, uint32_t endMs) {
+  size_t slice = (size_t)((uint64_t)nowMs * o.heatW.size() / endMs);
+  return o.heatW[slice < o.heatW.size() ? slice : o.heatW.size() - 1];
+}
+
+static int dhtReading(double tempC) {
+  return (int)lround(tempC);
+}
+
+// 🔁 Old bang-bang switch
+static RunStats runBangBang(const ModelOptions& o, uint32_t endMs) {
+  RunStats stats;
+  Plant plant{o.startC};
+  int reading = dhtReading(plant.tempC);
+  bool on = false;
+  for (uint32_t now = 0; now < endMs; now += OLD_LOOP_MS) {
+    if (now % DHT_UPDATE_MS == 0) reading = dhtReading(plant.tempC);
+    bool wanted = reading > TEMP_THRESHOLD || o.humidityPct > HUMIDITY_THRESHOLD;
+    if (wanted != on) stats.toggles++;
+    on = wanted;
+    stats.writes++;            // digitalWrite() on every pass
+    double duty = on ? 1.0 : 0.0;
+    plant.step(o, heatAt(o, now, endMs), duty, OLD_LOOP_MS / 1000.0);
+    stats.sample(plant.tempC, duty, OLD_LOOP_MS / 1000.0);
+  }
+  return stats;
+}
+
+// 🔁 Firmware PI loop
+static RunStats runFirmware(const ModelOptions& o, uint32_t endMs, FILE* csv) {
+  RunStats stats;
+  Plant plant{o.startC};
+  int reading = dhtReading(plant.tempC);
+  int stepped = INT32_MIN;     // Reading of the last loop step
+  uint16_t duty = 0;
+  uint32_t steps = 0;
+  initFanControl();
+
+  if (csv) fprintf(csv, "t_s,temp_c,reading_c,duty_permille,integral_permille,heat_w\n");
+  for (uint32_t now = 0; now < endMs; now += SAMPLE_MS) {
+    if (now % DHT_UPDATE_MS == 0) reading = dhtReading(plant.tempC);
+    if (reading != stepped || fanControlDueInMs(now) == 0) {
+      uint16_t next = updateFanControl(reading, o.humidityPct, false, now);
+      if ((next == 0) != (duty == 0)) stats.toggles++;
+      duty = next;
+      stepped = reading;
+      steps++;
+    }
+    double heat = heatAt(o, now, endMs);
+    plant.step(o, heat, duty / 1000.0, SAMPLE_MS / 1000.0);
+    stats.sample(plant.tempC, duty / 1000.0, SAMPLE_MS / 1000.0);
+
+    if (csv && now % 10000 == 0) {
+      FanControlState s;
+      getFanControlState(&s);
+      fprintf(csv, "%u,%.2f,%d,%u,%d,%.0f\n", now / 1000, plant.tempC, reading, duty,
+              (int)s.integralPermille, heat);
+    }
+  }
+  FanControlState s;
+  getFanControlState(&s);
+  stats.writes = s.writes;
+  printf("loop steps: %u (%.2f per minute)\n", steps, steps / (endMs / 60000.0));
+  return stats;
+}
+
+static void printStats(const char* name, const RunStats& s) {
+  printf("%-10s max %5.2f C  mean |err| %4.2f C  >SP+1 %5.1f%%  mean duty %5.1f%%  toggles %5u  writes %8u\n",
+         name, s.maxC, s.sumAbsErr / s.seconds, 100.0 * s.overSetpointS / s.seconds,
+         100.0 * s.dutySum / s.seconds, s.toggles, s.writes);
+}
+
+static std::vector<double> parseList(const char* text) {
+  std::vector<double> values;
+  std::string item;
+  for (const char* p = text;; p++) {
+    if (*p == ',' || *p == 0) {
+      if (!item.empty()) values.push_back(atof(item.c_str()));
+      item.clear();
+      if (*p == 0) break;
+    } else {
+      item += *p;
+    }
+  }
+  return values;
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "usage: %s [--hours H] [--heat W[,W...]] [--ambient C] [--start C]\n"
+          "          [--capacity J/K] [--loss W/K] [--fan W/K] [--humidity PCT] [--csv FILE]\n",
+          argv0);
+}
+
+int main(int argc, char** argv) {
+  ModelOptions o;
+  static const struct option longOpts[] = {
+    {"hours", required_argument, nullptr, 'H'},
+    {"heat", required_argument, nullptr, 'q'},
+    {"ambient", required_argument, nullptr, 'a'},
+    {"start", required_argument, nullptr, 's'},
+    {"capacity", required_argument, nullptr, 'c'},
+    {"loss", required_argument, nullptr, 'l'},
+    {"fan", required_argument, nullptr, 'f'},
+    {"humidity", required_argument, nullptr, 'h'},
+    {"csv", required_argument, nullptr, 'o'},
+    {nullptr, 0, nullptr, 0},
+  };
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", longOpts, nullptr)) != -1) {
+    switch (opt) {
+      case 'H': o.hours = atof(optarg); break;
+      case 'q': o.heatW = parseList(optarg); break;
+      case 'a': o.ambientC = atof(optarg); break;
+      case 's': o.startC = atof(optarg); break;
+      case 'c': o.capJPerK = atof(optarg); break;
+      case 'l': o.lossWPerK = atof(optarg); break;
+      case 'f': o.fanWPerK = atof(optarg); break;
+      case 'h': o.humidityPct = atoi(optarg); break;
+      case 'o': o.csvPath = optarg; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (o.hours <= 0 || o.heatW.empty() || o.capJPerK <= 0) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  FILE* csv = nullptr;
+  if (o.csvPath) {
+    csv = fopen(o.csvPath, "w");
+    if (!csv) {
+      perror(o.csvPath);
+      return 1;
+    }
+  }
+
+  uint32_t endMs = (uint32_t)(o.hours * 3600000.0);
+  printf("🌀 %.1f h, setpoint %d C, ambient %.1f C, heat", o.hours, FAN_TEMP_SETPOINT_C, o.ambientC);
+  for (double w : o.heatW) printf(" %.0f", w);
+  printf(" W, Kp %d Ki %d, duty %d-%d permille (hysteresis %d)\n",
+         FAN_KP, FAN_KI, FAN_MIN_DUTY, FAN_MAX_DUTY, FAN_HYSTERESIS);
+
+  RunStats pi = runFirmware(o, endMs, csv);
+  RunStats bang = runBangBang(o, endMs);
+  printStats("firmware", pi);
+  printStats("bang-bang", bang);
+
+  if (csv) fclose(csv);
+  return 0;
+}
@@ -0,0 +1,279 @@
+// 📊 Rollup engine benchmark over synthetic years
+// Feeds the firmware's rollup engine (src/history_rollup.cpp, linked
+// unchanged) one point per second of a synthetic shop: daily and seasonal
+// temperature and humidity swings, motion bursts in opening hours, door
+// openings, rare night intrusions and fires. Afterwards it checks random
+// range queries against a brute-force scan of per-minute reference buckets
+// and reports the cost of an append, of a query and of the scan it replaces.
+//
+//   ./rollup_bench
+//   ./rollup_bench --years 5 --queries 2000 --seed 7
+//
+// Query edges are aligned to the finest bucket the rings still hold at the
+// range start (minutes within the last day, hours within the hour ring,
+// days beyond), where the rollup answer must match the scan exactly.
+
+#include "history_rollup.h"
+#include "history_store.h"
+
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#define DAY_S   86400u
+#define YEAR_S  (365u * DAY_S)
+
+// ⚙️ Command line options
+struct BenchOptions {
+  double years = 2;
+  uint32_t queries = 1000;
+  uint32_t seed = 1;
+};
+
+static uint32_t rng = 1;
+
+static uint32_t nextRandom() {   // xorshift32
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static uint32_t randomBelow(uint32_t n) {
+  return n ? nextRandom() % n : 0;
+}
+
+static uint64_t nowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// 🏪 Synthetic shop, one sample per second
+struct ShopModel {
+  uint32_t motionUntil = 0;
+  uint32_t doorUntil = 0;
+  uint32_t intrusionUntil = 0;
+  uint32_t fireUntil = 0;
+  double baseTemp = 0;
+  double baseHum = 0;
+
+  // Slow components once per minute: the sines dominate the run time otherwise
+  void minute(uint32_t sec) {
+    double day = 2 * M_PI * (sec % DAY_S) / DAY_S;
+    double season = 2 * M_PI * (sec % YEAR_S) / YEAR_S;
+    baseTemp = 21 + 4 * sin(day - M_PI / 2) + 7 * sin(season - M_PI / 2);
+    baseHum = 55 - 12 * sin(day - M_PI / 2) + 8 * sin(season);
+  }
+
+  void sample(uint32_t sec, int16_t* tempC, int16_t* humPct, uint8_t* hazards) {
+    uint32_t hour = (sec % DAY_S) / 3600;
+    bool open = hour >= 9 && hour < 19;
+    if (open && sec >= motionUntil && randomBelow(600) == 0) {
+      motionUntil = sec + 5 + randomBelow(55);
+      if (randomBelow(3) == 0) doorUntil = sec + 10;
+    }
+    if (!open && sec >= intrusionUntil && randomBelow(3 * DAY_S) == 0) intrusionUntil = sec + 30;
+    if (sec >= fireUntil && randomBelow(180 * DAY_S) == 0) fireUntil = sec + 120;
+
+    double noise = (int32_t)randomBelow(1001) / 1000.0 - 0.5;
+    *tempC = (int16_t)lround(baseTemp + noise + (sec < fireUntil ? 15 : 0));
+    *humPct = (int16_t)std::min(95L, std::max(15L, lround(baseHum + 2 * noise)));
+    *hazards = (sec < motionUntil || sec < intrusionUntil ? HIST_HAZ_MOTION : 0) |
+               (sec < intrusionUntil ? HIST_HAZ_INTRUSION : 0) | (sec < fireUntil ? HIST_HAZ_FIRE : 0) |
+               (sec < doorUntil ? HIST_HAZ_DOOR : 0);
+  }
+};
+
+// 🧾 Reference: per-minute buckets of the same samples, scanned by brute force
+struct RefMinute {
+  int32_t tempSum, humSum;
+  int16_t tempMin, tempMax, humMin, humMax;
+  uint16_t samples, motion, intrusion, fire, door;
+};
+
+static void refQuery(const std::vector<RefMinute>& ref, uint32_t fromSec, uint32_t toSec, RollupAgg* out) {
+  memset(out, 0, sizeof(*out));
+  out->tempMin = out->humMin = INT16_MAX;
+  out->tempMax = out->humMax = INT16_MIN;
+  for (uint32_t m = fromSec / 60; m < (toSec + 59) / 60 && m < ref.size(); m++) {
+    const RefMinute& r = ref[m];
+    if (!r.samples) continue;
+    out->tempSum += r.tempSum;
+    out->humSum += r.humSum;
+    out->samples += r.samples;
+    out->tempMin = std::min(out->tempMin, r.tempMin);
+    out->tempMax = std::max(out->tempMax, r.tempMax);
+    out->humMin = std::min(out->humMin, r.humMin);
+    out->humMax = std::max(out->humMax, r.humMax);
+    out->motionEvents += r.motion;
+    out->intrusionAlarms += r.intrusion;
+    out->fireEvents += r.fire;
+    out->doorOpenings += r.door;
+  }
+}
+
+static bool sameAgg(const RollupAgg* a, const RollupAgg* b) {
+  if (a->samples != b->samples) return false;
+  if (!a->samples) return true;
+  return a->tempSum == b->tempSum && a->humSum == b->humSum && a->tempMin == b->tempMin &&
+         a->tempMax == b->tempMax && a->humMin == b->humMin && a->humMax == b->humMax &&
+         a->motionEvents == b->motionEvents && a->intrusionAlarms == b->intrusionAlarms &&
+         a->fireEvents == b->fireEvents && a->doorOpenings == b->doorOpenings;
+}
+
+// Aligns a range to the finest bucket still held at its start
+static void alignRange(uint32_t newestSec, uint32_t* fromSec, uint32_t* toSec) {
+  uint32_t width;
+  uint32_t toMin = newestSec / 60, toHour = newestSec / 3600;
+  if (*fromSec / 60 + ROLLUP_MINUTE_BUCKETS > toMin) {
+    width = 60;
+  } else if (*fromSec / 3600 + ROLLUP_HOUR_BUCKETS > toHour) {
+    width = 3600;
+  } else {
+    width = DAY_S;
+    uint32_t oldestDay = newestSec / DAY_S + 1 > ROLLUP_DAY_BUCKETS ? newestSec / DAY_S + 1 - ROLLUP_DAY_BUCKETS : 0;
+    if (*fromSec / DAY_S < oldestDay) *fromSec = oldestDay * DAY_S;
+  }
+  *fromSec = *fromSec / width * width;
+  *toSec = *toSec / width * width;
+}
+
+static uint64_t percentile(std::vector<uint64_t>& v, double p) {
+  if (v.empty()) return 0;
+  std::sort(v.begin(), v.end());
+  return v[(size_t)(p / 100.0 * (v.size() - 1) + 0.5)];
+}
+
+static void printAgg(const char* label, const RollupAgg* a) {
+  int32_t t10 = rollupTempAvg10(a), h10 = rollupHumAvg10(a);
+  printf("  %-6s T %3d/%5.1f/%3d C  H %3d/%5.1f/%3d %%  motion %6u  door %5u  intrusion %3u  fire %u\n",
+         label, a->tempMin, t10 / 10.0, a->tempMax, a->humMin, h10 / 10.0, a->humMax,
+         (unsigned)a->motionEvents, (unsigned)a->doorOpenings, (unsigned)a->intrusionAlarms,
+         (unsigned)a->fireEvents);
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "usage: %s [--years Y] [--queries N] [--seed S]\n"
+          "  --years Y     synthetic time fed at 1 Hz (2)\n"
+          "  --queries N   random ranges checked against the brute-force scan (1000)\n"
+          "  --seed S      random seed (1)\n",
+          argv0);
+}
+
+int main(int argc, char** argv) {
+  BenchOptions o;
+  static const struct option longOpts[] = {
+    {"years", required_argument, nullptr, 'y'},
+    {"queries", required_argument, nullptr, 'q'},
+    {"seed", required_argument, nullptr, 's'},
+    {nullptr, 0, nullptr, 0},
+  };
+  int opt;
+  while ((opt = getopt_long(argc, argv, "", longOpts, nullptr)) != -1) {
+    switch (opt) {
+      case 'y': o.years = atof(optarg); break;
+      case 'q': o.queries = (uint32_t)atoi(optarg); break;
+      case 's': o.seed = (uint32_t)atoi(optarg); break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (o.years <= 0 || o.years > 100) {
+    usage(argv[0]);
+    return 2;
+  }
+  rng = o.seed ? o.seed : 1;
+
+  if (!initHistoryRollup()) return 1;
+  uint32_t totalSec = (uint32_t)(o.years * YEAR_S);
+  std::vector<RefMinute> ref((totalSec + 59) / 60);
+  for (RefMinute& r : ref) {
+    memset(&r, 0, sizeof(r));
+    r.tempMin = r.humMin = INT16_MAX;
+    r.tempMax = r.humMax = INT16_MIN;
+  }
+
+  // ✍️ Feed
+  ShopModel shop;
+  uint8_t prevHazards = 0;
+  uint64_t addNs = 0;
+  for (uint32_t sec = 0; sec < totalSec; sec++) {
+    if (sec % 60 == 0) shop.minute(sec);
+    int16_t tempC, humPct;
+    uint8_t hazards;
+    shop.sample(sec, &tempC, &humPct, &hazards);
+
+    uint64_t t0 = nowNs();
+    rollupAdd(sec, tempC, humPct, hazards);
+    addNs += nowNs() - t0;
+
+    RefMinute& r = ref[sec / 60];
+    uint8_t rising = hazards & ~prevHazards;
+    prevHazards = hazards;
+    r.tempSum += tempC;
+    r.humSum += humPct;
+    r.samples++;
+    r.tempMin = std::min(r.tempMin, tempC);
+    r.tempMax = std::max(r.tempMax, tempC);
+    r.humMin = std::min(r.humMin, humPct);
+    r.humMax = std::max(r.humMax, humPct);
+    r.motion += (rising & HIST_HAZ_MOTION) ? 1 : 0;
+    r.intrusion += (rising & HIST_HAZ_INTRUSION) ? 1 : 0;
+    r.fire += (rising & HIST_HAZ_FIRE) ? 1 : 0;
+    r.door += (rising & HIST_HAZ_DOOR) ? 1 : 0;
+  }
+  uint32_t newestSec = totalSec - 1;
+  printf("=== %g years at 1 Hz: %u points, append %.1f ns/point ===\n",
+         o.years, (unsigned)totalSec, (double)addNs / totalSec);
+
+  // 🔎 Random ranges: the rollup against the scan
+  std::vector<uint64_t> queryNs, scanNs;
+  uint32_t mismatches = 0;
+  for (uint32_t i = 0; i < o.queries; i++) {
+    uint32_t span = 60 + randomBelow(std::min(totalSec, ROLLUP_DAY_BUCKETS * DAY_S));
+    uint32_t toSec = newestSec + 1 - randomBelow(std::min(totalSec / 4 + 1, 30 * DAY_S));
+    uint32_t fromSec = toSec > span ? toSec - span : 0;
+    alignRange(newestSec, &fromSec, &toSec);
+    if (fromSec >= toSec) continue;
+
+    RollupAgg got, want;
+    uint64_t t0 = nowNs();
+    rollupQuery(fromSec, toSec, &got);
+    uint64_t t1 = nowNs();
+    refQuery(ref, fromSec, toSec, &want);
+    uint64_t t2 = nowNs();
+    queryNs.push_back(t1 - t0);
+    scanNs.push_back(t2 - t1);
+    if (!sameAgg(&got, &want)) {
+      if (mismatches++ < 5) {
+        printf("  mismatch [%u, %u) s:\n", (unsigned)fromSec, (unsigned)toSec);
+        printAgg("rollup", &got);
+        printAgg("scan", &want);
+      }
+    }
+  }
+  printf("  %zu ranges checked, %u mismatches\n", queryNs.size(), (unsigned)mismatches);
+  printf("  rollup query   p50=%8.2f us  p99=%8.2f us  max=%8.2f us\n", percentile(queryNs, 50) / 1000.0,
+         percentile(queryNs, 99) / 1000.0, percentile(queryNs, 100) / 1000.0);
+  printf("  minute scan    p50=%8.2f us  p99=%8.2f us  max=%8.2f us (60x more for raw points)\n",
+         percentile(scanNs, 50) / 1000.0, percentile(scanNs, 99) / 1000.0, percentile(scanNs, 100) / 1000.0);
+
+  // 📤 What the OLED and Blynk show at the end of the run
+  static const struct {
+    const char* label;
+    uint32_t seconds;
+  } windows[] = {{"1h", 3600}, {"24h", DAY_S}, {"7d", 7 * DAY_S}, {"30d", 30 * DAY_S}, {"1y", YEAR_S}};
+  for (const auto& w : windows) {
+    RollupAgg a;
+    rollupLast(w.seconds, &a);
+    printAgg(w.label, &a);
+  }
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+// 🔎 Deferred log decoder
+// Turns the firmware's Serial stream back into text: binary records (0x1E ...
+// 0x00 frames, see include/deferred_log.h) are formatted from the same
+// log_catalog.h the firmware was built with; everything else - boot messages
+// and other plain prints - passes through untouched.
+//
+//   ./log_decode --port /dev/ttyACM0           # live, sets the tty to raw mode
+//   ./log_decode capture.bin > capture.txt
+//   pio device monitor --raw | ./log_decode
+
+#include "deferred_log.h"
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <string>
+
+// ⚙️ Command line options
+struct DecodeOptions {
+  const char* port = nullptr;
+  bool relative = false;       // Timestamps relative to the first record
+  bool stats = false;          // Print record / byte counts on exit
+};
+
+struct DecodeState {
+  bool inFrame = false;
+  std::string frame;
+  uint64_t epochUs = 0;        // Unwraps the 32-bit µs timestamp (71 min)
+  uint32_t lastTsUs = 0;
+  bool haveTs = false;
+  uint64_t firstUs = 0;
+  uint32_t records = 0;
+  uint32_t badFrames = 0;
+  uint64_t frameBytes = 0;
+  uint64_t textBytes = 0;
+  bool atLineStart = true;
+};
+
+static int openPort(const char* path) {
+  int fd = open(path, O_RDONLY | O_NOCTTY);
+  if (fd < 0) {
+    perror(path);
+    return -1;
+  }
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B921600);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  return fd;
+}
+
+static void emitRecord(DecodeState& st, const DecodeOptions& opt) {
+  LogRecord rec;
+  if (!decodeLogFrame((const uint8_t*)st.frame.data(), st.frame.size(), &rec)) {
+    st.badFrames++;
+    return;
+  }
+  if (st.haveTs && rec.tsUs < st.lastTsUs) {
+    st.epochUs += 1ull << 32;
+  }
+  st.lastTsUs = rec.tsUs;
+  uint64_t us = st.epochUs + rec.tsUs;
+  if (!st.haveTs) {
+    st.firstUs = us;
+    st.haveTs = true;
+  }
+  if (opt.relative) us -= st.firstUs;
+
+  char text[256];
+  formatLogRecord(&rec, text, sizeof(text));
+  if (!st.atLineStart) putchar('\n');
+  printf("[%6llu.%06llu c%u] %s\n", (unsigned long long)(us / 1000000),
+         (unsigned long long)(us % 1000000), rec.core, text);
+  st.atLineStart = true;
+  st.records++;
+
+  if (rec.id == LOG_BOOT && rec.argc == 1 && (uint32_t)rec.args[0] != getLogCatalogHash()) {
+    printf("⚠️ log_decode: firmware catalog %08x differs from this build (%08x) - rebuild the decoder\n",
+           (unsigned)rec.args[0], (unsigned)getLogCatalogHash());
+  }
+}
+
+static void feed(DecodeState& st, const DecodeOptions& opt, const uint8_t* buf, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    uint8_t c = buf[i];
+    if (st.inFrame) {
+      st.frameBytes++;
+      if (c == LOG_FRAME_END) {
+        emitRecord(st, opt);
+        st.inFrame = false;
+      } else if (st.frame.size() > LOG_MAX_FRAME + 4) {
+        st.badFrames++;            // Lost the end marker; resync on the next start
+        st.inFrame = false;
+      } else {
+        st.frame.push_back((char)c);
+      }
+      continue;
+    }
+    if (c == LOG_FRAME_START) {
+      st.inFrame = true;
+      st.frame.clear();
+      st.frameBytes++;
+      continue;
+    }
+    st.textBytes++;
+    if (c == '\r') continue;
+    putchar(c);
+    st.atLineStart = c == '\n';
+  }
+  fflush(stdout);
+}
+
+static void usage(const char* prog) {
+  fprintf(stderr, "usage: %s [--port TTY] [--relative] [--stats] [FILE]\n", prog);
+}
+
+int main(int argc, char** argv) {
+  DecodeOptions opt;
+  static const struct option longOpts[] = {
+    {"port",     required_argument, nullptr, 'p'},
+    {"relative", no_argument,       nullptr, 'r'},
+    {"stats",    no_argument,       nullptr, 's'},
+    {"help",     no_argument,       nullptr, 'h'},
+    {nullptr, 0, nullptr, 0}
+  };
+  int ch;
+  while ((ch = getopt_long(argc, argv, "p:rsh", longOpts, nullptr)) != -1) {
+    switch (ch) {
+      case 'p': opt.port = optarg; break;
+      case 'r': opt.relative = true; break;
+      case 's': opt.stats = true; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+
+  int fd = STDIN_FILENO;
+  if (opt.port) {
+    fd = openPort(opt.port);
+  } else if (optind < argc) {
+    fd = open(argv[optind], O_RDONLY);
+    if (fd < 0) perror(argv[optind]);
+  }
+  if (fd < 0) return 1;
+
+  DecodeState st;
+  uint8_t buf[4096];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf))) > 0) {
+    feed(st, opt, buf, (size_t)n);
+  }
+
+  if (opt.stats) {
+    fprintf(stderr, "log_decode: %u records (%llu bytes, %.1f B/record), %u bad frames, %llu text bytes\n",
+            st.records, (unsigned long long)st.frameBytes,
+            st.records ? (double)st.frameBytes / st.records : 0.0, st.badFrames,
+            (unsigned long long)st.textBytes);
+  }
+  return 0;
+}
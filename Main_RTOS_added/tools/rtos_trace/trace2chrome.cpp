@@ -0,0 +1,492 @@
+// 🔬 RTOS trace to Chrome trace JSON
+// Reads a Serial capture containing an RTOS trace dump ("#R:" lines, see
+// include/rtos_trace.h) and writes Chrome trace event JSON: one process per
+// core with a row per task, plus an "I2C bus" process. Open the result in
+// chrome://tracing or https://ui.perfetto.dev.
+//
+//   ./trace2chrome capture.log > trace.json
+//   ./log_decode --port /dev/ttyACM0 | tee capture.log     # capture first
+//   ./trace2chrome --dump 0 -o first.json capture.log
+//
+// A summary (CPU time per task, mutex waits, I2C bus load) goes to stderr.
+
+#include "rtos_trace_hooks.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// ⚙️ Command line options
+struct ConvertOptions {
+  int dump = -1;               // Which dump of the capture (-1 = last complete one)
+  const char* output = nullptr;
+};
+
+struct TraceObject {
+  uint8_t kind;
+  std::string name;
+};
+
+struct Dump {
+  unsigned source = RTOS_SRC_TICK;
+  unsigned cpuMhz = 240;
+  unsigned sinceBoot = 0;
+  std::map<uint32_t, TraceObject> objects;
+  std::vector<RtosTraceEvent> events;
+  bool complete = false;
+};
+
+// 📂 Input: every "#R:" record, wherever it starts (binary log frames have no newline)
+static bool loadDumps(const char* path, std::vector<Dump>* dumps) {
+  FILE* f = path ? fopen(path, "rb") : stdin;
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  std::string content;
+  char buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    content.append(buf, n);
+  }
+  if (path) fclose(f);
+
+  const size_t prefixLen = strlen(RTOS_TRACE_DUMP_PREFIX);
+  size_t pos = 0;
+  while ((pos = content.find(RTOS_TRACE_DUMP_PREFIX, pos)) != std::string::npos) {
+    pos += prefixLen;
+    size_t end = content.find('\n', pos);
+    if (end == std::string::npos) break;   // Cut off capture
+    std::string line = content.substr(pos, end - pos);
+    pos = end;
+    if (line.size() < 2) continue;
+
+    char kind = line[0];
+    const char* rest = line.c_str() + 2;
+    if (kind == 'H') {
+      Dump d;
+      unsigned version = 0, count = 0;
+      if (sscanf(rest, "%u %u %u %u %u", &version, &d.source, &d.cpuMhz, &count, &d.sinceBoot) != 5 ||
+          version != RTOS_TRACE_VERSION || d.cpuMhz == 0) {
+        fprintf(stderr, "trace2chrome: unsupported dump header '%s'\n", line.c_str());
+        continue;
+      }
+      d.events.reserve(count);
+      dumps->push_back(d);
+      continue;
+    }
+    if (dumps->empty()) continue;
+    Dump& d = dumps->back();
+    if (kind == 'O') {
+      unsigned id, objKind;
+      int nameAt = 0;
+      if (sscanf(rest, "%x %u %n", &id, &objKind, &nameAt) >= 2 && nameAt > 0) {
+        d.objects[id] = { (uint8_t)objKind, std::string(rest + nameAt) };
+      }
+    } else if (kind == 'E') {
+      size_t hexLen = strspn(rest, "0123456789abcdef");
+      const size_t eventHex = sizeof(RtosTraceEvent) * 2;
+      if (hexLen % eventHex != 0) continue;   // Line damaged in transit
+      for (size_t i = 0; i < hexLen; i += eventHex) {
+        uint8_t raw[sizeof(RtosTraceEvent)];
+        for (size_t b = 0; b < sizeof(raw); b++) {
+          char byteHex[3] = { rest[i + 2 * b], rest[i + 2 * b + 1], 0 };
+          raw[b] = (uint8_t)strtoul(byteHex, nullptr, 16);
+        }
+        RtosTraceEvent e;
+        memcpy(&e, raw, sizeof(e));
+        d.events.push_back(e);
+      }
+    } else if (kind == 'Z') {
+      d.complete = true;
+    }
+  }
+  return true;
+}
+
+// ⏱️ Cycle counts to µs: each core's events are placed relative to that
+// core's nearest preceding SYNC (or its first one, for events before it)
+static std::vector<double> timestamps(const Dump& d) {
+  std::vector<double> us(d.events.size(), 0);
+  bool haveSync[2] = { false, false };
+  uint32_t syncCycles[2] = { 0, 0 };
+  double syncUs[2] = { 0, 0 };
+  uint64_t microsBase = 0;
+  uint32_t lastMicros = 0;
+  bool anyMicros = false;
+
+  auto syncAt = [&](const RtosTraceEvent& e) {
+    if (anyMicros && e.obj < lastMicros && lastMicros - e.obj > 0x80000000u) {
+      microsBase += 1ull << 32;   // micros() wrapped (71 min)
+    }
+    lastMicros = e.obj;
+    anyMicros = true;
+    int c = e.core & 1;
+    haveSync[c] = true;
+    syncCycles[c] = e.cycles;
+    syncUs[c] = (double)(microsBase + e.obj);
+  };
+
+  // Events before a core's first SYNC use that first SYNC
+  for (const RtosTraceEvent& e : d.events) {
+    if (e.type == RTOS_EV_SYNC && !haveSync[e.core & 1]) {
+      haveSync[e.core & 1] = true;
+      syncCycles[e.core & 1] = e.cycles;
+      syncUs[e.core & 1] = e.obj;
+    }
+  }
+  for (size_t i = 0; i < d.events.size(); i++) {
+    const RtosTraceEvent& e = d.events[i];
+    if (e.type == RTOS_EV_SYNC) syncAt(e);
+    int c = e.core & 1;
+    us[i] = syncUs[c] + (double)(int32_t)(e.cycles - syncCycles[c]) / d.cpuMhz;
+  }
+  return us;
+}
+
+// 📝 JSON output
+class ChromeWriter {
+public:
+  explicit ChromeWriter(FILE* out) : out_(out) {
+    fprintf(out_, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  }
+  ~ChromeWriter() {
+    fprintf(out_, "\n]}\n");
+  }
+
+  void meta(const char* what, int pid, int tid, const std::string& name) {
+    begin();
+    fprintf(out_, "{\"ph\":\"M\",\"name\":\"%s\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+            what, pid, tid, escape(name).c_str());
+  }
+
+  void slice(const std::string& name, const char* cat, int pid, int tid, double ts, double dur,
+             const std::string& args = "") {
+    begin();
+    fprintf(out_, "{\"ph\":\"X\",\"name\":\"%s\",\"cat\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f%s%s%s}",
+            escape(name).c_str(), cat, pid, tid, ts, dur < 0 ? 0 : dur,
+            args.empty() ? "" : ",\"args\":{", args.c_str(), args.empty() ? "" : "}");
+  }
+
+  void instant(const std::string& name, const char* cat, int pid, int tid, double ts) {
+    begin();
+    fprintf(out_, "{\"ph\":\"i\",\"s\":\"t\",\"name\":\"%s\",\"cat\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f}",
+            escape(name).c_str(), cat, pid, tid, ts);
+  }
+
+  static std::string escape(const std::string& s) {
+    std::string r;
+    for (char ch : s) {
+      if (ch == '"' || ch == '\\') r += '\\';
+      if ((unsigned char)ch >= 0x20) r += ch;
+    }
+    return r;
+  }
+
+private:
+  void begin() {
+    if (count_++) fputs(",\n", out_);
+  }
+
+  FILE* out_;
+  unsigned count_ = 0;
+};
+
+#define PID_I2C 2
+#define TID_ISR 0
+
+struct Open {
+  bool active = false;
+  double startUs = 0;
+  uint32_t obj = 0;
+  int core = 0;
+};
+
+struct WaitStats {
+  unsigned count = 0;
+  unsigned timeouts = 0;
+  double totalUs = 0;
+  double maxUs = 0;
+
+  void add(double us, bool ok) {
+    count++;
+    if (!ok) timeouts++;
+    totalUs += us;
+    if (us > maxUs) maxUs = us;
+  }
+};
+
+// 🔄 Conversion
+static void convert(const Dump& d, FILE* out) {
+  std::vector<double> us = timestamps(d);
+  double t0 = 1e300, tEnd = 0;
+  for (size_t i = 0; i < us.size(); i++) {
+    if (us[i] < t0) t0 = us[i];
+    if (us[i] > tEnd) tEnd = us[i];
+  }
+  if (us.empty()) t0 = 0;
+
+  // Rows: tid per task handle, in order of first appearance
+  std::map<uint32_t, int> taskTid;
+  auto nameOf = [&](uint32_t id) {
+    auto it = d.objects.find(id);
+    if (it != d.objects.end() && it->second.name != "?") return it->second.name;
+    char buf[24];
+    snprintf(buf, sizeof(buf), "0x%08x", id);
+    return std::string(buf);
+  };
+  auto isMutex = [&](uint32_t id) {
+    auto it = d.objects.find(id);
+    return it != d.objects.end() && it->second.kind == RTOS_OBJ_MUTEX;
+  };
+  auto tidOf = [&](uint32_t task) {
+    if (task == 0) return TID_ISR;
+    auto it = taskTid.find(task);
+    if (it != taskTid.end()) return it->second;
+    int tid = (int)taskTid.size() + 1;
+    taskTid[task] = tid;
+    return tid;
+  };
+
+  ChromeWriter w(out);
+  w.meta("process_name", 0, 0, "Core 0");
+  w.meta("process_name", 1, 0, "Core 1");
+  w.meta("process_name", PID_I2C, 0, "I2C bus");
+  w.meta("thread_name", 0, TID_ISR, "ISR");
+  w.meta("thread_name", 1, TID_ISR, "ISR");
+  w.meta("thread_name", PID_I2C, 1, "transactions");
+
+  std::map<std::pair<int, uint32_t>, bool> namedRows;   // (pid, task) rows that got thread_name
+  auto row = [&](int pid, uint32_t task) {
+    int tid = tidOf(task);
+    if (task && !namedRows[{ pid, task }]) {
+      namedRows[{ pid, task }] = true;
+      w.meta("thread_name", pid, tid, nameOf(task));
+    }
+    return tid;
+  };
+
+  std::map<uint32_t, double> cpuUs;            // Running time per task
+  Open running[2];                             // Tick/kernel: one task per core
+  std::map<uint32_t, Open> runningSim;         // Native: open slice per task
+  std::map<uint32_t, Open> blocked;            // Task -> queue it blocks on
+  std::map<std::pair<uint32_t, uint32_t>, double> holding;   // (task, mutex) -> take time
+  std::map<uint32_t, WaitStats> waits;         // Per queue/mutex, blocking waits
+  std::map<uint32_t, Open> i2cWait;            // Task -> time it asked for the bus
+  WaitStats i2cWaits;
+  Open i2cBus;
+  uint32_t i2cOwner = 0;
+  double i2cBusyUs = 0;
+  unsigned i2cTransactions = 0;
+
+  auto closeRun = [&](uint32_t task, const Open& o, double now) {
+    int pid = o.core;
+    w.slice(nameOf(task), "task", pid, row(pid, task), o.startUs - t0, now - o.startUs);
+    cpuUs[task] += now - o.startUs;
+  };
+
+  for (size_t i = 0; i < d.events.size(); i++) {
+    const RtosTraceEvent& e = d.events[i];
+    double now = us[i];
+    int core = e.core & 1;
+    double ts = now - t0;
+
+    switch (e.type) {
+      case RTOS_EV_TASK_IN:
+        if (d.source == RTOS_SRC_SIM) {
+          Open& o = runningSim[e.obj];
+          if (!o.active) o = { true, now, e.obj, core };
+        } else {
+          if (running[core].active && running[core].obj != e.obj) {
+            closeRun(running[core].obj, running[core], now);
+          }
+          if (!running[core].active || running[core].obj != e.obj) {
+            running[core] = { true, now, e.obj, core };
+          }
+        }
+        break;
+
+      case RTOS_EV_TASK_OUT: {
+        Open& o = runningSim[e.obj];
+        if (o.active) {
+          closeRun(e.obj, o, now);
+          o.active = false;
+        }
+        break;
+      }
+
+      case RTOS_EV_QUEUE_BLOCK_SEND:
+      case RTOS_EV_QUEUE_BLOCK_RECV:
+        blocked[e.task] = { true, now, e.obj, core };
+        break;
+
+      case RTOS_EV_QUEUE_SEND:
+      case RTOS_EV_QUEUE_SEND_FAIL:
+      case RTOS_EV_QUEUE_RECV:
+      case RTOS_EV_QUEUE_RECV_FAIL:
+      case RTOS_EV_QUEUE_PEEK: {
+        bool mutex = isMutex(e.obj);
+        bool ok = e.type == RTOS_EV_QUEUE_SEND || e.type == RTOS_EV_QUEUE_RECV || e.type == RTOS_EV_QUEUE_PEEK;
+        bool receive = e.type >= RTOS_EV_QUEUE_RECV;
+        const char* verb = mutex ? (receive ? (ok ? "take" : "take timeout") : "give")
+                                 : (e.type == RTOS_EV_QUEUE_PEEK ? "peek"
+                                    : receive ? (ok ? "recv" : "recv timeout") : (ok ? "send" : "send failed"));
+        int tid = row(core, e.task);
+
+        auto b = blocked.find(e.task);
+        if (b != blocked.end() && b->second.active && b->second.obj == e.obj) {
+          char args[64];
+          snprintf(args, sizeof(args), "\"waited_us\":%.1f,\"ok\":%s", now - b->second.startUs, ok ? "true" : "false");
+          w.slice("wait " + nameOf(e.obj), "wait", core, tid, b->second.startUs - t0, now - b->second.startUs, args);
+          waits[e.obj].add(now - b->second.startUs, ok);
+          b->second.active = false;
+        }
+        w.instant(std::string(verb) + " " + nameOf(e.obj), mutex ? "mutex" : "queue", core, tid, ts);
+
+        if (mutex && receive && ok) {
+          holding[{ e.task, e.obj }] = now;
+        } else if (mutex && !receive && ok) {
+          auto h = holding.find({ e.task, e.obj });
+          if (h != holding.end()) {
+            w.slice("hold " + nameOf(e.obj), "mutex", core, tid, h->second - t0, now - h->second);
+            holding.erase(h);
+          }
+        }
+        break;
+      }
+
+      case RTOS_EV_I2C_WAIT:
+        i2cWait[e.task] = { true, now, e.obj, core };
+        break;
+
+      case RTOS_EV_I2C_BEGIN:
+      case RTOS_EV_I2C_TIMEOUT: {
+        bool ok = e.type == RTOS_EV_I2C_BEGIN;
+        int tid = row(core, e.task);
+        Open& wt = i2cWait[e.task];
+        double waited = wt.active ? now - wt.startUs : 0;
+        if (wt.active && (waited > 0 || !ok)) {
+          char args[64];
+          snprintf(args, sizeof(args), "\"waited_us\":%.1f,\"ok\":%s", waited, ok ? "true" : "false");
+          w.slice("wait I2C", "wait", core, tid, wt.startUs - t0, waited, args);
+        }
+        if (wt.active) {
+          i2cWaits.add(waited, ok);
+          wt.active = false;
+        }
+        if (ok) {
+          i2cBus = { true, now, e.obj, core };
+          i2cOwner = e.task;
+        } else {
+          w.instant("I2C timeout", "i2c", core, tid, ts);
+        }
+        break;
+      }
+
+      case RTOS_EV_I2C_END:
+        if (i2cBus.active && i2cOwner == e.task) {
+          char args[96];
+          snprintf(args, sizeof(args), "\"task\":\"%s\",\"core\":%d",
+                   ChromeWriter::escape(nameOf(e.task)).c_str(), core);
+          w.slice("I2C " + nameOf(e.task), "i2c", PID_I2C, 1, i2cBus.startUs - t0, now - i2cBus.startUs, args);
+          w.slice("I2C", "i2c", core, row(core, e.task), i2cBus.startUs - t0, now - i2cBus.startUs);
+          i2cBusyUs += now - i2cBus.startUs;
+          i2cTransactions++;
+          i2cBus.active = false;
+        }
+        break;
+
+      case RTOS_EV_ISR: {
+        char name[32];
+        snprintf(name, sizeof(name), "ISR %u", e.aux);
+        w.instant(name, "isr", core, TID_ISR, ts);
+        break;
+      }
+
+      default:
+        break;
+    }
+  }
+
+  // Close whatever still runs at the end of the window
+  for (int c = 0; c < 2; c++) {
+    if (running[c].active) closeRun(running[c].obj, running[c], tEnd);
+  }
+  for (auto& r : runningSim) {
+    if (r.second.active) closeRun(r.first, r.second, tEnd);
+  }
+
+  // 📊 Summary
+  double spanUs = tEnd - t0;
+  static const char* const sources[] = { "tick-sampled", "kernel hooks", "simulated kernel" };
+  fprintf(stderr, "trace2chrome: %zu events, %.3f s window, task switches: %s\n", d.events.size(),
+          spanUs / 1e6, d.source < 3 ? sources[d.source] : "?");
+  if (d.sinceBoot > d.events.size()) {
+    fprintf(stderr, "  (ring wrapped: %u events recorded since boot, last %zu kept)\n", d.sinceBoot, d.events.size());
+  }
+  for (auto& c : cpuUs) {
+    fprintf(stderr, "  %-16s %9.1f ms  %5.1f%%\n", nameOf(c.first).c_str(), c.second / 1000,
+            spanUs > 0 ? 100.0 * c.second / spanUs : 0.0);
+  }
+  for (auto& wq : waits) {
+    fprintf(stderr, "  wait %-11s %u blocking waits, %u timeouts, avg %.1f us, max %.1f us\n",
+            nameOf(wq.first).c_str(), wq.second.count, wq.second.timeouts,
+            wq.second.count ? wq.second.totalUs / wq.second.count : 0.0, wq.second.maxUs);
+  }
+  fprintf(stderr, "  I2C bus: %u transactions, %.1f%% busy, waits avg %.1f us, max %.1f us, %u timeouts\n",
+          i2cTransactions, spanUs > 0 ? 100.0 * i2cBusyUs / spanUs : 0.0,
+          i2cWaits.count ? i2cWaits.totalUs / i2cWaits.count : 0.0, i2cWaits.maxUs, i2cWaits.timeouts);
+}
+
+static void usage(const char* prog) {
+  fprintf(stderr, "usage: %s [--dump N] [-o OUT.json] [CAPTURE]\n", prog);
+}
+
+int main(int argc, char** argv) {
+  ConvertOptions opt;
+  static const struct option longOpts[] = {
+    {"dump",   required_argument, nullptr, 'd'},
+    {"output", required_argument, nullptr, 'o'},
+    {"help",   no_argument,       nullptr, 'h'},
+    {nullptr, 0, nullptr, 0}
+  };
+  int ch;
+  while ((ch = getopt_long(argc, argv, "d:o:h", longOpts, nullptr)) != -1) {
+    switch (ch) {
+      case 'd': opt.dump = atoi(optarg); break;
+      case 'o': opt.output = optarg; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+
+  std::vector<Dump> dumps;
+  if (!loadDumps(optind < argc ? argv[optind] : nullptr, &dumps)) return 1;
+
+  int pick = opt.dump;
+  if (pick < 0) {
+    for (int i = (int)dumps.size() - 1; i >= 0 && pick < 0; i--) {
+      if (dumps[i].complete) pick = i;
+    }
+  }
+  if (pick < 0 || pick >= (int)dumps.size()) {
+    fprintf(stderr, "trace2chrome: no %sdump found (%zu in capture)\n", opt.dump < 0 ? "complete " : "", dumps.size());
+    return 1;
+  }
+  if (!dumps[pick].complete) {
+    fprintf(stderr, "trace2chrome: dump %d is incomplete, converting what arrived\n", pick);
+  }
+
+  FILE* out = stdout;
+  if (opt.output && !(out = fopen(opt.output, "w"))) {
+    perror(opt.output);
+    return 1;
+  }
+  convert(dumps[pick], out);
+  if (out != stdout) fclose(out);
+  return 0;
+}
@@ -0,0 +1,322 @@
+// ⏩ Sensor trace replay
+// Feeds recorded TaskSensorPoll samples through the firmware's own sampleSensors(),
+// readFlameSensor(), readMotion() and the intrusion fusion (src/sensors.cpp and
+// src/intrusion_fusion.cpp, linked unchanged) at a multiple of real time, then
+// scores the fire/motion alarms against the raw activity in the trace. The
+// door position is not recorded; the fusion sees it closed. The ultrasonic
+// channel reports what the distance filter rejected, how often the door would
+// have opened on raw vs. filtered distance, and the filter's cost per ping.
+//
+//   ./trace_replay shop_monday.log flash_dump.bin
+//   ./trace_replay --fire-samples 4 --pir-samples 3 --speed 0 site/*.log
+//
+// Scoring, per channel: raw active runs closer than --merge-ms form one incident.
+// An incident lasting at least --min-incident-ms is real, anything shorter is
+// noise. Alarms during a real incident count as detections (latency measured
+// from the incident's first active sample), alarms during noise as false alarms.
+
+#include "sensors.h"
+#include "sensor_trace.h"
+#include "intrusion_fusion.h"
+#include "distance_filter.h"
+#include "system.h"
+#include "sim_hw.h"
+#include "bench_stats.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+// Firmware globals that sensors.cpp links against (normally in main.cpp)
+DHT dht(DHTPIN, DHTTYPE);
+int t = 0;
+int h = 0;
+long duration = 0;
+bool isDay = true;             // Thief-alert mode, so motion events are posted
+QueueHandle_t eventQueue = nullptr;
+
+// ⚙️ Command line options
+struct ReplayOptions {
+  double speed = 1000;         // Replay rate vs. real time (0 = as fast as possible)
+  int fireSamples = FIRE_DEBOUNCE_SAMPLES;
+  int pirSamples = PIR_DEBOUNCE_SAMPLES;
+  uint32_t mergeMs = 2000;     // Raw runs closer than this are one incident
+  uint32_t minIncidentMs = 1000;  // Shorter incidents are noise
+};
+
+struct Run {
+  uint32_t startMs;
+  uint32_t endMs;
+};
+
+// Raw activity and debounced alarms of one channel (fire or motion)
+struct Channel {
+  const char* name;
+  std::vector<Run> runs;
+  std::vector<uint32_t> alarms;
+  bool active = false;
+
+  void sample(bool raw, uint32_t tsMs) {
+    if (raw && !active) {
+      runs.push_back({tsMs, tsMs});
+    }
+    if (active || raw) {
+      runs.back().endMs = tsMs;
+    }
+    active = raw;
+  }
+};
+
+static const SensorSample* replaySample = nullptr;
+
+static void readReplaySample(SensorSample* out) {
+  *out = *replaySample;
+}
+
+static uint64_t monoUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// 📂 Input: raw flash dump, or a Serial monitor log with "#T:" lines
+static bool loadTrace(const char* path, std::vector<uint8_t>* bytes) {
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  std::string content;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    content.append(buf, n);
+  }
+  fclose(f);
+
+  if (content.find(TRACE_SERIAL_PREFIX) == std::string::npos) {
+    bytes->assign(content.begin(), content.end());
+    return true;
+  }
+
+  size_t pos = 0;
+  while ((pos = content.find(TRACE_SERIAL_PREFIX, pos)) != std::string::npos) {
+    pos += strlen(TRACE_SERIAL_PREFIX);
+    size_t end = pos;
+    while (end < content.size() && isxdigit((unsigned char)content[end])) end++;
+    bool wholeLine = end == content.size() || content[end] == '\r' || content[end] == '\n';
+    if (wholeLine && (end - pos) % 2 == 0) {   // Skip lines cut by a reset or a noisy link
+      for (size_t i = pos; i < end; i += 2) {
+        bytes->push_back((uint8_t)strtoul(content.substr(i, 2).c_str(), nullptr, 16));
+      }
+    }
+    pos = end;
+  }
+  return true;
+}
+
+// 📊 Scoring
+static void scoreChannel(Channel& ch, const ReplayOptions& opt) {
+  std::vector<Run> incidents;
+  for (const Run& r : ch.runs) {
+    if (!incidents.empty() && r.startMs - incidents.back().endMs < opt.mergeMs) {
+      incidents.back().endMs = r.endMs;
+    } else {
+      incidents.push_back(r);
+    }
+  }
+
+  LatencyStats latency;
+  uint32_t real = 0, detected = 0, missed = 0, retriggers = 0, falseAlarms = 0, rejected = 0;
+  size_t a = 0;
+  for (const Run& inc : incidents) {
+    uint32_t alarmsHere = 0, firstAlarm = 0;
+    while (a < ch.alarms.size() && ch.alarms[a] < inc.startMs) {
+      falseAlarms++;            // Alarm with no raw activity behind it
+      a++;
+    }
+    while (a < ch.alarms.size() && ch.alarms[a] <= inc.endMs) {
+      if (alarmsHere++ == 0) firstAlarm = ch.alarms[a];
+      a++;
+    }
+
+    bool isReal = inc.endMs - inc.startMs >= opt.minIncidentMs;
+    if (isReal) {
+      real++;
+      if (alarmsHere) {
+        detected++;
+        retriggers += alarmsHere - 1;
+        latency.add((uint64_t)(firstAlarm - inc.startMs) * 1000);
+      } else {
+        missed++;
+      }
+    } else if (alarmsHere) {
+      falseAlarms += alarmsHere;
+    } else {
+      rejected++;
+    }
+  }
+  falseAlarms += ch.alarms.size() - a;
+
+  printf("  %-6s incidents: %u real, %zu noise | detected %u, missed %u, re-triggers %u | "
+         "false alarms %u, glitches rejected %u\n",
+         ch.name, real, incidents.size() - real, detected, missed, retriggers, falseAlarms, rejected);
+  latency.print(ch.name[0] == 'f' ? "fire detect" : "motion detect");
+}
+
+// 📏 Ultrasonic channel: door triggers raw vs. filtered, filter counters and cost
+static void scoreDistance(const std::vector<SensorSample>& samples) {
+  DistanceFilter f;
+  distanceFilterReset(&f);
+  uint32_t rawOpens = 0, filteredOpens = 0;
+  bool rawNear = false, filteredNear = false;
+  for (const SensorSample& s : samples) {
+    bool raw = echoToCm(s.echoUs) <= DISTANCE_THRESHOLD;
+    bool filtered = distanceFilterUpdate(&f, s.echoUs, s.tsMs).distanceCm <= DISTANCE_THRESHOLD;
+    rawOpens += raw && !rawNear;
+    filteredOpens += filtered && !filteredNear;
+    rawNear = raw;
+    filteredNear = filtered;
+  }
+  printf("  dist   pings %u, no echo %u, spikes overruled %u, coasted %u, tracks %u | "
+         "door triggers raw %u, filtered %u\n",
+         (unsigned)f.pings, (unsigned)f.dropouts, (unsigned)f.spikes, (unsigned)f.coasted,
+         (unsigned)f.snaps, (unsigned)rawOpens, (unsigned)filteredOpens);
+
+  // Cost: the whole session through a fresh filter until ~1M pings are timed
+  size_t rounds = 1000000 / samples.size() + 1;
+  volatile int16_t sink = 0;
+  uint64_t start = monoUs();
+  for (size_t r = 0; r < rounds; r++) {
+    distanceFilterReset(&f);
+    for (const SensorSample& s : samples) {
+      sink = distanceFilterUpdate(&f, s.echoUs, s.tsMs).distanceCm;
+    }
+  }
+  (void)sink;
+  double ns = (monoUs() - start) * 1000.0 / ((double)rounds * samples.size());
+  printf("  dist   filter %.1f ns/ping on this host (median-of-%d + alpha-beta)\n", ns, DIST_MEDIAN_N);
+}
+
+// ⏩ Replay of one recording session
+static void replaySession(const char* label, const std::vector<SensorSample>& samples,
+                          const ReplayOptions& opt) {
+  if (samples.empty()) return;
+
+  Channel fire, motion;
+  fire.name = "fire";
+  motion.name = "motion";
+  setDebounceSamples(opt.fireSamples, opt.pirSamples);
+  resetIntrusionFusion();
+  xQueueReset(eventQueue);
+
+  uint32_t t0 = samples.front().tsMs;
+  uint64_t wallStart = monoUs();
+  for (const SensorSample& s : samples) {
+    if (opt.speed > 0) {
+      uint64_t due = wallStart + (uint64_t)((s.tsMs - t0) * 1000.0 / opt.speed);
+      uint64_t now = monoUs();
+      if (due > now) {
+        struct timespec ts = { (time_t)((due - now) / 1000000), (long)((due - now) % 1000000) * 1000 };
+        nanosleep(&ts, nullptr);
+      }
+    }
+
+    replaySample = &s;
+    sampleSensors();
+    readFlameSensor();
+    readMotion();
+    updateIntrusionSample(getDistance(), false, s.tsMs);
+
+    fire.sample(s.flame, s.tsMs);
+    motion.sample(s.pirMotion, s.tsMs);
+    Event e;
+    while (xQueueReceive(eventQueue, &e, 0) == pdTRUE) {
+      if (e.type == EVENT_FIRE_DETECTED) fire.alarms.push_back(e.tsMs);
+      if (e.type == EVENT_MOTION_DETECTED) motion.alarms.push_back(e.tsMs);
+    }
+  }
+  double wallS = (monoUs() - wallStart) / 1e6;
+  double spanS = (samples.back().tsMs - t0) / 1000.0;
+
+  printf("=== %s: %zu samples, %.1f min of trace replayed in %.2f s (%.0fx) ===\n",
+         label, samples.size(), spanS / 60, wallS, wallS > 0 ? spanS / wallS : 0.0);
+  scoreChannel(fire, opt);
+  scoreChannel(motion, opt);
+  scoreDistance(samples);
+}
+
+static void usage(const char* prog) {
+  fprintf(stderr,
+          "usage: %s [--speed X] [--fire-samples N] [--pir-samples N]\n"
+          "          [--merge-ms MS] [--min-incident-ms MS] TRACE...\n"
+          "  TRACE is a flash partition dump or a Serial log with " TRACE_SERIAL_PREFIX " lines\n",
+          prog);
+}
+
+int main(int argc, char** argv) {
+  ReplayOptions opt;
+  static const struct option longOpts[] = {
+    {"speed",           required_argument, nullptr, 's'},
+    {"fire-samples",    required_argument, nullptr, 'f'},
+    {"pir-samples",     required_argument, nullptr, 'p'},
+    {"merge-ms",        required_argument, nullptr, 'm'},
+    {"min-incident-ms", required_argument, nullptr, 'i'},
+    {"help",            no_argument,       nullptr, 'h'},
+    {nullptr, 0, nullptr, 0}
+  };
+  int ch;
+  while ((ch = getopt_long(argc, argv, "s:f:p:m:i:h", longOpts, nullptr)) != -1) {
+    switch (ch) {
+      case 's': opt.speed = atof(optarg); break;
+      case 'f': opt.fireSamples = atoi(optarg); break;
+      case 'p': opt.pirSamples = atoi(optarg); break;
+      case 'm': opt.mergeMs = (uint32_t)atoi(optarg); break;
+      case 'i': opt.minIncidentMs = (uint32_t)atoi(optarg); break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (optind >= argc) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  simSetSerialEcho(false);     // readMotion() logs every transition
+  eventQueue = xQueueCreate(16, sizeof(Event));
+  setSensorSource(readReplaySample);
+
+  for (int i = optind; i < argc; i++) {
+    std::vector<uint8_t> bytes;
+    if (!loadTrace(argv[i], &bytes)) return 1;
+
+    TraceReader reader;
+    traceReaderInit(&reader, bytes.data(), bytes.size());
+    std::vector<SensorSample> samples;
+    SensorSample s;
+    int session = 0;
+    char label[256];
+    TraceRecordKind kind;
+    while ((kind = traceReaderNext(&reader, &s)) != TRACE_KIND_END) {
+      if (kind == TRACE_KIND_ERROR) {
+        fprintf(stderr, "%s: bad record at byte %zu, rest of file skipped\n", argv[i], reader.pos);
+        break;
+      }
+      if (kind == TRACE_KIND_SESSION) {
+        snprintf(label, sizeof(label), "%s #%d", argv[i], session);
+        replaySession(label, samples, opt);
+        samples.clear();
+        session++;
+        continue;
+      }
+      samples.push_back(s);
+    }
+    snprintf(label, sizeof(label), "%s #%d", argv[i], session);
+    replaySession(label, samples, opt);
+  }
+  return 0;
+}